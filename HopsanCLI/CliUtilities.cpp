@@ -37,6 +37,9 @@
 #include <sstream>
 #include <fstream>
 #include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
 
 #if defined(_WIN32)
   #include <windows.h>
@@ -281,6 +284,46 @@ bool compareVectors(const std::vector<double> &rVec, const std::vector<double> &
     return true;
 }
 
+//! @brief Convert a string to a double, the whole string must be a number
+//! @param[in] rString The string to convert
+//! @param[out] rValue The value, only changed on success
+//! @returns True if the conversion succeeded
+bool parseDouble(const std::string &rString, double &rValue)
+{
+    if (rString.empty())
+    {
+        return false;
+    }
+    char *pEnd;
+    const double value = strtod(rString.c_str(), &pEnd);
+    if ((*pEnd != '\0') || !std::isfinite(value))
+    {
+        return false;
+    }
+    rValue = value;
+    return true;
+}
+
+//! @brief Convert a string to an unsigned integer, the whole string must be a non-negative integer
+//! @param[in] rString The string to convert
+//! @param[out] rValue The value, only changed on success
+//! @returns True if the conversion succeeded
+bool parseUnsignedInteger(const std::string &rString, size_t &rValue)
+{
+    if (rString.empty() || (rString.find_first_not_of("0123456789") != std::string::npos))
+    {
+        return false;
+    }
+    errno = 0;
+    const unsigned long long value = strtoull(rString.c_str(), 0, 10);
+    if ((errno == ERANGE) || (value > std::numeric_limits<size_t>::max()))
+    {
+        return false;
+    }
+    rValue = size_t(value);
+    return true;
+}
+
 //! @brief Read the paths of external liubs from a text file
 //! @param[in] filePath The file to read from
 //! @param[out] rExtLibFileNames A vector with paths to the external libs to load
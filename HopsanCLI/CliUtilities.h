@@ -58,6 +58,8 @@ size_t getNumAvailibleCores();
 
 // ===== Data Functions =====
 bool compareVectors(const std::vector<double> &rVec, const std::vector<double> &rRef, const double tol);
+bool parseDouble(const std::string &rString, double &rValue);
+bool parseUnsignedInteger(const std::string &rString, size_t &rValue);
 
 // ===== Read File Functions =====
 void readExternalLibsFromTxtFile(const std::string filePath, std::vector<std::string> &rExtLibFileNames);
@@ -30,6 +30,7 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <map>
 
 #include "ModelUtilities.h"
 #include "version_cli.h"
@@ -37,6 +38,7 @@
 
 #include "HopsanEssentials.h"
 #include "HopsanTypes.h"
+#include "CoreUtilities/ResultFile.h"
 
 #ifdef USEHDF5
 #include "hopsanhdf5exporter.h"
@@ -503,6 +505,58 @@ void saveResultsToHDF5(ComponentSystem *pRootSystem, const string &rFileName, co
 #endif
 }
 
+//! @brief Save all logged results to a Hopsan binary result file (.hrb)
+//! @details Each variable is transposed directly from the port log storage into one contiguous column in the file
+//! @param [in] pRootSystem Pointer to component system
+//! @param [in] rFileName File name for output file
+//! @param [in] includeFilter list of full port names or variables names to include (excluding all others)
+void saveResultsToBinary(ComponentSystem *pRootSystem, const string &rFileName, const std::vector<string>& includeFilter)
+{
+    if(!pRootSystem) {
+        return;
+    }
+    ResultFileWriter writer;
+    // Variables are added before the time vector of their system, so remember them until the time vector is known
+    std::map<const ComponentSystem*, std::vector<size_t> > variablesWaitingForTime;
+
+    auto addTimeVariable = [&writer, &variablesWaitingForTime](ComponentSystem* pSystem) {
+        const vector<double> *pLogTimeVector = pSystem->getLogTimeVector();
+        const size_t numLoggedSamples = pSystem->getNumActuallyLoggedSamples();
+        if (numLoggedSamples > 0) {
+            const HString timeName = generateFullSubSystemHierarchyName(pSystem,"$")+"Time";
+            const size_t timeIdx = writer.addVariable(timeName, "", "s", "Time", numLoggedSamples, [pLogTimeVector](double *pColumn, size_t numSamples) {
+                std::copy(pLogTimeVector->begin(), pLogTimeVector->begin()+numSamples, pColumn);
+            });
+            for (size_t varIdx : variablesWaitingForTime[pSystem]) {
+                writer.setTimeVariableIndex(varIdx, int(timeIdx));
+            }
+        }
+        variablesWaitingForTime.erase(pSystem);
+    };
+
+    auto addVariable = [&writer, &variablesWaitingForTime](const ComponentSystem* pSystem, const Component* pComponent, const Port* pPort, size_t variableIndex) {
+        const vector< vector<double> > *pLogData = pPort->getLogDataVectorPtr();
+        const size_t numLoggedSamples = pSystem->getNumActuallyLoggedSamples();
+        if( (pLogData != nullptr) && !pLogData->empty() && (numLoggedSamples > 0)) {
+            const NodeDataDescription& variable = *pPort->getNodeDataDescription(variableIndex);
+            const HString fullVarName = generateFullSubSystemHierarchyName(pSystem,"$") + pComponent->getName() + "#" + pPort->getName() + "#" + variable.name;
+            const size_t varIdx = writer.addVariable(fullVarName, pPort->getVariableAlias(variableIndex), variable.unit, variable.quantity, numLoggedSamples,
+                                                     [pLogData, variableIndex](double *pColumn, size_t numSamples) {
+                for (size_t t=0; t<numSamples; ++t) {
+                    pColumn[t] = (*pLogData)[t][variableIndex];
+                }
+            });
+            variablesWaitingForTime[pSystem].push_back(varIdx);
+        }
+    };
+
+    saveResultsTo(pRootSystem, includeFilter, addTimeVariable, addVariable);
+
+    if (!writer.writeToFile(rFileName.c_str())) {
+        printErrorMessage(writer.getErrorString().c_str());
+    }
+}
+
 //! @brief Save results to HDF5 format
 //! @param [in] pRootSystem Pointer to component system
 //! @param [in] rFileName File name for output file
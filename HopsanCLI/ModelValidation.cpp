@@ -529,10 +529,8 @@ bool performModelTest(const std::string hvcFilePath)
                             }
 
 
-                            for(size_t i=0; i<vTime.size(); ++i)
-                            {
-                                vRef.push_back(refDataTable.interpolate(vTime[i]));
-                            }
+                            vRef.resize(vTime.size());
+                            refDataTable.interpolateMany(vTime.data(), vRef.data(), vTime.size());
 
                             //std::cout.rdbuf(cout_sbuf); // restore the original stream buffer
 
@@ -709,11 +707,8 @@ bool performModelTest(const std::string hvcFilePath)
 
                         // Build the reference vector for each variable, by interpolating from reference data file
                         // Interpolation prevents failure if nLogSamples would change (provided sample frequency is not decreased to much)
-                        vReferenceData.reserve(vTime.size());
-                        for(size_t i=0; i<vTime.size(); ++i)
-                        {
-                            vReferenceData.push_back(refDataTable.interpolate(vTime[i]));
-                        }
+                        vReferenceData.resize(vTime.size());
+                        refDataTable.interpolateMany(vTime.data(), vReferenceData.data(), vTime.size());
 
                         for (size_t c=0; c<vvvSimulationData1.size(); ++c)
                         {
@@ -31,6 +31,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <limits>
 
 #include <tclap/CmdLine.h>
 
@@ -40,6 +41,10 @@
 #include "TicToc.hpp"
 #include "version_cli.h"
 #include "CoreUtilities/SaveRestoreSimulationPoint.h"
+#include "CoreUtilities/SimulationCheckpoint.h"
+#include "CoreUtilities/SimulationProfiler.h"
+#include "CoreUtilities/SimulationTracer.h"
+#include "CoreUtilities/SimulationProgress.h"
 
 #include "CliUtilities.h"
 #include "ModelValidation.h"
@@ -140,6 +145,7 @@ public:
     //void evaluateAllPoints();
     void evaluateCandidate(size_t idx)
     {
+        const double setupStart = Ops::EvaluationStatistics::now();
         for(size_t i=0; i<mpWorker->getNumberOfParameters(); ++i)
         {
             double par = mpWorker->getCandidateParameter(idx, i);
@@ -149,9 +155,11 @@ public:
             }
         }
 
+        const double simulationStart = Ops::EvaluationStatistics::now();
         mRootSystemPtrs.at(0)->initialize(mStartTime,mStopTime);
         mRootSystemPtrs.at(0)->simulate(mStopTime);
 
+        const double objectiveStart = Ops::EvaluationStatistics::now();
         double obj = 0.0;
         for(size_t i=0; i<mObjComps.size(); ++i)
         {
@@ -162,14 +170,18 @@ public:
             obj += mObjWeights[i]*data;
         }
         mpWorker->setCandidateObjectiveValue(idx, obj);
+        mStatistics.addCandidate(idx, simulationStart-setupStart, objectiveStart-simulationStart, Ops::EvaluationStatistics::now()-objectiveStart);
 
         ++mEvaulationCounter;
     }
 
     void evaluateAllCandidates()
     {
+        mStatistics.beginGeneration();
+        vector<double> setupTimes(mpWorker->getNumberOfCandidates(), 0.0);
         for(size_t c=0; c<mpWorker->getNumberOfCandidates(); ++c)
         {
+            const double setupStart = Ops::EvaluationStatistics::now();
             for(size_t i=0; i<mpWorker->getNumberOfParameters(); ++i)
             {
                 double par = mpWorker->getCandidateParameter(c, i);
@@ -178,6 +190,7 @@ public:
                     cout << "Error: Parameter " << mParNames[i] << " not found in model." << endl;
                 }
             }
+            setupTimes[c] = Ops::EvaluationStatistics::now()-setupStart;
         }
 
         int  threads = mpWorker->getNumberOfCandidates();
@@ -186,11 +199,14 @@ public:
             threads = -1;
         }
 
+        const double simulationStart = Ops::EvaluationStatistics::now();
         gHopsanCore.getSimulationHandler()->initializeSystem(mStartTime,mStopTime,mRootSystemPtrs);
         gHopsanCore.getSimulationHandler()->simulateSystem(mStartTime,mStopTime,threads,mRootSystemPtrs);
+        mStatistics.setGenerationSimulationTime(Ops::EvaluationStatistics::now()-simulationStart);
 
         for(size_t c=0; c<mpWorker->getNumberOfCandidates(); ++c)
         {
+            const double objectiveStart = Ops::EvaluationStatistics::now();
             double obj = 0.0;
             for(size_t i=0; i<mObjComps.size(); ++i)
             {
@@ -201,8 +217,12 @@ public:
                 obj += mObjWeights[i]*data;
             }
             mpWorker->setCandidateObjectiveValue(c, obj);
+            // Candidates are simulated in parallel, so the simulation time of each one is taken from its own system
+            mStatistics.addCandidate(c, setupTimes[c], mRootSystemPtrs.at(c)->getSimulationProgress()->getSimulationWallTime(),
+                                     Ops::EvaluationStatistics::now()-objectiveStart);
             ++mEvaulationCounter;
         }
+        mStatistics.endGeneration();
     }
 
     size_t getNumberOfEvaluations() { return mEvaulationCounter; }
@@ -243,21 +263,40 @@ int main(int argc, char *argv[])
         TCLAP::ValueArg<std::string> saveSimulationStateOption("", "saveSimState", "Export the simulation state to this file", false, "Path to file", "string", cmd);
         TCLAP::ValueArg<std::string> loadSimulationStateOption("", "loadSimState", "Load the simulation state (with time offset) from this file", false, "Path to file", "string", cmd);
         TCLAP::ValueArg<std::string> loadSimulationSVOption("", "loadSimStartValues", "Load the start values (simulation state without time offset) from this file", false, "Path to file", "string", cmd);
+        TCLAP::ValueArg<std::string> checkpointOption("", "checkpoint", "Periodically write a binary checkpoint of the complete simulation state to this file (see --checkpointInterval)", false, "", "Path to file", cmd);
+        TCLAP::ValueArg<std::string> checkpointIntervalOption("", "checkpointInterval", "Checkpoint interval in simulation steps, or in wall-clock seconds if suffixed with s, e.g. 100000 or 600s", false, "100000", "string", cmd);
+        TCLAP::ValueArg<std::string> restoreCheckpointOption("", "restoreCheckpoint", "Continue the simulation from a checkpoint written with --checkpoint (same model and simulation settings)", false, "", "Path to file", cmd);
+        TCLAP::SwitchArg profileOption("", "profile", "Profile the simulation and print the time spent in each component, in logging and waiting at thread barriers", cmd);
+        TCLAP::ValueArg<std::string> profileOutputOption("", "profileOutput", "Write the simulation profile to this file, as JSON if it ends with .json otherwise as CSV (implies --profile)", false, "", "Path to file", cmd);
+        TCLAP::SwitchArg profileCountersOption("", "profileCounters", "Also measure hardware performance counters (cycles, instructions, cache and branch misses) per component when profiling, Linux only (implies --profile)", cmd);
+        TCLAP::ValueArg<std::string> profileSampleIntervalOption("", "profileSampleInterval", "Measure component times every N:th simulation step when profiling (default: 16)", false, "16", "integer", cmd);
+        TCLAP::ValueArg<std::string> traceOption("", "trace", "Write a timeline of each simulation thread in the Chrome trace format (.json) to this file, requires --parallel", false, "", "Path to file", cmd);
+        TCLAP::ValueArg<std::string> traceStepsOption("", "traceSteps", "The range of simulation steps to trace as: first,last (default: 0,1000)", false, "0,1000", "Comma separated string", cmd);
+        TCLAP::SwitchArg schedulingReportOption("", "schedulingReport", "Print the busy and barrier wait time of each thread and the parallel efficiency after a parallel simulation, requires --parallel", cmd);
+        TCLAP::SwitchArg traceComponentsOption("", "traceComponents", "Include each component call in the trace, not only simulation phases and barrier waits", cmd);
+        TCLAP::SwitchArg memoryReportOption("", "memoryReport", "Print the estimated memory usage (node data, logging, component buffers and lookup data) before initialize and the allocated memory usage after", cmd);
+        TCLAP::ValueArg<std::string> memoryBudgetOption("", "memoryBudget", "Do not simulate if the estimated memory usage exceeds this number of MiB (see --memoryBudgetAction)", false, "", "double", cmd);
+        TCLAP::SwitchArg progressOption("", "progress", "Print the simulation progress, phase, steps per second, simulated time per wall time and ETA as one JSON object per line on stderr", cmd);
+        TCLAP::ValueArg<std::string> progressIntervalOption("", "progressInterval", "Seconds between progress lines (default: 1)", false, "1", "double", cmd);
+        TCLAP::ValueArg<std::string> memoryBudgetActionOption("", "memoryBudgetAction", "What to do if the memory budget is exceeded: [refuse, reduce] (reduce lowers the number of log samples)", false, "refuse", "string", cmd);
         TCLAP::ValueArg<std::string> resultsCSVSortOption("", "resultsCSVSort", "Export results in columns or in rows: [rows, cols]", false, "rows", "string", cmd);
         TCLAP::ValueArg<std::string> resultsFinalCSVOption("", "resultsFinalCSV", "Export the results (only final values)", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> resultsFullCSVOption("", "resultsFullCSV", "Export the results (all logged data) to CSV", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> resultsFinalHDF5Option("", "resultsFinalHDF5", "Exeport the results (only final values) to HDF5", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> resultsFullHDF5Option("", "resultsFullHDF5", "Exeport the results (all logged data) to HDF5", false, "", "Path to file", cmd);
+        TCLAP::ValueArg<std::string> resultsFullBinaryOption("", "resultsFullBinary", "Export the results (all logged data) to a Hopsan binary result file (.hrb)", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> parameterExportOption("", "parameterExport", "CSV file with exported parameter values", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> parameterImportOption("", "parameterImport", "CSV file with parameter values to import", false, "", "Path to file", cmd);
         TCLAP::ValueArg<std::string> hvcTestOption("t","validate","Perform model validation based on HopsanValidationConfiguration",false,"","Path to .hvc file", cmd);
         TCLAP::ValueArg<std::string> nLogSamplesOption("l","numLogSamples","Set the number of log samples to store for the top-level system, (default: Use number in .hmf)",false,"","integer", cmd);
         TCLAP::ValueArg<std::string> logonlyOption("","logonly","If specified, log only given ports or variables. Can be a file (one full port/variable name per line) or coma separated list.",false,"","string", cmd);
         TCLAP::ValueArg<std::string> simulateOption("s","simulate","Specify simulation time as: [hmf] or [start,ts,stop] or [ts,stop] or [stop]",false,"","Comma separated string", cmd);
+        TCLAP::ValueArg<std::string> randomSeedOption("","randomSeed","Seed for the random number streams of the components, (default: Use value in .hmf or 0)",false,"","integer", cmd);
         TCLAP::ValueArg<std::string> parallelOption("p","parallel","Enable parallel simulation with specified number of threads. 0 threads  means auto-detect number of procssors.",false,"0","integer", cmd);
         TCLAP::ValueArg<std::string> extLibsFileOption("","externalLibsFile","A text file containing the external libs to load",false,"","Path to file", cmd);
         TCLAP::MultiArg<std::string> extLibPathsOption("e","externalLib","Path to a .dll/.so/.dylib externalComponentLib. Can be given multiple times",false,"Path to file", cmd);
         TCLAP::MultiArg<std::string> optimizationOption("o","optScript","Optimization scripts",false,"Path to files", cmd);
+        TCLAP::ValueArg<std::string> optimizationStatisticsOption("","optStatistics","Write the setup, simulation and objective time of each optimization evaluation to this CSV file",false,"","Path to file", cmd);
         TCLAP::MultiArg<std::string> optimizationSettings("","optSettings","Optimization settings",false,"Settings", cmd);
         TCLAP::ValueArg<std::string> hmfPathOption("m","hmf","The Hopsan model file to load",false,"","Path to file", cmd);
 
@@ -769,6 +808,20 @@ int main(int argc, char *argv[])
                     pBaseWorker->initialize();
                     pBaseWorker->run();
 
+                    //Print evaluation timing
+                    if(!silentOption.getValue())
+                    {
+                        cout << pEvaluator->getStatistics().toTable();
+                    }
+                    if(optimizationStatisticsOption.isSet())
+                    {
+                        cout << "Saving optimization evaluation statistics to file: " << optimizationStatisticsOption.getValue() << endl;
+                        if(!pEvaluator->getStatistics().writeCSV(optimizationStatisticsOption.getValue()))
+                        {
+                            printErrorMessage("Could not write optimization evaluation statistics to file: "+optimizationStatisticsOption.getValue(), silentOption.getValue());
+                        }
+                    }
+
                     //Print results
                     if(printDebugFile)
                     {
@@ -887,6 +940,18 @@ int main(int argc, char *argv[])
                         pRootSystem->setNumLogSamples(nSamp);
                     }
 
+                    if (randomSeedOption.isSet())
+                    {
+                        size_t seed = 0;
+                        if (!parseUnsignedInteger(randomSeedOption.getValue(), seed) || (seed > size_t(std::numeric_limits<int>::max())))
+                        {
+                            printErrorMessage("Invalid random seed: "+randomSeedOption.getValue()+", expected a non-negative integer");
+                            return -1;
+                        }
+                        cout << "Setting random seed to: " << seed << endl;
+                        pRootSystem->setRandomSeed(int(seed));
+                    }
+
                     if (logonlyOption.isSet())
                     {
                         auto file_or_list = logonlyOption.getValue();
@@ -942,6 +1007,105 @@ int main(int argc, char *argv[])
                         pRootSystem->setKeepValuesAsStartValues(true);
                     }
 
+                    const bool doProfile = profileOption.getValue() || profileOutputOption.isSet() || profileCountersOption.getValue();
+                    if (doProfile)
+                    {
+                        const int sampleInterval = atoi(profileSampleIntervalOption.getValue().c_str());
+                        if (sampleInterval < 1)
+                        {
+                            printErrorMessage("Profile sample interval must be at least 1.");
+                            return -1;
+                        }
+                        pRootSystem->setProfilingEnabled(true, size_t(sampleInterval), profileCountersOption.getValue());
+                    }
+
+                    if (traceOption.isSet())
+                    {
+                        std::vector<std::string> traceSteps;
+                        splitStringOnDelimiter(traceStepsOption.getValue(), ',', traceSteps);
+                        size_t firstTraceStep = 0, lastTraceStep = 0;
+                        if (traceSteps.size() != 2 || !parseUnsignedInteger(traceSteps[0], firstTraceStep) ||
+                            !parseUnsignedInteger(traceSteps[1], lastTraceStep) || (lastTraceStep < firstTraceStep))
+                        {
+                            printErrorMessage("Invalid trace steps: "+traceStepsOption.getValue()+", expected first,last with 0 <= first <= last");
+                            return -1;
+                        }
+                        if (!parallelOption.isSet())
+                        {
+                            printWarningMessage("Tracing is only done in multi-threaded simulation (--parallel)", silentOption.getValue());
+                        }
+                        pRootSystem->setTracingEnabled(firstTraceStep, lastTraceStep, traceComponentsOption.getValue());
+                    }
+
+                    if (memoryReportOption.getValue() || memoryBudgetOption.isSet())
+                    {
+                        MemoryReport memoryEstimate = pRootSystem->estimateMemoryUsage(startTime, stopTime);
+                        if (memoryReportOption.getValue() && !silentOption.getValue())
+                        {
+                            cout << memoryEstimate.toTable().c_str();
+                        }
+
+                        if (memoryBudgetOption.isSet())
+                        {
+                            const double budgetMiB = atof(memoryBudgetOption.getValue().c_str());
+                            const std::string action = memoryBudgetActionOption.getValue();
+                            if (budgetMiB <= 0 || (action != "refuse" && action != "reduce"))
+                            {
+                                printErrorMessage("Memory budget must be a positive number of MiB and the action one of: refuse, reduce");
+                                return -1;
+                            }
+                            const size_t budget = size_t(budgetMiB*1024.0*1024.0);
+
+                            if (memoryEstimate.getTotalBytes() > budget && action == "reduce")
+                            {
+                                // Log storage grows linearly with the number of log samples, scale it down until everything fits
+                                const size_t nRequestedSamples = pRootSystem->getNumLogSamples();
+                                size_t nSamples = std::min(nRequestedSamples, size_t((stopTime-startTime)/stepTime+1));
+                                while (memoryEstimate.getTotalBytes() > budget && nSamples > 0)
+                                {
+                                    const MemoryUsageEntry totals = memoryEstimate.getTotals();
+                                    const size_t otherBytes = totals.getTotalBytes()-totals.mLogDataBytes;
+                                    if (otherBytes >= budget || totals.mLogDataBytes == 0)
+                                    {
+                                        break;
+                                    }
+                                    const double scale = double(budget-otherBytes)/double(totals.mLogDataBytes);
+                                    nSamples = std::min(nSamples-1, size_t(double(nSamples)*scale));
+                                    pRootSystem->setNumLogSamples(nSamples);
+                                    memoryEstimate = pRootSystem->estimateMemoryUsage(startTime, stopTime);
+                                }
+                                if (memoryEstimate.getTotalBytes() <= budget)
+                                {
+                                    printWarningMessage("Reduced the number of log samples from "+to_string(nRequestedSamples)+" to "+to_string(nSamples)+
+                                                        " to fit the memory budget", silentOption.getValue());
+                                }
+                            }
+
+                            if (memoryEstimate.getTotalBytes() > budget)
+                            {
+                                printErrorMessage("The estimated memory usage "+std::string(formatByteSize(memoryEstimate.getTotalBytes()).c_str())+
+                                                  " exceeds the memory budget "+std::string(formatByteSize(budget).c_str())+", Simulation aborted!");
+                                doSimulate = false;
+                            }
+                        }
+                    }
+
+                    if (progressOption.getValue())
+                    {
+                        double progressInterval = 0;
+                        if (!parseDouble(progressIntervalOption.getValue(), progressInterval) || !(progressInterval > 0))
+                        {
+                            printErrorMessage("Invalid progress interval: "+progressIntervalOption.getValue()+", expected a positive number of seconds");
+                            return -1;
+                        }
+                        if (!pRootSystem->getSimulationProgress()->startMonitor([](const SimulationProgressMetrics &rMetrics)
+                                                                                { cerr << rMetrics.toJSON().c_str() << endl; },
+                                                                                progressInterval))
+                        {
+                            printWarningMessage("Progress reporting requires multi-threading support, no progress will be printed", silentOption.getValue());
+                        }
+                    }
+
                     //! @todo maybe use simulation handler object instead
                     TicToc isoktimer("IsOkTime");
                     doSimulate = doSimulate && pRootSystem->checkModelBeforeSimulation();
@@ -958,6 +1122,50 @@ int main(int argc, char *argv[])
                         printErrorMessage("Initialize failed, Simulation aborted!", silentOption.getValue());
                     }
 
+                    if (doSimulate && memoryReportOption.getValue() && !silentOption.getValue())
+                    {
+                        cout << pRootSystem->getMemoryUsage().toTable().c_str();
+                    }
+
+                    if (doSimulate && restoreCheckpointOption.isSet())
+                    {
+                        doSimulate = restoreCheckpoint(restoreCheckpointOption.getValue().c_str(), pRootSystem);
+                        if (doSimulate)
+                        {
+                            cout << "Restored checkpoint at time: " << pRootSystem->getTime() << endl;
+                            startTime = pRootSystem->getTime();
+                        }
+                        else
+                        {
+                            printWaitingMessages(printDebugOption.getValue(), silentOption.getValue());
+                            printErrorMessage("Could not restore checkpoint, Simulation aborted!", silentOption.getValue());
+                        }
+                    }
+
+                    if (doSimulate && checkpointOption.isSet())
+                    {
+                        std::string interval = checkpointIntervalOption.getValue();
+                        const bool isWallTime = !interval.empty() && (interval.back() == 's');
+                        if (isWallTime)
+                        {
+                            interval.pop_back();
+                        }
+                        double wallTimeInterval = 0;
+                        size_t stepInterval = 0;
+                        const bool isValid = isWallTime ? (parseDouble(interval, wallTimeInterval) && (wallTimeInterval > 0)) :
+                                                          (parseUnsignedInteger(interval, stepInterval) && (stepInterval > 0));
+                        if (!isValid)
+                        {
+                            printErrorMessage("Invalid checkpoint interval: "+checkpointIntervalOption.getValue()+", expected a positive number of steps or seconds, e.g. 100000 or 600s");
+                            return -1;
+                        }
+                        pRootSystem->enableCheckpoints((destinationPath+checkpointOption.getValue()).c_str(), stepInterval, wallTimeInterval);
+                        if (parallelOption.isSet())
+                        {
+                            printWarningMessage("Checkpoints are only written in single-threaded simulation", silentOption.getValue());
+                        }
+                    }
+
                     if (doSimulate)
                     {
                         cout << "Simulating: " << startTime << " to " << stopTime << " with Ts: " << stepTime << "     Please Wait!" << endl;
@@ -968,6 +1176,10 @@ int main(int argc, char *argv[])
                                 printErrorMessage("Number of threads cannot be negative.");
                                 return -1;
                             }
+                            if (schedulingReportOption.getValue())
+                            {
+                                pRootSystem->setSchedulingSampleInterval(16);
+                            }
                             pRootSystem->simulateMultiThreaded(startTime, stopTime, nThreads);
                         }
                         else {
@@ -975,6 +1187,47 @@ int main(int argc, char *argv[])
                         }
 
                         simuTimer.TocPrint();
+
+                        if (doProfile)
+                        {
+                            SimulationProfile profile;
+                            profile.collect(pRootSystem);
+                            if (!silentOption.getValue())
+                            {
+                                cout << profile.toTable(30).c_str();
+                            }
+                            if (profileOutputOption.isSet())
+                            {
+                                const std::string profilePath = destinationPath+profileOutputOption.getValue();
+                                cout << "Saving simulation profile to file: " << profilePath << endl;
+                                if (!profile.writeToFile(profilePath.c_str()))
+                                {
+                                    printWarningMessage("Could not write simulation profile to file: "+profilePath, silentOption.getValue());
+                                }
+                            }
+                        }
+
+                        if (schedulingReportOption.getValue())
+                        {
+                            if (!parallelOption.isSet())
+                            {
+                                printWarningMessage("The scheduling report is only available for multi-threaded simulation (--parallel)", silentOption.getValue());
+                            }
+                            else if (!silentOption.getValue() && !pRootSystem->getSchedulingReport().isEmpty())
+                            {
+                                cout << pRootSystem->getSchedulingReport().toTable().c_str();
+                            }
+                        }
+
+                        if (pRootSystem->getSimulationTracer() && parallelOption.isSet())
+                        {
+                            const std::string tracePath = destinationPath+traceOption.getValue();
+                            cout << "Saving simulation trace to file: " << tracePath << endl;
+                            if (!pRootSystem->getSimulationTracer()->writeChromeTrace(tracePath.c_str()))
+                            {
+                                printWarningMessage("Could not write simulation trace to file: "+tracePath, silentOption.getValue());
+                            }
+                        }
                     }
                     if (pRootSystem->wasSimulationAborted())
                     {
@@ -986,6 +1239,7 @@ int main(int argc, char *argv[])
                     }
 
                     pRootSystem->finalize();
+                    pRootSystem->getSimulationProgress()->stopMonitor();
                 }
 
                 printWaitingMessages(printDebugOption.getValue(), silentOption.getValue());
@@ -1044,6 +1298,11 @@ int main(int argc, char *argv[])
                     saveResultsToHDF5(pRootSystem, destinationPath+resultsFinalHDF5Option.getValue(), logOnlyPortsOrVariables, Final);
                 }
 
+                if(resultsFullBinaryOption.isSet()) {
+                    cout << "Saving full results to file: " << destinationPath+resultsFullBinaryOption.getValue() << endl;
+                    saveResultsToBinary(pRootSystem, destinationPath+resultsFullBinaryOption.getValue(), logOnlyPortsOrVariables);
+                }
+
                 // Save simulation state
                 if (saveSimulationStateOption.isSet())
                 {
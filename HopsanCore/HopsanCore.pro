@@ -66,6 +66,7 @@ SOURCES += $${PWD}/dependencies/sundials/src/kinsol/kinsol_spils.c \
            $${PWD}/dependencies/sundials/src/sundials/sundials_matrix.c \
            $${PWD}/dependencies/sundials/src/sundials/sundials_math.c \
            $${PWD}/dependencies/sundials/src/sunmatrix/band/sunmatrix_band.c \
+           $${PWD}/dependencies/sundials/src/sunmatrix/sparse/sunmatrix_sparse.c \
            $${PWD}/dependencies/sundials/src/sunlinsol/band/sunlinsol_band.c \
            $${PWD}/dependencies/sundials/src/sunlinsol/dense/sunlinsol_dense.c \
 #-------------------------------------------------
@@ -151,11 +152,14 @@ SOURCES += \
     src/CoreUtilities/HopsanCoreMessageHandler.cpp \
     src/CoreUtilities/HmfLoader.cpp \
     src/ComponentUtilities/WhiteGaussianNoise.cpp \
+    src/ComponentUtilities/RandomStream.cpp \
+    src/ComponentUtilities/SparseLU.cpp \
     src/ComponentUtilities/SecondOrderTransferFunction.cpp \
     src/ComponentUtilities/matrix.cpp \
     src/ComponentUtilities/ludcmp.cpp \
     src/ComponentUtilities/IntegratorLimited.cpp \
     src/ComponentUtilities/FirstOrderTransferFunction.cpp \
+    src/ComponentUtilities/FilterBank.cpp \
     src/ComponentUtilities/CSVParser.cpp \
     src/Parameters.cpp \
     src/ComponentUtilities/AuxiliarySimulationFunctions.cpp \
@@ -165,6 +169,7 @@ SOURCES += \
     src/HString.cpp \
     src/ComponentUtilities/HopsanPowerUser.cpp \
     src/ComponentUtilities/LookupTable.cpp \
+    src/ComponentUtilities/LookupTableCache.cpp \
     src/ComponentUtilities/PLOParser.cpp \
     src/ComponentUtilities/TempDirectoryHandle.cpp \
     $${PWD}/dependencies/indexingcsvparser/src/indexingcsvparser.cpp \
@@ -175,7 +180,15 @@ SOURCES += \
     src/CoreUtilities/SimulationHandler.cpp \
     src/CoreUtilities/MultiThreadingUtilities.cpp \
     src/CoreUtilities/StringUtilities.cpp \
-    src/CoreUtilities/SaveRestoreSimulationPoint.cpp
+    src/CoreUtilities/SaveRestoreSimulationPoint.cpp \
+    src/CoreUtilities/ResultFile.cpp \
+    src/CoreUtilities/SimulationCheckpoint.cpp \
+    src/CoreUtilities/SimulationProfiler.cpp \
+    src/CoreUtilities/SimulationTracer.cpp \
+    src/CoreUtilities/PerformanceCounters.cpp \
+    src/CoreUtilities/MemoryReport.cpp \
+    src/CoreUtilities/SimulationProgress.cpp \
+    src/CoreUtilities/SchedulingReport.cpp
 HEADERS += \
     include/win32dll.h \
     include/Port.h \
@@ -195,6 +208,8 @@ HEADERS += \
     include/CoreUtilities/ClassFactoryStatusCheck.hpp \
     include/CoreUtilities/ClassFactory.hpp \
     include/ComponentUtilities/WhiteGaussianNoise.h \
+    include/ComponentUtilities/RandomStream.h \
+    include/ComponentUtilities/SparseLU.h \
     include/ComponentUtilities/ValveHysteresis.h \
     include/ComponentUtilities/TurbulentFlowFunction.h \
     include/ComponentUtilities/SecondOrderTransferFunction.h \
@@ -204,6 +219,7 @@ HEADERS += \
     include/ComponentUtilities/IntegratorLimited.h \
     include/ComponentUtilities/Integrator.h \
     include/ComponentUtilities/FirstOrderTransferFunction.h \
+    include/ComponentUtilities/FilterBank.h \
     include/ComponentUtilities/DoubleIntegratorWithDampingAndCoulumbFriction.h \
     include/ComponentUtilities/DoubleIntegratorWithDamping.h \
     include/ComponentUtilities/Delay.hpp \
@@ -223,6 +239,8 @@ HEADERS += \
     include/HopsanCoreMacros.h \
     include/compiler_info.h \
     include/ComponentUtilities/LookupTable.h \
+    include/ComponentUtilities/LookupTableCache.h \
+    include/ComponentUtilities/StateSerialization.h \
     include/ComponentUtilities/PLOParser.h \
     $${PWD}/dependencies/indexingcsvparser/include/indexingcsvparser/indexingcsvparser.h \
     include/Quantities.h \
@@ -233,7 +251,15 @@ HEADERS += \
     include/CoreUtilities/ConnectionAssistant.h \
     include/CoreUtilities/AliasHandler.h \
     include/CoreUtilities/SimulationHandler.h \
-    include/CoreUtilities/SaveRestoreSimulationPoint.h
+    include/CoreUtilities/SaveRestoreSimulationPoint.h \
+    include/CoreUtilities/ResultFile.h \
+    include/CoreUtilities/SimulationCheckpoint.h \
+    include/CoreUtilities/SimulationProfiler.h \
+    include/CoreUtilities/SimulationTracer.h \
+    include/CoreUtilities/PerformanceCounters.h \
+    include/CoreUtilities/MemoryReport.h \
+    include/CoreUtilities/SimulationProgress.h \
+    include/CoreUtilities/SchedulingReport.h
 
 #DO NOT remove the commented line below, it will be autoreplaced by script
 #INTERNALCOMPLIB_FMI4C_DEPENDENCY#
@@ -25,6 +25,7 @@ set(sundials_c
     ${sundials_dir}/src/sundials/sundials_matrix.c
     ${sundials_dir}/src/sundials/sundials_math.c
     ${sundials_dir}/src/sunmatrix/band/sunmatrix_band.c
+    ${sundials_dir}/src/sunmatrix/sparse/sunmatrix_sparse.c
     ${sundials_dir}/src/sunlinsol/band/sunlinsol_band.c
     ${sundials_dir}/src/sunlinsol/dense/sunlinsol_dense.c
 )
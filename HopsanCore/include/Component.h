@@ -37,6 +37,7 @@
 #include "Node.h"
 #include "Port.h"
 #include "Parameters.h"
+#include "CoreUtilities/PerformanceCounters.h"
 #include "win32dll.h"
 #include <map>
 #include <list>
@@ -58,6 +59,11 @@ class ComponentSystem;
 class HopsanEssentials;
 class HopsanCoreMessageHandler;
 class NumericalIntegrationSolver;
+class StateWriter;
+class MemoryReport;
+class StateReader;
+class RandomStream;
+class FilterBank;
 
 enum VariameterTypeEnumT {InputVariable, OutputVariable, OtherVariable};
 
@@ -89,6 +95,10 @@ class HOPSANCORE_DLLAPI Component
 public:
     //! @brief Enum type for all CQS types
     enum CQSEnumT {CType, QType, SType, UndefinedCQSType};
+    //! @brief How component internal state is handled by simulation checkpoints
+    enum StateSupportEnumT {NoInternalState,        //!< All state between time steps is kept in nodes (default)
+                            SupportsInternalState,  //!< Internal state is saved and restored by saveState() and restoreState()
+                            LacksInternalState};    //!< Internal state exists but is not part of checkpoints
 
     //==========Public functions==========
     // Configuration and simulation functions
@@ -211,6 +221,24 @@ public:
     void setMeasuredTime(const double time);
     double getMeasuredTime() const;
 
+    //! @brief Adds the wall time of one sampled call to simulate(), used by the simulation profiler
+    inline void addProfiledTime(const double time) {mProfiledTime += time; ++mNumProfiledSamples;}
+    double getProfiledTime() const;
+    size_t getNumProfiledSamples() const;
+    void resetProfiledTime();
+
+    //! @brief Adds the hardware counter increase during one sampled call to simulate(), used by the simulation profiler
+    inline void addProfiledCounters(const PerformanceCounters::CounterValuesT &rBefore, const PerformanceCounters::CounterValuesT &rAfter)
+    {
+        for (int i=0; i<PerformanceCounters::NumCounters; ++i)
+        {
+            mProfiledCounters[i] += rAfter[i]-rBefore[i];
+        }
+        ++mNumCountedSamples;
+    }
+    unsigned long long getProfiledCounter(const PerformanceCounters::CounterEnumT counter) const;
+    size_t getNumCountedSamples() const;
+
     void addDebugMessage(const HString &rMessage, const HString &rTag="") const;
     void addWarningMessage(const HString &rMessage, const HString &rTag="") const;
     void addErrorMessage(const HString &rMessage, const HString &rTag="") const;
@@ -223,6 +251,9 @@ public:
     // HopsanEssentials
     HopsanEssentials *getHopsanEssentials();
 
+    // Message handler
+    virtual void setMessageHandler(HopsanCoreMessageHandler *pMessageHandler);
+
     // Search path
     HString findFilePath(const HString &rFileName) const;
     std::vector<HString> getSearchPaths() const;
@@ -232,8 +263,21 @@ public:
     virtual void solveSystem();
     virtual double getStateVariableDerivative(int /*i*/);
     virtual double getStateVariableSecondDerivative(int /*i*/);
+    virtual bool computeDerivatives(const double * /*y*/, double * /*dydt*/);
     virtual void getResiduals(double * /*y*/, double* /*res*/);
     virtual void getJacobian(double * /*y*/, double* /*f*/, double* /*J*/);
+    virtual void getSparseJacobian(double * /*y*/, double* /*f*/, double* /*values*/);
+
+    // Checkpoint state serialization
+    virtual void saveState(StateWriter &rWriter) const;
+    virtual bool restoreState(StateReader &rReader);
+    StateSupportEnumT getStateSupport() const;
+
+    // Memory footprint accounting
+    virtual void reportMemoryUsage(MemoryReport &rReport, const double timestep) const;
+
+    // Batched simulation of filter components
+    virtual bool addToFilterBank(FilterBank &rBank);
 
 protected:
     //==========Protected member functions==========
@@ -255,6 +299,12 @@ protected:
 
     void initializeAutoSignalNodeDataPtrs();
 
+    // Checkpoint state serialization
+    void setStateSupport(const StateSupportEnumT support);
+
+    // Random numbers
+    void seedRandomStream(RandomStream &rStream, const HString &rStreamName="");
+
     // Port functions
     Port* addPort(const HString &rPortName, const PortTypesEnumT portType, const HString &rNodeType, const HString &rDescription, const Port::RequireConnectionEnumT reqConnection);
     Port* addPowerPort(const HString &rPortName, const HString &rNodeType, const HString &rDescription="", const Port::RequireConnectionEnumT reqConnect=Port::Required);
@@ -305,11 +355,16 @@ private:
     PortPtrMapT mPortPtrMap;
     std::vector<Port*> mPortPtrVector;
     double mMeasuredTime;
+    double mProfiledTime;
+    size_t mNumProfiledSamples;
+    PerformanceCounters::CounterValuesT mProfiledCounters;
+    size_t mNumCountedSamples;
     HopsanEssentials *mpHopsanEssentials;
     HopsanCoreMessageHandler *mpMessageHandler;
     std::vector<VariameterDescription> mVariameters;
     std::map<Port*, double**> mAutoSignalNodeDataPtrPorts;
     bool mIsDisabled;
+    StateSupportEnumT mStateSupport;
 };
 
 
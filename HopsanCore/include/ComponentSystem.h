@@ -43,10 +43,16 @@
 #include "Component.h"
 #include "CoreUtilities/SimulationHandler.h"
 #include "CoreUtilities/AliasHandler.h"
+#include "CoreUtilities/MemoryReport.h"
+#include "CoreUtilities/SchedulingReport.h"
 
 namespace hopsan {
     class NumHopHelper;
     class ComponentSystemMultiThreadPrivates;
+    class ComponentSystemFilterBanks;
+    class CheckpointWriter;
+    class SimulationTracer;
+    class SimulationProgress;
 
     class HOPSANCORE_DLLAPI ComponentSystem :public Component
     {
@@ -82,6 +88,9 @@ namespace hopsan {
         HString reserveUniqueName(const HString &rDesiredName, const UniqeNameEnumT type=UniqueReservedNameType);
         void unReserveUniqueName(const HString &rName);
 
+        // Message handler
+        void setMessageHandler(HopsanCoreMessageHandler *pMessageHandler);
+
         // System Parameter functions
         bool renameParameter(const HString &rOldName, const HString &rNewName);
         virtual std::list<HString> getModelAssets() const;
@@ -161,6 +170,44 @@ namespace hopsan {
         size_t getNumLogSamples() const;
         size_t getNumActuallyLoggedSamples() const;
 
+        // Checkpoint and restart
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
+        void enableCheckpoints(const HString &rFilePath, const size_t stepInterval, const double wallTimeInterval=0);
+        void disableCheckpoints();
+
+        // Profiling
+        void setProfilingEnabled(const bool enabled, const size_t sampleInterval=16, const bool hardwareCounters=false);
+        size_t getProfilingSampleInterval() const;
+        bool getProfilingHardwareCounters() const;
+        void resetProfiling();
+        size_t getNumProfiledSteps() const;
+        double getProfiledWallTime() const;
+        double getProfiledLoggingTime() const;
+        double getProfiledBarrierTime() const;
+
+        // Timeline tracing of multi-threaded simulations
+        void setTracingEnabled(const size_t firstStep, const size_t lastStep, const bool traceComponents=false);
+        void disableTracing();
+        SimulationTracer *getSimulationTracer();
+
+        // Load balance of multi-threaded simulations
+        void setSchedulingSampleInterval(const size_t sampleInterval);
+        size_t getSchedulingSampleInterval() const;
+        const SchedulingReport &getSchedulingReport() const;
+
+        // Batched simulation of filter components
+        void setFilterBanksEnabled(const bool enabled);
+        bool getFilterBanksEnabled() const;
+        size_t getNumFilterBankComponents() const;
+
+        // Live progress and throughput
+        SimulationProgress *getSimulationProgress();
+
+        // Memory footprint
+        MemoryReport estimateMemoryUsage(const double startT, const double stopT);
+        MemoryReport getMemoryUsage() const;
+
         // Stop a running initialization or simulation
         void stopSimulation(const HString &rReason);
         void stopSimulation();
@@ -172,6 +219,10 @@ namespace hopsan {
         void unRegisterParameter(const HString &name);
         void addSearchPath(HString searchPath);
 
+        // Random numbers
+        void setRandomSeed(const int seed);
+        int getRandomSeed();
+
         // Add and Remove sub-nodes
         void addSubNode(Node* pNode);
         void removeSubNode(Node* pNode);
@@ -207,6 +258,8 @@ namespace hopsan {
 //        void setLogSettingsSkipFactor(double factor, double start, double stop, double sampletime);
         void setupLogSlotsAndTs(const double simStartT, const double simStopT, const double simTs);
         void preAllocateLogSpace();
+        void addMemoryUsage(MemoryReport &rReport, const HString &rName, const double simStartT, const double simStopT, const double simTs,
+                            const size_t nLogSamples, const double logStartT) const;
 
         // Add and Remove subcomponent ptrs from storage vectors
         void addSubComponentPtrToStorage(Component* pComponent);
@@ -257,6 +310,29 @@ namespace hopsan {
         ComponentSystemMultiThreadPrivates *mpMultiThreadPrivates;
         //------------------------------------------------------------------
 
+        CheckpointWriter *mpCheckpointWriter;
+
+        // Profiling, times are only measured in every mProfilingSampleInterval step (0 = disabled)
+        void simulateProfiled(const size_t numSimulationSteps);
+        size_t mProfilingSampleInterval;
+        bool mProfileHardwareCounters;
+        size_t mNumProfiledSteps, mNumProfiledSampledSteps;
+        double mProfiledWallTime, mProfiledLoggingTime, mProfiledBarrierTime;
+
+        SimulationTracer *mpSimulationTracer;
+        SimulationProgress *mpSimulationProgress;
+
+        // Filter banks, filter components that simulate() updates together instead of one by one
+        void setupFilterBanks();
+        void loadFilterBankStates();
+        void storeFilterBankStates();
+        bool mUseFilterBanks;
+        ComponentSystemFilterBanks *mpFilterBanks;
+
+        // Scheduling statistics, measured in every mSchedulingSampleInterval step of simulateMultiThreaded() (0 = disabled)
+        size_t mSchedulingSampleInterval;
+        SchedulingReport mSchedulingReport;
+
         bool mKeepValuesAsStartValues;
 
         AliasHandler mAliasHandler;
@@ -27,9 +27,12 @@
 #ifndef COMPONENTUTILITIES_H_INCLUDED
 #define COMPONENTUTILITIES_H_INCLUDED
 
+#include "ComponentUtilities/StateSerialization.h"
+#include "CoreUtilities/MemoryReport.h"
 #include "ComponentUtilities/Delay.hpp"
 #include "ComponentUtilities/FirstOrderTransferFunction.h"
 #include "ComponentUtilities/SecondOrderTransferFunction.h"
+#include "ComponentUtilities/FilterBank.h"
 #include "ComponentUtilities/Integrator.h"
 #include "ComponentUtilities/IntegratorLimited.h"
 #include "ComponentUtilities/TurbulentFlowFunction.h"
@@ -44,8 +47,11 @@
 #include "ComponentUtilities/AuxiliarySimulationFunctions.h"
 #include "ComponentUtilities/AuxiliaryMathematicaWrapperFunctions.h"
 #include "ComponentUtilities/WhiteGaussianNoise.h"
+#include "ComponentUtilities/RandomStream.h"
+#include "ComponentUtilities/SparseLU.h"
 #include "ComponentUtilities/num2string.hpp"
 #include "ComponentUtilities/EquationSystemSolver.h"
 #include "ComponentUtilities/LookupTable.h"
+#include "ComponentUtilities/LookupTableCache.h"
 #include "ComponentUtilities/TempDirectoryHandle.h"
 #endif // COMPONENTUTILITIES_H_INCLUDED
@@ -35,19 +35,34 @@
 #define DELAY_HPP_INCLUDED
 
 #include "stddef.h"
+#include "StateSerialization.h"
 
 namespace hopsan {
 
 //! @brief Delay template class, implementing a circular buffer containing values of specified type
 //! @ingroup ComponentUtilityClasses
+//! @details The buffer capacity is rounded up to a power of two, so that positions wrap with a bit mask instead of branches.
+//! With interpolation, delays that are not a multiple of the time step are interpolated between the stored values
+//! instead of being rounded to a whole number of steps.
 template<typename T>
 class DelayTemplate
 {
 public:
+    enum InterpolationEnumT {NoInterpolation, LinearInterpolation, LagrangeInterpolation};
+
     DelayTemplate()
     {
         mpArray = 0;
         mSize = 0;
+        mCapacity = 0;
+        mMask = 0;
+        mNewest = 0;
+        mInterpolation = NoInterpolation;
+        mFirstIdx = 0;
+        for (size_t i=0; i<4; ++i)
+        {
+            mWeights[i] = 0;
+        }
     }
 
     ~DelayTemplate()
@@ -65,66 +80,89 @@ public:
         initialize( int(timeDelay/Ts+0.5), initValue);
     }
 
-    //! @brief Initialize delay size based on known number of delay steps
-    //! @param [in] delaySteps The number of delay steps, must be >= 1
+    //! @brief Initialize delay buffer based on timeDelay and timestep, with interpolation of fractional delays
+    //! @details With NoInterpolation this is the same as initialize(timeDelay, Ts, initValue). Otherwise Td/Ts may be any value >= 0,
+    //! a value of 0 means that update() returns the new value.
+    //! @param [in] timeDelay The total time delay for a value to come out on the other side of the circle buffer
+    //! @param [in] Ts The timestep between each call
     //! @param [in] initValue The initial value of all buffer elements
-    void initialize(const int delaySteps, const T initValue)
+    //! @param [in] interpolation Linear interpolation between the two closest values, or third order Lagrange interpolation between the four closest values
+    void initialize(const double timeDelay, const double Ts, const T initValue, const InterpolationEnumT interpolation)
     {
-        // First clear old data
-        clear();
-
-        // Make sure we will not crash if someone entered < 1 delaysteps
-        if (delaySteps < 1)
+        if (interpolation == NoInterpolation)
         {
-            mSize = 1;
+            initialize(timeDelay, Ts, initValue);
+            return;
         }
-        else
+
+        double steps = (Ts > 0) ? timeDelay/Ts : 0;
+        if (steps < 0)
         {
-            mSize = size_t(delaySteps);
+            steps = 0;
         }
+        allocate(numInterpolationValues(steps, interpolation), initValue);
+        mInterpolation = interpolation;
 
-        mpArray = new T[mSize];
-        for (size_t i=0; i<mSize; ++i)
+        // The weights only depend on the delay, so they are computed once here
+        const size_t wholeSteps = size_t(steps);
+        const double frac = steps-double(wholeSteps);
+        if (interpolation == LinearInterpolation)
         {
-            mpArray[i] = initValue;
+            mFirstIdx = wholeSteps;
+            mWeights[0] = 1.0-frac;
+            mWeights[1] = frac;
+            mWeights[2] = 0;
+            mWeights[3] = 0;
+        }
+        else
+        {
+            // Use the values at (delay-1, delay, delay+1, delay+2) when possible, so that the delay is in the middle interval
+            mFirstIdx = (wholeSteps > 0) ? wholeSteps-1 : 0;
+            const double x = steps-double(mFirstIdx);
+            mWeights[0] = -(x-1.0)*(x-2.0)*(x-3.0)/6.0;
+            mWeights[1] = x*(x-2.0)*(x-3.0)/2.0;
+            mWeights[2] = -x*(x-1.0)*(x-3.0)/2.0;
+            mWeights[3] = x*(x-1.0)*(x-2.0)/6.0;
         }
+    }
 
-        mOldest = 0;
-        mNewest = mSize-1;
+    //! @brief Initialize delay size based on known number of delay steps
+    //! @param [in] delaySteps The number of delay steps, must be >= 1
+    //! @param [in] initValue The initial value of all buffer elements
+    void initialize(const int delaySteps, const T initValue)
+    {
+        // Make sure we will not crash if someone entered < 1 delaysteps
+        allocate((delaySteps < 1) ? 1 : size_t(delaySteps), initValue);
     }
 
     //! @brief Updates delay with a new value, "pop old", "push new". You should likely run this at the end of each time step
     //! @param [in] newValue The new value to insert into delay buffer
-    //! @return The oldest value in the delay buffer (After update, this value has been overwritten in the buffer)
+    //! @return The oldest value in the delay buffer (After update, this value has been overwritten in the buffer), or the interpolated delayed value
     inline T update(const T newValue)
     {
-        // First get the oldest value
-        T oldestValue = mpArray[mOldest];
-
-        // Increment the pointers, newest will after incrementation overwrite previous oldest
-        ++mOldest;
-        ++mNewest;
-
-        if (mOldest >= mSize)
-        {
-            mOldest = 0;
-        }
-        if (mNewest >= mSize)
+        if (mInterpolation == NoInterpolation)
         {
-            mNewest = 0;
+            // The oldest value is read before it can be overwritten, the capacity may equal the size
+            T oldestValue = mpArray[(mNewest+1-mSize) & mMask];
+            mNewest = (mNewest+1) & mMask;
+            mpArray[mNewest] = newValue;
+            return oldestValue;
         }
 
-        // Overwrite previous oldest with the new_value
+        mNewest = (mNewest+1) & mMask;
         mpArray[mNewest] = newValue;
-
-        return oldestValue;
+        return getDelayed();
     }
 
-    //! @brief Get the oldest value in the buffer
+    //! @brief Get the oldest value in the buffer, with interpolation this is the current delayed value
     //! @return The oldest value in the buffer
     inline T getOldest() const
     {
-        return mpArray[mOldest];
+        if (mInterpolation != NoInterpolation)
+        {
+            return getDelayed();
+        }
+        return mpArray[(mNewest+1-mSize) & mMask];
     }
 
     //! @brief Get the newest value in the buffer
@@ -139,15 +177,7 @@ public:
     //! @return Value at specified index
     inline T getIdx(const size_t i) const
     {
-        //if ( (int(mNewest)-int(i)) < 0 )
-        if ( i > mNewest )
-        {
-            return mpArray[mSize+mNewest-i];
-        }
-        else
-        {
-            return mpArray[mNewest-i];
-        }
+        return mpArray[(mNewest-i) & mMask];
     }
 
     //! @brief Returns a specific value, 0=oldest, 1=nextoldest, 2=nextnextoldest and so on, no range check is performed
@@ -155,14 +185,7 @@ public:
     //! @return Value at specified index
     inline T getOldIdx(const size_t i) const
     {
-        if (mOldest+i >= mSize)
-        {
-            return mpArray[mOldest+i-mSize];
-        }
-        else
-        {
-            return mpArray[mOldest+i];
-        }
+        return mpArray[(mNewest+1-mSize+i) & mMask];
     }
 
     //! @brief Get the size of the delay buffer (the number of buffer elements)
@@ -172,6 +195,76 @@ public:
         return mSize;
     }
 
+    //! @brief Get the memory used by the delay buffer
+    //! @return The size of the delay buffer in bytes
+    size_t getMemoryUsage() const
+    {
+        return mCapacity*sizeof(T);
+    }
+
+    //! @brief Estimate the memory a delay buffer will use, without initializing it
+    //! @param [in] timeDelay The total time delay
+    //! @param [in] Ts The timestep between each call
+    //! @param [in] interpolation The interpolation that will be used
+    //! @return The size of the delay buffer in bytes, after initialize(timeDelay, Ts, initValue, interpolation)
+    static size_t estimateMemoryUsage(const double timeDelay, const double Ts, const InterpolationEnumT interpolation=NoInterpolation)
+    {
+        if (interpolation != NoInterpolation)
+        {
+            const double steps = (Ts > 0) ? timeDelay/Ts : 0;
+            return capacityFor(numInterpolationValues((steps < 0) ? 0 : steps, interpolation))*sizeof(T);
+        }
+        const int delaySteps = (Ts > 0) ? int(timeDelay/Ts+0.5) : 1;
+        return capacityFor((delaySteps < 1) ? 1 : size_t(delaySteps))*sizeof(T);
+    }
+
+    //! @brief Write the buffer contents and positions to a checkpoint state
+    //! @details The values are written from oldest to newest, so the state does not depend on the buffer capacity
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeSize(mSize);
+        rWriter.writeSize(0);
+        rWriter.writeSize(mSize > 0 ? mSize-1 : 0);
+        for (size_t i=0; i<mSize; ++i)
+        {
+            const T value = getOldIdx(i);
+            rWriter.writeRaw(&value, sizeof(T));
+        }
+    }
+
+    //! @brief Restore the buffer from a checkpoint state, the buffer must already be initialized with the same size
+    //! @returns False if the stored size does not match
+    bool restoreState(StateReader &rReader)
+    {
+        size_t size, oldest, newest;
+        if (!rReader.readSize(size) || (size != mSize) || !rReader.readSize(oldest) || !rReader.readSize(newest))
+        {
+            return false;
+        }
+        // An uninitialized buffer has nothing more to restore
+        if (mSize == 0)
+        {
+            return true;
+        }
+        if ((oldest >= mSize) || (newest >= mSize))
+        {
+            return false;
+        }
+        // Stored values begin at the stored oldest position and wrap around the stored size
+        T *pStored = new T[mSize];
+        const bool ok = rReader.readRaw(pStored, mSize*sizeof(T));
+        if (ok)
+        {
+            mNewest = mSize-1;
+            for (size_t i=0; i<mSize; ++i)
+            {
+                mpArray[i] = pStored[(oldest+i) % mSize];
+            }
+        }
+        delete[] pStored;
+        return ok;
+    }
+
     //! @brief Clear the delay buffer, deleting all data
     void clear()
     {
@@ -180,13 +273,66 @@ public:
             delete[] mpArray;
             mpArray=0;
             mSize=0;
+            mCapacity=0;
+            mMask=0;
         }
     }
 
 
 private:
-    size_t mSize, mNewest, mOldest;
+    //! @brief Returns the smallest power of two that is >= size
+    static size_t capacityFor(const size_t size)
+    {
+        size_t capacity = 1;
+        while (capacity < size)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    //! @brief Returns the number of values that must be kept to interpolate a delay of steps
+    static size_t numInterpolationValues(const double steps, const InterpolationEnumT interpolation)
+    {
+        const size_t wholeSteps = size_t(steps);
+        return (interpolation == LinearInterpolation) ? wholeSteps+2 : ((wholeSteps > 0) ? wholeSteps+3 : 4);
+    }
+
+    //! @brief Allocates the buffer and sets all values to initValue, without interpolation
+    void allocate(const size_t size, const T initValue)
+    {
+        // First clear old data
+        clear();
+
+        mSize = size;
+        mCapacity = capacityFor(mSize);
+        mMask = mCapacity-1;
+        mpArray = new T[mCapacity];
+        for (size_t i=0; i<mCapacity; ++i)
+        {
+            mpArray[i] = initValue;
+        }
+        mNewest = mSize-1;
+        mInterpolation = NoInterpolation;
+        mFirstIdx = 0;
+    }
+
+    //! @brief Returns the interpolated delayed value
+    inline T getDelayed() const
+    {
+        if (mInterpolation == LinearInterpolation)
+        {
+            return mWeights[0]*getIdx(mFirstIdx) + mWeights[1]*getIdx(mFirstIdx+1);
+        }
+        return mWeights[0]*getIdx(mFirstIdx) + mWeights[1]*getIdx(mFirstIdx+1) +
+               mWeights[2]*getIdx(mFirstIdx+2) + mWeights[3]*getIdx(mFirstIdx+3);
+    }
+
+    size_t mSize, mCapacity, mMask, mNewest;
     T *mpArray;
+    InterpolationEnumT mInterpolation;
+    size_t mFirstIdx;
+    double mWeights[4];
 };
 
 //! @ingroup ComponentUtilityClasses
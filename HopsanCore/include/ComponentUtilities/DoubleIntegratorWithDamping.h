@@ -35,6 +35,7 @@
 #define DOUBLEINTEGRATORWITHDAMPING_H_INCLUDED
 
 #include "win32dll.h"
+#include "StateSerialization.h"
 
 namespace hopsan {
 
@@ -50,6 +51,8 @@ namespace hopsan {
         void redoIntegrate(double u);
         double valueFirst();
         double valueSecond();
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
 
     private:
         double mDelayU, mDelayY, mDelaySY;
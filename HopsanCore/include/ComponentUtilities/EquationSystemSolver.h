@@ -83,18 +83,42 @@ public:
     void solveTrapezoidRule();
     void solveRungeKutta();
     void solveDormandPrince();
+    void solveDormandPrinceAdaptive();
 
     void solvevariableTimeStep();
 
+    void getDenseOutput(const double theta, double *pStateVars) const;
+    size_t getNumSubSteps() const;
+    size_t getNumRejectedSubSteps() const;
+
     double findRoot(int i);
 
 private:
+    enum DerivativeInterfaceEnumT {UnknownInterface, BulkInterface, PerStateInterface};
+
+    void evaluateDerivatives(const double *pStateVars, double *pDerivatives);
+    void evaluateCurrentDerivatives(double *pDerivatives);
+    void setSolution(const double *pStateVars);
+    double *stage(const size_t k);
+
     Component *mpParentComponent;
 
     //Numerical integration members
     double mTimeStep;
     std::vector<double> *mpStateVars;
     int mnStateVars;
+    DerivativeInterfaceEnumT mDerivativeInterface;
+
+    //Preallocated stage storage, 7 derivative stages followed by the original, intermediate and new state variables
+    std::vector<double> mStages;
+
+    //Adaptive sub-stepping members
+    double mSubStepSize;
+    size_t mNumSubSteps;
+    size_t mNumRejectedSubSteps;
+    std::vector<double> mDenseStartTimes;
+    std::vector<double> mDenseStepSizes;
+    std::vector<double> mDenseCoefficients;
 
     //Implicit methods members
     double mTolerance;
@@ -108,6 +132,7 @@ public:
     enum SolverTypeEnum {NewtonIteration=0,FixedPointIteration=1};
 
     KinsolSolver(Component *pComponent, double tol, int n, SolverTypeEnum type);
+    KinsolSolver(Component *pComponent, double tol, int n, SolverTypeEnum type, const std::vector<int> &rJacobianRowPointers, const std::vector<int> &rJacobianColumnIndices);
     ~KinsolSolver();
     void solve();
     double getState(int i);
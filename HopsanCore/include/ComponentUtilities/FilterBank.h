@@ -0,0 +1,97 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   FilterBank.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a structure-of-arrays bank of independent transfer functions
+//!
+//$Id$
+
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <vector>
+#include <cstddef>
+#include "win32dll.h"
+
+namespace hopsan {
+
+class FirstOrderTransferFunction;
+class SecondOrderTransferFunction;
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Updates many independent first and second order transfer functions in one loop
+//! @details The coefficients and states of all filters are copied into one array per variable, so the filter equations of
+//! all filters can be evaluated in loops without branches or function calls, that the compiler can vectorize.
+//! The results are the same as calling update() on each transfer function. The input and output node data is read and
+//! written through pointers in each update. The transfer function objects are only used in loadStates() and storeStates(),
+//! call loadStates() before a sequence of updates and storeStates() after it, before the objects are used again.
+class HOPSANCORE_DLLAPI FilterBank
+{
+public:
+    FilterBank();
+
+    void clear();
+    void addFilter(FirstOrderTransferFunction *pFilter, const double *pInput, double *pOutput);
+    void addFilter(SecondOrderTransferFunction *pFilter, const double *pInput, double *pOutput);
+    size_t size() const;
+
+    void loadStates();
+    void update();
+    void storeStates();
+
+private:
+    struct FirstOrderArrays
+    {
+        void resize(const size_t n);
+        std::vector<FirstOrderTransferFunction*> mFilters;
+        std::vector<const double*> mInputPtrs;
+        std::vector<double*> mOutputPtrs;
+        std::vector<double> mU, mDelayedU, mDelayedY;
+        std::vector<double> mCoeffU0, mCoeffU1, mCoeffY0, mInvCoeffY1;
+        std::vector<double> mMin, mMax;
+    };
+
+    struct SecondOrderArrays
+    {
+        void resize(const size_t n);
+        std::vector<SecondOrderTransferFunction*> mFilters;
+        std::vector<const double*> mInputPtrs;
+        std::vector<double*> mOutputPtrs;
+        std::vector<double> mU, mDelayedU, mDelayed2U, mDelayedY, mDelayed2Y;
+        std::vector<double> mCoeffU0, mCoeffU1, mCoeffU2, mCoeffY1, mCoeffY2, mInvCoeffY0;
+        std::vector<double> mMin, mMax;
+    };
+
+    FirstOrderArrays mFirstOrder;
+    SecondOrderArrays mSecondOrder;
+    bool mIsUpdated;
+};
+
+}
+
+#endif // FILTERBANK_H
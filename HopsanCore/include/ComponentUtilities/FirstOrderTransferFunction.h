@@ -41,6 +41,8 @@ namespace hopsan {
 
     class HOPSANCORE_DLLAPI FirstOrderTransferFunction
     {
+        friend class FilterBank;
+
     public:
         void initialize(double timestep, double num[2], double den[2], double u0=0.0, double y0=0.0, double min=-1.5E+300, double max=1.5E+300);
         void initializeValues(double u0, double y0);
@@ -57,6 +59,8 @@ namespace hopsan {
         double delayedU() const;
         double delayedY() const;
         bool isSaturated() const;
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
 
     protected:
         double mValue;
@@ -89,6 +93,8 @@ namespace hopsan {
         void recalculateCoefficients();
         double update(double u);
         double value();
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
 
     private:
         double mValue;
@@ -74,6 +74,21 @@ public:
         return mDelayY;
     }
 
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(mDelayU);
+        rWriter.writeDouble(mDelayY);
+        rWriter.writeDouble(mTimeStep);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = rReader.readDouble(mDelayU);
+        ok = ok && rReader.readDouble(mDelayY);
+        ok = ok && rReader.readDouble(mTimeStep);
+        return ok;
+    }
+
 protected:
     double mDelayU, mDelayY;
     double mTimeStep;
@@ -129,6 +144,21 @@ public:
         return update(u);
     }
 
+    void saveState(StateWriter &rWriter) const
+    {
+        Integrator::saveState(rWriter);
+        mBackupU.saveState(rWriter);
+        mBackupY.saveState(rWriter);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = Integrator::restoreState(rReader);
+        ok = ok && mBackupU.restoreState(rReader);
+        ok = ok && mBackupY.restoreState(rReader);
+        return ok;
+    }
+
 protected:
     Delay mBackupU, mBackupY;
 
@@ -36,6 +36,14 @@
 
 #include <vector>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// Batched interpolation uses AVX2 when the compiler targets it, for example with -mavx2 or -march=native
+#if defined(__AVX2__) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h>
+#define HOPSAN_LOOKUPTABLE_AVX2
+#endif
 
 inline double interp1(const double x, const double i1, const double i2, const double v1, const double v2)
 {
@@ -54,12 +62,15 @@ public:
         clear();
     }
 
+    virtual ~LookupTableNDBase() {}
+
     void clear()
     {
         mValueData.clear();
         mIndexData.clear(); mIndexData.resize(mNumDims);
         mNumSubDimDataElements.clear(); mNumSubDimDataElements.resize(mNumDims, 0);
         mIndexIncreasingOrDecreasing.clear(); mIndexIncreasingOrDecreasing.resize(mNumDims, Unknown);
+        mIndexInvStep.clear(); mIndexInvStep.resize(mNumDims, 0);
         resetFirstLast();
     }
 
@@ -78,6 +89,17 @@ public:
         return mValueData;
     }
 
+    //! @brief Returns the size in bytes of the index and value data
+    size_t getMemoryUsage() const
+    {
+        size_t nElements = mValueData.capacity();
+        for (size_t d=0; d<mIndexData.size(); ++d)
+        {
+            nElements += mIndexData[d].capacity();
+        }
+        return nElements*sizeof(double);
+    }
+
     bool isDataSizeOK()
     {
         size_t num_index=1;
@@ -124,15 +146,55 @@ public:
 
                 isStrictlyInc = isStrictlyInc && (mIndexIncreasingOrDecreasing[d] == StrictlyIncreasing);
             }
+            calcUniformSpacing();
             return isStrictlyInc;
         }
         else
         {
             resetFirstLast();
+            std::fill(mIndexInvStep.begin(), mIndexInvStep.end(), 0.0);
             return false;
         }
     }
 
+    //! @brief Check if the index data in a dimension is uniformly spaced, then intervals are found arithmetically
+    bool isIndexUniform(const size_t d) const
+    {
+        return mIndexInvStep[d] > 0;
+    }
+
+    //! @brief Detects uniformly spaced (within rounding) strictly increasing index vectors, called by isDataOK()
+    void calcUniformSpacing()
+    {
+        for (size_t d=0; d<mNumDims; ++d)
+        {
+            mIndexInvStep[d] = 0;
+            const std::vector<double> &rIndexData = mIndexData[d];
+            const size_t n = rIndexData.size();
+            if ((n < 2) || (mIndexIncreasingOrDecreasing[d] != StrictlyIncreasing))
+            {
+                continue;
+            }
+
+            const double range = rIndexData[n-1] - rIndexData[0];
+            const double step = range/double(n-1);
+            const double tolerance = 1e-9*range;
+            bool isUniform = true;
+            for (size_t i=1; i<n-1; ++i)
+            {
+                if (std::fabs(rIndexData[i] - (rIndexData[0] + double(i)*step)) > tolerance)
+                {
+                    isUniform = false;
+                    break;
+                }
+            }
+            if (isUniform)
+            {
+                mIndexInvStep[d] = 1.0/step;
+            }
+        }
+    }
+
     bool allIndexStrictlyIncreasing() const
     {
         for (size_t d=0; d<mNumDims; ++d)
@@ -322,13 +384,136 @@ public:
         return mIndexData[dim].size();
     }
 
+    //! @brief Find the start index of the interval containing x
+    //! @details If x equals an index value the lower of the two intervals is returned, all search methods give the same interval
     //! @note Assumes that x is within index range
     size_t findIndexAlongDim(const size_t dim, const double x) const
+    {
+        if (mIndexInvStep[dim] > 0)
+        {
+            return findIndexUniform(dim, x);
+        }
+        return intervalHalfSubDiv(x, 0, mIndexData[dim].size()-1, dim);
+    }
+
+    //! @brief Find the start index of the interval containing x, starting the search from the interval found in the previous call
+    //! @details The search hunts outwards from rHint with doubling steps and then bisects the bracketed range,
+    //! for slowly varying x this is O(1). The hint is owned by the caller since tables may be shared between components.
+    //! @param[in] dim The dimension to search along
+    //! @param[in] x The value to search for
+    //! @param[in,out] rHint The previously found interval, updated with the new interval
+    //! @note Assumes that x is within index range
+    size_t findIndexAlongDim(const size_t dim, const double x, size_t &rHint) const
+    {
+        if (mIndexInvStep[dim] > 0)
+        {
+            rHint = findIndexUniform(dim, x);
+            return rHint;
+        }
+
+        const std::vector<double> &rIndexData = mIndexData[dim];
+        const size_t last = rIndexData.size()-2;
+        size_t i = std::min(rHint, last);
+        if ((x <= rIndexData[i]) && (i > 0))
+        {
+            // Hunt downwards, x <= rIndexData[hi]
+            size_t hi = i, lo = i-1, step = 1;
+            while ((lo > 0) && (x <= rIndexData[lo]))
+            {
+                hi = lo;
+                step *= 2;
+                lo = (step < lo) ? lo-step : 0;
+            }
+            i = intervalHalfSubDiv(x, lo, hi, dim);
+        }
+        else if ((x > rIndexData[i+1]) && (i < last))
+        {
+            // Hunt upwards, x > rIndexData[lo]
+            size_t lo = i+1, hi = i+2, step = 1;
+            while ((hi < last+1) && (x > rIndexData[hi]))
+            {
+                lo = hi;
+                step *= 2;
+                hi = std::min(hi+step, last+1);
+            }
+            i = intervalHalfSubDiv(x, lo, hi, dim);
+        }
+        rHint = i;
+        return i;
+    }
+
+    //! @brief Find the start index of the interval containing x using bisection only, regardless of index spacing
+    //! @note Assumes that x is within index range
+    size_t findIndexAlongDimBisection(const size_t dim, const double x) const
     {
         return intervalHalfSubDiv(x, 0, mIndexData[dim].size()-1, dim);
     }
 
+    //! @brief Find the start indexes of the intervals containing n values
+    //! @details Uniform index is computed directly. If the values are in increasing order each search hunts from the previous
+    //! interval, so ordered values such as time vectors are found in O(1), otherwise independent bisection is used.
+    //! @param[in] dim The dimension to search along
+    //! @param[in] pX Array of n values
+    //! @param[out] pIdx Array for the n interval start indexes
+    //! @param[in] n The number of values
+    //! @param[in,out] rHint The interval where the first search starts, updated with the last interval
+    //! @note Assumes that the values are within index range
+    void findIndexesAlongDim(const size_t dim, const double *pX, size_t *pIdx, const size_t n, size_t &rHint) const
+    {
+        if (mIndexInvStep[dim] > 0)
+        {
+            for (size_t k=0; k<n; ++k)
+            {
+                pIdx[k] = findIndexUniform(dim, pX[k]);
+            }
+            return;
+        }
+
+        // Hunting makes each search depend on the previous one, for unordered values independent searches are faster
+        bool isIncreasing = true;
+        for (size_t k=1; k<n; ++k)
+        {
+            isIncreasing = isIncreasing && (pX[k] >= pX[k-1]);
+        }
+        if (isIncreasing)
+        {
+            for (size_t k=0; k<n; ++k)
+            {
+                pIdx[k] = findIndexAlongDim(dim, pX[k], rHint);
+            }
+        }
+        else
+        {
+            const size_t iend = mIndexData[dim].size()-1;
+            for (size_t k=0; k<n; ++k)
+            {
+                pIdx[k] = intervalHalfSubDiv(pX[k], 0, iend, dim);
+            }
+        }
+    }
+
 protected:
+    //! @brief The number of values handled at a time in batched interpolation, the temporary buffers are kept on the stack
+    static const size_t InterpolationBatchSize = 256;
+
+    inline size_t findIndexUniform(const size_t dim, const double x) const
+    {
+        const std::vector<double> &rIndexData = mIndexData[dim];
+        const size_t last = rIndexData.size()-2;
+        const double pos = (x - mIndexFirst[dim])*mIndexInvStep[dim];
+        size_t i = (pos > 0) ? std::min(size_t(pos), last) : 0;
+        // The index values are only uniform within rounding, adjust if we ended up in a neighbouring interval
+        while ((i > 0) && (x <= rIndexData[i]))
+        {
+            --i;
+        }
+        while ((i < last) && (x > rIndexData[i+1]))
+        {
+            ++i;
+        }
+        return i;
+    }
+
     size_t intervalHalfSubDiv(const double x, const size_t i1, const size_t iend, const size_t dim) const
     {
         if (iend-i1 <= 1)
@@ -496,6 +681,7 @@ protected:
     std::vector<double> mIndexFirst;
     std::vector<double> mIndexLast;
     std::vector<IncreasingEnumT> mIndexIncreasingOrDecreasing;
+    std::vector<double> mIndexInvStep;
 
     std::vector< std::vector<double> > mIndexData;
     std::vector<double> mValueData;
@@ -529,14 +715,165 @@ public:
             return mValueData[mValueData.size()-1];
         }
         // Handle in range
+        return interpolateInInterval(x, findIndexAlongDim(0, x));
+    }
+
+    //! @brief Interpolate, starting the interval search from rHint, use this when x varies slowly between calls
+    double interpolate(const double x, size_t &rHint) const
+    {
+        if( x<mIndexFirst[0] )
+        {
+            return mValueData[0];
+        }
+        else if( x>=mIndexLast[0] )
         {
-            const std::vector<double> &rIndexData = mIndexData[0];
-            const size_t idx = findIndexAlongDim(0, x);
+            return mValueData[mValueData.size()-1];
+        }
+        return interpolateInInterval(x, findIndexAlongDim(0, x, rHint));
+    }
 
-            // Note, assumes that index data is strictly increasing (two values can not be the same). That will lead to division by zero here
-            return mValueData[idx] + (x - rIndexData[idx])*(mValueData[idx+1] -  mValueData[idx])/(rIndexData[idx+1] -  rIndexData[idx]);
+    //! @brief Interpolate n values at once, the results are identical to calling interpolate() for each value
+    //! @details The intervals are searched for a batch of values first, then the values are interpolated four at a time with AVX2.
+    //! With uniform index and AVX2 the intervals are also computed four at a time. Searches in non-uniform index are fastest when
+    //! the values are ordered, such as time vectors.
+    //! @param[in] pX Array of n input values
+    //! @param[out] pOut Array for the n results, may be the same array as pX
+    //! @param[in] n The number of values
+    void interpolateMany(const double *pX, double *pOut, const size_t n) const
+    {
+        double x[InterpolationBatchSize];
+        size_t idx[InterpolationBatchSize];
+        size_t hint=0;
+        for (size_t b=0; b<n; b+=InterpolationBatchSize)
+        {
+            const size_t m = (n-b < InterpolationBatchSize) ? n-b : InterpolationBatchSize;
+            // Search with the values limited to the index range, values outside are handled when interpolating
+            for (size_t k=0; k<m; ++k)
+            {
+                x[k] = limitToRange(0, pX[b+k]);
+            }
+
+            size_t k=0;
+#ifdef HOPSAN_LOOKUPTABLE_AVX2
+            if (isIndexUniform(0))
+            {
+                // The intervals are computed together with the interpolation
+                k = interpolateUniformAVX2(x, pX+b, pOut+b, m);
+            }
+#endif
+            findIndexesAlongDim(0, x+k, idx+k, m-k, hint);
+#ifdef HOPSAN_LOOKUPTABLE_AVX2
+            k += interpolateIntervalsAVX2(pX+b+k, idx+k, pOut+b+k, m-k);
+#endif
+            for (; k<m; ++k)
+            {
+                const double xk = pX[b+k];
+                if (xk < mIndexFirst[0])
+                {
+                    pOut[b+k] = mValueData[0];
+                }
+                else if (xk >= mIndexLast[0])
+                {
+                    pOut[b+k] = mValueData[mValueData.size()-1];
+                }
+                else
+                {
+                    pOut[b+k] = interpolateInInterval(xk, idx[k]);
+                }
+            }
         }
     }
+
+    void interpolateMany(const std::vector<double> &rX, std::vector<double> &rOut) const
+    {
+        rOut.resize(rX.size());
+        interpolateMany(rX.data(), rOut.data(), rX.size());
+    }
+
+private:
+    inline double interpolateInInterval(const double x, const size_t idx) const
+    {
+        const std::vector<double> &rIndexData = mIndexData[0];
+        // Note, assumes that index data is strictly increasing (two values can not be the same). That will lead to division by zero here
+        return mValueData[idx] + (x - rIndexData[idx])*(mValueData[idx+1] -  mValueData[idx])/(rIndexData[idx+1] -  rIndexData[idx]);
+    }
+
+#ifdef HOPSAN_LOOKUPTABLE_AVX2
+    //! @brief Vectorized interpolateInInterval() including the out of range handling, for four values in the intervals starting at i
+    inline __m256d interpolateInIntervalsAVX2(const __m256d x, const __m256i i, const __m256d x0, const __m256d x1) const
+    {
+        const double *pValue = mValueData.data();
+        const __m256d v0 = _mm256_i64gather_pd(pValue, i, 8);
+        const __m256d v1 = _mm256_i64gather_pd(pValue+1, i, 8);
+
+        // Same operations in the same order as the scalar version, so that the results are identical
+        __m256d y = _mm256_add_pd(v0, _mm256_div_pd(_mm256_mul_pd(_mm256_sub_pd(x, x0), _mm256_sub_pd(v1, v0)), _mm256_sub_pd(x1, x0)));
+        y = _mm256_blendv_pd(y, _mm256_set1_pd(mValueData[mValueData.size()-1]), _mm256_cmp_pd(x, _mm256_set1_pd(mIndexLast[0]), _CMP_GE_OQ));
+        return _mm256_blendv_pd(y, _mm256_set1_pd(mValueData[0]), _mm256_cmp_pd(x, _mm256_set1_pd(mIndexFirst[0]), _CMP_LT_OQ));
+    }
+
+    //! @brief Vectorized interpolation for blocks of four values with known intervals
+    //! @returns The number of values handled, the remainder must be handled by the scalar version
+    size_t interpolateIntervalsAVX2(const double *pX, const size_t *pIdx, double *pOut, const size_t n) const
+    {
+        const double *pIndex = mIndexData[0].data();
+        size_t k=0;
+        for (; k+4<=n; k+=4)
+        {
+            const __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIdx+k));
+            const __m256d x0 = _mm256_i64gather_pd(pIndex, i, 8);
+            const __m256d x1 = _mm256_i64gather_pd(pIndex+1, i, 8);
+            _mm256_storeu_pd(pOut+k, interpolateInIntervalsAVX2(_mm256_loadu_pd(pX+k), i, x0, x1));
+        }
+        return k;
+    }
+
+    //! @brief Vectorized interpolation for blocks of four values in uniform index, the intervals are computed as in findIndexUniform()
+    //! @param[in] pXLimited The values limited to the index range, used to compute the intervals
+    //! @param[in] pX The values to interpolate
+    //! @param[out] pOut The results
+    //! @param[in] n The number of values
+    //! @returns The number of values handled, the remainder must be handled by the scalar version
+    size_t interpolateUniformAVX2(const double *pXLimited, const double *pX, double *pOut, const size_t n) const
+    {
+        const double *pIndex = mIndexData[0].data();
+        const long long last = static_cast<long long>(mIndexData[0].size()-2);
+        const __m256d first = _mm256_set1_pd(mIndexFirst[0]);
+        const __m256d invStep = _mm256_set1_pd(mIndexInvStep[0]);
+        const __m256d lastD = _mm256_set1_pd(double(last));
+        const __m256i zeroI = _mm256_setzero_si256();
+        const __m256i lastI = _mm256_set1_epi64x(last);
+
+        size_t k=0;
+        for (; k+4<=n; k+=4)
+        {
+            const __m256d xl = _mm256_loadu_pd(pXLimited+k);
+            // Max is taken first so that NaN gives interval 0, as in the scalar version
+            const __m256d pos = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(xl, first), invStep), _mm256_setzero_pd());
+            __m256i i = _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(_mm256_min_pd(pos, lastD)));
+            __m256d x0 = _mm256_i64gather_pd(pIndex, i, 8);
+            __m256d x1 = _mm256_i64gather_pd(pIndex+1, i, 8);
+
+            // Rarely, rounding puts a value in a neighbouring interval, then let the scalar search correct all four
+            const __m256i wrongLo = _mm256_and_si256(_mm256_castpd_si256(_mm256_cmp_pd(xl, x0, _CMP_LE_OQ)), _mm256_cmpgt_epi64(i, zeroI));
+            const __m256i wrongHi = _mm256_and_si256(_mm256_castpd_si256(_mm256_cmp_pd(xl, x1, _CMP_GT_OQ)), _mm256_cmpgt_epi64(lastI, i));
+            const __m256i wrong = _mm256_or_si256(wrongLo, wrongHi);
+            if (!_mm256_testz_si256(wrong, wrong))
+            {
+                size_t idx[4];
+                for (size_t j=0; j<4; ++j)
+                {
+                    idx[j] = findIndexUniform(0, pXLimited[k+j]);
+                }
+                i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx));
+                x0 = _mm256_i64gather_pd(pIndex, i, 8);
+                x1 = _mm256_i64gather_pd(pIndex+1, i, 8);
+            }
+            _mm256_storeu_pd(pOut+k, interpolateInIntervalsAVX2(_mm256_loadu_pd(pX+k), i, x0, x1));
+        }
+        return k;
+    }
+#endif
 };
 
 
@@ -556,9 +893,97 @@ public:
         r = limitToRange(0, r);
         c = limitToRange(1, c);
 
-        const size_t tl_r = findIndexAlongDim(0, r);
+        return interpolateInInterval(r, c, findIndexAlongDim(0, r), findIndexAlongDim(1, c));
+    }
+
+    //! @brief Interpolate, starting the interval searches from the row and column hints, use this when the input varies slowly between calls
+    double interpolate(double r, double c, size_t &rRowHint, size_t &rColHint) const
+    {
+        r = limitToRange(0, r);
+        c = limitToRange(1, c);
+
+        return interpolateInInterval(r, c, findIndexAlongDim(0, r, rRowHint), findIndexAlongDim(1, c, rColHint));
+    }
+
+    //! @brief Interpolate n points at once, the results are identical to calling interpolate() for each point
+    //! @details The intervals are searched for a batch of points first, then the points are interpolated four at a time with AVX2
+    //! @param[in] pRows Array of n row values
+    //! @param[in] pCols Array of n column values
+    //! @param[out] pOut Array for the n results, may be the same array as one of the inputs
+    //! @param[in] n The number of points
+    void interpolateMany(const double *pRows, const double *pCols, double *pOut, const size_t n) const
+    {
+        double r[InterpolationBatchSize], c[InterpolationBatchSize];
+        size_t ri[InterpolationBatchSize], ci[InterpolationBatchSize];
+        size_t rowHint=0, colHint=0;
+        for (size_t b=0; b<n; b+=InterpolationBatchSize)
+        {
+            const size_t m = (n-b < InterpolationBatchSize) ? n-b : InterpolationBatchSize;
+            for (size_t k=0; k<m; ++k)
+            {
+                r[k] = limitToRange(0, pRows[b+k]);
+                c[k] = limitToRange(1, pCols[b+k]);
+            }
+            findIndexesAlongDim(0, r, ri, m, rowHint);
+            findIndexesAlongDim(1, c, ci, m, colHint);
+
+            size_t k=0;
+#ifdef HOPSAN_LOOKUPTABLE_AVX2
+            k = interpolateIntervalsAVX2(r, c, ri, ci, pOut+b, m);
+#endif
+            for (; k<m; ++k)
+            {
+                pOut[b+k] = interpolateInInterval(r[k], c[k], ri[k], ci[k]);
+            }
+        }
+    }
+
+private:
+#ifdef HOPSAN_LOOKUPTABLE_AVX2
+    //! @brief Vectorized interpolateInInterval() for blocks of four points
+    //! @returns The number of points handled, the remainder must be handled by the scalar version
+    size_t interpolateIntervalsAVX2(const double *pRows, const double *pCols, const size_t *pRowIdx, const size_t *pColIdx, double *pOut, const size_t n) const
+    {
+        const double *pRowIndex = mIndexData[0].data();
+        const double *pColIndex = mIndexData[1].data();
+        const double *pValue = mValueData.data();
+        const __m256i rowStride = _mm256_set1_epi64x(static_cast<long long>(mNumSubDimDataElements[0]));
+
+        size_t k=0;
+        for (; k+4<=n; k+=4)
+        {
+            const __m256d r = _mm256_loadu_pd(pRows+k);
+            const __m256d c = _mm256_loadu_pd(pCols+k);
+            const __m256i ri = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRowIdx+k));
+            const __m256i ci = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pColIdx+k));
+            const __m256d r0 = _mm256_i64gather_pd(pRowIndex, ri, 8);
+            const __m256d r1 = _mm256_i64gather_pd(pRowIndex+1, ri, 8);
+            const __m256d c0 = _mm256_i64gather_pd(pColIndex, ci, 8);
+            const __m256d c1 = _mm256_i64gather_pd(pColIndex+1, ci, 8);
+
+            // Data index of the top left corner, the other corners are offset by one column and one row
+            const __m256i tl = _mm256_add_epi64(_mm256_mul_epu32(ri, rowStride), ci);
+            const __m256i bl = _mm256_add_epi64(tl, rowStride);
+            const __m256d tl_v = _mm256_i64gather_pd(pValue, tl, 8);
+            const __m256d tr_v = _mm256_i64gather_pd(pValue+1, tl, 8);
+            const __m256d bl_v = _mm256_i64gather_pd(pValue, bl, 8);
+            const __m256d br_v = _mm256_i64gather_pd(pValue+1, bl, 8);
+
+            // Same operations in the same order as interp1(), so that the results are identical to the scalar version
+            const __m256d dr = _mm256_sub_pd(r, r0);
+            const __m256d wr = _mm256_sub_pd(r1, r0);
+            const __m256d val_l = _mm256_add_pd(tl_v, _mm256_div_pd(_mm256_mul_pd(dr, _mm256_sub_pd(bl_v, tl_v)), wr));
+            const __m256d val_r = _mm256_add_pd(tr_v, _mm256_div_pd(_mm256_mul_pd(dr, _mm256_sub_pd(br_v, tr_v)), wr));
+            const __m256d y = _mm256_add_pd(val_l, _mm256_div_pd(_mm256_mul_pd(_mm256_sub_pd(c, c0), _mm256_sub_pd(val_r, val_l)), _mm256_sub_pd(c1, c0)));
+            _mm256_storeu_pd(pOut+k, y);
+        }
+        return k;
+    }
+#endif
+
+    double interpolateInInterval(const double r, const double c, const size_t tl_r, const size_t tl_c) const
+    {
         const size_t tr_r = tl_r;
-        const size_t tl_c = findIndexAlongDim(1, c);
         const size_t bl_c = tl_c;
 
         const size_t tr_c = tl_c+1;
@@ -600,9 +1025,54 @@ public:
         // Find planes, lower an higher
         const size_t pl = findIndexAlongDim(2, p);
 
-        // Now do 2d interpolation in each plane
-        const size_t tl_r = findIndexAlongDim(0, r);
-        const size_t tl_c = findIndexAlongDim(1, c);
+        return interpolateInInterval(r, c, p, findIndexAlongDim(0, r), findIndexAlongDim(1, c), pl);
+    }
+
+    //! @brief Interpolate, starting the interval searches from the hints, use this when the input varies slowly between calls
+    double interpolate(double r, double c, double p, size_t &rRowHint, size_t &rColHint, size_t &rPlaneHint) const
+    {
+        r = limitToRange(0, r);
+        c = limitToRange(1, c);
+        p = limitToRange(2, p);
+
+        return interpolateInInterval(r, c, p, findIndexAlongDim(0, r, rRowHint), findIndexAlongDim(1, c, rColHint),
+                                     findIndexAlongDim(2, p, rPlaneHint));
+    }
+
+    //! @brief Interpolate n points at once, the results are identical to calling interpolate() for each point
+    //! @param[in] pRows Array of n row values
+    //! @param[in] pCols Array of n column values
+    //! @param[in] pPlanes Array of n plane values
+    //! @param[out] pOut Array for the n results, may be the same array as one of the inputs
+    //! @param[in] n The number of points
+    void interpolateMany(const double *pRows, const double *pCols, const double *pPlanes, double *pOut, const size_t n) const
+    {
+        double r[InterpolationBatchSize], c[InterpolationBatchSize], p[InterpolationBatchSize];
+        size_t ri[InterpolationBatchSize], ci[InterpolationBatchSize], pli[InterpolationBatchSize];
+        size_t rowHint=0, colHint=0, planeHint=0;
+        for (size_t b=0; b<n; b+=InterpolationBatchSize)
+        {
+            const size_t m = (n-b < InterpolationBatchSize) ? n-b : InterpolationBatchSize;
+            for (size_t k=0; k<m; ++k)
+            {
+                r[k] = limitToRange(0, pRows[b+k]);
+                c[k] = limitToRange(1, pCols[b+k]);
+                p[k] = limitToRange(2, pPlanes[b+k]);
+            }
+            findIndexesAlongDim(0, r, ri, m, rowHint);
+            findIndexesAlongDim(1, c, ci, m, colHint);
+            findIndexesAlongDim(2, p, pli, m, planeHint);
+            for (size_t k=0; k<m; ++k)
+            {
+                pOut[b+k] = interpolateInInterval(r[k], c[k], p[k], ri[k], ci[k], pli[k]);
+            }
+        }
+    }
+
+private:
+    double interpolateInInterval(const double r, const double c, const double p, const size_t tl_r, const size_t tl_c, const size_t pl) const
+    {
+        // Do 2d interpolation in each plane
         const double vpl = interp2d(tl_r, tl_c, pl, r, c);
         const double vph = interp2d(tl_r, tl_c, pl+1, r, c);
 
@@ -610,7 +1080,6 @@ public:
         return interp1(p, mIndexData[2][pl], mIndexData[2][pl+1], vpl, vph);
     }
 
-private:
     double interp2d(const size_t tl_r, const size_t tl_c, const size_t plane, const double r, const double c) const
     {
         const size_t tr_r = tl_r;
@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   LookupTableCache.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a process wide cache for shared read-only lookup table data
+//!
+//$Id$
+
+#ifndef LOOKUPTABLECACHE_H
+#define LOOKUPTABLECACHE_H
+
+#include "win32dll.h"
+#include "HopsanTypes.h"
+#include "ComponentUtilities/LookupTable.h"
+
+#include <memory>
+#include <functional>
+
+namespace hopsan {
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Process wide, reference counted cache of parsed lookup table data
+//! @details Tables are identified by the canonical file path, the file modification time and size, and a parse options
+//! string supplied by the caller. All users of the same key share one read-only table. The cache only keeps weak
+//! references, so the data is released when the last user lets go of it. A modified file gives a new key and is reloaded.
+class HOPSANCORE_DLLAPI LookupTableCache
+{
+public:
+    typedef std::shared_ptr<const LookupTableNDBase> SharedTableT;
+    //! @brief The loader should return a new table with checked data, or nullptr on failure (after reporting errors)
+    typedef std::function<LookupTableNDBase*()> LoaderFunctionT;
+
+    static SharedTableT getOrLoad(const HString &rFilePath, const HString &rParseOptions, const LoaderFunctionT &rLoader);
+    static size_t getNumCachedTables();
+    static size_t estimateMemoryUsage(const HString &rFilePath);
+};
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Convenience function to get a shared lookup table of a specific type from the LookupTableCache
+//! @param[in] rFilePath The path to the data file
+//! @param[in] rParseOptions Any settings affecting how the file is parsed, including the component type name
+//! @param[in] loader Function returning a new TableT* (or nullptr on failure), only called if data is not already cached
+//! @returns Shared pointer to the read-only table data, empty on failure
+template<typename TableT, typename LoaderT>
+std::shared_ptr<const TableT> getSharedLookupTable(const HString &rFilePath, const HString &rParseOptions, LoaderT loader)
+{
+    return std::static_pointer_cast<const TableT>(LookupTableCache::getOrLoad(rFilePath, rParseOptions, loader));
+}
+
+}
+
+#endif // LOOKUPTABLECACHE_H
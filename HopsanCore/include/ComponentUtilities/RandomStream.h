@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   RandomStream.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a counter-based random number stream
+//!
+//$Id$
+
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "win32dll.h"
+#include "HopsanTypes.h"
+
+namespace hopsan {
+
+class StateWriter;
+class StateReader;
+
+//! @ingroup ComponentUtilityClasses
+//! @brief An independent and reproducible stream of random numbers, based on the Philox4x32-10 counter-based generator
+//! @details Value number n of a stream is a pure function of the seed, the stream id and n. Streams with different ids are
+//! independent, so each component can own a stream without sharing state with other components or threads, and the results
+//! do not depend on execution order or the number of simulation threads.
+//! Normal distributed values are generated with the ziggurat method.
+class HOPSANCORE_DLLAPI RandomStream
+{
+public:
+    RandomStream();
+    RandomStream(const uint64_t seed, const uint64_t streamId);
+
+    void setSeed(const uint64_t seed, const uint64_t streamId);
+    static uint64_t streamIdFromName(const HString &rName);
+
+    uint64_t nextUInt64();
+    double nextUniform();
+    double nextUniformOpen();
+    double nextNormal();
+
+    void fillUInt64(uint64_t *pValues, const size_t n);
+    void fillUniform(double *pValues, const size_t n);
+    void fillNormal(double *pValues, const size_t n);
+
+    void saveState(StateWriter &rWriter) const;
+    bool restoreState(StateReader &rReader);
+
+    static void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+private:
+    inline void generateBlock(const uint64_t blockIndex, uint64_t *pOut) const;
+    double normalSlowPath(uint64_t rnd);
+
+    uint32_t mKey[2];
+    uint32_t mStream[2];
+    uint64_t mNextBlock;
+    uint64_t mBuffer[2];
+    size_t mBufferPos;
+};
+
+}
+
+#endif // RANDOMSTREAM_H
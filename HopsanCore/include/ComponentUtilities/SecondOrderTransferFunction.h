@@ -41,6 +41,8 @@ namespace hopsan {
 
     class HOPSANCORE_DLLAPI SecondOrderTransferFunction
     {
+        friend class FilterBank;
+
     public:
         void initialize(double timestep, double num[3], double den[3], double u0=0.0, double y0=0.0, double min=-1.5E+300, double max=1.5E+300, double sy0=0.0);
         void initializeValues(double u0, double y0);
@@ -59,6 +61,8 @@ namespace hopsan {
         double delayedY() const;
         double delayed2Y() const;
         bool isSaturated() const;
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
 
     private:
         double mValue;
@@ -83,6 +87,8 @@ namespace hopsan {
         double update(double u);
         double value();
         void recalculateCoefficients();
+        void saveState(StateWriter &rWriter) const;
+        bool restoreState(StateReader &rReader);
 
     private:
         double mValue;
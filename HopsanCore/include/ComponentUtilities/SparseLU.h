@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SparseLU.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a sparse LU factorization for equation systems with a fixed sparsity pattern
+//!
+//$Id$
+
+#ifndef SPARSELU_H
+#define SPARSELU_H
+
+#include <vector>
+#include <cstddef>
+#include "win32dll.h"
+
+namespace hopsan {
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Sparse LU factorization with partial pivoting, for solving A*x = b where A has a fixed sparsity pattern
+//! @details The pattern is given once in compressed sparse row (CSR) format, after that only the values are needed to
+//! refactorize. The left-looking Gilbert-Peierls algorithm is used, so the work is proportional to the number of
+//! floating point operations. The diagonal is preferred as pivot when it is within the pivot tolerance of the largest
+//! candidate, to keep the fill-in low. Columns are not reordered.
+class HOPSANCORE_DLLAPI SparseLU
+{
+public:
+    SparseLU();
+
+    bool analyze(const int n, const int *pRowPointers, const int *pColumnIndices);
+    bool factorize(const double *pValues);
+    void solve(double *pRhs);
+
+    int size() const;
+    size_t getNumNonZeros() const;
+    size_t getNumFactorNonZeros() const;
+    void setPivotTolerance(const double tolerance);
+
+private:
+    int reach(const int k);
+
+    int mN;
+    double mPivotTolerance;
+
+    // The matrix A in compressed sparse column format, and the position of each value in the CSR input
+    std::vector<int> mColPointers, mRowIndices, mCsrPositions;
+    std::vector<double> mValues;
+
+    // The factors P*A = L*U in compressed sparse column format, L has unit diagonal stored first and U has the diagonal stored last
+    std::vector<int> mLColPointers, mLRowIndices, mUColPointers, mURowIndices;
+    std::vector<double> mLValues, mUValues;
+    std::vector<int> mPivotRowInv;
+
+    // Work arrays
+    std::vector<int> mReachStack;
+    std::vector<char> mMarked;
+    std::vector<double> mWork;
+    bool mIsFactorized;
+};
+
+}
+
+#endif // SPARSELU_H
@@ -0,0 +1,243 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   StateSerialization.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the binary state writer and reader used for simulation checkpoints
+//!
+//$Id$
+
+#ifndef STATESERIALIZATION_H
+#define STATESERIALIZATION_H
+
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+#include "HopsanTypes.h"
+
+namespace hopsan {
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Appends raw binary state data to a memory buffer
+//! @details Values are stored in native byte order, a state can only be restored on the same platform and build
+class StateWriter
+{
+public:
+    void writeDouble(const double value)
+    {
+        writeRaw(&value, sizeof(value));
+    }
+
+    void writeDoubles(const double *pValues, const size_t n)
+    {
+        writeRaw(pValues, n*sizeof(double));
+    }
+
+    void writeInt(const int value)
+    {
+        const int64_t v = value;
+        writeRaw(&v, sizeof(v));
+    }
+
+    void writeBool(const bool value)
+    {
+        const char v = value ? 1 : 0;
+        writeRaw(&v, sizeof(v));
+    }
+
+    void writeSize(const size_t value)
+    {
+        const uint64_t v = value;
+        writeRaw(&v, sizeof(v));
+    }
+
+    void writeVector(const std::vector<double> &rValues)
+    {
+        writeSize(rValues.size());
+        writeDoubles(rValues.data(), rValues.size());
+    }
+
+    void writeString(const HString &rString)
+    {
+        writeSize(rString.size());
+        writeRaw(rString.c_str(), rString.size());
+    }
+
+    //! @brief Begin a length prefixed block, so that a reader can skip or isolate it
+    //! @returns The block handle to pass to endBlock()
+    size_t beginBlock()
+    {
+        const size_t handle = mData.size();
+        writeSize(0);
+        return handle;
+    }
+
+    //! @brief End a block started with beginBlock(), writing its length
+    void endBlock(const size_t handle)
+    {
+        const uint64_t length = mData.size()-handle-sizeof(uint64_t);
+        memcpy(&mData[handle], &length, sizeof(length));
+    }
+
+    void writeRaw(const void *pData, const size_t numBytes)
+    {
+        const char *pBytes = static_cast<const char*>(pData);
+        mData.insert(mData.end(), pBytes, pBytes+numBytes);
+    }
+
+    const std::vector<char> &getData() const
+    {
+        return mData;
+    }
+
+    std::vector<char> &getData()
+    {
+        return mData;
+    }
+
+    void clear()
+    {
+        mData.clear();
+    }
+
+private:
+    std::vector<char> mData;
+};
+
+//! @ingroup ComponentUtilityClasses
+//! @brief Reads binary state data written by StateWriter
+//! @details All read functions return false if there is not enough data left, the reader then stays in a failed state
+class StateReader
+{
+public:
+    StateReader() : mpData(0), mSize(0), mPos(0), mIsOk(true) {}
+    StateReader(const char *pData, const size_t size) : mpData(pData), mSize(size), mPos(0), mIsOk(true) {}
+
+    bool readDouble(double &rValue)
+    {
+        return readRaw(&rValue, sizeof(rValue));
+    }
+
+    bool readDoubles(double *pValues, const size_t n)
+    {
+        return readRaw(pValues, n*sizeof(double));
+    }
+
+    bool readInt(int &rValue)
+    {
+        int64_t v;
+        const bool ok = readRaw(&v, sizeof(v));
+        rValue = ok ? int(v) : 0;
+        return ok;
+    }
+
+    bool readBool(bool &rValue)
+    {
+        char v;
+        const bool ok = readRaw(&v, sizeof(v));
+        rValue = ok && (v != 0);
+        return ok;
+    }
+
+    bool readSize(size_t &rValue)
+    {
+        uint64_t v;
+        const bool ok = readRaw(&v, sizeof(v));
+        rValue = ok ? size_t(v) : 0;
+        return ok;
+    }
+
+    //! @brief Read a vector, its stored size must match the size of rValues
+    bool readVector(std::vector<double> &rValues)
+    {
+        size_t n;
+        if (!readSize(n) || n != rValues.size())
+        {
+            mIsOk = false;
+            return false;
+        }
+        return readDoubles(rValues.data(), n);
+    }
+
+    bool readString(HString &rString)
+    {
+        size_t n;
+        if (!readSize(n) || n > mSize-mPos)
+        {
+            mIsOk = false;
+            return false;
+        }
+        rString = HString(mpData+mPos, n);
+        mPos += n;
+        return true;
+    }
+
+    //! @brief Read a block written between StateWriter::beginBlock() and endBlock()
+    //! @param[out] rBlock A reader limited to the block contents
+    bool readBlock(StateReader &rBlock)
+    {
+        size_t n;
+        if (!readSize(n) || n > mSize-mPos)
+        {
+            mIsOk = false;
+            return false;
+        }
+        rBlock = StateReader(mpData+mPos, n);
+        mPos += n;
+        return true;
+    }
+
+    bool readRaw(void *pData, const size_t numBytes)
+    {
+        if (!mIsOk || numBytes > mSize-mPos)
+        {
+            mIsOk = false;
+            return false;
+        }
+        memcpy(pData, mpData+mPos, numBytes);
+        mPos += numBytes;
+        return true;
+    }
+
+    bool isOk() const
+    {
+        return mIsOk;
+    }
+
+    bool atEnd() const
+    {
+        return mPos == mSize;
+    }
+
+private:
+    const char *mpData;
+    size_t mSize, mPos;
+    bool mIsOk;
+};
+
+}
+
+#endif // STATESERIALIZATION_H
@@ -39,6 +39,9 @@
 namespace hopsan {
 
     //! @ingroup ComponentUtilityClasses
+    //! @brief Generates standard normal distributed values from a random number stream that is local to the calling thread
+    //! @deprecated The sequence depends on which components share the thread, use a RandomStream seeded with
+    //! Component::seedRandomStream() to get reproducible results
     class HOPSANCORE_DLLAPI WhiteGaussianNoise
     {
     public:
@@ -0,0 +1,92 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   MemoryReport.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the memory footprint report for simulation models
+//!
+//$Id$
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <set>
+#include <vector>
+#include "HopsanTypes.h"
+#include "win32dll.h"
+
+namespace hopsan {
+
+//! @brief Memory usage of one system, not including its subsystems
+class HOPSANCORE_DLLAPI MemoryUsageEntry
+{
+public:
+    MemoryUsageEntry();
+    size_t getTotalBytes() const;
+
+    HString mName;              //!< Full name with parent systems separated by |
+    size_t mNodeDataBytes;      //!< Node data variables
+    size_t mLogDataBytes;       //!< Log storage for node data and time
+    size_t mComponentDataBytes; //!< Component internal buffers, such as delay lines
+    size_t mLookupDataBytes;    //!< Lookup table data, tables shared between components are counted once
+};
+
+//! @brief Collects the memory footprint of a model, either estimated before initialize or as allocated after initialize
+//! @details Sizes are the payload of the data containers, allocator overhead and the component objects themselves are not included.
+//! @see ComponentSystem::estimateMemoryUsage(), ComponentSystem::getMemoryUsage(), Component::reportMemoryUsage()
+class HOPSANCORE_DLLAPI MemoryReport
+{
+public:
+    MemoryReport(const bool isEstimate=false);
+
+    void beginSystem(const HString &rName);
+    void addNodeData(const size_t bytes);
+    void addLogData(const size_t bytes);
+    void addComponentData(const size_t bytes);
+    void addLookupData(const HString &rKey, const size_t bytes);
+
+    bool isEstimate() const;
+    const std::vector<MemoryUsageEntry> &getEntries() const;
+    MemoryUsageEntry getTotals() const;
+    size_t getTotalBytes() const;
+
+    HString toTable() const;
+    HString toCSV() const;
+
+private:
+    MemoryUsageEntry &currentEntry();
+
+    std::vector<MemoryUsageEntry> mEntries;
+    std::set<HString> mCountedLookupKeys;
+    bool mIsEstimate;
+};
+
+//! @brief Formats a byte count with a binary unit prefix, e.g. 1.50 MiB
+HOPSANCORE_DLLAPI HString formatByteSize(const size_t bytes);
+
+}
+
+#endif // MEMORYREPORT_H
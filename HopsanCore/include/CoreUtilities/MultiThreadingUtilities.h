@@ -60,6 +60,8 @@ namespace hopsan {
 class Component;
 class ComponentSystem;
 class Node;
+class SimulationTraceBuffer;
+class SchedulingThreadStatistics;
 
 //! @brief Class for barrier locks in multi-threaded simulations.
 class BarrierLock
@@ -100,12 +102,16 @@ private:
 HOPSANCORE_DLLAPI void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std::vector<Component *> &cVector,
                                  std::vector<Component *> &qVector, std::vector<Node *> &nVector, std::vector<double *> &pSimTimes,
                                  double startTime, double timeStep, size_t numSimSteps, BarrierLock *pBarrier_S,
-                                 BarrierLock *pBarrier_C, BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N);
+                                 BarrierLock *pBarrier_C, BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N,
+                                 double *pProfiledWaitTime, double *pProfiledLoggingTime, SimulationTraceBuffer *pTraceBuffer,
+                                 SchedulingThreadStatistics *pSchedulingStatistics);
 
 HOPSANCORE_DLLAPI void simSlave(ComponentSystem *pSystem, std::vector<Component*> &sVector, std::vector<Component*> &cVector,
                                 std::vector<Component*> &qVector, std::vector<Node*> &nVector, double startTime,
                                 double timeStep, size_t numSimSteps, BarrierLock *pBarrier_S,
-                                BarrierLock *pBarrier_C, BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N);
+                                BarrierLock *pBarrier_C, BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N,
+                                double *pProfiledWaitTime, SimulationTraceBuffer *pTraceBuffer,
+                                SchedulingThreadStatistics *pSchedulingStatistics);
 
 HOPSANCORE_DLLAPI void simWholeSystemInRealtime(double realTimeFactor, volatile bool *pStopSimulation, double *pTime, double timeStep, std::vector<Component *> signalComponentPtrs, std::vector<Component *> cComponentPtrs, std::vector<Component *> qComponentPtrs);
 
@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   PerformanceCounters.h
+//! @date   2026-10-19
+//!
+//! @brief Contains hardware performance counters used by the simulation profiler
+//!
+//$Id$
+
+#ifndef PERFORMANCECOUNTERS_H
+#define PERFORMANCECOUNTERS_H
+
+#include "HString.h"
+#include "win32dll.h"
+
+namespace hopsan {
+
+//! @brief Hardware performance counters (cycles, instructions, cache misses, branch misses) for the calling thread
+//! @details Uses perf_event_open on Linux. The counters are unavailable on other platforms, and when the kernel or a container
+//! does not allow them (see /proc/sys/kernel/perf_event_paranoid). Only user space events are counted.
+class HOPSANCORE_DLLAPI PerformanceCounters
+{
+public:
+    enum CounterEnumT {Cycles, Instructions, CacheMisses, BranchMisses, NumCounters};
+    typedef unsigned long long CounterValuesT[NumCounters];
+
+    PerformanceCounters();
+    ~PerformanceCounters();
+
+    bool open();
+    void close();
+    bool isAvailable() const;
+    bool isCounterAvailable(const CounterEnumT counter) const;
+    const HString &getErrorString() const;
+    bool read(CounterValuesT &rValues) const;
+
+    static const char *getCounterName(const CounterEnumT counter);
+    static PerformanceCounters *getThreadInstance();
+
+private:
+    PerformanceCounters(const PerformanceCounters &);
+    PerformanceCounters &operator=(const PerformanceCounters &);
+
+    int mFileDescriptors[NumCounters];
+    int mGroupIndex[NumCounters];
+    int mNumOpened;
+    HString mErrorString;
+};
+
+}
+
+#endif // PERFORMANCECOUNTERS_H
@@ -0,0 +1,132 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   ResultFile.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the Hopsan binary result file (.hrb) writer and memory mapped reader
+//!
+//$Id$
+
+#ifndef RESULTFILE_H
+#define RESULTFILE_H
+
+#include "win32dll.h"
+#include "HopsanTypes.h"
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+//! @defgroup ResultFileFormat Hopsan binary result file format
+//! @details Version 1 of the format is laid out as follows (native little endian byte order):
+//! - A 64 byte header: the magic "HOPSRES\0", uint32 version, uint32 byte order mark (0x01020304),
+//!   uint64 number of variables, uint64 variable table offset, uint64 variable table size and uint64 data offset.
+//! - The variable table, for each variable: uint64 data offset, uint64 number of samples, int64 index of the
+//!   time (or frequency) variable it belongs to (-1 if none) and the strings name, alias, unit and quantity,
+//!   each stored as uint32 length followed by the characters (no terminating null).
+//! - The data section, one contiguous column of doubles per variable, each column starting on a 64 byte boundary.
+//!
+//! Since the columns are contiguous and aligned, a memory mapped file can be used directly as double arrays,
+//! reading one variable or a time window only touches the pages containing that data.
+
+namespace hopsan {
+
+//! @ingroup ResultFileFormat
+//! @brief Description of one variable in a binary result file
+class HOPSANCORE_DLLAPI ResultFileVariable
+{
+public:
+    HString mName;
+    HString mAlias;
+    HString mUnit;
+    HString mQuantity;
+    int mTimeVariableIndex = -1;
+    size_t mNumSamples = 0;
+    uint64_t mDataOffset = 0;
+};
+
+//! @ingroup ResultFileFormat
+//! @brief Writes binary result files, data is fetched column by column while writing to avoid an extra copy of all results
+class HOPSANCORE_DLLAPI ResultFileWriter
+{
+public:
+    //! @brief Function that should fill the (already sized) column buffer with the variable data
+    typedef std::function<void(double *pColumn, size_t numSamples)> ColumnFillFunctionT;
+
+    size_t addVariable(const HString &rName, const HString &rAlias, const HString &rUnit, const HString &rQuantity,
+                       const size_t numSamples, ColumnFillFunctionT fillFunction, const int timeVariableIndex=-1);
+    void setTimeVariableIndex(const size_t variableIndex, const int timeVariableIndex);
+    size_t getNumVariables() const;
+
+    bool writeToFile(const HString &rFilePath);
+    const HString &getErrorString() const;
+
+private:
+    std::vector<ResultFileVariable> mVariables;
+    std::vector<ColumnFillFunctionT> mFillFunctions;
+    HString mErrorString;
+};
+
+//! @ingroup ResultFileFormat
+//! @brief Reads binary result files through a read-only memory mapping, data pointers are valid until the file is closed
+class HOPSANCORE_DLLAPI ResultFileReader
+{
+public:
+    ResultFileReader();
+    ~ResultFileReader();
+
+    bool openFile(const HString &rFilePath);
+    void closeFile();
+    bool isOpen() const;
+    const HString &getErrorString() const;
+
+    size_t getNumVariables() const;
+    const ResultFileVariable *getVariable(const size_t idx) const;
+    int findVariable(const HString &rName) const;
+
+    const double *getVariableData(const size_t idx) const;
+    const double *getTimeData(const size_t idx) const;
+    bool findTimeWindow(const size_t idx, const double startT, const double stopT, size_t &rFirst, size_t &rCount) const;
+    size_t copyVariableData(const size_t idx, const size_t first, const size_t count, double *pDst) const;
+
+private:
+    // The reader owns a file mapping, it can not be copied
+    ResultFileReader(const ResultFileReader &);
+    ResultFileReader &operator=(const ResultFileReader &);
+
+    bool parseHeader();
+
+    std::vector<ResultFileVariable> mVariables;
+    HString mErrorString;
+    const char *mpMappedData;
+    uint64_t mMappedSize;
+    void *mpFileHandle;
+    void *mpMappingHandle;
+};
+
+}
+
+#endif // RESULTFILE_H
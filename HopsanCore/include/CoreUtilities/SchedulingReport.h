@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SchedulingReport.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the load balance statistics of the a priori scheduling algorithm
+//!
+//$Id$
+
+#ifndef SCHEDULINGREPORT_H
+#define SCHEDULINGREPORT_H
+
+#include <vector>
+#include <cstddef>
+#include "HopsanTypes.h"
+#include "win32dll.h"
+
+namespace hopsan {
+
+//! @brief The phases of one step in the a priori scheduling algorithm, each phase begins with a thread barrier
+enum SchedulingPhaseT {SchedulingSignalPhase, SchedulingCPhase, SchedulingQPhase, SchedulingLogPhase, NumSchedulingPhases};
+
+//! @brief Time spent by one simulation thread in each scheduling phase
+class HOPSANCORE_DLLAPI SchedulingThreadStatistics
+{
+public:
+    SchedulingThreadStatistics();
+    double getTotalBusyTime() const;
+    double getTotalWaitTime() const;
+
+    double mBusyTime[NumSchedulingPhases];      //!< Time spent in components, or logging data in the log phase
+    double mWaitTime[NumSchedulingPhases];      //!< Time spent waiting at the barrier that begins each phase
+    size_t mNumComponents[NumSchedulingPhases]; //!< Number of components assigned to the thread
+    size_t mNumSteps;                           //!< Number of steps taken by the thread
+    size_t mNumSampledSteps;                    //!< Number of steps in which the times were measured
+};
+
+//! @brief Load balance report of a multi-threaded simulation with the a priori scheduling algorithm
+//! @details Times are only measured in every N:th step (see ComponentSystem::setSchedulingSampleInterval()) and are scaled to estimate the totals for all steps.
+//! The serial time is estimated as the sum of the busy time of all threads.
+//! @see ComponentSystem::getSchedulingReport()
+class HOPSANCORE_DLLAPI SchedulingReport
+{
+public:
+    SchedulingReport();
+
+    void clear();
+    void setThreadStatistics(const std::vector<SchedulingThreadStatistics> &rThreads, const double wallTime);
+
+    bool isEmpty() const;
+    size_t getNumThreads() const;
+    size_t getNumSteps() const;
+    const SchedulingThreadStatistics &getThreadStatistics(const size_t thread) const;
+
+    double getWallTime() const;
+    double getSerialTime() const;
+    double getSpeedup() const;
+    double getParallelEfficiency() const;
+    double getLoadImbalance(const SchedulingPhaseT phase) const;
+
+    HString toTable() const;
+    HString toCSV() const;
+
+private:
+    std::vector<SchedulingThreadStatistics> mThreads;
+    double mWallTime;
+};
+
+}
+
+#endif // SCHEDULINGREPORT_H
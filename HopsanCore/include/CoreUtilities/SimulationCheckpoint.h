@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SimulationCheckpoint.h
+//! @date   2026-10-19
+//!
+//! @brief Contains functions and a class for writing and restoring binary simulation checkpoints
+//!
+//$Id$
+
+#ifndef SIMULATIONCHECKPOINT_H
+#define SIMULATIONCHECKPOINT_H
+
+#include <vector>
+#include <chrono>
+#include "win32dll.h"
+#include "HopsanTypes.h"
+#include "CoreUtilities/MultiThreadingUtilities.h"
+
+#if defined(HOPSANCORE_USEMULTITHREADING)
+#include <atomic>
+#include <thread>
+#endif
+
+namespace hopsan {
+
+class ComponentSystem;
+
+bool HOPSANCORE_DLLAPI saveCheckpoint(const HString &rFilePath, ComponentSystem *pRootSystem);
+bool HOPSANCORE_DLLAPI restoreCheckpoint(const HString &rFilePath, ComponentSystem *pRootSystem);
+
+//! @brief Writes periodic checkpoints during simulation
+//! @details The state is captured into a memory buffer on the simulation thread and written to file by a background
+//! thread, so that the simulation only stalls for the copy. A new checkpoint waits for the previous write to finish.
+class HOPSANCORE_DLLAPI CheckpointWriter
+{
+public:
+    CheckpointWriter(const HString &rFilePath, const size_t stepInterval, const double wallTimeInterval);
+    ~CheckpointWriter();
+
+    bool isDue(const size_t simStep);
+    void write(ComponentSystem *pRootSystem);
+    void waitForPendingWrite();
+
+private:
+    CheckpointWriter(const CheckpointWriter &);
+    CheckpointWriter &operator=(const CheckpointWriter &);
+
+    HString mFilePath;
+    size_t mStepInterval, mNextStep;
+    double mWallTimeInterval;
+    std::chrono::steady_clock::time_point mNextWallTime;
+    bool mHasCheckedStateSupport;
+    ComponentSystem *mpRootSystem;
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    std::thread mWriteThread;
+    std::atomic<bool> mWriteFailed;
+#endif
+};
+
+}
+
+#endif // SIMULATIONCHECKPOINT_H
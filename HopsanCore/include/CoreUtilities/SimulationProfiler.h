@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   SimulationProfiler.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the simulation profiler helpers and the profiling report
+//!
+//$Id$
+
+#ifndef SIMULATIONPROFILER_H
+#define SIMULATIONPROFILER_H
+
+#include <chrono>
+#include <vector>
+#include "Component.h"
+#include "CoreUtilities/PerformanceCounters.h"
+#include "win32dll.h"
+
+namespace hopsan {
+
+class ComponentSystem;
+
+//! @brief The clock used by the simulation profiler
+typedef std::chrono::steady_clock ProfilerClockT;
+
+//! @brief Returns the time in seconds elapsed since a given time point
+inline double profilerSecondsSince(const ProfilerClockT::time_point &rStart)
+{
+    return std::chrono::duration<double>(ProfilerClockT::now()-rStart).count();
+}
+
+//! @brief Simulates components and adds the wall time of each call to the component, used in sampled profiling steps
+//! @details Consecutive calls share clock readings, so only one clock reading is needed per component
+//! @param [in] rComponents The components to simulate
+//! @param [in] stopT The time to simulate to
+//! @returns The total wall time spent in the components
+inline double simulateAndProfileComponents(std::vector<Component*> &rComponents, const double stopT)
+{
+    const ProfilerClockT::time_point start = ProfilerClockT::now();
+    ProfilerClockT::time_point t0 = start;
+    for (size_t i=0; i<rComponents.size(); ++i)
+    {
+        rComponents[i]->simulate(stopT);
+        const ProfilerClockT::time_point t1 = ProfilerClockT::now();
+        rComponents[i]->addProfiledTime(std::chrono::duration<double>(t1-t0).count());
+        t0 = t1;
+    }
+    return std::chrono::duration<double>(t0-start).count();
+}
+
+//! @brief Simulates components and adds the wall time and hardware counter increase of each call to the component
+//! @param [in] rComponents The components to simulate
+//! @param [in] stopT The time to simulate to
+//! @param [in] pCounters The counters of the calling thread, if 0 only wall time is measured
+//! @returns The total wall time spent in the components
+inline double simulateAndProfileComponents(std::vector<Component*> &rComponents, const double stopT, const PerformanceCounters *pCounters)
+{
+    if (!pCounters)
+    {
+        return simulateAndProfileComponents(rComponents, stopT);
+    }
+    PerformanceCounters::CounterValuesT before, after;
+    double totalTime = 0;
+    for (size_t i=0; i<rComponents.size(); ++i)
+    {
+        pCounters->read(before);
+        const ProfilerClockT::time_point t0 = ProfilerClockT::now();
+        rComponents[i]->simulate(stopT);
+        const double time = profilerSecondsSince(t0);
+        pCounters->read(after);
+        rComponents[i]->addProfiledTime(time);
+        rComponents[i]->addProfiledCounters(before, after);
+        totalTime += time;
+    }
+    return totalTime;
+}
+
+//! @brief Profiling result for one component or subsystem
+class HOPSANCORE_DLLAPI ProfilingEntry
+{
+public:
+    HString mName;          //!< Full name with parent systems separated by |
+    HString mTypeName;
+    HString mCQSType;
+    bool mIsSystem;
+    size_t mNumCalls;       //!< Number of calls to simulate()
+    size_t mNumSamples;     //!< Number of measured calls
+    double mTime;           //!< Estimated total wall time in seconds (inclusive for subsystems)
+    double mLoggingTime;    //!< Estimated time spent logging (subsystems only)
+    double mBarrierTime;    //!< Estimated time spent waiting at thread barriers, summed over threads (subsystems only)
+    bool mHasCounters;      //!< True if hardware counters were measured
+    double mCounters[PerformanceCounters::NumCounters];  //!< Estimated total hardware counter values
+};
+
+//! @brief Collects and formats the profiling results of a system that has been simulated with profiling enabled
+//! @see ComponentSystem::setProfilingEnabled()
+class HOPSANCORE_DLLAPI SimulationProfile
+{
+public:
+    SimulationProfile();
+    void collect(ComponentSystem *pRootSystem);
+
+    const std::vector<ProfilingEntry> &getEntries() const;
+    double getTotalTime() const;
+    double getLoggingTime() const;
+    double getBarrierTime() const;
+    size_t getNumSteps() const;
+    size_t getSampleInterval() const;
+    bool hasCounters() const;
+    const HString &getCounterStatus() const;
+
+    HString toTable(const size_t maxRows=0) const;
+    HString toCSV() const;
+    HString toJSON() const;
+    bool writeToFile(const HString &rFilePath) const;
+
+private:
+    void collectSystem(ComponentSystem *pSystem, const HString &rPrefix);
+
+    std::vector<ProfilingEntry> mEntries;
+    double mTotalTime;
+    double mLoggingTime;
+    double mBarrierTime;
+    size_t mNumSteps;
+    size_t mSampleInterval;
+    bool mHasCounters;
+    HString mCounterStatus;
+};
+
+}
+
+#endif // SIMULATIONPROFILER_H
@@ -0,0 +1,128 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SimulationProgress.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the live simulation progress and throughput metrics
+//!
+//$Id$
+
+#ifndef SIMULATIONPROGRESS_H
+#define SIMULATIONPROGRESS_H
+
+#include <atomic>
+#include <functional>
+#include "HopsanTypes.h"
+#include "win32dll.h"
+#include "CoreUtilities/MultiThreadingUtilities.h"
+
+#if defined(HOPSANCORE_USEMULTITHREADING)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace hopsan {
+
+//! @brief A snapshot of the progress of a simulation
+class HOPSANCORE_DLLAPI SimulationProgressMetrics
+{
+public:
+    SimulationProgressMetrics();
+    HString toJSON() const;
+
+    const char *mPhase;         //!< Idle, Initializing, Initialized, Simulating, Finalizing, Finished or Aborted
+    double mSimulationTime;     //!< Current simulation time
+    double mStartTime;          //!< Simulation start time
+    double mStopTime;           //!< Simulation stop time
+    double mProgress;           //!< Simulated fraction 0..1
+    size_t mNumSteps;           //!< Number of taken top-level steps
+    size_t mTotalNumSteps;      //!< Total number of top-level steps
+    double mWallTime;           //!< Wall time in seconds spent in the current phase, or in simulation once finished
+    double mStepsPerSecond;     //!< Top-level steps per wall clock second
+    double mRealTimeRatio;      //!< Simulated time per wall clock time, > 1 is faster than real time
+    double mEstimatedTimeRemaining; //!< Estimated wall time in seconds until the simulation is finished, -1 if unknown
+};
+
+//! @brief Progress of the simulation of a system, updated by the simulating thread and readable from any other thread
+//! @details The simulation loops only store the current time with a relaxed atomic store, no locks are taken per step.
+//! Metrics are computed when requested with getMetrics() or periodically by a monitor thread.
+//! @see ComponentSystem::getSimulationProgress()
+class HOPSANCORE_DLLAPI SimulationProgress
+{
+public:
+    enum PhaseEnumT {Idle, Initializing, Initialized, Simulating, Finalizing, Finished, Aborted};
+    typedef std::function<void(const SimulationProgressMetrics&)> CallbackT;
+
+    SimulationProgress();
+    ~SimulationProgress();
+
+    void beginInitialize(const double startT, const double stopT, const double timestep);
+    void beginSimulation();
+    void endSimulation();
+    void setPhase(const PhaseEnumT phase);
+    PhaseEnumT getPhase() const;
+
+    //! @brief Publish the current simulation time, called by the simulating thread after each step
+    inline void publishTime(const double time)
+    {
+        mTime.store(time, std::memory_order_relaxed);
+    }
+
+    SimulationProgressMetrics getMetrics() const;
+    double getSimulationWallTime() const;
+
+    bool startMonitor(const CallbackT &rCallback, const double intervalSeconds);
+    void stopMonitor();
+
+private:
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    void runMonitor();
+#endif
+
+    std::atomic<int> mPhase;
+    std::atomic<double> mTime;
+    std::atomic<double> mStartTime;
+    std::atomic<double> mStopTime;
+    std::atomic<double> mTimestep;
+    std::atomic<double> mSimulationStartTime;
+    std::atomic<long long> mWallStartNs;
+    std::atomic<long long> mWallStopNs;
+    std::atomic<long long> mSimulationStopNs;
+
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    std::thread mMonitorThread;
+    std::mutex mMonitorMutex;
+    std::condition_variable mMonitorCondition;
+    bool mStopMonitor;
+    CallbackT mCallback;
+    double mMonitorInterval;
+#endif
+};
+
+}
+
+#endif // SIMULATIONPROGRESS_H
@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   SimulationTracer.h
+//! @date   2026-10-19
+//!
+//! @brief Contains the per-thread timeline tracer for multi-threaded simulations
+//!
+//$Id$
+
+#ifndef SIMULATIONTRACER_H
+#define SIMULATIONTRACER_H
+
+#include <vector>
+#include "CoreUtilities/SimulationProfiler.h"
+#include "HString.h"
+#include "win32dll.h"
+
+namespace hopsan {
+
+class Component;
+
+//! @brief The kind of interval recorded by the simulation tracer
+enum SimulationTracePhaseEnum {TraceSignalComponents, TraceCComponents, TraceQComponents, TraceLogNodes,
+                               TraceWaitS, TraceWaitC, TraceWaitQ, TraceWaitN, TraceComponent};
+
+//! @brief One recorded interval, times are in nanoseconds since the tracer epoch
+class SimulationTraceEvent
+{
+public:
+    const Component *mpComponent;   //!< The component, only for TraceComponent events
+    size_t mStep;
+    long long mBegin;
+    long long mEnd;
+    SimulationTracePhaseEnum mPhase;
+};
+
+//! @brief Fixed size ring buffer with trace events from one simulation thread
+//! @details Each buffer is only written by its own thread, and only read after the threads have been joined, so no locking is needed.
+//! When the buffer is full the oldest events are overwritten.
+class HOPSANCORE_DLLAPI SimulationTraceBuffer
+{
+public:
+    SimulationTraceBuffer(const size_t capacity, const ProfilerClockT::time_point &rEpoch, const size_t firstStep, const size_t lastStep, const bool traceComponents);
+
+    //! @brief Sets the current step and returns true if it is inside the traced step window
+    inline bool beginStep(const size_t step)
+    {
+        mCurrentStep = step;
+        return (step >= mFirstStep) && (step <= mLastStep);
+    }
+
+    inline bool tracesComponents() const
+    {
+        return mTraceComponents;
+    }
+
+    //! @brief Records an interval from rBegin until now
+    //! @returns The end time of the interval, to be used as begin time for the next one
+    inline ProfilerClockT::time_point record(const SimulationTracePhaseEnum phase, const ProfilerClockT::time_point &rBegin, const Component *pComponent=0)
+    {
+        const ProfilerClockT::time_point end = ProfilerClockT::now();
+        SimulationTraceEvent &rEvent = mEvents[mNumRecorded % mEvents.size()];
+        rEvent.mpComponent = pComponent;
+        rEvent.mStep = mCurrentStep;
+        rEvent.mBegin = std::chrono::duration_cast<std::chrono::nanoseconds>(rBegin-mEpoch).count();
+        rEvent.mEnd = std::chrono::duration_cast<std::chrono::nanoseconds>(end-mEpoch).count();
+        rEvent.mPhase = phase;
+        ++mNumRecorded;
+        return end;
+    }
+
+    //! @brief Simulates components and records one event per component
+    inline void simulateAndTraceComponents(std::vector<Component*> &rComponents, const double stopT)
+    {
+        ProfilerClockT::time_point t0 = ProfilerClockT::now();
+        for (size_t i=0; i<rComponents.size(); ++i)
+        {
+            rComponents[i]->simulate(stopT);
+            t0 = record(TraceComponent, t0, rComponents[i]);
+        }
+    }
+
+    size_t getNumEvents() const;
+    size_t getNumDropped() const;
+    const SimulationTraceEvent &getEvent(const size_t idx) const;
+
+private:
+    std::vector<SimulationTraceEvent> mEvents;
+    size_t mNumRecorded;
+    size_t mCurrentStep;
+    size_t mFirstStep, mLastStep;
+    bool mTraceComponents;
+    ProfilerClockT::time_point mEpoch;
+};
+
+//! @brief Records a timeline of what each simulation thread does in a window of simulation steps
+//! @details Steps are counted from the start of each multi-threaded simulation call. The recorded timeline can be exported
+//! in the Chrome trace event format, that can be opened in chrome://tracing or Perfetto.
+//! @see ComponentSystem::setTracingEnabled()
+class HOPSANCORE_DLLAPI SimulationTracer
+{
+public:
+    SimulationTracer(const size_t firstStep, const size_t lastStep, const bool traceComponents);
+
+    void prepare(const size_t numThreads, const size_t maxNumComponentsPerThread);
+    size_t getNumThreads() const;
+    SimulationTraceBuffer *getThreadBuffer(const size_t threadIdx);
+    const SimulationTraceBuffer *getThreadBuffer(const size_t threadIdx) const;
+
+    size_t getFirstStep() const;
+    size_t getLastStep() const;
+    bool tracesComponents() const;
+
+    HString toChromeTraceJSON() const;
+    bool writeChromeTrace(const HString &rFilePath) const;
+
+private:
+    std::vector<SimulationTraceBuffer> mThreadBuffers;
+    size_t mFirstStep, mLastStep;
+    bool mTraceComponents;
+};
+
+}
+
+#endif // SIMULATIONTRACER_H
@@ -35,6 +35,7 @@
 #define STRINGUTILITIES_H
 
 #include <sstream>
+#include <string>
 #include <vector>
 #include "HopsanTypes.h"
 
@@ -46,6 +47,7 @@ HString HOPSANCORE_DLLAPI santizeName(const HString &rName);
 bool HOPSANCORE_DLLAPI isNameValid(const HString &rString);
 bool HOPSANCORE_DLLAPI isNameValid(const HString &rString, const HString &rExceptions);
 void HOPSANCORE_DLLAPI splitString(const HString &rString, const char delim, std::vector<HString> &rParts);
+std::string HOPSANCORE_DLLAPI formatString(const char *format, ...);
 
 //! @brief Help function for create a unique name among names from one STL Container
 template<typename ContainerT>
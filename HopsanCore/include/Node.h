@@ -108,6 +108,9 @@ public:
     virtual bool getSignalQuantityModifyable(const size_t dataId=0) const;
 
     void logData(const size_t logSlot);
+    size_t getDataMemoryUsage() const;
+    size_t getLogDataMemoryUsage() const;
+    size_t estimateLogDataMemoryUsage(const size_t nLogSlots) const;
 
     int getNumberOfPortsByType(const int type) const;
     size_t getNumConnectedPorts() const;
@@ -44,6 +44,7 @@
 #include "HopsanEssentials.h"
 #include "CoreUtilities/StringUtilities.h"
 #include "ComponentUtilities/num2string.hpp"
+#include "ComponentUtilities/RandomStream.h"
 #include "Quantities.h"
 
 using namespace std;
@@ -78,11 +79,15 @@ Component::Component()
 
     mInheritTimestep = true;
     mIsDisabled = false;
+    mStateSupport = NoInternalState;
     mTimestep = 0.001;
 
     mpSystemParent = 0;
     mModelHierarchyDepth = 0;
 
+    mMeasuredTime = 0;
+    resetProfiledTime();
+
     mpParameters = new ParameterEvaluatorHandler(this);
 
     mSearchPaths.clear();
@@ -335,6 +340,103 @@ void Component::finalize()
     //Default does nothing
 }
 
+//! @brief Write component internal state to a simulation checkpoint
+//! @ingroup ComponentSimulationFunctions
+//! @details Node data and the component time are saved by the parent system. Override this function in components that
+//! keep state between time steps in member variables or component utilities (filters, integrators, delays), and declare
+//! it with setStateSupport(). Write exactly what restoreState() reads, in the same order.
+//! @param [in,out] rWriter The state writer to append the state to
+void Component::saveState(StateWriter &/*rWriter*/) const
+{
+    //Default does nothing
+}
+
+//! @brief Restore component internal state from a simulation checkpoint, called after initialize
+//! @ingroup ComponentSimulationFunctions
+//! @param [in,out] rReader The state reader, containing only the data written by saveState()
+//! @returns False if the state could not be restored
+bool Component::restoreState(StateReader &/*rReader*/)
+{
+    //Default does nothing
+    return true;
+}
+
+//! @brief Declare how the internal state of this component is handled by simulation checkpoints
+//! @ingroup ComponentSimulationFunctions
+//! @details Call this in configure(). Components that keep state between time steps outside of the nodes should declare
+//! SupportsInternalState if they override saveState() and restoreState(), or LacksInternalState if they do not. Checkpoints
+//! warn about components that lack state support, since a restarted simulation of them will not give the same results.
+//! @param [in] support The state support of this component
+void Component::setStateSupport(const StateSupportEnumT support)
+{
+    mStateSupport = support;
+}
+
+//! @brief Returns how the internal state of this component is handled by simulation checkpoints
+//! @see setStateSupport()
+Component::StateSupportEnumT Component::getStateSupport() const
+{
+    return mStateSupport;
+}
+
+//! @brief Add the size of component internal buffers and lookup data to a memory report
+//! @ingroup ComponentSimulationFunctions
+//! @details Override this function in components that allocate buffers whose size depends on parameters or the timestep,
+//! such as delay lines. If rReport.isEstimate() is true the component has not been initialized yet, the size should then be
+//! estimated from the parameter values and the timestep.
+//! @param [in,out] rReport The report to add the memory usage to
+//! @param [in] timestep The timestep the component will use (or is using)
+void Component::reportMemoryUsage(MemoryReport &/*rReport*/, const double /*timestep*/) const
+{
+    //Default does nothing
+}
+
+//! @brief Add the transfer function of a filter component to a filter bank, so that the parent system can simulate it together with other filters
+//! @ingroup ComponentSimulationFunctions
+//! @details Called by the parent system after initialize. Override this function in signal components whose
+//! simulateOneTimestep() only updates one FirstOrderTransferFunction or SecondOrderTransferFunction with constant
+//! coefficients, from one input variable to one output variable. The component is then not simulated on its own,
+//! the bank updates the transfer function and writes the output instead. Only components that use the timestep of the
+//! parent system are added, since the bank updates each transfer function once per system step.
+//! @param [in,out] rBank The bank to add the transfer function to
+//! @returns True if the component was added, the default returns false
+bool Component::addToFilterBank(FilterBank &/*rBank*/)
+{
+    //Default does nothing
+    return false;
+}
+
+//! @brief Seed a random number stream that is unique to this component
+//! @ingroup ComponentSimulationFunctions
+//! @details The seed is the random seed of the top-level system, see ComponentSystem::setRandomSeed(). The stream id is
+//! derived from the component name and the names of its parent subsystems, so the random numbers do not depend on the
+//! simulation order, the number of threads or on other components. Call this in initialize().
+//! @param [out] rStream The stream to seed
+//! @param [in] rStreamName Optional name to tell several streams in the same component apart
+void Component::seedRandomStream(RandomStream &rStream, const HString &rStreamName)
+{
+    HString fullName = getName();
+    int seed = 0;
+    ComponentSystem *pSystem = getSystemParent();
+    while (pSystem)
+    {
+        if (pSystem->getSystemParent())
+        {
+            fullName = pSystem->getName()+"$"+fullName;
+        }
+        else
+        {
+            seed = pSystem->getRandomSeed();
+        }
+        pSystem = pSystem->getSystemParent();
+    }
+    if (!rStreamName.empty())
+    {
+        fullName += "#"+rStreamName;
+    }
+    rStream.setSeed(uint64_t(seed), RandomStream::streamIdFromName(fullName));
+}
+
 
 //! @brief Set the desired component name
 //! @param [in] name The desired component name
@@ -449,6 +551,14 @@ HopsanEssentials *Component::getHopsanEssentials()
     return mpHopsanEssentials;
 }
 
+//! @brief Set the message handler that receives the messages added by this component
+//! @details By default this is the message handler of the HopsanEssentials instance that created the component
+//! @param [in] pMessageHandler Pointer to the new message handler
+void Component::setMessageHandler(HopsanCoreMessageHandler *pMessageHandler)
+{
+    mpMessageHandler = pMessageHandler;
+}
+
 ///@{
 //! @brief Add (register) a constant parameter to the component
 //! @param [in] rName The name of the constant
@@ -1454,6 +1564,49 @@ double Component::getMeasuredTime() const
 }
 
 
+//! @brief Returns the sum of the wall times measured by the simulation profiler
+//! @see getNumProfiledSamples(), ComponentSystem::setProfilingEnabled()
+double Component::getProfiledTime() const
+{
+    return mProfiledTime;
+}
+
+
+//! @brief Returns the number of calls to simulate() measured by the simulation profiler
+size_t Component::getNumProfiledSamples() const
+{
+    return mNumProfiledSamples;
+}
+
+
+//! @brief Resets the time measured by the simulation profiler
+void Component::resetProfiledTime()
+{
+    mProfiledTime = 0;
+    mNumProfiledSamples = 0;
+    for (int i=0; i<PerformanceCounters::NumCounters; ++i)
+    {
+        mProfiledCounters[i] = 0;
+    }
+    mNumCountedSamples = 0;
+}
+
+
+//! @brief Returns the sum of a hardware counter measured by the simulation profiler
+//! @see getNumCountedSamples(), ComponentSystem::setProfilingEnabled()
+unsigned long long Component::getProfiledCounter(const PerformanceCounters::CounterEnumT counter) const
+{
+    return mProfiledCounters[counter];
+}
+
+
+//! @brief Returns the number of calls to simulate() measured with hardware counters by the simulation profiler
+size_t Component::getNumCountedSamples() const
+{
+    return mNumCountedSamples;
+}
+
+
 //! @brief Write an Debug message, i.e. for debugging purposes.
 //! @ingroup ComponentMessageFunctions
 //! @param [in] rMessage The message string
@@ -1850,6 +2003,16 @@ void Component::getJacobian(double *, double *, double *)
     return;
 }
 
+//! @brief Computes the non-zero Jacobian values for a KinsolSolver with a sparse Jacobian pattern
+//! @param[in] y The current state
+//! @param[in] f The residuals at y
+//! @param[out] values The Jacobian values, in the order of the compressed row pattern given to the solver
+void Component::getSparseJacobian(double *, double *, double *)
+{
+    stopSimulation("getSparseJacobian() is not implemented in component.");
+    return;
+}
+
 double Component::getStateVariableSecondDerivative(int)
 {
     addErrorMessage("getStateVariableSecondDerivative() is not implemented in component.");
@@ -1858,3 +2021,14 @@ double Component::getStateVariableSecondDerivative(int)
     return 0;
 }
 
+//! @brief Computes all state variable derivatives for the NumericalIntegrationSolver in one call
+//! @details Override this instead of reInitializeValuesFromNodes(), solveSystem() and getStateVariableDerivative() to avoid one
+//! virtual call per state variable and solver stage. The function must not modify the state variable vector of the solver.
+//! @param [in] y Array with the state variables
+//! @param [out] dydt Array for the state variable derivatives
+//! @returns False if not implemented, the solver then uses getStateVariableDerivative()
+bool Component::computeDerivatives(const double *, double *)
+{
+    return false;
+}
+
@@ -48,6 +48,12 @@
 #include "CoreUtilities/HmfLoader.h"
 #include "CoreUtilities/NumHopHelper.h"
 #include "CoreUtilities/ConnectionAssistant.h"
+#include "CoreUtilities/SimulationCheckpoint.h"
+#include "CoreUtilities/SimulationProfiler.h"
+#include "CoreUtilities/SimulationTracer.h"
+#include "CoreUtilities/SimulationProgress.h"
+#include "ComponentUtilities/StateSerialization.h"
+#include "ComponentUtilities/FilterBank.h"
 #include "ComponentUtilities/num2string.hpp"
 
 using namespace std;
@@ -122,6 +128,28 @@ public:
 
 };
 
+//! @brief The filter banks of a system, and the order in which simulate() calls signal components and filter banks
+class ComponentSystemFilterBanks {
+public:
+    //! @brief A signal component to simulate, or a filter bank to update if mpComponent is null
+    struct SignalStep
+    {
+        Component *mpComponent;
+        size_t mBankIdx;
+    };
+
+    void clear()
+    {
+        mBanks.clear();
+        mBankComponents.clear();
+        mSignalSteps.clear();
+    }
+
+    std::vector<FilterBank> mBanks;
+    std::vector< std::vector<Component*> > mBankComponents;
+    std::vector<SignalStep> mSignalSteps;
+};
+
 
 //Constructor
 ComponentSystem::ComponentSystem() : Component(), mAliasHandler(this)
@@ -136,6 +164,19 @@ ComponentSystem::ComponentSystem() : Component(), mAliasHandler(this)
     mRequestedNumLogSamples = 0; //This has to be 0 since we want logging to be disabled by default
     mRequestedLogStartTime = 0;
     mpMultiThreadPrivates = new ComponentSystemMultiThreadPrivates;
+    mpFilterBanks = new ComponentSystemFilterBanks;
+    mUseFilterBanks = true;
+    mpCheckpointWriter = 0;
+    mpSimulationTracer = 0;
+    mpSimulationProgress = new SimulationProgress();
+    mProfilingSampleInterval = 0;
+    mNumProfiledSteps = 0;
+    mNumProfiledSampledSteps = 0;
+    mProfileHardwareCounters = false;
+    mProfiledWallTime = 0;
+    mProfiledLoggingTime = 0;
+    mProfiledBarrierTime = 0;
+    mSchedulingSampleInterval = 0;
     mpNumHopHelper = 0;
 
     // Prevent creation of components, system parameters and system ports named "self"
@@ -159,6 +200,10 @@ ComponentSystem::~ComponentSystem()
     // Clear the contents of the system
     clear();
     delete mpMultiThreadPrivates;
+    delete mpFilterBanks;
+    delete mpCheckpointWriter;
+    delete mpSimulationTracer;
+    delete mpSimulationProgress;
 }
 
 void ComponentSystem::configure()
@@ -363,6 +408,7 @@ void ComponentSystem::addComponent(Component *pComponent)
 
         // Set system parent and model system depth hierarchy
         pComponent->setSystemParent(this);
+        pComponent->setMessageHandler(mpMessageHandler);
         pComponent->mModelHierarchyDepth = mModelHierarchyDepth+1; //Set the ModelHierarchyDepth counter
 
         // Go through the components ports and take ownership of any dummy nodes
@@ -397,6 +443,19 @@ void ComponentSystem::addComponent(Component *pComponent)
 }
 
 
+//! @brief Set the message handler of this system and of all its sub components, also components added later will use it
+//! @param [in] pMessageHandler Pointer to the new message handler
+void ComponentSystem::setMessageHandler(HopsanCoreMessageHandler *pMessageHandler)
+{
+    Component::setMessageHandler(pMessageHandler);
+    SubComponentMapT::iterator it;
+    for (it = mSubComponentMap.begin(); it != mSubComponentMap.end(); ++it)
+    {
+        it->second->setMessageHandler(pMessageHandler);
+    }
+}
+
+
 //! @brief Rename a sub component and automatically fix unique names
 void ComponentSystem::renameSubComponent(const HString &rOldName, const HString &rNewName)
 {
@@ -534,6 +593,9 @@ void ComponentSystem::addSubComponentPtrToStorage(Component* pComponent)
 
 void ComponentSystem::removeSubComponentPtrFromStorage(Component* pComponent)
 {
+    // The filter banks may refer to the component, they are set up again in initialize
+    mpFilterBanks->clear();
+
     SubComponentMapT::iterator it = mSubComponentMap.find(pComponent->getName());
     if (it != mSubComponentMap.end())
     {
@@ -938,6 +1000,14 @@ void ComponentSystem::removeSubNode(Node* pNode)
 }
 
 
+//! @brief Determines if a node should have log storage, used when allocating and when estimating log memory
+//! @details If the node is in a read port and if that port is not connected (node only have one connected port)
+//! then logging should be disabled for that node as logging the start value does not make sense
+static bool isNodeLogged(const Node *pNode)
+{
+    return !( (pNode->getNumConnectedPorts() < 2) && (pNode->getNumberOfPortsByType(ReadPortType) == 1) );
+}
+
 //! @brief preAllocates log space (to speed up later access for log writing)
 void ComponentSystem::preAllocateLogSpace()
 {
@@ -967,9 +1037,7 @@ void ComponentSystem::preAllocateLogSpace()
                 // Now try to allocate log memory for each node
                 try
                 {
-                    // If the node is in a read port and if that port is not connected (node only have one connected port)
-                    // Then we should disable logging for that node as logging the start value does not make sense
-                    if ( ((*it)->getNumConnectedPorts() < 2) && ((*it)->getNumberOfPortsByType(ReadPortType) == 1) )
+                    if (!isNodeLogged(*it))
                     {
                         (*it)->setDoLogIfEnabled(false);
                     }
@@ -1007,6 +1075,9 @@ void ComponentSystem::preAllocateLogSpace()
 
 void ComponentSystem::logTimeAndNodes(const size_t simStep)
 {
+    // Called by the simulating thread after every step, so this is where progress is published
+    mpSimulationProgress->publishTime(mTime);
+
     if (mEnableLogData)
     {
         if (mLogTheseTimeSteps[mLogCtr] ==  simStep)
@@ -1025,6 +1096,353 @@ void ComponentSystem::logTimeAndNodes(const size_t simStep)
 }
 
 
+//! @brief Write the complete simulation state of this system to a checkpoint
+//! @details Saves time and step counters, log storage, all node data and the time and internal state of all
+//! sub components (recursively for subsystems). Each sub component state is stored in a named block.
+//! @param [in,out] rWriter The state writer
+void ComponentSystem::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mTime);
+    rWriter.writeSize(mTotalTakenSimulationSteps);
+
+    // Log storage, only the slots that have been used
+    rWriter.writeBool(mEnableLogData);
+    rWriter.writeSize(mnLogSlots);
+    rWriter.writeSize(mLogCtr);
+    if (mEnableLogData)
+    {
+        rWriter.writeDoubles(mTimeStorage.data(), mLogCtr);
+    }
+
+    rWriter.writeSize(mSubNodePtrs.size());
+    for (const Node *pNode : mSubNodePtrs)
+    {
+        rWriter.writeVector(pNode->mDataValues);
+        rWriter.writeBool(pNode->mDoLog);
+        if (mEnableLogData && pNode->mDoLog)
+        {
+            for (size_t l=0; l<mLogCtr; ++l)
+            {
+                rWriter.writeVector(pNode->mDataStorage[l]);
+            }
+        }
+    }
+
+    rWriter.writeSize(mSubComponentMap.size());
+    for (SubComponentMapT::const_iterator it=mSubComponentMap.begin(); it!=mSubComponentMap.end(); ++it)
+    {
+        const Component *pComponent = it->second;
+        rWriter.writeString(pComponent->getName());
+        rWriter.writeDouble(pComponent->mTime);
+        const size_t block = rWriter.beginBlock();
+        pComponent->saveState(rWriter);
+        rWriter.endBlock(block);
+    }
+}
+
+//! @brief Restore the complete simulation state of this system from a checkpoint
+//! @details The system must have been initialized with the same settings as when the state was saved
+//! @param [in,out] rReader The state reader
+//! @returns False if the state does not match this system
+bool ComponentSystem::restoreState(StateReader &rReader)
+{
+    size_t nTakenSteps, nLogSlots, logCtr, nNodes, nComponents;
+    bool enableLogData;
+    double time;
+    bool isOK = rReader.readDouble(time) && rReader.readSize(nTakenSteps);
+    isOK = isOK && rReader.readBool(enableLogData) && rReader.readSize(nLogSlots) && rReader.readSize(logCtr);
+    if (!isOK || (enableLogData != mEnableLogData) || (enableLogData && ((nLogSlots != mnLogSlots) || (logCtr > mTimeStorage.size()))))
+    {
+        addErrorMessage("Checkpoint log settings do not match system: "+getName());
+        return false;
+    }
+    if (mEnableLogData && !rReader.readDoubles(mTimeStorage.data(), logCtr))
+    {
+        return false;
+    }
+
+    if (!rReader.readSize(nNodes) || (nNodes != mSubNodePtrs.size()))
+    {
+        addErrorMessage("Checkpoint nodes do not match system: "+getName());
+        return false;
+    }
+    for (Node *pNode : mSubNodePtrs)
+    {
+        bool doLog;
+        isOK = rReader.readVector(pNode->mDataValues) && rReader.readBool(doLog) && (doLog == pNode->mDoLog);
+        if (isOK && mEnableLogData && doLog)
+        {
+            for (size_t l=0; l<logCtr && isOK; ++l)
+            {
+                isOK = rReader.readVector(pNode->mDataStorage[l]);
+            }
+        }
+        if (!isOK)
+        {
+            addErrorMessage("Checkpoint node data do not match system: "+getName());
+            return false;
+        }
+    }
+
+    if (!rReader.readSize(nComponents) || (nComponents != mSubComponentMap.size()))
+    {
+        addErrorMessage("Checkpoint components do not match system: "+getName());
+        return false;
+    }
+    for (size_t c=0; c<nComponents; ++c)
+    {
+        HString name;
+        double componentTime;
+        StateReader block;
+        if (!rReader.readString(name) || !rReader.readDouble(componentTime) || !rReader.readBlock(block))
+        {
+            return false;
+        }
+        Component *pComponent = getSubComponent(name);
+        if (!pComponent)
+        {
+            addErrorMessage("Checkpoint component: "+name+" does not exist in system: "+getName());
+            return false;
+        }
+        pComponent->mTime = componentTime;
+        if (!pComponent->restoreState(block) || !block.isOk())
+        {
+            addErrorMessage("Failed to restore checkpoint state of component: "+name);
+            return false;
+        }
+    }
+
+    mTime = time;
+    mTotalTakenSimulationSteps = nTakenSteps;
+    mLogCtr = logCtr;
+    return true;
+}
+
+//! @brief Enable periodic checkpoints during simulate()
+//! @details The checkpoint file is replaced by each new checkpoint. Checkpoints are not written by simulateMultiThreaded().
+//! @param [in] rFilePath The checkpoint file
+//! @param [in] stepInterval Write a checkpoint every stepInterval simulation steps (0 = disabled)
+//! @param [in] wallTimeInterval Write a checkpoint every wallTimeInterval seconds of real time (0 = disabled)
+void ComponentSystem::enableCheckpoints(const HString &rFilePath, const size_t stepInterval, const double wallTimeInterval)
+{
+    disableCheckpoints();
+    if ((stepInterval > 0) || (wallTimeInterval > 0))
+    {
+        mpCheckpointWriter = new CheckpointWriter(rFilePath, stepInterval, wallTimeInterval);
+    }
+}
+
+//! @brief Disable periodic checkpoints, waits for any checkpoint being written
+void ComponentSystem::disableCheckpoints()
+{
+    delete mpCheckpointWriter;
+    mpCheckpointWriter = 0;
+}
+
+
+//! @brief Enable or disable profiling of the wall time spent in each component, in this system and all subsystems
+//! @details When enabled, simulate() and simulateMultiThreaded() measure the time of each component call, and the time spent logging
+//! and waiting at thread barriers, in every sampleInterval step. Measurements are reset by initialize().
+//! @param [in] enabled Enable or disable profiling
+//! @param [in] sampleInterval Measure every sampleInterval step, 1 measures all steps but adds more overhead
+//! @param [in] hardwareCounters Also measure hardware performance counters in sampled steps, if available (Linux only)
+//! @see SimulationProfile, PerformanceCounters
+void ComponentSystem::setProfilingEnabled(const bool enabled, const size_t sampleInterval, const bool hardwareCounters)
+{
+    mProfilingSampleInterval = enabled ? std::max(sampleInterval, size_t(1)) : 0;
+    mProfileHardwareCounters = enabled && hardwareCounters;
+    for (SubComponentMapT::iterator it=mSubComponentMap.begin(); it!=mSubComponentMap.end(); ++it)
+    {
+        if (it->second->isComponentSystem())
+        {
+            static_cast<ComponentSystem*>(it->second)->setProfilingEnabled(enabled, sampleInterval, hardwareCounters);
+        }
+    }
+    resetProfiling();
+}
+
+//! @brief Returns the profiling sample interval, 0 if profiling is disabled
+size_t ComponentSystem::getProfilingSampleInterval() const
+{
+    return mProfilingSampleInterval;
+}
+
+//! @brief Returns true if hardware performance counters are measured when profiling
+bool ComponentSystem::getProfilingHardwareCounters() const
+{
+    return mProfileHardwareCounters;
+}
+
+//! @brief Resets all profiling measurements in this system and all subsystems
+void ComponentSystem::resetProfiling()
+{
+    mNumProfiledSteps = 0;
+    mNumProfiledSampledSteps = 0;
+    mProfiledWallTime = 0;
+    mProfiledLoggingTime = 0;
+    mProfiledBarrierTime = 0;
+    for (SubComponentMapT::iterator it=mSubComponentMap.begin(); it!=mSubComponentMap.end(); ++it)
+    {
+        it->second->resetProfiledTime();
+        if (it->second->isComponentSystem())
+        {
+            static_cast<ComponentSystem*>(it->second)->resetProfiling();
+        }
+    }
+}
+
+//! @brief Returns the number of steps taken with profiling enabled
+size_t ComponentSystem::getNumProfiledSteps() const
+{
+    return mNumProfiledSteps;
+}
+
+//! @brief Returns the total wall time spent in simulate() or simulateMultiThreaded() with profiling enabled
+double ComponentSystem::getProfiledWallTime() const
+{
+    return mProfiledWallTime;
+}
+
+//! @brief Returns the estimated total time spent logging data with profiling enabled
+double ComponentSystem::getProfiledLoggingTime() const
+{
+    if (mNumProfiledSampledSteps == 0)
+    {
+        return 0;
+    }
+    return mProfiledLoggingTime*double(mNumProfiledSteps)/double(mNumProfiledSampledSteps);
+}
+
+//! @brief Returns the estimated total time spent waiting at thread barriers with profiling enabled, summed over all threads
+double ComponentSystem::getProfiledBarrierTime() const
+{
+    if (mNumProfiledSampledSteps == 0)
+    {
+        return 0;
+    }
+    return mProfiledBarrierTime*double(mNumProfiledSteps)/double(mNumProfiledSampledSteps);
+}
+
+//! @brief Set how often the busy and barrier wait times of each thread are measured in simulateMultiThreaded()
+//! @details Measuring every step costs a few clock reads per thread and phase, measurements are disabled by default.
+//! @param [in] sampleInterval Measure every N:th step, 0 disables the measurements
+//! @see getSchedulingReport()
+void ComponentSystem::setSchedulingSampleInterval(const size_t sampleInterval)
+{
+    mSchedulingSampleInterval = sampleInterval;
+}
+
+//! @brief Returns how often the scheduling statistics are measured, 0 if disabled
+size_t ComponentSystem::getSchedulingSampleInterval() const
+{
+    return mSchedulingSampleInterval;
+}
+
+//! @brief Returns the load balance of the last call to simulateMultiThreaded()
+//! @details Only the a priori scheduling algorithm is measured, the report is empty for other algorithms or if measurements are disabled
+const SchedulingReport &ComponentSystem::getSchedulingReport() const
+{
+    return mSchedulingReport;
+}
+
+//! @brief Enable recording of a per-thread timeline in a window of steps of simulateMultiThreaded()
+//! @details Only the a priori scheduling algorithm is traced. Steps are counted from the start of each simulateMultiThreaded() call,
+//! and each call replaces the previous recording. Use getSimulationTracer() to export the timeline after the simulation.
+//! @param [in] firstStep The first step to record
+//! @param [in] lastStep The last step to record (inclusive)
+//! @param [in] traceComponents Record each component call, not only the simulation phases and barrier waits
+void ComponentSystem::setTracingEnabled(const size_t firstStep, const size_t lastStep, const bool traceComponents)
+{
+    disableTracing();
+    mpSimulationTracer = new SimulationTracer(firstStep, lastStep, traceComponents);
+}
+
+//! @brief Disable timeline tracing and discard any recorded timeline
+void ComponentSystem::disableTracing()
+{
+    delete mpSimulationTracer;
+    mpSimulationTracer = 0;
+}
+
+//! @brief Returns the simulation tracer, or 0 if tracing is disabled
+SimulationTracer *ComponentSystem::getSimulationTracer()
+{
+    return mpSimulationTracer;
+}
+
+//! @brief Enable or disable batched simulation of filter components, in this system and all subsystems
+//! @details When enabled, initialize() groups filter components that can be simulated together into filter banks, see
+//! Component::addToFilterBank(). The banks are used by simulate(), but not in profiled, multi-threaded or real-time
+//! simulations. Takes effect in the next call to initialize().
+//! @param [in] enabled Enable or disable filter banks
+void ComponentSystem::setFilterBanksEnabled(const bool enabled)
+{
+    mUseFilterBanks = enabled;
+    for (SubComponentMapT::iterator it=mSubComponentMap.begin(); it!=mSubComponentMap.end(); ++it)
+    {
+        if (it->second->isComponentSystem())
+        {
+            static_cast<ComponentSystem*>(it->second)->setFilterBanksEnabled(enabled);
+        }
+    }
+}
+
+//! @brief Returns true if filter components are simulated in filter banks
+bool ComponentSystem::getFilterBanksEnabled() const
+{
+    return mUseFilterBanks;
+}
+
+//! @brief Returns the number of components in this system (not in subsystems) that are simulated in filter banks
+size_t ComponentSystem::getNumFilterBankComponents() const
+{
+    size_t num = 0;
+    for (size_t b=0; b<mpFilterBanks->mBankComponents.size(); ++b)
+    {
+        num += mpFilterBanks->mBankComponents[b].size();
+    }
+    return num;
+}
+
+//! @brief Returns the live progress of the initialization and simulation of this system
+//! @details The progress can be read, or monitored with a periodic callback, from any thread while simulating
+SimulationProgress *ComponentSystem::getSimulationProgress()
+{
+    return mpSimulationProgress;
+}
+
+//! @brief Set the seed of the random number streams of the components in the model
+//! @details The seed is stored as the system parameter "random_seed", so it is saved with the model and can be changed
+//! between simulations. Only the seed of the top-level system is used.
+//! @param [in] seed The seed
+void ComponentSystem::setRandomSeed(const int seed)
+{
+    setOrAddSystemParameter("random_seed", to_hstring(seed), "integer", "Seed for the random number streams of the components");
+}
+
+//! @brief Returns the seed of the random number streams of the components in the model
+//! @returns The value of the "random_seed" system parameter of the top-level system, or 0 if it is not set
+int ComponentSystem::getRandomSeed()
+{
+    ComponentSystem *pTopLevel = this;
+    while (pTopLevel->getSystemParent())
+    {
+        pTopLevel = pTopLevel->getSystemParent();
+    }
+    HString value;
+    if (pTopLevel->hasParameter("random_seed") && pTopLevel->evaluateParameter("random_seed", value, "integer"))
+    {
+        bool isOK;
+        const long int seed = value.toLongInt(&isOK);
+        if (isOK)
+        {
+            return int(seed);
+        }
+    }
+    return 0;
+}
+
+
 //! @brief Rename a system parameter
 bool ComponentSystem::renameParameter(const HString &rOldName, const HString &rNewName)
 {
@@ -1763,6 +2181,101 @@ void ComponentSystem::setupLogSlotsAndTs(const double simStartT, const double si
 }
 
 
+
+//! @brief Estimate the memory a simulation will need, call this before initialize()
+//! @details Node data, log storage, component internal buffers and lookup data are counted for this system and all subsystems,
+//! using the same number of log slots and component timesteps as initialize() would. Parameters are evaluated first.
+//! @param[in] startT Start time of simulation
+//! @param[in] stopT Stop time of simulation
+//! @returns The estimated memory usage, one entry per system
+MemoryReport ComponentSystem::estimateMemoryUsage(const double startT, const double stopT)
+{
+    evaluateParametersRecursively();
+    MemoryReport report(true);
+    addMemoryUsage(report, getName(), startT, stopT, mTimestep, mRequestedNumLogSamples, mRequestedLogStartTime);
+    return report;
+}
+
+//! @brief Get the memory allocated for this system and all subsystems, call this after initialize()
+//! @returns The allocated memory usage, one entry per system
+MemoryReport ComponentSystem::getMemoryUsage() const
+{
+    MemoryReport report(false);
+    addMemoryUsage(report, getName(), 0, 0, mTimestep, mnLogSlots, mRequestedLogStartTime);
+    return report;
+}
+
+//! @brief Add the memory usage of this system to a report, then recurse into subsystems
+//! @details When estimating, the simulation time and log arguments are used to calculate the number of log slots, as subsystems
+//! get their log settings and timestep from the parent system in initialize()
+void ComponentSystem::addMemoryUsage(MemoryReport &rReport, const HString &rName, const double simStartT, const double simStopT,
+                                     const double simTs, const size_t nLogSamples, const double logStartT) const
+{
+    const bool estimate = rReport.isEstimate();
+    rReport.beginSystem(rName);
+
+    // Node data and log storage
+    const size_t nLogSlots = estimate ? limitNumLogSlotsToLogOrSimTimeInterval(simStartT, simStopT, simTs, logStartT, nLogSamples) : mnLogSlots;
+    for (size_t i=0; i<mSubNodePtrs.size(); ++i)
+    {
+        const Node *pNode = mSubNodePtrs[i];
+        rReport.addNodeData(pNode->getDataMemoryUsage());
+        if (!estimate)
+        {
+            rReport.addLogData(pNode->getLogDataMemoryUsage());
+        }
+        else if (isNodeLogged(pNode))
+        {
+            rReport.addLogData(pNode->estimateLogDataMemoryUsage(nLogSlots));
+        }
+    }
+    if (estimate)
+    {
+        rReport.addLogData(nLogSlots*(sizeof(double)+sizeof(size_t)));
+    }
+    else
+    {
+        rReport.addLogData(mTimeStorage.capacity()*sizeof(double)+mLogTheseTimeSteps.capacity()*sizeof(size_t));
+    }
+
+    // Component internal buffers, subsystems are added as separate entries afterwards
+    std::vector<const ComponentSystem*> subsystems;
+    std::vector<double> subsystemTimesteps;
+    SubComponentMapT::const_iterator it;
+    for (it=mSubComponentMap.begin(); it!=mSubComponentMap.end(); ++it)
+    {
+        const Component *pComponent = it->second;
+        if (pComponent->isDisabled())
+        {
+            continue;
+        }
+
+        // Use the timestep that adjustTimestep() will give the component
+        double subTs = pComponent->getTimestep();
+        if (estimate)
+        {
+            subTs = (pComponent->doesInheritTimestep() || (pComponent->mDesiredTimestep <= 0.0)) ? simTs : pComponent->mDesiredTimestep;
+        }
+
+        if (pComponent->isComponentSystem())
+        {
+            subsystems.push_back(static_cast<const ComponentSystem*>(pComponent));
+            subsystemTimesteps.push_back(subTs);
+        }
+        else
+        {
+            pComponent->reportMemoryUsage(rReport, subTs);
+        }
+    }
+
+    for (size_t s=0; s<subsystems.size(); ++s)
+    {
+        const ComponentSystem *pSystem = subsystems[s];
+        pSystem->addMemoryUsage(rReport, rName+"|"+pSystem->getName(), simStartT, simStopT, subsystemTimesteps[s],
+                                estimate ? nLogSamples : pSystem->mnLogSlots, logStartT);
+    }
+}
+
 //! @brief Returns whether or not to keep node values instead of over writing with defaultStartValues
 bool ComponentSystem::keepsValuesAsStartValues()
 {
@@ -2235,6 +2748,13 @@ bool ComponentSystem::initialize(const double startT, const double stopT)
     // Set initial time
     mTime = startT;
     mTotalTakenSimulationSteps=0;
+    mpSimulationProgress->beginInitialize(startT, stopT, mTimestep);
+
+    // Profiling stays enabled, but measurements from previous simulations are cleared
+    if (mProfilingSampleInterval > 0)
+    {
+        resetProfiling();
+    }
 
     // Make sure timestep is not to low
     if (mTimestep < 10*(std::numeric_limits<double>::min)())
@@ -2378,10 +2898,14 @@ bool ComponentSystem::initialize(const double startT, const double stopT)
         return false;
     }
 
+    // Group filter components into filter banks, now that their transfer functions are initialized
+    setupFilterBanks();
+
     // Log the start values
     logTimeAndNodes(mTotalTakenSimulationSteps);
 
     // We seems to have initialized successfully
+    mpSimulationProgress->setPhase(SimulationProgress::Initialized);
     return true;
 }
 
@@ -2389,6 +2913,12 @@ bool ComponentSystem::initialize(const double startT, const double stopT)
 #if defined(HOPSANCORE_USEMULTITHREADING)
 void ComponentSystem::simulateMultiThreaded(const double startT, const double stopT, const size_t nDesiredThreads, const bool noChanges, const ParallelAlgorithmT algorithm)
 {
+    if (!mpSystemParent)
+    {
+        mpSimulationProgress->beginSimulation();
+    }
+    mSchedulingReport.clear();
+
     size_t nThreads = determineActualNumberOfThreads(nDesiredThreads);      //Calculate how many threads to actually use
 
     std::stringstream ss;
@@ -2480,6 +3010,23 @@ void ComponentSystem::simulateMultiThreaded(const double startT, const double st
         BarrierLock *pBarrierLock_Q = new BarrierLock(nThreads);
         BarrierLock *pBarrierLock_N = new BarrierLock(nThreads);
 
+        std::vector<double> profiledWaitTimes(nThreads, 0);        //Per-thread barrier wait time, only used when profiling
+        double profiledLoggingTime = 0;
+        std::vector<SchedulingThreadStatistics> schedulingStatistics(nThreads);     //Written by each thread when it finishes
+        const ProfilerClockT::time_point wallStart = ProfilerClockT::now();
+
+        if(mpSimulationTracer)
+        {
+            size_t maxNumComponents = 0;
+            for(size_t t=0; t<nThreads; ++t)
+            {
+                maxNumComponents = std::max(maxNumComponents, mpMultiThreadPrivates->mSplitSignalVector[t].size()+
+                                                              mpMultiThreadPrivates->mSplitCVector[t].size()+
+                                                              mpMultiThreadPrivates->mSplitQVector[t].size());
+            }
+            mpSimulationTracer->prepare(nThreads, maxNumComponents);
+        }
+
         std::thread *tt = new std::thread[nThreads];
 
         tt[0] = std::thread(simMaster,
@@ -2495,7 +3042,11 @@ void ComponentSystem::simulateMultiThreaded(const double startT, const double st
                             pBarrierLock_S,
                             pBarrierLock_C,
                             pBarrierLock_Q,
-                            pBarrierLock_N);
+                            pBarrierLock_N,
+                            &profiledWaitTimes[0],
+                            &profiledLoggingTime,
+                            mpSimulationTracer ? mpSimulationTracer->getThreadBuffer(0) : 0,
+                            &schedulingStatistics[0]);
 
         for (size_t t=1; t<nThreads; ++t)
         {
@@ -2511,13 +3062,41 @@ void ComponentSystem::simulateMultiThreaded(const double startT, const double st
                                 pBarrierLock_S,
                                 pBarrierLock_C,
                                 pBarrierLock_Q,
-                                pBarrierLock_N);
+                                pBarrierLock_N,
+                                &profiledWaitTimes[t],
+                                mpSimulationTracer ? mpSimulationTracer->getThreadBuffer(t) : 0,
+                                &schedulingStatistics[t]);
         }
 
         for (size_t i = 0; i<nThreads; ++i)                 //Wait for all tasks to finish
         {
             tt[i].join();
         }
+        const double wallTime = profilerSecondsSince(wallStart);
+
+        if(mSchedulingSampleInterval > 0)
+        {
+            for(size_t t=0; t<nThreads; ++t)
+            {
+                schedulingStatistics[t].mNumComponents[SchedulingSignalPhase] = mpMultiThreadPrivates->mSplitSignalVector[t].size();
+                schedulingStatistics[t].mNumComponents[SchedulingCPhase] = mpMultiThreadPrivates->mSplitCVector[t].size();
+                schedulingStatistics[t].mNumComponents[SchedulingQPhase] = mpMultiThreadPrivates->mSplitQVector[t].size();
+            }
+            mSchedulingReport.setThreadStatistics(schedulingStatistics, wallTime);
+            addDebugMessage("Parallel efficiency: "+to_hstring(100.0*mSchedulingReport.getParallelEfficiency())+" %");
+        }
+
+        if(mProfilingSampleInterval > 0)
+        {
+            for (size_t i = 0; i<nThreads; ++i)
+            {
+                mProfiledBarrierTime += profiledWaitTimes[i];
+            }
+            mProfiledLoggingTime += profiledLoggingTime;
+            mNumProfiledSteps += nSteps;
+            mNumProfiledSampledSteps += (nSteps+mProfilingSampleInterval-1)/mProfilingSampleInterval;
+            mProfiledWallTime += wallTime;
+        }
 
         delete[] tt;
         delete(pBarrierLock_S);
@@ -2802,6 +3381,10 @@ void ComponentSystem::simulateMultiThreaded(const double startT, const double st
             logTimeAndNodes(mTotalTakenSimulationSteps);
         }
     }
+    if (!mpSystemParent)
+    {
+        mpSimulationProgress->endSimulation();
+    }
 }
 
 
@@ -3340,6 +3923,179 @@ void ComponentSystem::distributeNodePointers(vector< vector<Node*> > &/*rSplitNo
 //}
 
 
+//! @brief Groups filter components into filter banks, and determines the order of signal components and banks in simulate()
+//! @details A filter component can be moved from its place in the sorted signal component vector, as long as it is not
+//! moved past a component that it shares a node with. Filters that can be moved to a common place, and that are not
+//! connected to each other, are put in the same bank. This includes filters in the same sort level, unless a component
+//! that one of them is connected to is sorted in between. A filter that can not be grouped, or that does not use the
+//! timestep of this system, is simulated as usual.
+void ComponentSystem::setupFilterBanks()
+{
+    mpFilterBanks->clear();
+    if (!mUseFilterBanks)
+    {
+        return;
+    }
+
+    const size_t numComponents = mComponentSignalptrs.size();
+    const size_t noBank = std::numeric_limits<size_t>::max();
+    std::map<Component*, size_t> positions;
+    for (size_t s=0; s<numComponents; ++s)
+    {
+        positions.insert(std::pair<Component*, size_t>(mComponentSignalptrs[s], s));
+    }
+
+    std::vector<size_t> bankIdxs(numComponents, noBank);
+    std::vector<size_t> bankPositions;
+
+    // The open group, its members can be simulated in place of component number first to last (both included)
+    FilterBank openBank;
+    std::vector<size_t> openMembers;
+    size_t openFirst=0, openLast=numComponents;
+
+    for (size_t s=0; s<=numComponents; ++s)
+    {
+        // Find the range this component can be moved within, from the components it shares nodes with
+        size_t first=0, last=numComponents;
+        bool isConnectedToOpen=false;
+        if (s < numComponents)
+        {
+            Component *pComponent = mComponentSignalptrs[s];
+            std::vector<Port*> ports = pComponent->getPortPtrVector();
+            for (size_t p=0; p<ports.size(); ++p)
+            {
+                const Node *pNode = ports[p]->isMultiPort() ? 0 : ports[p]->getNodePtr();
+                if (!pNode)
+                {
+                    continue;
+                }
+                for (size_t c=0; c<pNode->mConnectedPorts.size(); ++c)
+                {
+                    // Components in subsystems are represented by the subsystem in this system
+                    Component *pOther = pNode->mConnectedPorts[c]->getComponent();
+                    while (pOther && (pOther->mpSystemParent != this))
+                    {
+                        pOther = pOther->mpSystemParent;
+                    }
+                    std::map<Component*, size_t>::const_iterator it = pOther ? positions.find(pOther) : positions.end();
+                    if ((it == positions.end()) || (pOther == pComponent))
+                    {
+                        continue;
+                    }
+
+                    const size_t pos = it->second;
+                    if (pos > s)
+                    {
+                        last = std::min(last, pos);
+                    }
+                    else if (bankIdxs[pos] != noBank)
+                    {
+                        first = std::max(first, bankPositions[bankIdxs[pos]]);
+                    }
+                    else
+                    {
+                        first = std::max(first, pos+1);
+                        isConnectedToOpen = isConnectedToOpen || vectorContains<size_t>(openMembers, pos);
+                    }
+                }
+            }
+        }
+
+        // A bank updates each filter once per system step, components with their own timestep are simulated as usual
+        const bool canBank = (s < numComponents) && (mComponentSignalptrs[s]->getTimestep() == mTimestep);
+        const bool fitsOpen = canBank && !openMembers.empty() && !isConnectedToOpen &&
+                              (std::max(first, openFirst) <= std::min(last, openLast));
+        FilterBank newBank;
+        if (fitsOpen && mComponentSignalptrs[s]->addToFilterBank(openBank))
+        {
+            openMembers.push_back(s);
+            openFirst = std::max(first, openFirst);
+            openLast = std::min(last, openLast);
+        }
+        else if ((s == numComponents) || (canBank && mComponentSignalptrs[s]->addToFilterBank(newBank)))
+        {
+            // Close the open group, it is only worth a bank if it has more than one member
+            if (openMembers.size() > 1)
+            {
+                for (size_t m=0; m<openMembers.size(); ++m)
+                {
+                    bankIdxs[openMembers[m]] = mpFilterBanks->mBanks.size();
+                }
+                if (isConnectedToOpen)
+                {
+                    first = std::max(first, openFirst);
+                }
+                mpFilterBanks->mBanks.push_back(openBank);
+                bankPositions.push_back(openFirst);
+            }
+            openBank = newBank;
+            openMembers.assign(1, s);
+            openFirst = first;
+            openLast = last;
+        }
+    }
+
+    // Banks are updated just before the component at their position, banks at the same position in the order they were created
+    std::multimap<size_t, size_t> banksAtPositions;
+    for (size_t b=0; b<bankPositions.size(); ++b)
+    {
+        banksAtPositions.insert(std::pair<size_t, size_t>(bankPositions[b], b));
+    }
+    size_t numBanked=0;
+    mpFilterBanks->mBankComponents.resize(mpFilterBanks->mBanks.size());
+    std::multimap<size_t, size_t>::const_iterator bit = banksAtPositions.begin();
+    for (size_t s=0; s<numComponents; ++s)
+    {
+        for (; (bit != banksAtPositions.end()) && (bit->first == s); ++bit)
+        {
+            ComponentSystemFilterBanks::SignalStep step = {0, bit->second};
+            mpFilterBanks->mSignalSteps.push_back(step);
+        }
+        if (bankIdxs[s] == noBank)
+        {
+            ComponentSystemFilterBanks::SignalStep step = {mComponentSignalptrs[s], 0};
+            mpFilterBanks->mSignalSteps.push_back(step);
+        }
+        else
+        {
+            mpFilterBanks->mBankComponents[bankIdxs[s]].push_back(mComponentSignalptrs[s]);
+            ++numBanked;
+        }
+    }
+
+    if (mpFilterBanks->mBanks.empty())
+    {
+        mpFilterBanks->clear();
+    }
+    else
+    {
+        addDebugMessage("Simulating "+to_hstring(numBanked)+" filter components in "+to_hstring(mpFilterBanks->mBanks.size())+" filter banks");
+    }
+}
+
+//! @brief Copy the states of the filter components into the filter banks, before simulating with the banks
+void ComponentSystem::loadFilterBankStates()
+{
+    for (size_t b=0; b<mpFilterBanks->mBanks.size(); ++b)
+    {
+        mpFilterBanks->mBanks[b].loadStates();
+    }
+}
+
+//! @brief Copy the states from the filter banks back to the filter components, and update the time of the components
+void ComponentSystem::storeFilterBankStates()
+{
+    for (size_t b=0; b<mpFilterBanks->mBanks.size(); ++b)
+    {
+        mpFilterBanks->mBanks[b].storeStates();
+        for (size_t c=0; c<mpFilterBanks->mBankComponents[b].size(); ++c)
+        {
+            mpFilterBanks->mBankComponents[b][c]->mTime = mTime;
+        }
+    }
+}
+
+
 //! @brief Used for initialization in exported FMUs
 //! @details Calls simulateOneTimestep() for each component in the system. Time variable is not increased.
 void ComponentSystem::simulateOnceWithoutIncreasingTime()
@@ -3367,9 +4123,33 @@ void ComponentSystem::simulateOnceWithoutIncreasingTime()
 //! @param[in] stopT Simulate from current time until stop time
 void ComponentSystem::simulate(const double stopT)
 {
+    // Only the top-level system measures progress, subsystems are simulated one step at a time by their parent
+    if (!mpSystemParent)
+    {
+        mpSimulationProgress->beginSimulation();
+    }
+
     // Round to nearest, we may not get exactly the stop time that we want
     size_t numSimulationSteps = calcNumSimSteps(mTime, stopT); //Here mTime is the last time step since it is not updated yet
 
+    // Profiled simulation is kept in a separate loop so that normal simulation is unaffected
+    if (mProfilingSampleInterval > 0)
+    {
+        simulateProfiled(numSimulationSteps);
+        if (!mpSystemParent)
+        {
+            mpSimulationProgress->endSimulation();
+        }
+        return;
+    }
+
+    // Filter banks keep the filter states while simulating, they are stored back in the components afterwards
+    const bool useFilterBanks = !mpFilterBanks->mSignalSteps.empty();
+    if (useFilterBanks)
+    {
+        loadFilterBankStates();
+    }
+
     //Simulate
     for (size_t i=0; i<numSimulationSteps; ++i)
     {
@@ -3382,9 +4162,27 @@ void ComponentSystem::simulate(const double stopT)
 
         //! @todo maybe use iterators instead
         //Signal components
-        for (size_t s=0; s < mComponentSignalptrs.size(); ++s)
+        if (useFilterBanks)
         {
-            mComponentSignalptrs[s]->simulate(mTime);
+            for (size_t s=0; s < mpFilterBanks->mSignalSteps.size(); ++s)
+            {
+                const ComponentSystemFilterBanks::SignalStep &rStep = mpFilterBanks->mSignalSteps[s];
+                if (rStep.mpComponent)
+                {
+                    rStep.mpComponent->simulate(mTime);
+                }
+                else
+                {
+                    mpFilterBanks->mBanks[rStep.mBankIdx].update();
+                }
+            }
+        }
+        else
+        {
+            for (size_t s=0; s < mComponentSignalptrs.size(); ++s)
+            {
+                mComponentSignalptrs[s]->simulate(mTime);
+            }
         }
 
         //C components
@@ -3402,7 +4200,88 @@ void ComponentSystem::simulate(const double stopT)
         ++mTotalTakenSimulationSteps;
 
         logTimeAndNodes(mTotalTakenSimulationSteps);
+
+        if (mpCheckpointWriter && mpCheckpointWriter->isDue(mTotalTakenSimulationSteps))
+        {
+            if (useFilterBanks)
+            {
+                storeFilterBankStates();
+            }
+            mpCheckpointWriter->write(this);
+        }
+    }
+
+    if (useFilterBanks)
+    {
+        storeFilterBankStates();
     }
+    if (!mpSystemParent)
+    {
+        mpSimulationProgress->endSimulation();
+    }
+}
+
+
+//! @brief Simulates a number of steps while measuring the time of component calls and logging in every mProfilingSampleInterval step
+//! @param [in] numSimulationSteps Number of steps to simulate
+void ComponentSystem::simulateProfiled(const size_t numSimulationSteps)
+{
+    const ProfilerClockT::time_point start = ProfilerClockT::now();
+    const PerformanceCounters *pCounters = mProfileHardwareCounters ? PerformanceCounters::getThreadInstance() : 0;
+
+    for (size_t i=0; i<numSimulationSteps; ++i)
+    {
+        if (mStopSimulation) {
+            break;
+        }
+
+        mTime += mTimestep;
+
+        const bool sample = ((mNumProfiledSteps % mProfilingSampleInterval) == 0);
+        if (sample)
+        {
+            simulateAndProfileComponents(mComponentSignalptrs, mTime, pCounters);
+            simulateAndProfileComponents(mComponentCptrs, mTime, pCounters);
+            simulateAndProfileComponents(mComponentQptrs, mTime, pCounters);
+        }
+        else
+        {
+            for (size_t s=0; s < mComponentSignalptrs.size(); ++s)
+            {
+                mComponentSignalptrs[s]->simulate(mTime);
+            }
+            for (size_t c=0; c < mComponentCptrs.size(); ++c)
+            {
+                mComponentCptrs[c]->simulate(mTime);
+            }
+            for (size_t q=0; q < mComponentQptrs.size(); ++q)
+            {
+                mComponentQptrs[q]->simulate(mTime);
+            }
+        }
+
+        ++mTotalTakenSimulationSteps;
+        ++mNumProfiledSteps;
+
+        if (sample)
+        {
+            const ProfilerClockT::time_point logStart = ProfilerClockT::now();
+            logTimeAndNodes(mTotalTakenSimulationSteps);
+            mProfiledLoggingTime += profilerSecondsSince(logStart);
+            ++mNumProfiledSampledSteps;
+        }
+        else
+        {
+            logTimeAndNodes(mTotalTakenSimulationSteps);
+        }
+
+        if (mpCheckpointWriter && mpCheckpointWriter->isDue(mTotalTakenSimulationSteps))
+        {
+            mpCheckpointWriter->write(this);
+        }
+    }
+
+    mProfiledWallTime += profilerSecondsSince(start);
 }
 
 bool ComponentSystem::startRealtimeSimulation(double realTimeFactor)
@@ -3421,6 +4300,13 @@ bool ComponentSystem::startRealtimeSimulation(double realTimeFactor)
 //! @brief Finalizes a system component and all its contained components after a simulation.
 void ComponentSystem::finalize()
 {
+    mpSimulationProgress->setPhase(SimulationProgress::Finalizing);
+
+    if (mpCheckpointWriter)
+    {
+        mpCheckpointWriter->waitForPendingWrite();
+    }
+
     //Finalize
     //Signal components
     for (size_t s=0; s < mComponentSignalptrs.size(); ++s)
@@ -3442,6 +4328,8 @@ void ComponentSystem::finalize()
 
     //loadStartValuesFromSimulation();
 
+    mpFilterBanks->clear();
+
     //Move disabled components back to their original vectors
     for(size_t i=0; i<mDisabledCptrs.size(); ++i)
     {
@@ -3458,6 +4346,8 @@ void ComponentSystem::finalize()
         mComponentSignalptrs.push_back(mDisabledSptrs.at(i));
     }
     mDisabledSptrs.clear();
+
+    mpSimulationProgress->setPhase(mStopSimulation ? SimulationProgress::Aborted : SimulationProgress::Finished);
 }
 
 ////! @brief This function will set the number of log data slots for preallocation and logDt based on a skip factor to the sample time
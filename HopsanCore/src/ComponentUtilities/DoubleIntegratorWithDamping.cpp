@@ -104,3 +104,31 @@ double DoubleIntegratorWithDamping::valueSecond()
 {
     return mDelayY;
 }
+
+//! @brief Write the internal state to a checkpoint
+void DoubleIntegratorWithDamping::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mDelayU);
+    rWriter.writeDouble(mDelayY);
+    rWriter.writeDouble(mDelaySY);
+    rWriter.writeDouble(mDelayUbackup);
+    rWriter.writeDouble(mDelayYbackup);
+    rWriter.writeDouble(mDelaySYbackup);
+    rWriter.writeDouble(mTimeStep);
+    rWriter.writeDouble(mW0);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool DoubleIntegratorWithDamping::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mDelayU);
+    ok = ok && rReader.readDouble(mDelayY);
+    ok = ok && rReader.readDouble(mDelaySY);
+    ok = ok && rReader.readDouble(mDelayUbackup);
+    ok = ok && rReader.readDouble(mDelayYbackup);
+    ok = ok && rReader.readDouble(mDelaySYbackup);
+    ok = ok && rReader.readDouble(mTimeStep);
+    ok = ok && rReader.readDouble(mW0);
+    return ok;
+}
@@ -171,3 +171,37 @@ double DoubleIntegratorWithDampingAndCoulombFriction::valueSecond()
 {
     return mDelayY;
 }
+
+//! @brief Write the internal state to a checkpoint
+void DoubleIntegratorWithDampingAndCoulombFriction::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mDelayU);
+    rWriter.writeDouble(mDelayY);
+    rWriter.writeDouble(mDelaySY);
+    rWriter.writeDouble(mDelayUbackup);
+    rWriter.writeDouble(mDelayYbackup);
+    rWriter.writeDouble(mDelaySYbackup);
+    rWriter.writeDouble(mTimeStep);
+    rWriter.writeDouble(mW0);
+    rWriter.writeDouble(mUs);
+    rWriter.writeDouble(mUk);
+    rWriter.writeInt(movement);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool DoubleIntegratorWithDampingAndCoulombFriction::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mDelayU);
+    ok = ok && rReader.readDouble(mDelayY);
+    ok = ok && rReader.readDouble(mDelaySY);
+    ok = ok && rReader.readDouble(mDelayUbackup);
+    ok = ok && rReader.readDouble(mDelayYbackup);
+    ok = ok && rReader.readDouble(mDelaySYbackup);
+    ok = ok && rReader.readDouble(mTimeStep);
+    ok = ok && rReader.readDouble(mW0);
+    ok = ok && rReader.readDouble(mUs);
+    ok = ok && rReader.readDouble(mUk);
+    ok = ok && rReader.readInt(movement);
+    return ok;
+}
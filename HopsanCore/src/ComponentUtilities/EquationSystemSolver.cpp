@@ -33,6 +33,7 @@
 
 #include "ComponentUtilities/EquationSystemSolver.h"
 #include "ComponentUtilities/ludcmp.h"
+#include "ComponentUtilities/SparseLU.h"
 #include "CoreUtilities/HopsanCoreMessageHandler.h"
 #include "Component.h"
 #include "ComponentUtilities/matrix.h"
@@ -44,12 +45,14 @@
 #include "nvector/nvector_serial.h"
 #include "sunmatrix/sunmatrix_dense.h"
 #include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_sparse.h"
 
 #include <cstring>
 #include <stdlib.h>
 #include <math.h>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 using namespace hopsan;
 
@@ -184,16 +187,24 @@ void EquationSystemSolver::solve()
 
 
 //! @brief Constructor for solver utility using numerical integration methods
+//! @details The parent component can provide all state variable derivatives at once by overriding Component::computeDerivatives(),
+//! otherwise the state variables are written to pStateVars and the derivatives are read one at a time with
+//! Component::getStateVariableDerivative() after Component::reInitializeValuesFromNodes() and Component::solveSystem().
 //! @param pParentComponent Pointer to parent component
 //! @param pStateVars Pointer to vector with state variables
-//! @param tolerance Tolerance (for Newton-Rhapson with implicit methods)
-//! @param maxIter Maximum number of iterations with Newton-Rhapson
+//! @param tolerance Tolerance (for Newton-Rhapson with implicit methods, and relative and absolute error tolerance for adaptive sub-stepping)
+//! @param maxIter Maximum number of iterations with Newton-Rhapson, and maximum number of sub-steps per time step with adaptive sub-stepping
 NumericalIntegrationSolver::NumericalIntegrationSolver(Component *pParentComponent, std::vector<double> *pStateVars, double tolerance, size_t maxIter)
 {
     mpParentComponent = pParentComponent;
     mTimeStep = mpParentComponent->getTimestep();
     mpStateVars = pStateVars;
     mnStateVars = pStateVars->size();
+    mDerivativeInterface = UnknownInterface;
+    mStages.resize(10*mnStateVars);
+    mSubStepSize = 0;
+    mNumSubSteps = 0;
+    mNumRejectedSubSteps = 0;
     mTolerance = tolerance;
     mMaxIter = maxIter;
 }
@@ -209,6 +220,7 @@ const std::vector<HString> NumericalIntegrationSolver::getAvailableSolverTypes()
     availableSolvers.push_back(HString("Dormand-Prince"));
     availableSolvers.push_back(HString("Backward Euler"));
     availableSolvers.push_back(HString("Trapezoid Rule"));
+    availableSolvers.push_back(HString("Dormand-Prince (adaptive)"));
     return availableSolvers;
 }
 
@@ -242,6 +254,9 @@ void NumericalIntegrationSolver::solve(const int solverType)
     case 5:
         solveTrapezoidRule();
         break;
+    case 6:
+        solveDormandPrinceAdaptive();
+        break;
     default:
         mpParentComponent->addErrorMessage("Unknown solver type!");
         mpParentComponent->stopSimulation();
@@ -249,89 +264,139 @@ void NumericalIntegrationSolver::solve(const int solverType)
 }
 
 
-//! @brief Solves a system using forward Euler method
-void NumericalIntegrationSolver::solveForwardEuler()
+//! @brief Returns stage buffer k, 0-6 are derivative stages, 7 the original, 8 intermediate and 9 the new state variables
+inline double *NumericalIntegrationSolver::stage(const size_t k)
 {
+    return &mStages[k*mnStateVars];
+}
+
+
+//! @brief Evaluates the state variable derivatives for the given state variables
+void NumericalIntegrationSolver::evaluateDerivatives(const double *pStateVars, double *pDerivatives)
+{
+    if(mDerivativeInterface != PerStateInterface)
+    {
+        if(mpParentComponent->computeDerivatives(pStateVars, pDerivatives))
+        {
+            mDerivativeInterface = BulkInterface;
+            return;
+        }
+        mDerivativeInterface = PerStateInterface;
+    }
+
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*mpParentComponent->getStateVariableDerivative(i);
+        (*mpStateVars)[i] = pStateVars[i];
     }
     mpParentComponent->reInitializeValuesFromNodes();
     mpParentComponent->solveSystem();
+    for(int i=0; i<mnStateVars; ++i)
+    {
+        pDerivatives[i] = mpParentComponent->getStateVariableDerivative(i);
+    }
 }
 
 
-//! @brief Solves a system using midpoint method
-void NumericalIntegrationSolver::solveMidpointMethod()
+//! @brief Evaluates the state variable derivatives for the current state variables
+//! @details With the per-state interface the component is assumed to already be solved for the current state variables
+void NumericalIntegrationSolver::evaluateCurrentDerivatives(double *pDerivatives)
 {
-    std::vector<double> k1, k2;
-    k1.resize(mnStateVars);
-    k2.resize(mnStateVars);
+    if(mDerivativeInterface != PerStateInterface)
+    {
+        if(mpParentComponent->computeDerivatives(mpStateVars->data(), pDerivatives))
+        {
+            mDerivativeInterface = BulkInterface;
+            return;
+        }
+        mDerivativeInterface = PerStateInterface;
+    }
 
-    std::vector<double> orgStateVars;
-    orgStateVars.resize(mnStateVars);
+    for(int i=0; i<mnStateVars; ++i)
+    {
+        pDerivatives[i] = mpParentComponent->getStateVariableDerivative(i);
+    }
+}
 
-    orgStateVars= *mpStateVars;
+
+//! @brief Stores the new state variables, and solves the component for them when the per-state interface is used
+void NumericalIntegrationSolver::setSolution(const double *pStateVars)
+{
     for(int i=0; i<mnStateVars; ++i)
     {
-        k1[i] = mpParentComponent->getStateVariableDerivative(i);
+        (*mpStateVars)[i] = pStateVars[i];
+    }
+    if(mDerivativeInterface == PerStateInterface)
+    {
+        mpParentComponent->reInitializeValuesFromNodes();
+        mpParentComponent->solveSystem();
     }
+}
+
+
+//! @brief Solves a system using forward Euler method
+void NumericalIntegrationSolver::solveForwardEuler()
+{
+    double *k1 = stage(0), *y1 = stage(9);
+    evaluateCurrentDerivatives(k1);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/2.0*k1[i];
+        y1[i] = (*mpStateVars)[i] + mTimeStep*k1[i];
     }
-    mpParentComponent->reInitializeValuesFromNodes();
-    mpParentComponent->solveSystem();
+    setSolution(y1);
+}
+
+
+//! @brief Solves a system using midpoint method
+void NumericalIntegrationSolver::solveMidpointMethod()
+{
+    double *k1 = stage(0), *k2 = stage(1);
+    double *y0 = stage(7), *y = stage(8), *y1 = stage(9);
+
     for(int i=0; i<mnStateVars; ++i)
     {
-        k2[i] = mpParentComponent->getStateVariableDerivative(i);
+        y0[i] = (*mpStateVars)[i];
     }
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
+    evaluateCurrentDerivatives(k1);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*k2[i];
+        y[i] = y0[i] + mTimeStep/2.0*k1[i];
     }
-    mpParentComponent->solveSystem();
+    evaluateDerivatives(y, k2);
+    for(int i=0; i<mnStateVars; ++i)
+    {
+        y1[i] = y0[i] + mTimeStep*k2[i];
+    }
+    setSolution(y1);
 }
 
 
 //! @brief Solves a system using implicit Euler
 void NumericalIntegrationSolver::solveBackwardEuler()
 {
-    std::vector<double> yorg;
-    yorg.resize(mnStateVars);
-    yorg= *mpStateVars;
-
-    std::vector<double> y0;
-    y0.resize(mnStateVars);
-
-    std::vector<double> y1;
-    y1.resize(mnStateVars);
+    double *d = stage(0);
+    double *yorg = stage(7), *y0 = stage(8), *y1 = stage(9);
 
     for(int i=0; i<mnStateVars; ++i)
     {
-       y0[i] = yorg[i] + mTimeStep*mpParentComponent->getStateVariableDerivative(i);
+        yorg[i] = (*mpStateVars)[i];
+    }
+    evaluateCurrentDerivatives(d);
+    for(int i=0; i<mnStateVars; ++i)
+    {
+       y0[i] = yorg[i] + mTimeStep*d[i];
+       y1[i] = y0[i];
     }
-    mpParentComponent->reInitializeValuesFromNodes();
-    mpParentComponent->solveSystem();
 
     bool doBreak = false;
     size_t i;
     for(i=0; i<mMaxIter; ++i)
     {
-        (*mpStateVars) = y0;
-        for(int j=0; j<mnStateVars; ++j)
-        {
-            y1[j] = yorg[j] + mTimeStep*mpParentComponent->getStateVariableDerivative(j);
-        }
-        mpParentComponent->reInitializeValuesFromNodes();
-        mpParentComponent->solveSystem();
-
+        evaluateDerivatives(y0, d);
         doBreak = true;
         for(int j=0; j<mnStateVars; ++j)
         {
-            if(fabs( fabs(y1[j]-y0[j])/y0[j] ) > mTolerance)
+            y1[j] = yorg[j] + mTimeStep*d[j];
+            if(fabs(y1[j]-y0[j]) > mTolerance*fabs(y0[j]))
             {
                 doBreak = false;
             }
@@ -339,7 +404,7 @@ void NumericalIntegrationSolver::solveBackwardEuler()
 
         if(doBreak) break;
 
-        y0 = y1;
+        std::swap(y0, y1);
     }
     if(!doBreak)
     {
@@ -348,55 +413,38 @@ void NumericalIntegrationSolver::solveBackwardEuler()
         mpParentComponent->addWarningMessage(ss.str().c_str());
     }
 
-    (*mpStateVars) = y1;
+    setSolution(y1);
 }
 
 
 //! @brief Solves a system using trapezoid rule of integration
 void NumericalIntegrationSolver::solveTrapezoidRule()
 {
-    //Store original state variables = y(t)
-    std::vector<double> yorg;
-    yorg.resize(mnStateVars);
-    yorg= *mpStateVars;
+    double *dorg = stage(0), *d = stage(1);
+    double *yorg = stage(7), *y0 = stage(8), *y1 = stage(9);
 
-    //Store original state variable derivatives = f(t,y(t))
-    std::vector<double> dorg;
-    dorg.resize(mnStateVars);
+    //Store original state variables = y(t) and their derivatives = f(t,y(t))
     for(int i=0; i<mnStateVars; ++i)
     {
-        dorg[i] = mpParentComponent->getStateVariableDerivative(i);
+        yorg[i] = (*mpStateVars)[i];
     }
-
-    std::vector<double> y0;
-    y0.resize(mnStateVars);
-
-    std::vector<double> y1;
-    y1.resize(mnStateVars);
-
+    evaluateCurrentDerivatives(dorg);
     for(int i=0; i<mnStateVars; ++i)
     {
-        y0[i] = yorg[i] + 0.5*mTimeStep*(dorg[i] + mpParentComponent->getStateVariableDerivative(i));
+        y0[i] = yorg[i] + mTimeStep*dorg[i];
+        y1[i] = y0[i];
     }
-    mpParentComponent->reInitializeValuesFromNodes();
-    mpParentComponent->solveSystem();
 
     bool doBreak=true;
     size_t i;
     for(i=0; i<mMaxIter; ++i)
     {
-        (*mpStateVars) = y0;
-        for(int j=0; j<mnStateVars; ++j)
-        {
-            y1[j] = yorg[j] + 0.5*mTimeStep*(dorg[j] + mpParentComponent->getStateVariableDerivative(j));
-        }
-        mpParentComponent->reInitializeValuesFromNodes();
-        mpParentComponent->solveSystem();
-
+        evaluateDerivatives(y0, d);
         doBreak = true;
         for(int j=0; j<mnStateVars; ++j)
         {
-            if(fabs( fabs(y1[j]-y0[j])/y0[j] ) > mTolerance)
+            y1[j] = yorg[j] + 0.5*mTimeStep*(dorg[j] + d[j]);
+            if(fabs(y1[j]-y0[j]) > mTolerance*fabs(y0[j]))
             {
                 doBreak = false;
             }
@@ -404,7 +452,7 @@ void NumericalIntegrationSolver::solveTrapezoidRule()
 
         if(doBreak) break;
 
-        y0 = y1;
+        std::swap(y0, y1);
     }
     if(!doBreak)
     {
@@ -413,156 +461,268 @@ void NumericalIntegrationSolver::solveTrapezoidRule()
         mpParentComponent->addWarningMessage(ss.str().c_str());
     }
 
-    (*mpStateVars) = y1;
+    setSolution(y1);
 }
 
 
 //! @brief Solves a system using Runge-Kutta (RK4)
 void NumericalIntegrationSolver::solveRungeKutta()
 {
-    std::vector<double> k1, k2, k3, k4;
-    k1.resize(mnStateVars);
-    k2.resize(mnStateVars);
-    k3.resize(mnStateVars);
-    k4.resize(mnStateVars);
+    double *k1 = stage(0), *k2 = stage(1), *k3 = stage(2), *k4 = stage(3);
+    double *y0 = stage(7), *y = stage(8), *y1 = stage(9);
+    const double h = mTimeStep;
 
-    std::vector<double> orgStateVars;
-    orgStateVars.resize(mnStateVars);
-
-    orgStateVars= *mpStateVars;
-    for(int i=0; i<mnStateVars; ++i)
-    {
-        k1[i] = mpParentComponent->getStateVariableDerivative(i);
-    }
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/2.0*k1[i];
+        y0[i] = (*mpStateVars)[i];
     }
-    mpParentComponent->reInitializeValuesFromNodes();
-    mpParentComponent->solveSystem();
+    evaluateCurrentDerivatives(k1);
     for(int i=0; i<mnStateVars; ++i)
     {
-        k2[i] = mpParentComponent->getStateVariableDerivative(i);
+        y[i] = y0[i] + h/2.0*k1[i];
     }
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
+    evaluateDerivatives(y, k2);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/2.0*k2[i];
+        y[i] = y0[i] + h/2.0*k2[i];
     }
-    mpParentComponent->solveSystem();
+    evaluateDerivatives(y, k3);
     for(int i=0; i<mnStateVars; ++i)
     {
-        k3[i] = mpParentComponent->getStateVariableDerivative(i);
+        y[i] = y0[i] + h*k3[i];
     }
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
+    evaluateDerivatives(y, k4);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*k3[i];
+        y1[i] = y0[i] + h/6.0*(k1[i]+2.0*k2[i]+2.0*k3[i]+k4[i]);
     }
-    mpParentComponent->solveSystem();
-    for(int i=0; i<mnStateVars; ++i)
-    {
-        k4[i] = mpParentComponent->getStateVariableDerivative(i);
-    }
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
-    for(int i=0; i<mnStateVars; ++i)
-    {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/6.0*(k1[i]+2.0*k2[i]+2.0*k3[i]+k4[i]);
-    }
-    mpParentComponent->solveSystem();
+    setSolution(y1);
 }
 
 
 //! @brief Solves a system using Dormand-Prince
 void NumericalIntegrationSolver::solveDormandPrince()
 {
-    std::vector<double> k1, k2, k3, k4, k5, k6;
-    k1.resize(mnStateVars);
-    k2.resize(mnStateVars);
-    k3.resize(mnStateVars);
-    k4.resize(mnStateVars);
-    k5.resize(mnStateVars);
-    k6.resize(mnStateVars);
-
-    std::vector<double> orgStateVars;
-    orgStateVars.resize(mnStateVars);
+    double *k1 = stage(0), *k2 = stage(1), *k3 = stage(2), *k4 = stage(3), *k5 = stage(4), *k6 = stage(5);
+    double *y0 = stage(7), *y = stage(8), *y1 = stage(9);
+    const double h = mTimeStep;
 
-    orgStateVars= *mpStateVars;
     for(int i=0; i<mnStateVars; ++i)
     {
-        k1[i] = mpParentComponent->getStateVariableDerivative(i);
+        y0[i] = (*mpStateVars)[i];
     }
-
+    evaluateCurrentDerivatives(k1);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/5.0*k1[i];
+        y[i] = y0[i] + h/5.0*k1[i];
     }
-    mpParentComponent->reInitializeValuesFromNodes();
-    mpParentComponent->solveSystem();
+    evaluateDerivatives(y, k2);
     for(int i=0; i<mnStateVars; ++i)
     {
-        k2[i] = mpParentComponent->getStateVariableDerivative(i);
+        y[i] = y0[i] + h/40.0*(3*k1[i] + 9*k2[i]);
     }
-
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
+    evaluateDerivatives(y, k3);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep/40.0*(3*k1[i] + 9*k2[i]);
+        y[i] = y0[i] + h*(44.0/45.0*k1[i] - 56.0/15.0*k2[i] + 32.0/9.0*k3[i]);
     }
-    mpParentComponent->solveSystem();
+    evaluateDerivatives(y, k4);
     for(int i=0; i<mnStateVars; ++i)
     {
-        k3[i] = mpParentComponent->getStateVariableDerivative(i);
+        y[i] = y0[i] + h*(19372.0/6561.0*k1[i] - 25360.0/2187.0*k2[i] + 64448.0/6561.0*k3[i] - 212.0/729.0*k4[i]);
     }
-
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
+    evaluateDerivatives(y, k5);
     for(int i=0; i<mnStateVars; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*(44.0/45.0*k1[i] - 56.0/15.0*k2[i] + 32.0/9.0*k3[i]);
+        y[i] = y0[i] + h*(9017.0/3168.0*k1[i] -  355.0/33.0*k2[i] + 46732.0/5247.0*k3[i] + 49.0/176.0*k4[i] - 5103.0/18656.0*k5[i]);
     }
-    mpParentComponent->solveSystem();
+    evaluateDerivatives(y, k6);
     for(int i=0; i<mnStateVars; ++i)
     {
-        k4[i] = mpParentComponent->getStateVariableDerivative(i);
+        y1[i] = y0[i] + h*(35.0/384.0*k1[i] + 500.0/1113.0*k3[i] + 125.0/192.0*k4[i] - 2187.0/6784.0*k5[i] + 11.0/84.0*k6[i]);
     }
+    setSolution(y1);
+}
 
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
-    for(int i=0; i<mnStateVars; ++i)
+
+//! @brief Solves a system using Dormand-Prince with adaptive sub-steps within the time step
+//! @details The step size is controlled by the embedded fourth order error estimate, with the tolerance used as both relative
+//! and absolute error tolerance. The last sub-step size is reused as the first guess in the next time step. The input variables
+//! of the component are held constant during the time step. Use getDenseOutput() to get the state variables at any time within
+//! the time step.
+void NumericalIntegrationSolver::solveDormandPrinceAdaptive()
+{
+    // Coefficients of the error estimate and the continuous extension (Hairer, Norsett and Wanner)
+    const double e1=71.0/57600.0, e3=-71.0/16695.0, e4=71.0/1920.0, e5=-17253.0/339200.0, e6=22.0/525.0, e7=-1.0/40.0;
+    const double d1=-12715105075.0/11282082432.0, d3=87487479700.0/32700410799.0, d4=-10690763975.0/1880347072.0,
+                 d5=701980252875.0/199316789632.0, d6=-1453857185.0/822651844.0, d7=69997945.0/29380423.0;
+
+    double *k1 = stage(0), *k2 = stage(1), *k3 = stage(2), *k4 = stage(3), *k5 = stage(4), *k6 = stage(5), *k7 = stage(6);
+    double *y0 = stage(7), *y = stage(8), *y1 = stage(9);
+    const size_t n = size_t(mnStateVars);
+
+    for(size_t i=0; i<n; ++i)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*(19372.0/6561.0*k1[i] - 25360.0/2187.0*k2[i] + 64448.0/6561.0*k3[i] - 212.0/729.0*k4[i]);
+        y0[i] = (*mpStateVars)[i];
     }
-    mpParentComponent->solveSystem();
-    for(int i=0; i<mnStateVars; ++i)
+    evaluateCurrentDerivatives(k1);
+
+    mNumSubSteps = 0;
+    mNumRejectedSubSteps = 0;
+    mDenseStartTimes.clear();
+    mDenseStepSizes.clear();
+    mDenseCoefficients.clear();
+
+    double t = 0;
+    double h = (mSubStepSize > 0) ? std::min(mSubStepSize, mTimeStep) : mTimeStep;
+    bool lastRejected = false;
+    bool warned = false;
+    while(t < mTimeStep)
     {
-        k5[i] = mpParentComponent->getStateVariableDerivative(i);
-    }
+        // Take the rest of the time step if it is (almost) reached, to avoid a tiny final sub-step
+        const bool isLast = (t + 1.01*h >= mTimeStep);
+        const double hTry = isLast ? mTimeStep-t : h;
+        for(size_t i=0; i<n; ++i)
+        {
+            y[i] = y0[i] + hTry/5.0*k1[i];
+        }
+        evaluateDerivatives(y, k2);
+        for(size_t i=0; i<n; ++i)
+        {
+            y[i] = y0[i] + hTry/40.0*(3*k1[i] + 9*k2[i]);
+        }
+        evaluateDerivatives(y, k3);
+        for(size_t i=0; i<n; ++i)
+        {
+            y[i] = y0[i] + hTry*(44.0/45.0*k1[i] - 56.0/15.0*k2[i] + 32.0/9.0*k3[i]);
+        }
+        evaluateDerivatives(y, k4);
+        for(size_t i=0; i<n; ++i)
+        {
+            y[i] = y0[i] + hTry*(19372.0/6561.0*k1[i] - 25360.0/2187.0*k2[i] + 64448.0/6561.0*k3[i] - 212.0/729.0*k4[i]);
+        }
+        evaluateDerivatives(y, k5);
+        for(size_t i=0; i<n; ++i)
+        {
+            y[i] = y0[i] + hTry*(9017.0/3168.0*k1[i] - 355.0/33.0*k2[i] + 46732.0/5247.0*k3[i] + 49.0/176.0*k4[i] - 5103.0/18656.0*k5[i]);
+        }
+        evaluateDerivatives(y, k6);
+        for(size_t i=0; i<n; ++i)
+        {
+            y1[i] = y0[i] + hTry*(35.0/384.0*k1[i] + 500.0/1113.0*k3[i] + 125.0/192.0*k4[i] - 2187.0/6784.0*k5[i] + 11.0/84.0*k6[i]);
+        }
+        evaluateDerivatives(y1, k7);
 
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
-    for(int i=0; i<mnStateVars; ++i)
-    {
+        // Root mean square of the scaled error estimate
+        double err = 0;
+        for(size_t i=0; i<n; ++i)
+        {
+            const double sc = mTolerance + mTolerance*std::max(fabs(y0[i]), fabs(y1[i]));
+            const double ei = hTry*(e1*k1[i] + e3*k3[i] + e4*k4[i] + e5*k5[i] + e6*k6[i] + e7*k7[i])/sc;
+            err += ei*ei;
+        }
+        err = (n > 0) ? sqrt(err/double(n)) : 0;
+
+        // Give up on error control if too many sub-steps are needed, and finish the time step in one sub-step
+        const bool isForced = (mNumSubSteps + mNumRejectedSubSteps >= mMaxIter);
+        if(isForced && !warned)
+        {
+            std::stringstream ss;
+            ss << "Adaptive Dormand-Prince solver did not reach the tolerance within " << mMaxIter << " sub-steps.";
+            mpParentComponent->addWarningMessage(ss.str().c_str());
+            warned = true;
+        }
+
+        if(err <= 1.0 || isForced)
+        {
+            // Store the continuous extension of the accepted sub-step
+            mDenseStartTimes.push_back(t);
+            mDenseStepSizes.push_back(hTry);
+            for(size_t i=0; i<n; ++i)
+            {
+                const double ydiff = y1[i] - y0[i];
+                const double bspl = hTry*k1[i] - ydiff;
+                mDenseCoefficients.push_back(y0[i]);
+                mDenseCoefficients.push_back(ydiff);
+                mDenseCoefficients.push_back(bspl);
+                mDenseCoefficients.push_back(ydiff - hTry*k7[i] - bspl);
+                mDenseCoefficients.push_back(hTry*(d1*k1[i] + d3*k3[i] + d4*k4[i] + d5*k5[i] + d6*k6[i] + d7*k7[i]));
+            }
 
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*(9017.0/3168.0*k1[i] -  355.0/33.0*k2[i] + 46732.0/5247.0*k3[i] + 49.0/176.0*k4[i] - 5103.0/18656.0*k5[i]);
+            t = isLast ? mTimeStep : t+hTry;
+            std::swap(y0, y1);
+            std::swap(k1, k7);
+            ++mNumSubSteps;
+
+            double factor = (err > 0) ? std::min(5.0, std::max(0.2, 0.9*pow(err, -0.2))) : 5.0;
+            if(lastRejected)
+            {
+                factor = std::min(factor, 1.0);
+            }
+            lastRejected = false;
+            // Keep the previous proposal if the step was only shortened to reach the end of the time step
+            if(!isLast || hTry >= h)
+            {
+                h = hTry*factor;
+            }
+            if(isForced)
+            {
+                h = mTimeStep-t;
+            }
+        }
+        else
+        {
+            h = hTry*std::max(0.2, 0.9*pow(err, -0.2));
+            lastRejected = true;
+            ++mNumRejectedSubSteps;
+        }
     }
-    mpParentComponent->solveSystem();
-    for(int i=0; i<mnStateVars; ++i)
+    // Start over with a full time step guess if error control was abandoned
+    mSubStepSize = warned ? 0 : h;
+
+    setSolution(y0);
+}
+
+
+//! @brief Returns the state variables at a time within the last time step, from the continuous extension of the adaptive solver
+//! @details Only available after solveDormandPrinceAdaptive(), otherwise the current state variables are returned
+//! @param [in] theta The relative time within the time step, 0 is the start and 1 the end of the step
+//! @param [out] pStateVars Array with room for all state variables
+void NumericalIntegrationSolver::getDenseOutput(const double theta, double *pStateVars) const
+{
+    if(mDenseStartTimes.empty())
     {
-        k6[i] = mpParentComponent->getStateVariableDerivative(i);
+        for(int i=0; i<mnStateVars; ++i)
+        {
+            pStateVars[i] = (*mpStateVars)[i];
+        }
+        return;
     }
 
-    *mpStateVars = orgStateVars;
-    mpParentComponent->reInitializeValuesFromNodes();
-    for(int i=0; i<mnStateVars; ++i)
+    const double t = theta*mTimeStep;
+    size_t s = std::upper_bound(mDenseStartTimes.begin(), mDenseStartTimes.end(), t) - mDenseStartTimes.begin();
+    s = (s > 0) ? s-1 : 0;
+    const double th = std::max(0.0, std::min(1.0, (t-mDenseStartTimes[s])/mDenseStepSizes[s]));
+    const double th1 = 1.0-th;
+    const double *c = &mDenseCoefficients[5*mnStateVars*s];
+    for(int i=0; i<mnStateVars; ++i, c+=5)
     {
-        (*mpStateVars)[i] = (*mpStateVars)[i] + mTimeStep*(35.0/384.0*k1[i] + 500.0/1113.0*k3[i] + 125.0/192.0*k4[i] - 2187.0/6784.0*k5[i] + 11.0/84.0*k6[i]);
+        pStateVars[i] = c[0] + th*(c[1] + th1*(c[2] + th*(c[3] + th1*c[4])));
     }
-    mpParentComponent->solveSystem();
+}
+
+
+//! @brief Returns the number of accepted sub-steps in the last time step of the adaptive solver
+size_t NumericalIntegrationSolver::getNumSubSteps() const
+{
+    return mNumSubSteps;
+}
+
+
+//! @brief Returns the number of rejected sub-steps in the last time step of the adaptive solver
+size_t NumericalIntegrationSolver::getNumRejectedSubSteps() const
+{
+    return mNumRejectedSubSteps;
 }
 
 
@@ -602,26 +762,11 @@ void NumericalIntegrationSolver::solvevariableTimeStep()
 }
 
 
-static int kinsolResidualCallback(N_Vector y, N_Vector f, void *user_data)
-{
-    Component *pComponent = static_cast<Component*>(user_data);
-    pComponent->getResiduals(NV_DATA_S(y), NV_DATA_S(f));
-    return(0);
-}
-
-
-static int kinsolJacobianCallback(N_Vector y, N_Vector f, SUNMatrix J, void *user_data,N_Vector tmp1, N_Vector tmp2)
-{
-    Component *pComponent = static_cast<Component*>(user_data);
-    pComponent->getJacobian(NV_DATA_S(y), NV_DATA_S(f), SM_DATA_D(J));
-    return 0;
-}
-
-
 class KinsolSolver::Impl
 {
 public:
     Impl(Component *pParentComponent, double tol, int n, SolverTypeEnum solverType=NewtonIteration);
+    Impl(Component *pParentComponent, double tol, int n, SolverTypeEnum solverType, const std::vector<int> &rJacobianRowPointers, const std::vector<int> &rJacobianColumnIndices);
     ~Impl();
     void solve();
     double getState(int i);
@@ -636,13 +781,162 @@ public:
     SUNMatrix J;
     double mSolverTime;
     SolverTypeEnum mType;
+
+    //Sparse Jacobian pattern (compressed sparse row), empty for a dense Jacobian
+    std::vector<int> mJacobianRowPointers;
+    std::vector<int> mJacobianColumnIndices;
+
+private:
+    void init(double tol, int n);
+
+    static int residualCallback(N_Vector y, N_Vector f, void *user_data);
+    static int jacobianCallback(N_Vector y, N_Vector f, SUNMatrix J, void *user_data, N_Vector tmp1, N_Vector tmp2);
+    static int sparseJacobianCallback(N_Vector y, N_Vector f, SUNMatrix J, void *user_data, N_Vector tmp1, N_Vector tmp2);
 };
 
 
+int KinsolSolver::Impl::residualCallback(N_Vector y, N_Vector f, void *user_data)
+{
+    Component *pComponent = static_cast<KinsolSolver::Impl*>(user_data)->mpComponent;
+    pComponent->getResiduals(NV_DATA_S(y), NV_DATA_S(f));
+    return(0);
+}
+
+
+int KinsolSolver::Impl::jacobianCallback(N_Vector y, N_Vector f, SUNMatrix J, void *user_data, N_Vector /*tmp1*/, N_Vector /*tmp2*/)
+{
+    Component *pComponent = static_cast<KinsolSolver::Impl*>(user_data)->mpComponent;
+    pComponent->getJacobian(NV_DATA_S(y), NV_DATA_S(f), SM_DATA_D(J));
+    return 0;
+}
+
+
+int KinsolSolver::Impl::sparseJacobianCallback(N_Vector y, N_Vector f, SUNMatrix J, void *user_data, N_Vector /*tmp1*/, N_Vector /*tmp2*/)
+{
+    KinsolSolver::Impl *pImpl = static_cast<KinsolSolver::Impl*>(user_data);
+
+    //The matrix is cleared (including the pattern) before each call, so the pattern must be restored
+    sunindextype *pRowPointers = SM_INDEXPTRS_S(J);
+    sunindextype *pColumnIndices = SM_INDEXVALS_S(J);
+    for(size_t i=0; i<pImpl->mJacobianRowPointers.size(); ++i)
+    {
+        pRowPointers[i] = pImpl->mJacobianRowPointers[i];
+    }
+    for(size_t i=0; i<pImpl->mJacobianColumnIndices.size(); ++i)
+    {
+        pColumnIndices[i] = pImpl->mJacobianColumnIndices[i];
+    }
+    pImpl->mpComponent->getSparseJacobian(NV_DATA_S(y), NV_DATA_S(f), SM_DATA_S(J));
+    return 0;
+}
+
+
+//! @brief Content of the sparse LU linear solver for KINSOL
+struct SparseLinearSolverContent
+{
+    SparseLU lu;
+    sunindextype lastFlag;
+};
+
+
+static SUNLinearSolver_Type sparseLinearSolverGetType(SUNLinearSolver /*S*/)
+{
+    return SUNLINEARSOLVER_DIRECT;
+}
+
+
+static int sparseLinearSolverSetup(SUNLinearSolver S, SUNMatrix A)
+{
+    SparseLinearSolverContent *pContent = static_cast<SparseLinearSolverContent*>(S->content);
+    pContent->lastFlag = pContent->lu.factorize(SM_DATA_S(A)) ? SUNLS_SUCCESS : SUNLS_LUFACT_FAIL;
+    return int(pContent->lastFlag);
+}
+
+
+static int sparseLinearSolverSolve(SUNLinearSolver S, SUNMatrix /*A*/, N_Vector x, N_Vector b, realtype /*tol*/)
+{
+    SparseLinearSolverContent *pContent = static_cast<SparseLinearSolverContent*>(S->content);
+    N_VScale(1.0, b, x);
+    pContent->lu.solve(NV_DATA_S(x));
+    pContent->lastFlag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+}
+
+
+static sunindextype sparseLinearSolverLastFlag(SUNLinearSolver S)
+{
+    return static_cast<SparseLinearSolverContent*>(S->content)->lastFlag;
+}
+
+
+static int sparseLinearSolverFree(SUNLinearSolver S)
+{
+    if(S)
+    {
+        delete static_cast<SparseLinearSolverContent*>(S->content);
+        S->content = 0;
+        SUNLinSolFreeEmpty(S);
+    }
+    return SUNLS_SUCCESS;
+}
+
+
+//! @brief Creates a KINSOL linear solver using the built-in sparse LU factorization
+//! @returns Null if the pattern is invalid
+static SUNLinearSolver newSparseLinearSolver(const std::vector<int> &rRowPointers, const std::vector<int> &rColumnIndices)
+{
+    SparseLinearSolverContent *pContent = new SparseLinearSolverContent();
+    pContent->lastFlag = SUNLS_SUCCESS;
+    if(!pContent->lu.analyze(int(rRowPointers.size())-1, rRowPointers.data(), rColumnIndices.data()))
+    {
+        delete pContent;
+        return 0;
+    }
+
+    SUNLinearSolver S = SUNLinSolNewEmpty();
+    if(!S)
+    {
+        delete pContent;
+        return 0;
+    }
+    S->content = pContent;
+    S->ops->gettype = sparseLinearSolverGetType;
+    S->ops->setup = sparseLinearSolverSetup;
+    S->ops->solve = sparseLinearSolverSolve;
+    S->ops->lastflag = sparseLinearSolverLastFlag;
+    S->ops->free = sparseLinearSolverFree;
+    return S;
+}
+
+
 KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnum type)
     : mpComponent(pComponent),
       mSolverTime(pComponent->getTime()),
       mType(type)
+{
+    init(tol, n);
+}
+
+KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnum type, const std::vector<int> &rJacobianRowPointers, const std::vector<int> &rJacobianColumnIndices)
+    : mpComponent(pComponent),
+      mSolverTime(pComponent->getTime()),
+      mType(type),
+      mJacobianRowPointers(rJacobianRowPointers),
+      mJacobianColumnIndices(rJacobianColumnIndices)
+{
+    if(mJacobianRowPointers.size() != size_t(n+1) || mJacobianRowPointers.back() != int(mJacobianColumnIndices.size())) {
+        y = 0;
+        scale = 0;
+        LS = 0;
+        J = 0;
+        mem = 0;
+        mpComponent->stopSimulation("Sparse Jacobian pattern does not match the number of equations.");
+        return;
+    }
+    init(tol, n);
+}
+
+void KinsolSolver::Impl::init(double tol, int n)
 {
     int flag;
 
@@ -663,13 +957,13 @@ KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnu
         return;
     }
 
-    flag = KINSetUserData(mem, static_cast<void*>(mpComponent));
+    flag = KINSetUserData(mem, static_cast<void*>(this));
     if(flag < 0) {
         mpComponent->stopSimulation("KINSetUserData() failed with flag "+to_hstring(flag)+".");
         return;
     }
 
-    if(type == FixedPointIteration) {
+    if(mType == FixedPointIteration) {
         flag = KINSetMAA(mem, 2);
         if (flag < 0) {
             mpComponent->stopSimulation("KINSetMAA() failed with flag "+to_hstring(flag)+".");
@@ -677,7 +971,7 @@ KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnu
         }
     }
 
-    flag = KINInit(mem, kinsolResidualCallback, y);
+    flag = KINInit(mem, residualCallback, y);
     if (flag < 0) {
         mpComponent->stopSimulation("KINInit() failed with flag "+to_hstring(flag)+".");
         return;
@@ -685,7 +979,20 @@ KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnu
 
     setTolerance(tol);
 
-    if(type == NewtonIteration) {
+    if(mType == NewtonIteration && !mJacobianRowPointers.empty()) {
+        J = SUNSparseMatrix(n, n, mJacobianColumnIndices.size(), CSR_MAT);
+        if(!J) {
+            mpComponent->stopSimulation("SUNSparseMatrix() return null pointer.");
+            return;
+        }
+
+        LS = newSparseLinearSolver(mJacobianRowPointers, mJacobianColumnIndices);
+        if(!LS) {
+            mpComponent->stopSimulation("Failed to create sparse linear solver, the Jacobian pattern is invalid.");
+            return;
+        }
+    }
+    else if(mType == NewtonIteration) {
         J = SUNDenseMatrix(n, n);
         if(!J) {
             mpComponent->stopSimulation("SUNDenseMatrix() return null pointer.");
@@ -697,6 +1004,9 @@ KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnu
             mpComponent->stopSimulation("SUNLinSol_Dense() return null pointer.");
             return;
         }
+    }
+
+    if(mType == NewtonIteration) {
 
         flag = KINSetLinearSolver(mem, LS, J);
         if (flag < 0) {
@@ -716,7 +1026,7 @@ KinsolSolver::Impl::Impl(Component *pComponent, double tol, int n, SolverTypeEnu
             return;
         }
 
-        flag = KINSetJacFn(mem, kinsolJacobianCallback);
+        flag = KINSetJacFn(mem, mJacobianRowPointers.empty() ? jacobianCallback : sparseJacobianCallback);
         if (flag < 0) {
             mpComponent->stopSimulation("KINSetJacFn() failed with flag "+to_hstring(flag)+".");
             return;
@@ -785,6 +1095,17 @@ void KinsolSolver::Impl::setTolerance(double value)
 
 KinsolSolver::KinsolSolver(Component *pComponent, double tol, int n, SolverTypeEnum type=NewtonIteration) : impl(new Impl(pComponent, tol, n, type)) {}
 
+//! @brief Creates a Newton solver that uses a sparse Jacobian and a sparse LU factorization
+//! @details The component must implement getSparseJacobian(), that writes the non-zero Jacobian values in the order given by the pattern.
+//! @param[in] pComponent The component that owns the equation system
+//! @param[in] tol The tolerance
+//! @param[in] n The number of equations
+//! @param[in] type The solver type, the sparse Jacobian is only used for NewtonIteration
+//! @param[in] rJacobianRowPointers Compressed row pointers of the Jacobian pattern, n+1 elements
+//! @param[in] rJacobianColumnIndices Column indices of the non-zero Jacobian elements, row by row
+KinsolSolver::KinsolSolver(Component *pComponent, double tol, int n, SolverTypeEnum type, const std::vector<int> &rJacobianRowPointers, const std::vector<int> &rJacobianColumnIndices)
+    : impl(new Impl(pComponent, tol, n, type, rJacobianRowPointers, rJacobianColumnIndices)) {}
+
 KinsolSolver::~KinsolSolver()
 {
     delete impl;
@@ -0,0 +1,265 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   FilterBank.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a structure-of-arrays bank of independent transfer functions
+//!
+//$Id$
+
+#include "ComponentUtilities/FilterBank.h"
+#include "ComponentUtilities/FirstOrderTransferFunction.h"
+#include "ComponentUtilities/SecondOrderTransferFunction.h"
+
+using namespace hopsan;
+
+namespace {
+
+// The arrays never overlap, __restrict tells the compiler so, otherwise it will not vectorize loops with this many arrays.
+// The saturation flags are not stored in the loops, that also prevents vectorization, see isSaturated()
+
+//! @brief The filter equation of FirstOrderTransferFunction::update() for n filters
+void updateFirstOrder(const size_t n, const double *__restrict pU, double *__restrict pDelayedU, double *__restrict pDelayedY,
+                      const double *__restrict pCoeffU0, const double *__restrict pCoeffU1, const double *__restrict pCoeffY0,
+                      const double *__restrict pInvCoeffY1, const double *__restrict pMin, const double *__restrict pMax)
+{
+    for (size_t i=0; i<n; ++i)
+    {
+        const double y = pInvCoeffY1[i]*(pCoeffU1[i]*pU[i] + pCoeffU0[i]*pDelayedU[i] - pCoeffY0[i]*pDelayedY[i]);
+        const double max = pMax[i];
+        const double min = pMin[i];
+        pDelayedY[i] = (y >= max) ? max : ((y <= min) ? min : y);
+        pDelayedU[i] = pU[i];
+    }
+}
+
+//! @brief The filter equation of SecondOrderTransferFunction::update() for n filters
+void updateSecondOrder(const size_t n, const double *__restrict pU, double *__restrict pDelayedU, double *__restrict pDelayed2U,
+                       double *__restrict pDelayedY, double *__restrict pDelayed2Y,
+                       const double *__restrict pCoeffU0, const double *__restrict pCoeffU1, const double *__restrict pCoeffU2,
+                       const double *__restrict pCoeffY1, const double *__restrict pCoeffY2, const double *__restrict pInvCoeffY0,
+                       const double *__restrict pMin, const double *__restrict pMax)
+{
+    for (size_t i=0; i<n; ++i)
+    {
+        const double y = pInvCoeffY0[i]*(pCoeffU0[i]*pU[i] + pCoeffU1[i]*pDelayedU[i] + pCoeffU2[i]*pDelayed2U[i] -
+                                         pCoeffY1[i]*pDelayedY[i] - pCoeffY2[i]*pDelayed2Y[i]);
+        pDelayed2U[i] = pDelayedU[i];
+        pDelayedU[i] = pU[i];
+        const double max = pMax[i];
+        const double min = pMin[i];
+        pDelayed2Y[i] = pDelayedY[i];
+        pDelayedY[i] = (y >= max) ? max : ((y <= min) ? min : y);
+    }
+}
+
+//! @brief Returns if a filter output y was limited in the last update
+//! @details The limited output is equal to a limit, and an output that was not limited is strictly between the limits
+inline bool isSaturated(const double y, const double min, const double max)
+{
+    return (y >= max) || (y <= min);
+}
+
+}
+
+//! @class hopsan::FilterBank
+//! @brief An empty filter bank
+FilterBank::FilterBank()
+{
+    mIsUpdated = false;
+}
+
+void FilterBank::FirstOrderArrays::resize(const size_t n)
+{
+    mU.resize(n);
+    mDelayedU.resize(n);
+    mDelayedY.resize(n);
+    mCoeffU0.resize(n);
+    mCoeffU1.resize(n);
+    mCoeffY0.resize(n);
+    mInvCoeffY1.resize(n);
+    mMin.resize(n);
+    mMax.resize(n);
+}
+
+void FilterBank::SecondOrderArrays::resize(const size_t n)
+{
+    mU.resize(n);
+    mDelayedU.resize(n);
+    mDelayed2U.resize(n);
+    mDelayedY.resize(n);
+    mDelayed2Y.resize(n);
+    mCoeffU0.resize(n);
+    mCoeffU1.resize(n);
+    mCoeffU2.resize(n);
+    mCoeffY1.resize(n);
+    mCoeffY2.resize(n);
+    mInvCoeffY0.resize(n);
+    mMin.resize(n);
+    mMax.resize(n);
+}
+
+//! @brief Remove all filters from the bank
+void FilterBank::clear()
+{
+    mFirstOrder = FirstOrderArrays();
+    mSecondOrder = SecondOrderArrays();
+    mIsUpdated = false;
+}
+
+//! @brief Add a first order transfer function to the bank
+//! @param[in] pFilter The transfer function, it must be initialized and must outlive the bank
+//! @param[in] pInput The input value, read in each update
+//! @param[in] pOutput The output value, written in each update
+void FilterBank::addFilter(FirstOrderTransferFunction *pFilter, const double *pInput, double *pOutput)
+{
+    mFirstOrder.mFilters.push_back(pFilter);
+    mFirstOrder.mInputPtrs.push_back(pInput);
+    mFirstOrder.mOutputPtrs.push_back(pOutput);
+    mFirstOrder.resize(mFirstOrder.mFilters.size());
+}
+
+//! @brief Add a second order transfer function to the bank
+//! @param[in] pFilter The transfer function, it must be initialized and must outlive the bank
+//! @param[in] pInput The input value, read in each update
+//! @param[in] pOutput The output value, written in each update
+void FilterBank::addFilter(SecondOrderTransferFunction *pFilter, const double *pInput, double *pOutput)
+{
+    mSecondOrder.mFilters.push_back(pFilter);
+    mSecondOrder.mInputPtrs.push_back(pInput);
+    mSecondOrder.mOutputPtrs.push_back(pOutput);
+    mSecondOrder.resize(mSecondOrder.mFilters.size());
+}
+
+//! @brief Returns the number of filters in the bank
+size_t FilterBank::size() const
+{
+    return mFirstOrder.mFilters.size() + mSecondOrder.mFilters.size();
+}
+
+//! @brief Copy coefficients, limits and states from the transfer function objects into the bank
+void FilterBank::loadStates()
+{
+    mIsUpdated = false;
+    for (size_t i=0; i<mFirstOrder.mFilters.size(); ++i)
+    {
+        const FirstOrderTransferFunction *pTF = mFirstOrder.mFilters[i];
+        mFirstOrder.mDelayedU[i] = pTF->mDelayedU;
+        mFirstOrder.mDelayedY[i] = pTF->mDelayedY;
+        mFirstOrder.mCoeffU0[i] = pTF->mCoeffU[0];
+        mFirstOrder.mCoeffU1[i] = pTF->mCoeffU[1];
+        mFirstOrder.mCoeffY0[i] = pTF->mCoeffY[0];
+        mFirstOrder.mInvCoeffY1[i] = 1.0/pTF->mCoeffY[1];
+        mFirstOrder.mMin[i] = pTF->mMin;
+        mFirstOrder.mMax[i] = pTF->mMax;
+    }
+
+    for (size_t i=0; i<mSecondOrder.mFilters.size(); ++i)
+    {
+        const SecondOrderTransferFunction *pTF = mSecondOrder.mFilters[i];
+        mSecondOrder.mDelayedU[i] = pTF->mDelayedU;
+        mSecondOrder.mDelayed2U[i] = pTF->mDelayed2U;
+        mSecondOrder.mDelayedY[i] = pTF->mDelayedY;
+        mSecondOrder.mDelayed2Y[i] = pTF->mDelayed2Y;
+        mSecondOrder.mCoeffU0[i] = pTF->mCoeffU[0];
+        mSecondOrder.mCoeffU1[i] = pTF->mCoeffU[1];
+        mSecondOrder.mCoeffU2[i] = pTF->mCoeffU[2];
+        mSecondOrder.mCoeffY1[i] = pTF->mCoeffY[1];
+        mSecondOrder.mCoeffY2[i] = pTF->mCoeffY[2];
+        mSecondOrder.mInvCoeffY0[i] = 1.0/pTF->mCoeffY[0];
+        mSecondOrder.mMin[i] = pTF->mMin;
+        mSecondOrder.mMax[i] = pTF->mMax;
+    }
+}
+
+//! @brief Update all filters one time step, reads all inputs and writes all outputs
+//! @details The filter equations and the limits are the same as in FirstOrderTransferFunction::update() and
+//! SecondOrderTransferFunction::update(), and so are the results
+void FilterBank::update()
+{
+    mIsUpdated = true;
+
+    // First order filters
+    const size_t n1 = mFirstOrder.mFilters.size();
+    for (size_t i=0; i<n1; ++i)
+    {
+        mFirstOrder.mU[i] = *mFirstOrder.mInputPtrs[i];
+    }
+    updateFirstOrder(n1, mFirstOrder.mU.data(), mFirstOrder.mDelayedU.data(), mFirstOrder.mDelayedY.data(),
+                     mFirstOrder.mCoeffU0.data(), mFirstOrder.mCoeffU1.data(), mFirstOrder.mCoeffY0.data(), mFirstOrder.mInvCoeffY1.data(),
+                     mFirstOrder.mMin.data(), mFirstOrder.mMax.data());
+    for (size_t i=0; i<n1; ++i)
+    {
+        *mFirstOrder.mOutputPtrs[i] = mFirstOrder.mDelayedY[i];
+    }
+
+    // Second order filters
+    const size_t n2 = mSecondOrder.mFilters.size();
+    for (size_t i=0; i<n2; ++i)
+    {
+        mSecondOrder.mU[i] = *mSecondOrder.mInputPtrs[i];
+    }
+    updateSecondOrder(n2, mSecondOrder.mU.data(), mSecondOrder.mDelayedU.data(), mSecondOrder.mDelayed2U.data(),
+                      mSecondOrder.mDelayedY.data(), mSecondOrder.mDelayed2Y.data(),
+                      mSecondOrder.mCoeffU0.data(), mSecondOrder.mCoeffU1.data(), mSecondOrder.mCoeffU2.data(),
+                      mSecondOrder.mCoeffY1.data(), mSecondOrder.mCoeffY2.data(), mSecondOrder.mInvCoeffY0.data(),
+                      mSecondOrder.mMin.data(), mSecondOrder.mMax.data());
+    for (size_t i=0; i<n2; ++i)
+    {
+        *mSecondOrder.mOutputPtrs[i] = mSecondOrder.mDelayedY[i];
+    }
+}
+
+//! @brief Copy the states from the bank back to the transfer function objects
+void FilterBank::storeStates()
+{
+    // Without updates the objects are unchanged, their output value may then differ from the delayed output
+    if (!mIsUpdated)
+    {
+        return;
+    }
+
+    for (size_t i=0; i<mFirstOrder.mFilters.size(); ++i)
+    {
+        FirstOrderTransferFunction *pTF = mFirstOrder.mFilters[i];
+        pTF->mValue = mFirstOrder.mDelayedY[i];
+        pTF->mDelayedU = mFirstOrder.mDelayedU[i];
+        pTF->mDelayedY = mFirstOrder.mDelayedY[i];
+        pTF->mIsSaturated = isSaturated(mFirstOrder.mDelayedY[i], mFirstOrder.mMin[i], mFirstOrder.mMax[i]);
+    }
+
+    for (size_t i=0; i<mSecondOrder.mFilters.size(); ++i)
+    {
+        SecondOrderTransferFunction *pTF = mSecondOrder.mFilters[i];
+        pTF->mValue = mSecondOrder.mDelayedY[i];
+        pTF->mDelayedU = mSecondOrder.mDelayedU[i];
+        pTF->mDelayed2U = mSecondOrder.mDelayed2U[i];
+        pTF->mDelayedY = mSecondOrder.mDelayedY[i];
+        pTF->mDelayed2Y = mSecondOrder.mDelayed2Y[i];
+        pTF->mIsSaturated = isSaturated(mSecondOrder.mDelayedY[i], mSecondOrder.mMin[i], mSecondOrder.mMax[i]);
+    }
+}
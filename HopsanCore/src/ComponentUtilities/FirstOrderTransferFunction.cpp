@@ -221,6 +221,40 @@ bool FirstOrderTransferFunction::isSaturated() const
     return mIsSaturated;
 }
 
+//! @brief Write the internal state to a checkpoint
+void FirstOrderTransferFunction::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mValue);
+    rWriter.writeDouble(mDelayedU);
+    rWriter.writeDouble(mDelayedY);
+    rWriter.writeDouble(mMin);
+    rWriter.writeDouble(mMax);
+    rWriter.writeDouble(mTimeStep);
+    rWriter.writeDoubles(mCoeffU, 2);
+    rWriter.writeDoubles(mCoeffY, 2);
+    rWriter.writeBool(mIsSaturated);
+    mBackupU.saveState(rWriter);
+    mBackupY.saveState(rWriter);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool FirstOrderTransferFunction::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mValue);
+    ok = ok && rReader.readDouble(mDelayedU);
+    ok = ok && rReader.readDouble(mDelayedY);
+    ok = ok && rReader.readDouble(mMin);
+    ok = ok && rReader.readDouble(mMax);
+    ok = ok && rReader.readDouble(mTimeStep);
+    ok = ok && rReader.readDoubles(mCoeffU, 2);
+    ok = ok && rReader.readDoubles(mCoeffY, 2);
+    ok = ok && rReader.readBool(mIsSaturated);
+    ok = ok && mBackupU.restoreState(rReader);
+    ok = ok && mBackupY.restoreState(rReader);
+    return ok;
+}
+
 
 
 
@@ -338,6 +372,38 @@ double FirstOrderTransferFunctionVariable::value()
     return mValue;
 }
 
+//! @brief Write the internal state to a checkpoint
+void FirstOrderTransferFunctionVariable::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mValue);
+    rWriter.writeDouble(mDelayU);
+    rWriter.writeDouble(mDelayY);
+    rWriter.writeDouble(mMin);
+    rWriter.writeDouble(mMax);
+    rWriter.writeDouble(mPrevTimeStep);
+    rWriter.writeDoubles(mNum, 2);
+    rWriter.writeDoubles(mDen, 2);
+    rWriter.writeDoubles(mCoeffU, 2);
+    rWriter.writeDoubles(mCoeffY, 2);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool FirstOrderTransferFunctionVariable::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mValue);
+    ok = ok && rReader.readDouble(mDelayU);
+    ok = ok && rReader.readDouble(mDelayY);
+    ok = ok && rReader.readDouble(mMin);
+    ok = ok && rReader.readDouble(mMax);
+    ok = ok && rReader.readDouble(mPrevTimeStep);
+    ok = ok && rReader.readDoubles(mNum, 2);
+    ok = ok && rReader.readDoubles(mDen, 2);
+    ok = ok && rReader.readDoubles(mCoeffU, 2);
+    ok = ok && rReader.readDoubles(mCoeffY, 2);
+    return ok;
+}
+
 
 //! @class hopsan::FirstOrderLowPassFilter
 //! @ingroup ComponentUtilityClasses
@@ -126,3 +126,25 @@ double IntegratorLimited::value()
 {
     return mDelayY;
 }
+
+//! @brief Write the internal state to a checkpoint
+void IntegratorLimited::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mDelayU);
+    rWriter.writeDouble(mDelayY);
+    rWriter.writeDouble(mMin);
+    rWriter.writeDouble(mMax);
+    rWriter.writeDouble(mTimeStep);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool IntegratorLimited::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mDelayU);
+    ok = ok && rReader.readDouble(mDelayY);
+    ok = ok && rReader.readDouble(mMin);
+    ok = ok && rReader.readDouble(mMax);
+    ok = ok && rReader.readDouble(mTimeStep);
+    return ok;
+}
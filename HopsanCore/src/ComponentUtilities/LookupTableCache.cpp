@@ -0,0 +1,207 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   LookupTableCache.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a process wide cache for shared read-only lookup table data
+//!
+//$Id$
+
+#include "ComponentUtilities/LookupTableCache.h"
+#include "ComponentUtilities/num2string.hpp"
+
+#include <map>
+#include <mutex>
+#include <cstdlib>
+#include <climits>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace hopsan;
+
+namespace {
+
+//! @brief One cache entry, the entry mutex makes sure that only one instance parses a particular file
+struct CacheEntry
+{
+    std::mutex mLoadMutex;
+    std::weak_ptr<const LookupTableNDBase> mpTable;
+};
+
+typedef std::map<HString, std::shared_ptr<CacheEntry> > CacheMapT;
+
+std::mutex gCacheMutex;
+CacheMapT gCacheMap;
+
+//! @brief Get the sub-second part of the file modification time, so that files rewritten within the same second get new keys
+//! @param[in] rFilePath The path to the file
+//! @param[in] rStat The stat result for the same file
+//! @returns The sub-second part in the platform resolution (nanoseconds, or 100 ns ticks on Windows)
+long long subSecondModificationTime(const HString &rFilePath, const struct stat &rStat)
+{
+#if defined _WIN32
+    (void)rStat;
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (GetFileAttributesExA(rFilePath.c_str(), GetFileExInfoStandard, &attributes))
+    {
+        const unsigned long long ticks = (static_cast<unsigned long long>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                                         attributes.ftLastWriteTime.dwLowDateTime;
+        return static_cast<long long>(ticks % 10000000ULL);
+    }
+    return 0;
+#elif defined __APPLE__
+    (void)rFilePath;
+    return static_cast<long long>(rStat.st_mtimespec.tv_nsec);
+#else
+    (void)rFilePath;
+    return static_cast<long long>(rStat.st_mtim.tv_nsec);
+#endif
+}
+
+//! @brief Build the cache key from canonical path, modification time, size and parse options
+//! @returns False if the file could not be found, in that case nothing should be cached
+bool makeCacheKey(const HString &rFilePath, const HString &rParseOptions, HString &rKey)
+{
+    struct stat st;
+    if (stat(rFilePath.c_str(), &st) != 0)
+    {
+        return false;
+    }
+
+    HString canonicalPath;
+#ifdef _WIN32
+    char buff[_MAX_PATH];
+    if (_fullpath(buff, rFilePath.c_str(), _MAX_PATH) != nullptr)
+#else
+    char buff[PATH_MAX];
+    if (realpath(rFilePath.c_str(), buff) != nullptr)
+#endif
+    {
+        canonicalPath = buff;
+    }
+    else
+    {
+        canonicalPath = rFilePath;
+    }
+
+    rKey = rParseOptions+"|"+canonicalPath+"|"+to_hstring(static_cast<long long>(st.st_mtime))+"."+
+           to_hstring(subSecondModificationTime(rFilePath, st))+"|"+to_hstring(static_cast<long long>(st.st_size));
+    return true;
+}
+
+//! @brief Remove entries whose tables have been released by all users
+//! @note gCacheMutex must be locked by caller
+void pruneExpiredEntries()
+{
+    CacheMapT::iterator it = gCacheMap.begin();
+    while (it != gCacheMap.end())
+    {
+        // Entries that are currently being loaded by some other thread are kept, the lock can not be taken then
+        std::unique_lock<std::mutex> entryLock(it->second->mLoadMutex, std::try_to_lock);
+        if (entryLock.owns_lock() && it->second->mpTable.expired())
+        {
+            entryLock.unlock();
+            it = gCacheMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}
+
+//! @brief Get shared lookup table data for a file, loading it if it is not already cached
+//! @param[in] rFilePath The path to the data file
+//! @param[in] rParseOptions Any settings affecting how the file is parsed, must include something identifying the table type
+//! @param[in] rLoader Function that parses the file and returns a new table, or nullptr on failure
+//! @returns Shared pointer to the read-only table data, empty if loading failed
+LookupTableCache::SharedTableT LookupTableCache::getOrLoad(const HString &rFilePath, const HString &rParseOptions, const LoaderFunctionT &rLoader)
+{
+    HString key;
+    if (!makeCacheKey(rFilePath, rParseOptions, key))
+    {
+        // File can not be accessed, let the loader run and report its errors, but do not cache the result
+        return SharedTableT(rLoader());
+    }
+
+    std::shared_ptr<CacheEntry> pEntry;
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        pruneExpiredEntries();
+        std::shared_ptr<CacheEntry> &rpEntry = gCacheMap[key];
+        if (!rpEntry)
+        {
+            rpEntry = std::make_shared<CacheEntry>();
+        }
+        pEntry = rpEntry;
+    }
+
+    // Only the entry is locked during loading, so that different files can be loaded in parallel
+    std::lock_guard<std::mutex> entryLock(pEntry->mLoadMutex);
+    SharedTableT pTable = pEntry->mpTable.lock();
+    if (!pTable)
+    {
+        pTable = SharedTableT(rLoader());
+        pEntry->mpTable = pTable;
+    }
+    return pTable;
+}
+
+//! @brief Returns the number of tables currently held by the cache (by at least one user)
+size_t LookupTableCache::getNumCachedTables()
+{
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    size_t n=0;
+    for (CacheMapT::iterator it=gCacheMap.begin(); it!=gCacheMap.end(); ++it)
+    {
+        std::lock_guard<std::mutex> entryLock(it->second->mLoadMutex);
+        if (!it->second->mpTable.expired())
+        {
+            ++n;
+        }
+    }
+    return n;
+}
+
+//! @brief Estimate the memory needed for a table parsed from a data file, without parsing it
+//! @details Values of about eight characters including the separator give one double per eight bytes of text, so the
+//! file size is used as the estimate. Files with more columns than the table uses will be overestimated.
+//! @param[in] rFilePath The path to the data file
+//! @returns The estimated table size in bytes, 0 if the file can not be accessed
+size_t LookupTableCache::estimateMemoryUsage(const HString &rFilePath)
+{
+    struct stat st;
+    if (stat(rFilePath.c_str(), &st) != 0)
+    {
+        return 0;
+    }
+    return size_t(st.st_size);
+}
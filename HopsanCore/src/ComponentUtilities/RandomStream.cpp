@@ -0,0 +1,332 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   RandomStream.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a counter-based random number stream
+//!
+//$Id$
+
+#include "ComponentUtilities/RandomStream.h"
+#include "ComponentUtilities/StateSerialization.h"
+#include <cmath>
+
+using namespace hopsan;
+
+namespace {
+
+const uint32_t PhiloxM0 = 0xD2511F53;
+const uint32_t PhiloxM1 = 0xCD9E8D57;
+const uint32_t PhiloxW0 = 0x9E3779B9;
+const uint32_t PhiloxW1 = 0xBB67AE85;
+
+// 2^-53 and 2^-52
+const double DoubleEps53 = 1.0/9007199254740992.0;
+const double DoubleEps52 = 1.0/4503599627370496.0;
+
+//! @brief The SplitMix64 finalizer, used to spread seed and name bits over all key and counter bits
+inline uint64_t mix64(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+inline void philoxRound(uint32_t ctr[4], const uint32_t key[2])
+{
+    const uint64_t p0 = uint64_t(PhiloxM0)*ctr[0];
+    const uint64_t p1 = uint64_t(PhiloxM1)*ctr[2];
+    const uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ key[0];
+    const uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ key[1];
+    ctr[1] = uint32_t(p1);
+    ctr[3] = uint32_t(p0);
+    ctr[0] = c0;
+    ctr[2] = c2;
+}
+
+//! @brief Ziggurat tables for the standard normal distribution with 128 layers (Marsaglia and Tsang, with Doornik's improvements)
+struct ZigguratTables
+{
+    static const int NumLayers = 128;
+    //! @brief Start of the right tail
+    static double tailStart() { return 3.442619855899; }
+
+    ZigguratTables()
+    {
+        const double r = tailStart();
+        const double v = 9.91256303526217e-3; // Area of each layer
+        double f = std::exp(-0.5*r*r);
+        x[0] = v/f; // The bottom layer includes the tail
+        x[1] = r;
+        x[NumLayers] = 0;
+        for (int i=2; i<NumLayers; ++i)
+        {
+            x[i] = std::sqrt(-2*std::log(v/x[i-1] + f));
+            f = std::exp(-0.5*x[i]*x[i]);
+        }
+        for (int i=0; i<NumLayers; ++i)
+        {
+            ratio[i] = x[i+1]/x[i];
+        }
+    }
+
+    double x[NumLayers+1];
+    double ratio[NumLayers];
+};
+
+const ZigguratTables &zigguratTables()
+{
+    static const ZigguratTables tables;
+    return tables;
+}
+
+}
+
+//! @class hopsan::RandomStream
+//! @brief A stream with seed 0 and stream id 0
+RandomStream::RandomStream()
+{
+    setSeed(0, 0);
+}
+
+RandomStream::RandomStream(const uint64_t seed, const uint64_t streamId)
+{
+    setSeed(seed, streamId);
+}
+
+//! @brief Set the seed and stream id, and restart the stream from its first value
+//! @param[in] seed The seed, typically one per model or simulation run
+//! @param[in] streamId Identifies the stream, see streamIdFromName()
+void RandomStream::setSeed(const uint64_t seed, const uint64_t streamId)
+{
+    const uint64_t key = mix64(seed);
+    const uint64_t stream = mix64(streamId);
+    mKey[0] = uint32_t(key);
+    mKey[1] = uint32_t(key >> 32);
+    mStream[0] = uint32_t(stream);
+    mStream[1] = uint32_t(stream >> 32);
+    mNextBlock = 0;
+    mBufferPos = 2;
+}
+
+//! @brief Create a stream id from a name, such as the full name of a component
+//! @details Uses the 64-bit FNV-1a hash, the result is the same on all platforms
+uint64_t RandomStream::streamIdFromName(const HString &rName)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i=0; i<rName.size(); ++i)
+    {
+        hash ^= uint64_t(static_cast<unsigned char>(rName.c_str()[i]));
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+//! @brief The Philox4x32 bijection with 10 rounds, maps a 128-bit counter to 128 random bits
+//! @param[in] counter The counter
+//! @param[in] key The key
+//! @param[out] result The random bits
+void RandomStream::philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+    uint32_t ctr[4] = {counter[0], counter[1], counter[2], counter[3]};
+    uint32_t k[2] = {key[0], key[1]};
+    for (int r=0; r<9; ++r)
+    {
+        philoxRound(ctr, k);
+        k[0] += PhiloxW0;
+        k[1] += PhiloxW1;
+    }
+    philoxRound(ctr, k);
+    result[0] = ctr[0];
+    result[1] = ctr[1];
+    result[2] = ctr[2];
+    result[3] = ctr[3];
+}
+
+//! @brief Generate the two 64-bit values of one block, the block index and stream id form the counter
+inline void RandomStream::generateBlock(const uint64_t blockIndex, uint64_t *pOut) const
+{
+    const uint32_t counter[4] = {uint32_t(blockIndex), uint32_t(blockIndex >> 32), mStream[0], mStream[1]};
+    uint32_t result[4];
+    philox4x32(counter, mKey, result);
+    pOut[0] = uint64_t(result[0]) | (uint64_t(result[1]) << 32);
+    pOut[1] = uint64_t(result[2]) | (uint64_t(result[3]) << 32);
+}
+
+//! @brief Returns the next 64 random bits
+uint64_t RandomStream::nextUInt64()
+{
+    if (mBufferPos > 1)
+    {
+        generateBlock(mNextBlock++, mBuffer);
+        mBufferPos = 0;
+    }
+    return mBuffer[mBufferPos++];
+}
+
+//! @brief Returns a uniformly distributed value in [0, 1)
+double RandomStream::nextUniform()
+{
+    return double(nextUInt64() >> 11)*DoubleEps53;
+}
+
+//! @brief Returns a uniformly distributed value in (0, 1), that can be passed to log()
+double RandomStream::nextUniformOpen()
+{
+    return (double(nextUInt64() >> 12) + 0.5)*DoubleEps52;
+}
+
+//! @brief Returns a standard normal distributed value (mean 0, standard deviation 1)
+double RandomStream::nextNormal()
+{
+    const ZigguratTables &rZig = zigguratTables();
+    const uint64_t rnd = nextUInt64();
+    const size_t i = size_t(rnd & 0x7F);
+    const double u = 2.0*double(rnd >> 11)*DoubleEps53 - 1.0;
+    if (std::fabs(u) < rZig.ratio[i])
+    {
+        return u*rZig.x[i];
+    }
+    return normalSlowPath(rnd);
+}
+
+//! @brief Handles the about 1.2 % of ziggurat samples that are not inside a rectangle
+//! @param[in] rnd The rejected random bits, they choose the layer and the position in it
+double RandomStream::normalSlowPath(uint64_t rnd)
+{
+    const ZigguratTables &rZig = zigguratTables();
+    for (;;)
+    {
+        const size_t i = size_t(rnd & 0x7F);
+        const double u = 2.0*double(rnd >> 11)*DoubleEps53 - 1.0;
+        if (std::fabs(u) < rZig.ratio[i])
+        {
+            return u*rZig.x[i];
+        }
+
+        // The bottom layer, sample from the tail
+        if (i == 0)
+        {
+            const double r = ZigguratTables::tailStart();
+            double x, y;
+            do
+            {
+                x = std::log(nextUniformOpen())/r;
+                y = std::log(nextUniformOpen());
+            } while (-2*y < x*x);
+            return (u < 0) ? x-r : r-x;
+        }
+
+        // The wedge between this layer and the curve
+        const double x = u*rZig.x[i];
+        const double f0 = std::exp(-0.5*(rZig.x[i]*rZig.x[i] - x*x));
+        const double f1 = std::exp(-0.5*(rZig.x[i+1]*rZig.x[i+1] - x*x));
+        if (f1 + nextUniform()*(f0 - f1) < 1.0)
+        {
+            return x;
+        }
+        rnd = nextUInt64();
+    }
+}
+
+//! @brief Fill an array with the next n 64-bit values, the same values as n calls to nextUInt64()
+void RandomStream::fillUInt64(uint64_t *pValues, const size_t n)
+{
+    size_t k=0;
+    while ((k < n) && (mBufferPos < 2))
+    {
+        pValues[k++] = mBuffer[mBufferPos++];
+    }
+    // Blocks are independent of each other, so this loop has no dependencies between iterations
+    const size_t numBlocks = (n-k)/2;
+    for (size_t b=0; b<numBlocks; ++b)
+    {
+        generateBlock(mNextBlock+b, pValues+k+2*b);
+    }
+    mNextBlock += numBlocks;
+    k += 2*numBlocks;
+    if (k < n)
+    {
+        pValues[k] = nextUInt64();
+    }
+}
+
+//! @brief Fill an array with n uniformly distributed values in [0, 1), the same values as n calls to nextUniform()
+void RandomStream::fillUniform(double *pValues, const size_t n)
+{
+    uint64_t rnd[256];
+    for (size_t b=0; b<n; b+=256)
+    {
+        const size_t m = (n-b < 256) ? n-b : 256;
+        fillUInt64(rnd, m);
+        for (size_t k=0; k<m; ++k)
+        {
+            pValues[b+k] = double(rnd[k] >> 11)*DoubleEps53;
+        }
+    }
+}
+
+//! @brief Fill an array with n standard normal distributed values
+//! @details The random bits are generated in batches, so the sequence differs from n calls to nextNormal() when a sample
+//! is rejected, but it is still reproducible.
+void RandomStream::fillNormal(double *pValues, const size_t n)
+{
+    const ZigguratTables &rZig = zigguratTables();
+    uint64_t rnd[256];
+    for (size_t b=0; b<n; b+=256)
+    {
+        const size_t m = (n-b < 256) ? n-b : 256;
+        fillUInt64(rnd, m);
+        for (size_t k=0; k<m; ++k)
+        {
+            const size_t i = size_t(rnd[k] & 0x7F);
+            const double u = 2.0*double(rnd[k] >> 11)*DoubleEps53 - 1.0;
+            pValues[b+k] = (std::fabs(u) < rZig.ratio[i]) ? u*rZig.x[i] : normalSlowPath(rnd[k]);
+        }
+    }
+}
+
+//! @brief Save the stream position to a checkpoint
+void RandomStream::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeRaw(mKey, sizeof(mKey));
+    rWriter.writeRaw(mStream, sizeof(mStream));
+    rWriter.writeRaw(&mNextBlock, sizeof(mNextBlock));
+    rWriter.writeRaw(mBuffer, sizeof(mBuffer));
+    rWriter.writeSize(mBufferPos);
+}
+
+//! @brief Restore the stream position from a checkpoint
+//! @returns False if the state data is incomplete
+bool RandomStream::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readRaw(mKey, sizeof(mKey));
+    ok = ok && rReader.readRaw(mStream, sizeof(mStream));
+    ok = ok && rReader.readRaw(&mNextBlock, sizeof(mNextBlock));
+    ok = ok && rReader.readRaw(mBuffer, sizeof(mBuffer));
+    ok = ok && rReader.readSize(mBufferPos);
+    return ok;
+}
@@ -244,6 +244,44 @@ bool SecondOrderTransferFunction::isSaturated() const
     return mIsSaturated;
 }
 
+//! @brief Write the internal state to a checkpoint
+void SecondOrderTransferFunction::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mValue);
+    rWriter.writeDouble(mDelayedU);
+    rWriter.writeDouble(mDelayed2U);
+    rWriter.writeDouble(mDelayedY);
+    rWriter.writeDouble(mDelayed2Y);
+    rWriter.writeDouble(mMin);
+    rWriter.writeDouble(mMax);
+    rWriter.writeDouble(mTimeStep);
+    rWriter.writeDoubles(mCoeffU, 3);
+    rWriter.writeDoubles(mCoeffY, 3);
+    rWriter.writeBool(mIsSaturated);
+    mBackupU.saveState(rWriter);
+    mBackupY.saveState(rWriter);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool SecondOrderTransferFunction::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mValue);
+    ok = ok && rReader.readDouble(mDelayedU);
+    ok = ok && rReader.readDouble(mDelayed2U);
+    ok = ok && rReader.readDouble(mDelayedY);
+    ok = ok && rReader.readDouble(mDelayed2Y);
+    ok = ok && rReader.readDouble(mMin);
+    ok = ok && rReader.readDouble(mMax);
+    ok = ok && rReader.readDouble(mTimeStep);
+    ok = ok && rReader.readDoubles(mCoeffU, 3);
+    ok = ok && rReader.readDoubles(mCoeffY, 3);
+    ok = ok && rReader.readBool(mIsSaturated);
+    ok = ok && mBackupU.restoreState(rReader);
+    ok = ok && mBackupY.restoreState(rReader);
+    return ok;
+}
+
 
 
 
@@ -354,6 +392,38 @@ double SecondOrderTransferFunctionVariable::value()
     return mValue;
 }
 
+//! @brief Write the internal state to a checkpoint
+void SecondOrderTransferFunctionVariable::saveState(StateWriter &rWriter) const
+{
+    rWriter.writeDouble(mValue);
+    rWriter.writeDouble(mMin);
+    rWriter.writeDouble(mMax);
+    rWriter.writeDouble(mPrevTimeStep);
+    rWriter.writeDoubles(mDelayU, 2);
+    rWriter.writeDoubles(mDelayY, 2);
+    rWriter.writeDoubles(mNum, 3);
+    rWriter.writeDoubles(mDen, 3);
+    rWriter.writeDoubles(mCoeffU, 3);
+    rWriter.writeDoubles(mCoeffY, 3);
+}
+
+//! @brief Restore the internal state from a checkpoint
+//! @returns False if the state data is incomplete
+bool SecondOrderTransferFunctionVariable::restoreState(StateReader &rReader)
+{
+    bool ok = rReader.readDouble(mValue);
+    ok = ok && rReader.readDouble(mMin);
+    ok = ok && rReader.readDouble(mMax);
+    ok = ok && rReader.readDouble(mPrevTimeStep);
+    ok = ok && rReader.readDoubles(mDelayU, 2);
+    ok = ok && rReader.readDoubles(mDelayY, 2);
+    ok = ok && rReader.readDoubles(mNum, 3);
+    ok = ok && rReader.readDoubles(mDen, 3);
+    ok = ok && rReader.readDoubles(mCoeffU, 3);
+    ok = ok && rReader.readDoubles(mCoeffY, 3);
+    return ok;
+}
+
 void SecondOrderTransferFunctionVariable::recalculateCoefficients()
 {
     mCoeffU[0] = mNum[0]*(*mpTimeStep)*(*mpTimeStep) + 2.0*mNum[1]*(*mpTimeStep) + 4.0*mNum[2];
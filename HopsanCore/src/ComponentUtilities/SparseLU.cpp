@@ -0,0 +1,342 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SparseLU.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a sparse LU factorization for equation systems with a fixed sparsity pattern
+//!
+//$Id$
+
+#include "ComponentUtilities/SparseLU.h"
+#include <cmath>
+
+using namespace hopsan;
+
+//! @class hopsan::SparseLU
+SparseLU::SparseLU()
+{
+    mN = 0;
+    mPivotTolerance = 0.1;
+    mIsFactorized = false;
+}
+
+
+//! @brief Set the sparsity pattern of the matrix
+//! @param[in] n The number of rows and columns
+//! @param[in] pRowPointers Array with n+1 elements, the values of row i are at positions pRowPointers[i] to pRowPointers[i+1]-1
+//! @param[in] pColumnIndices The column index of each value
+//! @returns False if the pattern is invalid
+bool SparseLU::analyze(const int n, const int *pRowPointers, const int *pColumnIndices)
+{
+    mIsFactorized = false;
+    mN = 0;
+    if(n < 0 || pRowPointers[0] != 0)
+    {
+        return false;
+    }
+    for(int i=0; i<n; ++i)
+    {
+        if(pRowPointers[i+1] < pRowPointers[i])
+        {
+            return false;
+        }
+    }
+    const int nnz = pRowPointers[n];
+    for(int p=0; p<nnz; ++p)
+    {
+        if(pColumnIndices[p] < 0 || pColumnIndices[p] >= n)
+        {
+            return false;
+        }
+    }
+
+    // Transpose the pattern to compressed sparse column format, and remember where each value comes from
+    mColPointers.assign(n+1, 0);
+    for(int p=0; p<nnz; ++p)
+    {
+        ++mColPointers[pColumnIndices[p]+1];
+    }
+    for(int j=0; j<n; ++j)
+    {
+        mColPointers[j+1] += mColPointers[j];
+    }
+    std::vector<int> next(mColPointers.begin(), mColPointers.end()-1);
+    mRowIndices.resize(nnz);
+    mCsrPositions.resize(nnz);
+    for(int i=0; i<n; ++i)
+    {
+        for(int p=pRowPointers[i]; p<pRowPointers[i+1]; ++p)
+        {
+            const int c = next[pColumnIndices[p]]++;
+            mRowIndices[c] = i;
+            mCsrPositions[c] = p;
+        }
+    }
+    mValues.resize(nnz);
+
+    mLColPointers.resize(n+1);
+    mUColPointers.resize(n+1);
+    mPivotRowInv.resize(n);
+    mReachStack.resize(2*n);
+    mWork.assign(n, 0.0);
+    mN = n;
+    return true;
+}
+
+
+//! @brief Finds the rows of column k of L\\A(:,k) that may be non-zero, in topological order
+//! @returns The first position of the result in mReachStack, the result ends at position n-1
+int SparseLU::reach(const int k)
+{
+    int *pStack = &mReachStack[0];
+    int *pPositions = &mReachStack[mN];
+    std::vector<char> &rMarked = mMarked;
+    int top = mN;
+    for(int p=mColPointers[k]; p<mColPointers[k+1]; ++p)
+    {
+        if(rMarked[mRowIndices[p]])
+        {
+            continue;
+        }
+
+        // Depth-first search in the graph of L, from row i
+        int head = 0;
+        pStack[0] = mRowIndices[p];
+        while(head >= 0)
+        {
+            const int j = pStack[head];
+            const int jcol = mPivotRowInv[j];
+            if(!rMarked[j])
+            {
+                rMarked[j] = 1;
+                pPositions[head] = (jcol < 0) ? 0 : mLColPointers[jcol]+1;
+            }
+            bool done = true;
+            const int pend = (jcol < 0) ? 0 : mLColPointers[jcol+1];
+            for(int q=pPositions[head]; q<pend; ++q)
+            {
+                const int i = mLRowIndices[q];
+                if(rMarked[i])
+                {
+                    continue;
+                }
+                pPositions[head] = q+1;
+                pStack[++head] = i;
+                done = false;
+                break;
+            }
+            if(done)
+            {
+                --head;
+                pStack[--top] = j;
+            }
+        }
+    }
+    for(int p=top; p<mN; ++p)
+    {
+        rMarked[pStack[p]] = 0;
+    }
+    return top;
+}
+
+
+//! @brief Factorize the matrix
+//! @param[in] pValues The values of the matrix, in the order of the pattern given to analyze()
+//! @returns False if the matrix is singular
+bool SparseLU::factorize(const double *pValues)
+{
+    mIsFactorized = false;
+    const int n = mN;
+    for(size_t c=0; c<mValues.size(); ++c)
+    {
+        mValues[c] = pValues[mCsrPositions[c]];
+    }
+
+    mLRowIndices.clear();
+    mLValues.clear();
+    mURowIndices.clear();
+    mUValues.clear();
+    mMarked.assign(n, 0);
+    mPivotRowInv.assign(n, -1);
+    mWork.assign(n, 0.0);
+    double *x = mWork.data();
+    const int *xi = mReachStack.data();
+
+    for(int k=0; k<n; ++k)
+    {
+        mLColPointers[k] = int(mLValues.size());
+        mUColPointers[k] = int(mUValues.size());
+
+        // Sparse triangular solve x = L\A(:,k)
+        const int top = reach(k);
+        for(int p=mColPointers[k]; p<mColPointers[k+1]; ++p)
+        {
+            x[mRowIndices[p]] += mValues[p];
+        }
+        for(int px=top; px<n; ++px)
+        {
+            const int j = xi[px];
+            const int jcol = mPivotRowInv[j];
+            if(jcol < 0)
+            {
+                continue;
+            }
+            const double xj = x[j];
+            for(int q=mLColPointers[jcol]+1; q<mLColPointers[jcol+1]; ++q)
+            {
+                x[mLRowIndices[q]] -= mLValues[q]*xj;
+            }
+        }
+
+        // Store column k of U and find the pivot among the rows that are not yet pivotal
+        int ipiv = -1;
+        double a = -1;
+        for(int px=top; px<n; ++px)
+        {
+            const int i = xi[px];
+            if(mPivotRowInv[i] < 0)
+            {
+                if(std::fabs(x[i]) > a)
+                {
+                    a = std::fabs(x[i]);
+                    ipiv = i;
+                }
+            }
+            else
+            {
+                mURowIndices.push_back(mPivotRowInv[i]);
+                mUValues.push_back(x[i]);
+            }
+        }
+        if(ipiv < 0 || !(a > 0))
+        {
+            for(int px=top; px<n; ++px)
+            {
+                x[xi[px]] = 0;
+            }
+            return false;
+        }
+        if(mPivotRowInv[k] < 0 && std::fabs(x[k]) >= a*mPivotTolerance)
+        {
+            ipiv = k;
+        }
+
+        const double pivot = x[ipiv];
+        mURowIndices.push_back(k);
+        mUValues.push_back(pivot);
+        mPivotRowInv[ipiv] = k;
+        mLRowIndices.push_back(ipiv);
+        mLValues.push_back(1.0);
+        for(int px=top; px<n; ++px)
+        {
+            const int i = xi[px];
+            if(mPivotRowInv[i] < 0)
+            {
+                mLRowIndices.push_back(i);
+                mLValues.push_back(x[i]/pivot);
+            }
+            x[i] = 0;
+        }
+    }
+    mLColPointers[n] = int(mLValues.size());
+    mUColPointers[n] = int(mUValues.size());
+
+    // Number the rows of L in pivot order
+    for(size_t q=0; q<mLRowIndices.size(); ++q)
+    {
+        mLRowIndices[q] = mPivotRowInv[mLRowIndices[q]];
+    }
+    mIsFactorized = true;
+    return true;
+}
+
+
+//! @brief Solve A*x = b with the last factorization
+//! @param[in,out] pRhs The right-hand side b, replaced by the solution x
+void SparseLU::solve(double *pRhs)
+{
+    if(!mIsFactorized)
+    {
+        return;
+    }
+    const int n = mN;
+    double *x = mWork.data();
+    for(int i=0; i<n; ++i)
+    {
+        x[mPivotRowInv[i]] = pRhs[i];
+    }
+    for(int j=0; j<n; ++j)
+    {
+        const double xj = x[j];
+        for(int q=mLColPointers[j]+1; q<mLColPointers[j+1]; ++q)
+        {
+            x[mLRowIndices[q]] -= mLValues[q]*xj;
+        }
+    }
+    for(int j=n-1; j>=0; --j)
+    {
+        x[j] /= mUValues[mUColPointers[j+1]-1];
+        const double xj = x[j];
+        for(int q=mUColPointers[j]; q<mUColPointers[j+1]-1; ++q)
+        {
+            x[mURowIndices[q]] -= mUValues[q]*xj;
+        }
+    }
+    for(int i=0; i<n; ++i)
+    {
+        pRhs[i] = x[i];
+        x[i] = 0;
+    }
+}
+
+
+//! @brief Returns the number of rows and columns
+int SparseLU::size() const
+{
+    return mN;
+}
+
+
+//! @brief Returns the number of values in the sparsity pattern
+size_t SparseLU::getNumNonZeros() const
+{
+    return mValues.size();
+}
+
+
+//! @brief Returns the number of values in the L and U factors, including fill-in
+size_t SparseLU::getNumFactorNonZeros() const
+{
+    return mLValues.size() + mUValues.size();
+}
+
+
+//! @brief Set how much smaller than the largest candidate the diagonal may be and still be chosen as pivot
+//! @param[in] tolerance Between 0 and 1, 1 gives ordinary partial pivoting (default 0.1)
+void SparseLU::setPivotTolerance(const double tolerance)
+{
+    mPivotTolerance = tolerance;
+}
@@ -32,22 +32,14 @@
 //$Id$
 
 #include "ComponentUtilities/WhiteGaussianNoise.h"
-#include <stdlib.h>
-// For MSVC we need this define to get access to M_PI
-#define _USE_MATH_DEFINES
-#include <cmath>
+#include "ComponentUtilities/RandomStream.h"
 
 
 using namespace hopsan;
 
 double WhiteGaussianNoise::getValue()
 {
-    // Calc Gaussian random value
-     double random1 = 0;
-     while(random1 == 0)
-     {
-        random1 = (double)rand() / (double)RAND_MAX;
-     }
-     double random2 = (double)rand() / (double)RAND_MAX;
-     return sqrt((-2.0)*log(random1))*cos(2.0*M_PI*random2);
+    // Each thread has its own stream, so that simultaneous calls do not race on a shared generator state
+    static thread_local RandomStream stream;
+    return stream.nextNormal();
 }
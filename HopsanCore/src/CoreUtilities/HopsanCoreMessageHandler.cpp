@@ -61,6 +61,7 @@ HopsanCoreMessageHandler::HopsanCoreMessageHandler()
 HopsanCoreMessageHandler::~HopsanCoreMessageHandler()
 {
     clear();
+    delete mpPrivates;
 }
 
 //! @brief Adds a message to the message queue
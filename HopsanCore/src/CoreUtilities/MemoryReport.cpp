@@ -0,0 +1,182 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   MemoryReport.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the memory footprint report for simulation models
+//!
+//$Id$
+
+#include "CoreUtilities/MemoryReport.h"
+#include "CoreUtilities/StringUtilities.h"
+
+#include <string>
+
+using namespace hopsan;
+
+MemoryUsageEntry::MemoryUsageEntry()
+{
+    mNodeDataBytes = 0;
+    mLogDataBytes = 0;
+    mComponentDataBytes = 0;
+    mLookupDataBytes = 0;
+}
+
+size_t MemoryUsageEntry::getTotalBytes() const
+{
+    return mNodeDataBytes + mLogDataBytes + mComponentDataBytes + mLookupDataBytes;
+}
+
+
+//! @brief Constructor
+//! @param [in] isEstimate True if the report is made before initialize, components should then estimate their buffer sizes
+MemoryReport::MemoryReport(const bool isEstimate)
+{
+    mIsEstimate = isEstimate;
+}
+
+//! @brief Start a new entry, all following additions are counted for this system
+//! @param [in] rName The full name of the system
+void MemoryReport::beginSystem(const HString &rName)
+{
+    mEntries.push_back(MemoryUsageEntry());
+    mEntries.back().mName = rName;
+}
+
+void MemoryReport::addNodeData(const size_t bytes)
+{
+    currentEntry().mNodeDataBytes += bytes;
+}
+
+void MemoryReport::addLogData(const size_t bytes)
+{
+    currentEntry().mLogDataBytes += bytes;
+}
+
+void MemoryReport::addComponentData(const size_t bytes)
+{
+    currentEntry().mComponentDataBytes += bytes;
+}
+
+//! @brief Add lookup table data
+//! @param [in] rKey Identifies data that may be shared, data with the same key is only counted the first time. Use an empty key for data that is never shared.
+//! @param [in] bytes The size of the data
+void MemoryReport::addLookupData(const HString &rKey, const size_t bytes)
+{
+    if (rKey.empty() || mCountedLookupKeys.insert(rKey).second)
+    {
+        currentEntry().mLookupDataBytes += bytes;
+    }
+}
+
+bool MemoryReport::isEstimate() const
+{
+    return mIsEstimate;
+}
+
+const std::vector<MemoryUsageEntry> &MemoryReport::getEntries() const
+{
+    return mEntries;
+}
+
+//! @brief Returns the sum of all entries
+MemoryUsageEntry MemoryReport::getTotals() const
+{
+    MemoryUsageEntry totals;
+    totals.mName = "Total";
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        totals.mNodeDataBytes += mEntries[i].mNodeDataBytes;
+        totals.mLogDataBytes += mEntries[i].mLogDataBytes;
+        totals.mComponentDataBytes += mEntries[i].mComponentDataBytes;
+        totals.mLookupDataBytes += mEntries[i].mLookupDataBytes;
+    }
+    return totals;
+}
+
+size_t MemoryReport::getTotalBytes() const
+{
+    return getTotals().getTotalBytes();
+}
+
+//! @brief Formats the report as a human readable table, one row per system followed by the totals
+HString MemoryReport::toTable() const
+{
+    std::string table;
+    table.append(mIsEstimate ? "Estimated memory usage\n" : "Allocated memory usage\n");
+    table.append(formatString("%12s %12s %12s %12s %12s  %s\n", "Node data", "Log data", "Components", "Lookup data", "Total", "System"));
+    std::vector<MemoryUsageEntry> rows = mEntries;
+    rows.push_back(getTotals());
+    for (size_t i=0; i<rows.size(); ++i)
+    {
+        const MemoryUsageEntry &rEntry = rows[i];
+        table.append(formatString("%12s %12s %12s %12s %12s  %s\n", formatByteSize(rEntry.mNodeDataBytes).c_str(),
+                                  formatByteSize(rEntry.mLogDataBytes).c_str(), formatByteSize(rEntry.mComponentDataBytes).c_str(),
+                                  formatByteSize(rEntry.mLookupDataBytes).c_str(), formatByteSize(rEntry.getTotalBytes()).c_str(),
+                                  rEntry.mName.c_str()));
+    }
+    return HString(table.c_str());
+}
+
+//! @brief Formats the report as CSV, one row per system, sizes in bytes
+HString MemoryReport::toCSV() const
+{
+    std::string csv("system,node_data,log_data,component_data,lookup_data,total\n");
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        const MemoryUsageEntry &rEntry = mEntries[i];
+        csv.append(formatString("%s,%zu,%zu,%zu,%zu,%zu\n", rEntry.mName.c_str(), rEntry.mNodeDataBytes, rEntry.mLogDataBytes,
+                                rEntry.mComponentDataBytes, rEntry.mLookupDataBytes, rEntry.getTotalBytes()));
+    }
+    return HString(csv.c_str());
+}
+
+MemoryUsageEntry &MemoryReport::currentEntry()
+{
+    if (mEntries.empty())
+    {
+        beginSystem("");
+    }
+    return mEntries.back();
+}
+
+
+HString hopsan::formatByteSize(const size_t bytes)
+{
+    const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = double(bytes);
+    size_t u=0;
+    while ((value >= 1024.0) && (u < 4))
+    {
+        value /= 1024.0;
+        ++u;
+    }
+    if (u == 0)
+    {
+        return HString(formatString("%zu B", bytes).c_str());
+    }
+    return HString(formatString("%.2f %s", value, units[u]).c_str());
+}
@@ -44,6 +44,9 @@
 #endif
 
 #include "CoreUtilities/MultiThreadingUtilities.h"
+#include "CoreUtilities/SimulationProfiler.h"
+#include "CoreUtilities/SimulationTracer.h"
+#include "CoreUtilities/SchedulingReport.h"
 #include "ComponentSystem.h"
 
 namespace hopsan {
@@ -86,6 +89,91 @@ size_t determineActualNumberOfThreads(const size_t nDesiredThreads)
 
 #if defined(HOPSANCORE_USEMULTITHREADING)
 
+namespace {
+
+//! @brief Simulates a group of components, they are measured in profiled steps and recorded individually in traced steps if component tracing is enabled
+//! @param [in] rComponents The components to simulate
+//! @param [in] time The time to simulate to
+//! @param [in] sample True if this is a profiled step
+//! @param [in,out] rBusyTime Accumulates the time spent in components in profiled steps
+//! @param [in] pTrace Trace buffer if this is a traced step, otherwise 0
+//! @param [in] pCounters Hardware counters of this thread if they are measured when profiling, otherwise 0
+inline void simulateComponentGroup(std::vector<Component*> &rComponents, const double time, const bool sample, double &rBusyTime,
+                                   SimulationTraceBuffer *pTrace, const PerformanceCounters *pCounters)
+{
+    if(sample)
+    {
+        rBusyTime += simulateAndProfileComponents(rComponents, time, pCounters);
+    }
+    else if(pTrace && pTrace->tracesComponents())
+    {
+        pTrace->simulateAndTraceComponents(rComponents, time);
+    }
+    else
+    {
+        for(size_t i=0; i<rComponents.size(); ++i)
+        {
+            rComponents[i]->simulate(time);
+        }
+    }
+}
+
+//! @brief Measures busy and barrier wait time per phase in every N:th step of a simulation thread
+//! @details Times are accumulated in the thread that owns the sampler and are only stored to shared memory when the thread finishes
+class SchedulingSampler
+{
+public:
+    SchedulingSampler(const size_t sampleInterval)
+    {
+        mSampleInterval = sampleInterval;
+        mSampling = false;
+    }
+
+    inline void beginStep(const size_t step)
+    {
+        ++mStatistics.mNumSteps;
+        mSampling = (mSampleInterval > 0) && ((step % mSampleInterval) == 0);
+        if(mSampling)
+        {
+            ++mStatistics.mNumSampledSteps;
+            mMark = ProfilerClockT::now();
+        }
+    }
+
+    //! @brief Records the time since the previous mark as waiting at the barrier that begins phase
+    inline void waited(const SchedulingPhaseT phase)
+    {
+        if(mSampling) mStatistics.mWaitTime[phase] += lap();
+    }
+
+    //! @brief Records the time since the previous mark as work in phase
+    inline void worked(const SchedulingPhaseT phase)
+    {
+        if(mSampling) mStatistics.mBusyTime[phase] += lap();
+    }
+
+    void store(SchedulingThreadStatistics *pStatistics) const
+    {
+        if(pStatistics) *pStatistics = mStatistics;
+    }
+
+private:
+    inline double lap()
+    {
+        const ProfilerClockT::time_point now = ProfilerClockT::now();
+        const double seconds = std::chrono::duration<double>(now-mMark).count();
+        mMark = now;
+        return seconds;
+    }
+
+    size_t mSampleInterval;
+    bool mSampling;
+    ProfilerClockT::time_point mMark;
+    SchedulingThreadStatistics mStatistics;
+};
+
+}
+
 //! @brief Constructor for slave simulation thread function.
 //! @param pSystem Pointer to top level component system
 //! @param sVector Vector with signal components executed from this thread
@@ -99,6 +187,9 @@ size_t determineActualNumberOfThreads(const size_t nDesiredThreads)
 //! @param *pBarrier_C Pointer to barrier before C-type components
 //! @param *pBarrier_Q Pointer to barrier before Q-type components
 //! @param *pBarrier_N Pointer to barrier before node logging
+//! @param *pProfiledWaitTime Accumulates the time spent waiting at barriers in profiled steps, if profiling is enabled in pSystem
+//! @param *pTraceBuffer Trace buffer for this thread, or 0 if tracing is disabled
+//! @param *pSchedulingStatistics Receives the busy and wait times of this thread when it finishes, or 0
 void simSlave(ComponentSystem *pSystem,
               std::vector<Component*> &sVector,
               std::vector<Component*> &cVector,
@@ -110,26 +201,41 @@ void simSlave(ComponentSystem *pSystem,
               BarrierLock *pBarrier_S,
               BarrierLock *pBarrier_C,
               BarrierLock *pBarrier_Q,
-              BarrierLock *pBarrier_N)
+              BarrierLock *pBarrier_N,
+              double *pProfiledWaitTime,
+              SimulationTraceBuffer *pTraceBuffer,
+              SchedulingThreadStatistics *pSchedulingStatistics)
 {
     (void)nVector;
 
     double time = startTime;
+    const size_t sampleInterval = pSystem->getProfilingSampleInterval();
+    const PerformanceCounters *pCounters = pSystem->getProfilingHardwareCounters() ? PerformanceCounters::getThreadInstance() : 0;
+    SchedulingSampler scheduling(pSystem->getSchedulingSampleInterval());
 
     for(size_t i=0; i<numSimSteps; ++i)
     {
         time += timeStep;
+        scheduling.beginStep(i);
+
+        // In profiled steps, the time not spent in components is time spent waiting at barriers
+        const bool sample = (sampleInterval > 0) && ((i % sampleInterval) == 0);
+        const ProfilerClockT::time_point stepStart = sample ? ProfilerClockT::now() : ProfilerClockT::time_point();
+        double busyTime = 0;
+        SimulationTraceBuffer *pTrace = (pTraceBuffer && pTraceBuffer->beginStep(i)) ? pTraceBuffer : 0;
+        ProfilerClockT::time_point traceMark = pTrace ? ProfilerClockT::now() : ProfilerClockT::time_point();
 
         //! Signal Components !//
 
         pBarrier_S->increment();
         while(pBarrier_S->isLocked()){}                         //Wait at S barrier
         if(pSystem->wasSimulationAborted()) break;
+        if(pTrace) traceMark = pTrace->record(TraceWaitS, traceMark);
+        scheduling.waited(SchedulingSignalPhase);
 
-        for(size_t i=0; i<sVector.size(); ++i)
-        {
-            sVector[i]->simulate(time);
-        }
+        simulateComponentGroup(sVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceSignalComponents, traceMark);
+        scheduling.worked(SchedulingSignalPhase);
 
 
         //! C Components !//
@@ -137,11 +243,12 @@ void simSlave(ComponentSystem *pSystem,
         pBarrier_C->increment();
         while(pBarrier_C->isLocked()){}                         //Wait at C barrier
         if(pSystem->wasSimulationAborted()) break;
+        if(pTrace) traceMark = pTrace->record(TraceWaitC, traceMark);
+        scheduling.waited(SchedulingCPhase);
 
-        for(size_t i=0; i<cVector.size(); ++i)
-        {
-            cVector[i]->simulate(time);
-        }
+        simulateComponentGroup(cVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceCComponents, traceMark);
+        scheduling.worked(SchedulingCPhase);
 
 
         //! Q Components !//
@@ -149,17 +256,24 @@ void simSlave(ComponentSystem *pSystem,
         pBarrier_Q->increment();
         while(pBarrier_Q->isLocked()){}                         //Wait at Q barrier
         if(pSystem->wasSimulationAborted()) break;
+        if(pTrace) traceMark = pTrace->record(TraceWaitQ, traceMark);
+        scheduling.waited(SchedulingQPhase);
 
-        for(size_t i=0; i<qVector.size(); ++i)
-        {
-            qVector[i]->simulate(time);
-        }
+        simulateComponentGroup(qVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceQComponents, traceMark);
+        scheduling.worked(SchedulingQPhase);
 
         //! Log Nodes !//
 
         pBarrier_N->increment();
         while(pBarrier_N->isLocked()){}                         //Wait at N barrier
         if(pSystem->wasSimulationAborted()) break;
+        if(pTrace) traceMark = pTrace->record(TraceWaitN, traceMark);
+        scheduling.waited(SchedulingLogPhase);
+        if(sample)
+        {
+            *pProfiledWaitTime += profilerSecondsSince(stepStart) - busyTime;
+        }
         //! @todo Temporary hack by Peter, after rewriting how node data and time is logged this no longer works, now master thread loags all nodes, need to come up with something smart
         //            for(size_t i=0; i<mVectorN.size(); ++i)
         //            {
@@ -167,6 +281,8 @@ void simSlave(ComponentSystem *pSystem,
         //            }
 
     }
+
+    scheduling.store(pSchedulingStatistics);
 }
 
 
@@ -184,18 +300,34 @@ void simSlave(ComponentSystem *pSystem,
 //! @param *pBarrier_C Pointer to barrier before C-type components
 //! @param *pBarrier_Q Pointer to barrier before Q-type components
 //! @param *pBarrier_N Pointer to barrier before node logging
+//! @param *pProfiledWaitTime Accumulates the time spent waiting at barriers in profiled steps, if profiling is enabled in pSystem
+//! @param *pProfiledLoggingTime Accumulates the time spent logging in profiled steps
+//! @param *pTraceBuffer Trace buffer for this thread, or 0 if tracing is disabled
+//! @param *pSchedulingStatistics Receives the busy and wait times of this thread when it finishes, or 0
 void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std::vector<Component *> &cVector,
                std::vector<Component *> &qVector, std::vector<Node *> &nVector, std::vector<double *> &pSimTimes, double startTime, double timeStep,
                size_t numSimSteps, BarrierLock *pBarrier_S, BarrierLock *pBarrier_C,
-               BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N)
+               BarrierLock *pBarrier_Q, BarrierLock *pBarrier_N, double *pProfiledWaitTime, double *pProfiledLoggingTime,
+               SimulationTraceBuffer *pTraceBuffer, SchedulingThreadStatistics *pSchedulingStatistics)
 {
     (void)nVector;
 
     double time = startTime;
+    const size_t sampleInterval = pSystem->getProfilingSampleInterval();
+    const PerformanceCounters *pCounters = pSystem->getProfilingHardwareCounters() ? PerformanceCounters::getThreadInstance() : 0;
+    SchedulingSampler scheduling(pSystem->getSchedulingSampleInterval());
 
     for(size_t s=0; s<numSimSteps; ++s)
     {
         time += timeStep;
+        scheduling.beginStep(s);
+
+        // In profiled steps, the time not spent in components or logging is time spent waiting at barriers
+        const bool sample = (sampleInterval > 0) && ((s % sampleInterval) == 0);
+        const ProfilerClockT::time_point stepStart = sample ? ProfilerClockT::now() : ProfilerClockT::time_point();
+        double busyTime = 0;
+        SimulationTraceBuffer *pTrace = (pTraceBuffer && pTraceBuffer->beginStep(s)) ? pTraceBuffer : 0;
+        ProfilerClockT::time_point traceMark = pTrace ? ProfilerClockT::now() : ProfilerClockT::time_point();
 
         //! Signal Components !//
         bool stop=false;
@@ -218,11 +350,12 @@ void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std:
         }
         pBarrier_C->lock();                    //Lock next barrier (must be done before unlocking this one, to prevent deadlocks)
         pBarrier_S->unlock();                  //Unlock signal barrier
+        if(pTrace) traceMark = pTrace->record(TraceWaitS, traceMark);
+        scheduling.waited(SchedulingSignalPhase);
 
-        for(size_t i=0; i<sVector.size(); ++i)
-        {
-            sVector[i]->simulate(time);
-        }
+        simulateComponentGroup(sVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceSignalComponents, traceMark);
+        scheduling.worked(SchedulingSignalPhase);
 
         //! C Components !//
         stop=false;
@@ -244,11 +377,12 @@ void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std:
         }
         pBarrier_Q->lock();
         pBarrier_C->unlock();
+        if(pTrace) traceMark = pTrace->record(TraceWaitC, traceMark);
+        scheduling.waited(SchedulingCPhase);
 
-        for(size_t i=0; i<cVector.size(); ++i)
-        {
-            cVector[i]->simulate(time);
-        }
+        simulateComponentGroup(cVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceCComponents, traceMark);
+        scheduling.worked(SchedulingCPhase);
 
         //! Q Components !//
         stop=false;
@@ -270,10 +404,11 @@ void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std:
         }
         pBarrier_N->lock();
         pBarrier_Q->unlock();
-        for(size_t i=0; i<qVector.size(); ++i)
-        {
-            qVector[i]->simulate(time);
-        }
+        if(pTrace) traceMark = pTrace->record(TraceWaitQ, traceMark);
+        scheduling.waited(SchedulingQPhase);
+        simulateComponentGroup(qVector, time, sample, busyTime, pTrace, pCounters);
+        if(pTrace) traceMark = pTrace->record(TraceQComponents, traceMark);
+        scheduling.worked(SchedulingQPhase);
 
         for(size_t i=0; i<pSimTimes.size(); ++i)
             *pSimTimes[i] = time;     //Update time in component system, so that progress bar can use it
@@ -299,14 +434,31 @@ void simMaster(ComponentSystem *pSystem, std::vector<Component *> &sVector, std:
         }
         pBarrier_S->lock();
         pBarrier_N->unlock();
+        if(pTrace) traceMark = pTrace->record(TraceWaitN, traceMark);
+        scheduling.waited(SchedulingLogPhase);
 
         //! @todo Temporary hack by Peter, after rewriting how node data and time is logged this no longer works, now master thread loags all nodes, need to come up with something smart
         //            for(size_t i=0; i<mVectorN.size(); ++i)
         //            {
         //                mVectorN[i]->logData(time);
         //            }
-        pSystem->logTimeAndNodes(s+1); //s+1 since at s=0 one simulation has been performed /Björn
+        if(sample)
+        {
+            const ProfilerClockT::time_point logStart = ProfilerClockT::now();
+            pSystem->logTimeAndNodes(s+1); //s+1 since at s=0 one simulation has been performed /Björn
+            const double loggingTime = profilerSecondsSince(logStart);
+            *pProfiledLoggingTime += loggingTime;
+            *pProfiledWaitTime += profilerSecondsSince(stepStart) - busyTime - loggingTime;
+        }
+        else
+        {
+            pSystem->logTimeAndNodes(s+1); //s+1 since at s=0 one simulation has been performed /Björn
+        }
+        if(pTrace) traceMark = pTrace->record(TraceLogNodes, traceMark);
+        scheduling.worked(SchedulingLogPhase);
     }
+
+    scheduling.store(pSchedulingStatistics);
 }
 
 
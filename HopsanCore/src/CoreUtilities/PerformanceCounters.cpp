@@ -0,0 +1,204 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   PerformanceCounters.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains hardware performance counters used by the simulation profiler
+//!
+//$Id$
+
+#include "CoreUtilities/PerformanceCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HOPSAN_HAVE_PERF_EVENT
+#endif
+
+using namespace hopsan;
+
+namespace {
+
+#if defined(HOPSAN_HAVE_PERF_EVENT)
+int openPerfEvent(const unsigned long long config, const int groupFd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = (groupFd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // Count the calling thread on any cpu
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+}
+
+PerformanceCounters::PerformanceCounters()
+    : mNumOpened(0)
+{
+    for (int i=0; i<NumCounters; ++i)
+    {
+        mFileDescriptors[i] = -1;
+        mGroupIndex[i] = -1;
+    }
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+    close();
+}
+
+//! @brief Opens the counters for the calling thread, as one group so that they are always counted together
+//! @details Counters other than cycles that the hardware does not support are left unavailable
+//! @returns True if at least the cycle counter could be opened, otherwise see getErrorString()
+bool PerformanceCounters::open()
+{
+    close();
+#if defined(HOPSAN_HAVE_PERF_EVENT)
+    const unsigned long long configs[NumCounters] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                     PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i=0; i<NumCounters; ++i)
+    {
+        const int fd = openPerfEvent(configs[i], mFileDescriptors[Cycles]);
+        if (fd >= 0)
+        {
+            mFileDescriptors[i] = fd;
+            mGroupIndex[i] = mNumOpened++;
+        }
+        else if (i == Cycles)
+        {
+            mErrorString = HString("perf_event_open failed: ")+strerror(errno);
+            return false;
+        }
+    }
+    ioctl(mFileDescriptors[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(mFileDescriptors[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    mErrorString = "Hardware performance counters are only supported on Linux";
+    return false;
+#endif
+}
+
+//! @brief Closes all counters
+void PerformanceCounters::close()
+{
+#if defined(HOPSAN_HAVE_PERF_EVENT)
+    // Close members before the group leader
+    for (int i=NumCounters-1; i>=0; --i)
+    {
+        if (mFileDescriptors[i] >= 0)
+        {
+            ::close(mFileDescriptors[i]);
+        }
+    }
+#endif
+    for (int i=0; i<NumCounters; ++i)
+    {
+        mFileDescriptors[i] = -1;
+        mGroupIndex[i] = -1;
+    }
+    mNumOpened = 0;
+}
+
+bool PerformanceCounters::isAvailable() const
+{
+    return mNumOpened > 0;
+}
+
+bool PerformanceCounters::isCounterAvailable(const CounterEnumT counter) const
+{
+    return mGroupIndex[counter] >= 0;
+}
+
+//! @brief Returns the reason why the counters could not be opened
+const HString &PerformanceCounters::getErrorString() const
+{
+    return mErrorString;
+}
+
+//! @brief Reads the current counter values, unavailable counters are set to zero
+//! @returns True if the values could be read
+bool PerformanceCounters::read(CounterValuesT &rValues) const
+{
+#if defined(HOPSAN_HAVE_PERF_EVENT)
+    if (mNumOpened > 0)
+    {
+        // Group read format is the number of values followed by the values
+        unsigned long long buffer[1+NumCounters];
+        if (::read(mFileDescriptors[Cycles], buffer, sizeof(buffer)) > 0)
+        {
+            for (int i=0; i<NumCounters; ++i)
+            {
+                rValues[i] = (mGroupIndex[i] >= 0) ? buffer[1+mGroupIndex[i]] : 0;
+            }
+            return true;
+        }
+    }
+#endif
+    for (int i=0; i<NumCounters; ++i)
+    {
+        rValues[i] = 0;
+    }
+    return false;
+}
+
+const char *PerformanceCounters::getCounterName(const CounterEnumT counter)
+{
+    switch (counter)
+    {
+    case Cycles : return "cycles";
+    case Instructions : return "instructions";
+    case CacheMisses : return "cacheMisses";
+    case BranchMisses : return "branchMisses";
+    default: return "";
+    }
+}
+
+//! @brief Returns the counters of the calling thread, opened on first use
+//! @returns The counters, or 0 if they are unavailable
+PerformanceCounters *PerformanceCounters::getThreadInstance()
+{
+    static thread_local PerformanceCounters counters;
+    static thread_local bool tried = false;
+    if (!tried)
+    {
+        tried = true;
+        counters.open();
+    }
+    return counters.isAvailable() ? &counters : 0;
+}
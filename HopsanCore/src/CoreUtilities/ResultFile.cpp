@@ -0,0 +1,540 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   ResultFile.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the Hopsan binary result file (.hrb) writer and memory mapped reader
+//!
+//$Id$
+
+#include "CoreUtilities/ResultFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace hopsan;
+
+namespace {
+
+const char gMagic[8] = {'H','O','P','S','R','E','S','\0'};
+const uint32_t gFormatVersion = 1;
+const uint32_t gByteOrderMark = 0x01020304;
+const uint64_t gHeaderSize = 64;
+const uint64_t gColumnAlignment = 64;
+
+//! @brief The fixed size file header
+struct ResultFileHeader
+{
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mByteOrderMark;
+    uint64_t mNumVariables;
+    uint64_t mVariableTableOffset;
+    uint64_t mVariableTableSize;
+    uint64_t mDataOffset;
+    char mReserved[16];
+};
+
+inline uint64_t alignUp(const uint64_t value)
+{
+    return (value + gColumnAlignment - 1) / gColumnAlignment * gColumnAlignment;
+}
+
+void appendBytes(std::vector<char> &rBuffer, const void *pData, const size_t size)
+{
+    const char *pBytes = static_cast<const char*>(pData);
+    rBuffer.insert(rBuffer.end(), pBytes, pBytes+size);
+}
+
+void appendString(std::vector<char> &rBuffer, const HString &rString)
+{
+    const uint32_t len = static_cast<uint32_t>(rString.size());
+    appendBytes(rBuffer, &len, sizeof(len));
+    appendBytes(rBuffer, rString.c_str(), len);
+}
+
+//! @brief Read one value from the variable table, with bounds check
+template<typename T>
+bool readValue(const char *pData, const uint64_t end, uint64_t &rPos, T &rValue)
+{
+    if (rPos + sizeof(T) > end)
+    {
+        return false;
+    }
+    memcpy(&rValue, pData+rPos, sizeof(T));
+    rPos += sizeof(T);
+    return true;
+}
+
+bool readString(const char *pData, const uint64_t end, uint64_t &rPos, HString &rString)
+{
+    uint32_t len;
+    if (!readValue(pData, end, rPos, len) || (rPos + len > end))
+    {
+        return false;
+    }
+    rString.setString(pData+rPos, len);
+    rPos += len;
+    return true;
+}
+
+}
+
+//! @brief Add a variable to be written
+//! @param[in] rName The full variable name
+//! @param[in] rAlias The alias name (may be empty)
+//! @param[in] rUnit The unit
+//! @param[in] rQuantity The physical quantity (may be empty)
+//! @param[in] numSamples The number of data samples
+//! @param[in] fillFunction Function called during writeToFile() to copy the data into the column buffer
+//! @param[in] timeVariableIndex The index of the time (or frequency) variable, -1 if none or if this is a time variable
+//! @returns The index of the new variable
+size_t ResultFileWriter::addVariable(const HString &rName, const HString &rAlias, const HString &rUnit, const HString &rQuantity,
+                                     const size_t numSamples, ColumnFillFunctionT fillFunction, const int timeVariableIndex)
+{
+    ResultFileVariable variable;
+    variable.mName = rName;
+    variable.mAlias = rAlias;
+    variable.mUnit = rUnit;
+    variable.mQuantity = rQuantity;
+    variable.mNumSamples = numSamples;
+    variable.mTimeVariableIndex = timeVariableIndex;
+    mVariables.push_back(variable);
+    mFillFunctions.push_back(fillFunction);
+    return mVariables.size()-1;
+}
+
+//! @brief Set the time variable of an already added variable, useful when the time vector is added after its variables
+void ResultFileWriter::setTimeVariableIndex(const size_t variableIndex, const int timeVariableIndex)
+{
+    if (variableIndex < mVariables.size())
+    {
+        mVariables[variableIndex].mTimeVariableIndex = timeVariableIndex;
+    }
+}
+
+size_t ResultFileWriter::getNumVariables() const
+{
+    return mVariables.size();
+}
+
+//! @brief Write the header, variable table and all data columns to file
+//! @param[in] rFilePath The file to write
+//! @returns True if successful, else see getErrorString()
+bool ResultFileWriter::writeToFile(const HString &rFilePath)
+{
+    mErrorString.clear();
+
+    // Build variable table, first to get its size
+    std::vector<char> table;
+    for (const ResultFileVariable &rVariable : mVariables)
+    {
+        const uint64_t placeholder=0;
+        appendBytes(table, &placeholder, sizeof(placeholder));
+        const uint64_t numSamples = rVariable.mNumSamples;
+        appendBytes(table, &numSamples, sizeof(numSamples));
+        const int64_t timeIdx = rVariable.mTimeVariableIndex;
+        appendBytes(table, &timeIdx, sizeof(timeIdx));
+        appendString(table, rVariable.mName);
+        appendString(table, rVariable.mAlias);
+        appendString(table, rVariable.mUnit);
+        appendString(table, rVariable.mQuantity);
+    }
+
+    // Compute aligned column offsets and patch them into the table
+    const uint64_t dataOffset = alignUp(gHeaderSize + table.size());
+    uint64_t offset = dataOffset;
+    size_t tablePos = 0;
+    size_t maxNumSamples = 0;
+    for (ResultFileVariable &rVariable : mVariables)
+    {
+        rVariable.mDataOffset = offset;
+        memcpy(&table[tablePos], &offset, sizeof(offset));
+        tablePos += 3*sizeof(uint64_t) + 4*sizeof(uint32_t) + rVariable.mName.size() + rVariable.mAlias.size() +
+                    rVariable.mUnit.size() + rVariable.mQuantity.size();
+        offset = alignUp(offset + rVariable.mNumSamples*sizeof(double));
+        maxNumSamples = std::max(maxNumSamples, rVariable.mNumSamples);
+    }
+
+    ResultFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.mMagic, gMagic, sizeof(gMagic));
+    header.mVersion = gFormatVersion;
+    header.mByteOrderMark = gByteOrderMark;
+    header.mNumVariables = mVariables.size();
+    header.mVariableTableOffset = gHeaderSize;
+    header.mVariableTableSize = table.size();
+    header.mDataOffset = dataOffset;
+
+    FILE *pFile = fopen(rFilePath.c_str(), "wb");
+    if (!pFile)
+    {
+        mErrorString = "Could not open file for writing: "+rFilePath;
+        return false;
+    }
+
+    const char padding[gColumnAlignment] = {0};
+    bool isOK = (fwrite(&header, sizeof(header), 1, pFile) == 1);
+    isOK = isOK && (table.empty() || fwrite(table.data(), table.size(), 1, pFile) == 1);
+    uint64_t written = gHeaderSize + table.size();
+
+    // Write columns, reusing one buffer for all of them
+    std::vector<double> column;
+    column.reserve(maxNumSamples);
+    for (size_t v=0; v<mVariables.size() && isOK; ++v)
+    {
+        const ResultFileVariable &rVariable = mVariables[v];
+        const size_t nPad = size_t(rVariable.mDataOffset - written);
+        isOK = (nPad == 0) || (fwrite(padding, nPad, 1, pFile) == 1);
+        written += nPad;
+
+        if (rVariable.mNumSamples > 0)
+        {
+            column.resize(rVariable.mNumSamples);
+            mFillFunctions[v](column.data(), column.size());
+            isOK = isOK && (fwrite(column.data(), sizeof(double), column.size(), pFile) == column.size());
+            written += column.size()*sizeof(double);
+        }
+    }
+
+    if (fclose(pFile) != 0)
+    {
+        isOK = false;
+    }
+    if (!isOK)
+    {
+        mErrorString = "Failed to write result data to file: "+rFilePath;
+    }
+    return isOK;
+}
+
+const HString &ResultFileWriter::getErrorString() const
+{
+    return mErrorString;
+}
+
+
+ResultFileReader::ResultFileReader()
+    : mpMappedData(nullptr), mMappedSize(0), mpFileHandle(nullptr), mpMappingHandle(nullptr)
+{
+}
+
+ResultFileReader::~ResultFileReader()
+{
+    closeFile();
+}
+
+//! @brief Open and memory map a binary result file
+//! @param[in] rFilePath The file to open
+//! @returns True if the file was mapped and its header and variable table are valid
+bool ResultFileReader::openFile(const HString &rFilePath)
+{
+    closeFile();
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(rFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        mErrorString = "Could not open file: "+rFilePath;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(hFile);
+        mErrorString = "Could not determine size of file: "+rFilePath;
+        return false;
+    }
+    HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *pData = (hMapping != NULL) ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (pData == NULL)
+    {
+        if (hMapping != NULL)
+        {
+            CloseHandle(hMapping);
+        }
+        CloseHandle(hFile);
+        mErrorString = "Could not memory map file: "+rFilePath;
+        return false;
+    }
+    mpFileHandle = hFile;
+    mpMappingHandle = hMapping;
+    mMappedSize = uint64_t(fileSize.QuadPart);
+#else
+    int fd = open(rFilePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        mErrorString = "Could not open file: "+rFilePath;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        mErrorString = "Could not determine size of file: "+rFilePath;
+        return false;
+    }
+    void *pData = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    ::close(fd);
+    if (pData == MAP_FAILED)
+    {
+        mErrorString = "Could not memory map file: "+rFilePath;
+        return false;
+    }
+    mMappedSize = uint64_t(st.st_size);
+#endif
+    mpMappedData = static_cast<const char*>(pData);
+
+    if (!parseHeader())
+    {
+        HString error = mErrorString;
+        closeFile();
+        mErrorString = error+": "+rFilePath;
+        return false;
+    }
+    return true;
+}
+
+//! @brief Unmap and close the file, all data pointers become invalid
+void ResultFileReader::closeFile()
+{
+    if (mpMappedData)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mpMappedData);
+        CloseHandle(static_cast<HANDLE>(mpMappingHandle));
+        CloseHandle(static_cast<HANDLE>(mpFileHandle));
+#else
+        munmap(const_cast<char*>(mpMappedData), size_t(mMappedSize));
+#endif
+    }
+    mpMappedData = nullptr;
+    mpFileHandle = nullptr;
+    mpMappingHandle = nullptr;
+    mMappedSize = 0;
+    mVariables.clear();
+    mErrorString.clear();
+}
+
+bool ResultFileReader::isOpen() const
+{
+    return mpMappedData != nullptr;
+}
+
+const HString &ResultFileReader::getErrorString() const
+{
+    return mErrorString;
+}
+
+size_t ResultFileReader::getNumVariables() const
+{
+    return mVariables.size();
+}
+
+//! @brief Get the description of a variable
+//! @returns Pointer to the description, nullptr if idx is out of range
+const ResultFileVariable *ResultFileReader::getVariable(const size_t idx) const
+{
+    if (idx < mVariables.size())
+    {
+        return &mVariables[idx];
+    }
+    return nullptr;
+}
+
+//! @brief Find a variable by full name or alias
+//! @returns The variable index, -1 if not found
+int ResultFileReader::findVariable(const HString &rName) const
+{
+    for (size_t v=0; v<mVariables.size(); ++v)
+    {
+        if (mVariables[v].mName == rName || (!mVariables[v].mAlias.empty() && mVariables[v].mAlias == rName))
+        {
+            return int(v);
+        }
+    }
+    return -1;
+}
+
+//! @brief Get a pointer directly into the mapped data column of a variable, no data is copied
+//! @returns Pointer to getVariable(idx)->mNumSamples doubles, nullptr if idx is out of range or file is not open
+const double *ResultFileReader::getVariableData(const size_t idx) const
+{
+    if (!mpMappedData || idx >= mVariables.size())
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const double*>(mpMappedData + mVariables[idx].mDataOffset);
+}
+
+//! @brief Get a pointer to the time (or frequency) data belonging to a variable
+//! @returns Pointer to the mapped time data, nullptr if the variable has no time variable
+const double *ResultFileReader::getTimeData(const size_t idx) const
+{
+    if (idx >= mVariables.size() || mVariables[idx].mTimeVariableIndex < 0)
+    {
+        return nullptr;
+    }
+    return getVariableData(size_t(mVariables[idx].mTimeVariableIndex));
+}
+
+//! @brief Find the sample range of a variable within a time window, only the time column is accessed (binary search)
+//! @param[in] idx The variable index (a time variable can be given directly)
+//! @param[in] startT The window start time (inclusive)
+//! @param[in] stopT The window stop time (inclusive)
+//! @param[out] rFirst The first sample index in the window
+//! @param[out] rCount The number of samples in the window
+//! @returns False if the variable has no time data
+bool ResultFileReader::findTimeWindow(const size_t idx, const double startT, const double stopT, size_t &rFirst, size_t &rCount) const
+{
+    rFirst = 0;
+    rCount = 0;
+    if (idx >= mVariables.size())
+    {
+        return false;
+    }
+
+    size_t timeIdx = idx;
+    if (mVariables[idx].mTimeVariableIndex >= 0)
+    {
+        timeIdx = size_t(mVariables[idx].mTimeVariableIndex);
+    }
+    const double *pTime = getVariableData(timeIdx);
+    if (!pTime)
+    {
+        return false;
+    }
+
+    const size_t n = std::min(mVariables[timeIdx].mNumSamples, mVariables[idx].mNumSamples);
+    const double *pBegin = std::lower_bound(pTime, pTime+n, startT);
+    const double *pEnd = std::upper_bound(pBegin, pTime+n, stopT);
+    rFirst = size_t(pBegin-pTime);
+    rCount = size_t(pEnd-pBegin);
+    return true;
+}
+
+//! @brief Copy part of a variable data column
+//! @param[in] idx The variable index
+//! @param[in] first The first sample to copy
+//! @param[in] count The maximum number of samples to copy
+//! @param[out] pDst The destination buffer, must be able to hold count values
+//! @returns The number of values actually copied
+size_t ResultFileReader::copyVariableData(const size_t idx, const size_t first, const size_t count, double *pDst) const
+{
+    const double *pData = getVariableData(idx);
+    if (!pData || first >= mVariables[idx].mNumSamples)
+    {
+        return 0;
+    }
+    const size_t n = std::min(count, mVariables[idx].mNumSamples-first);
+    memcpy(pDst, pData+first, n*sizeof(double));
+    return n;
+}
+
+//! @brief Validate the header and read the variable table from the mapped file
+bool ResultFileReader::parseHeader()
+{
+    ResultFileHeader header;
+    if (mMappedSize < sizeof(header))
+    {
+        mErrorString = "File is too small to be a Hopsan binary result file";
+        return false;
+    }
+    memcpy(&header, mpMappedData, sizeof(header));
+    if (memcmp(header.mMagic, gMagic, sizeof(gMagic)) != 0)
+    {
+        mErrorString = "File is not a Hopsan binary result file";
+        return false;
+    }
+    if (header.mByteOrderMark != gByteOrderMark)
+    {
+        mErrorString = "Result file byte order does not match this platform";
+        return false;
+    }
+    if (header.mVersion > gFormatVersion)
+    {
+        mErrorString = HString("Unsupported result file version ")+HString(int(header.mVersion));
+        return false;
+    }
+
+    // Check the table location without overflow, the offset and size are read from the file and can not be trusted
+    if ((header.mVariableTableOffset < gHeaderSize) || (header.mVariableTableOffset > mMappedSize) ||
+        (header.mVariableTableSize > mMappedSize - header.mVariableTableOffset))
+    {
+        mErrorString = "Result file variable table is truncated";
+        return false;
+    }
+    const uint64_t tableEnd = header.mVariableTableOffset + header.mVariableTableSize;
+
+    // Each variable takes at least its offset, sample count, time index and four string lengths in the table
+    const uint64_t minVariableEntrySize = 3*sizeof(uint64_t) + 4*sizeof(uint32_t);
+    if (header.mNumVariables > header.mVariableTableSize/minVariableEntrySize)
+    {
+        mErrorString = "Result file variable table is corrupt";
+        return false;
+    }
+
+    uint64_t pos = header.mVariableTableOffset;
+    mVariables.resize(size_t(header.mNumVariables));
+    for (ResultFileVariable &rVariable : mVariables)
+    {
+        uint64_t numSamples;
+        int64_t timeIdx;
+        bool isOK = readValue(mpMappedData, tableEnd, pos, rVariable.mDataOffset);
+        isOK = isOK && readValue(mpMappedData, tableEnd, pos, numSamples);
+        isOK = isOK && readValue(mpMappedData, tableEnd, pos, timeIdx);
+        isOK = isOK && readString(mpMappedData, tableEnd, pos, rVariable.mName);
+        isOK = isOK && readString(mpMappedData, tableEnd, pos, rVariable.mAlias);
+        isOK = isOK && readString(mpMappedData, tableEnd, pos, rVariable.mUnit);
+        isOK = isOK && readString(mpMappedData, tableEnd, pos, rVariable.mQuantity);
+        if (!isOK)
+        {
+            mErrorString = "Result file variable table is corrupt";
+            return false;
+        }
+        rVariable.mNumSamples = size_t(numSamples);
+        rVariable.mTimeVariableIndex = (timeIdx >= 0 && uint64_t(timeIdx) < header.mNumVariables) ? int(timeIdx) : -1;
+
+        if ((rVariable.mDataOffset % sizeof(double) != 0) || (rVariable.mDataOffset > mMappedSize) ||
+            (numSamples > (mMappedSize - rVariable.mDataOffset)/sizeof(double)))
+        {
+            mErrorString = "Result file data for variable "+rVariable.mName+" is truncated";
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,221 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SchedulingReport.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the load balance statistics of the a priori scheduling algorithm
+//!
+//$Id$
+
+#include "CoreUtilities/SchedulingReport.h"
+#include "CoreUtilities/StringUtilities.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace hopsan;
+
+SchedulingThreadStatistics::SchedulingThreadStatistics()
+{
+    for (size_t p=0; p<NumSchedulingPhases; ++p)
+    {
+        mBusyTime[p] = 0;
+        mWaitTime[p] = 0;
+        mNumComponents[p] = 0;
+    }
+    mNumSteps = 0;
+    mNumSampledSteps = 0;
+}
+
+double SchedulingThreadStatistics::getTotalBusyTime() const
+{
+    double total = 0;
+    for (size_t p=0; p<NumSchedulingPhases; ++p)
+    {
+        total += mBusyTime[p];
+    }
+    return total;
+}
+
+double SchedulingThreadStatistics::getTotalWaitTime() const
+{
+    double total = 0;
+    for (size_t p=0; p<NumSchedulingPhases; ++p)
+    {
+        total += mWaitTime[p];
+    }
+    return total;
+}
+
+
+SchedulingReport::SchedulingReport()
+{
+    mWallTime = 0;
+}
+
+void SchedulingReport::clear()
+{
+    mThreads.clear();
+    mWallTime = 0;
+}
+
+//! @brief Set the statistics collected by the simulation threads
+//! @param [in] rThreads The statistics of each thread, as measured in the sampled steps. The first thread is the master thread.
+//! @param [in] wallTime The wall time of the simulation
+void SchedulingReport::setThreadStatistics(const std::vector<SchedulingThreadStatistics> &rThreads, const double wallTime)
+{
+    mThreads = rThreads;
+    mWallTime = wallTime;
+
+    // Scale the sampled times to estimate the totals for all steps
+    for (size_t t=0; t<mThreads.size(); ++t)
+    {
+        SchedulingThreadStatistics &rThread = mThreads[t];
+        const double scale = (rThread.mNumSampledSteps > 0) ? double(rThread.mNumSteps)/double(rThread.mNumSampledSteps) : 0.0;
+        for (size_t p=0; p<NumSchedulingPhases; ++p)
+        {
+            rThread.mBusyTime[p] *= scale;
+            rThread.mWaitTime[p] *= scale;
+        }
+    }
+}
+
+bool SchedulingReport::isEmpty() const
+{
+    return mThreads.empty();
+}
+
+size_t SchedulingReport::getNumThreads() const
+{
+    return mThreads.size();
+}
+
+//! @brief Returns the number of steps taken by the master thread
+size_t SchedulingReport::getNumSteps() const
+{
+    return mThreads.empty() ? 0 : mThreads.front().mNumSteps;
+}
+
+//! @brief Returns the estimated totals for one thread
+//! @param [in] thread The thread index, 0 is the master thread
+const SchedulingThreadStatistics &SchedulingReport::getThreadStatistics(const size_t thread) const
+{
+    return mThreads.at(thread);
+}
+
+double SchedulingReport::getWallTime() const
+{
+    return mWallTime;
+}
+
+//! @brief Returns the estimated time of a single-threaded simulation, the sum of the busy time of all threads
+double SchedulingReport::getSerialTime() const
+{
+    double total = 0;
+    for (size_t t=0; t<mThreads.size(); ++t)
+    {
+        total += mThreads[t].getTotalBusyTime();
+    }
+    return total;
+}
+
+//! @brief Returns the estimated speedup compared to a single-threaded simulation
+double SchedulingReport::getSpeedup() const
+{
+    if (mWallTime <= 0)
+    {
+        return 0;
+    }
+    return getSerialTime()/mWallTime;
+}
+
+//! @brief Returns the speedup divided by the number of threads, 1 means that no thread ever waited at a barrier
+double SchedulingReport::getParallelEfficiency() const
+{
+    if (mThreads.empty())
+    {
+        return 0;
+    }
+    return getSpeedup()/double(mThreads.size());
+}
+
+//! @brief Returns the busy time of the slowest thread divided by the mean busy time in one phase, 1 means perfect balance
+//! @param [in] phase The scheduling phase
+double SchedulingReport::getLoadImbalance(const SchedulingPhaseT phase) const
+{
+    double maxTime = 0;
+    double sumTime = 0;
+    for (size_t t=0; t<mThreads.size(); ++t)
+    {
+        maxTime = std::max(maxTime, mThreads[t].mBusyTime[phase]);
+        sumTime += mThreads[t].mBusyTime[phase];
+    }
+    if (sumTime <= 0)
+    {
+        return 1;
+    }
+    return maxTime*double(mThreads.size())/sumTime;
+}
+
+//! @brief Formats the report as a human readable table, one row per thread followed by the load imbalance of each phase
+HString SchedulingReport::toTable() const
+{
+    std::string table;
+    table.append(formatString("Parallel scheduling: %zu threads, %zu steps, wall time %.4f s\n", getNumThreads(), getNumSteps(), mWallTime));
+    table.append(formatString("Estimated serial time %.4f s, speedup %.2f, parallel efficiency %.1f %%\n", getSerialTime(), getSpeedup(), 100.0*getParallelEfficiency()));
+    table.append(formatString("%6s %12s %10s %10s %10s %10s %10s %10s %10s %10s %7s\n", "Thread", "Comps S/C/Q", "Busy S", "Busy C", "Busy Q", "Logging",
+                              "Wait S", "Wait C", "Wait Q", "Wait N", "Busy"));
+    for (size_t t=0; t<mThreads.size(); ++t)
+    {
+        const SchedulingThreadStatistics &rThread = mThreads[t];
+        const std::string comps = formatString("%zu/%zu/%zu", rThread.mNumComponents[SchedulingSignalPhase], rThread.mNumComponents[SchedulingCPhase],
+                                               rThread.mNumComponents[SchedulingQPhase]);
+        const double busyPercent = (mWallTime > 0) ? 100.0*rThread.getTotalBusyTime()/mWallTime : 0.0;
+        table.append(formatString("%6zu %12s %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %6.1f%%\n", t, comps.c_str(),
+                                  rThread.mBusyTime[SchedulingSignalPhase], rThread.mBusyTime[SchedulingCPhase], rThread.mBusyTime[SchedulingQPhase],
+                                  rThread.mBusyTime[SchedulingLogPhase], rThread.mWaitTime[SchedulingSignalPhase], rThread.mWaitTime[SchedulingCPhase],
+                                  rThread.mWaitTime[SchedulingQPhase], rThread.mWaitTime[SchedulingLogPhase], busyPercent));
+    }
+    table.append(formatString("Load imbalance (max/mean busy time): S %.2f, C %.2f, Q %.2f\n", getLoadImbalance(SchedulingSignalPhase),
+                              getLoadImbalance(SchedulingCPhase), getLoadImbalance(SchedulingQPhase)));
+    return HString(table.c_str());
+}
+
+//! @brief Formats the report as CSV, one row per thread, times in seconds
+HString SchedulingReport::toCSV() const
+{
+    std::string csv("thread,signal_components,c_components,q_components,busy_s,busy_c,busy_q,logging,wait_s,wait_c,wait_q,wait_n,steps,sampled_steps\n");
+    for (size_t t=0; t<mThreads.size(); ++t)
+    {
+        const SchedulingThreadStatistics &rThread = mThreads[t];
+        csv.append(formatString("%zu,%zu,%zu,%zu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%zu,%zu\n", t, rThread.mNumComponents[SchedulingSignalPhase],
+                                rThread.mNumComponents[SchedulingCPhase], rThread.mNumComponents[SchedulingQPhase],
+                                rThread.mBusyTime[SchedulingSignalPhase], rThread.mBusyTime[SchedulingCPhase], rThread.mBusyTime[SchedulingQPhase],
+                                rThread.mBusyTime[SchedulingLogPhase], rThread.mWaitTime[SchedulingSignalPhase], rThread.mWaitTime[SchedulingCPhase],
+                                rThread.mWaitTime[SchedulingQPhase], rThread.mWaitTime[SchedulingLogPhase], rThread.mNumSteps, rThread.mNumSampledSteps));
+    }
+    return HString(csv.c_str());
+}
@@ -0,0 +1,288 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SimulationCheckpoint.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains functions and a class for writing and restoring binary simulation checkpoints
+//!
+//$Id$
+
+#include "CoreUtilities/SimulationCheckpoint.h"
+#include "ComponentUtilities/StateSerialization.h"
+#include "ComponentUtilities/num2string.hpp"
+#include "ComponentSystem.h"
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+using namespace hopsan;
+
+/*
+ * Checkpoint file layout (native byte order)
+ *
+ * Magic     Version   ByteOrderMark  RootSystemName  RootSystemState
+ * 8-byte    4-byte    4-byte         string          block (see ComponentSystem::saveState)
+ *
+ * */
+
+namespace {
+
+const char gCheckpointMagic[8] = {'H','O','P','S','C','H','K','\0'};
+const uint32_t gCheckpointVersion = 1;
+const uint32_t gCheckpointByteOrderMark = 0x01020304;
+
+void captureCheckpoint(const ComponentSystem *pRootSystem, StateWriter &rWriter)
+{
+    rWriter.writeRaw(gCheckpointMagic, sizeof(gCheckpointMagic));
+    rWriter.writeRaw(&gCheckpointVersion, sizeof(gCheckpointVersion));
+    rWriter.writeRaw(&gCheckpointByteOrderMark, sizeof(gCheckpointByteOrderMark));
+    rWriter.writeString(pRootSystem->getName());
+    const size_t block = rWriter.beginBlock();
+    pRootSystem->saveState(rWriter);
+    rWriter.endBlock(block);
+}
+
+//! @brief Find components, also in subsystems, whose internal state is not saved in checkpoints
+void findComponentsLackingState(const ComponentSystem *pSystem, const HString &rPrefix, std::vector<HString> &rNames)
+{
+    const std::vector<Component*> components = pSystem->getSubComponents();
+    for (size_t c=0; c<components.size(); ++c)
+    {
+        if (components[c]->isComponentSystem())
+        {
+            findComponentsLackingState(static_cast<const ComponentSystem*>(components[c]), rPrefix+components[c]->getName()+"|", rNames);
+        }
+        else if (!components[c]->isDisabled() && (components[c]->getStateSupport() == Component::LacksInternalState))
+        {
+            rNames.push_back(rPrefix+components[c]->getName());
+        }
+    }
+}
+
+//! @brief Warn if the checkpoint does not contain the complete simulation state
+void warnAboutComponentsLackingState(ComponentSystem *pRootSystem)
+{
+    std::vector<HString> names;
+    findComponentsLackingState(pRootSystem, "", names);
+    if (names.empty())
+    {
+        return;
+    }
+    const size_t maxListed = 10;
+    HString list;
+    for (size_t n=0; (n<names.size()) && (n<maxListed); ++n)
+    {
+        list += (n > 0) ? ", "+names[n] : names[n];
+    }
+    if (names.size() > maxListed)
+    {
+        list += " and "+to_hstring(names.size()-maxListed)+" more";
+    }
+    pRootSystem->addWarningMessage("Checkpoint does not contain the internal state of: "+list+". A restarted simulation may give different results.");
+}
+
+//! @brief Write to a temporary file and then replace the target, so that a crash never leaves a half written checkpoint
+bool writeCheckpointFile(const HString &rFilePath, const std::vector<char> &rData)
+{
+    const HString tempPath = rFilePath+".tmp";
+    FILE *pFile = fopen(tempPath.c_str(), "wb");
+    if (!pFile)
+    {
+        return false;
+    }
+    bool isOK = (fwrite(rData.data(), 1, rData.size(), pFile) == rData.size());
+    isOK = (fclose(pFile) == 0) && isOK;
+    if (isOK)
+    {
+#ifdef _WIN32
+        // rename() does not replace existing files on Windows
+        remove(rFilePath.c_str());
+#endif
+        isOK = (rename(tempPath.c_str(), rFilePath.c_str()) == 0);
+    }
+    return isOK;
+}
+
+}
+
+//! @brief Save a complete checkpoint (component, node and log state) of an initialized system
+//! @param [in] rFilePath The checkpoint file
+//! @param [in] pRootSystem The system to save
+//! @returns True if the file was written successfully
+bool hopsan::saveCheckpoint(const HString &rFilePath, ComponentSystem *pRootSystem)
+{
+    warnAboutComponentsLackingState(pRootSystem);
+    StateWriter writer;
+    captureCheckpoint(pRootSystem, writer);
+    if (!writeCheckpointFile(rFilePath, writer.getData()))
+    {
+        pRootSystem->addErrorMessage("Could not write checkpoint file: "+rFilePath);
+        return false;
+    }
+    return true;
+}
+
+//! @brief Restore a checkpoint into a system
+//! @details The system must be the same model, initialized with the same simulation time and log settings as when the
+//! checkpoint was written. Simulation can then be continued from the checkpoint time by calling simulate(stopT).
+//! @param [in] rFilePath The checkpoint file
+//! @param [in] pRootSystem The initialized system to restore into
+//! @returns True if the state was restored
+bool hopsan::restoreCheckpoint(const HString &rFilePath, ComponentSystem *pRootSystem)
+{
+    FILE *pFile = fopen(rFilePath.c_str(), "rb");
+    if (!pFile)
+    {
+        pRootSystem->addErrorMessage("Could not open checkpoint file: "+rFilePath);
+        return false;
+    }
+    std::vector<char> data;
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer+n);
+    }
+    fclose(pFile);
+
+    StateReader reader(data.data(), data.size());
+    char magic[8];
+    uint32_t version, bom;
+    bool isOK = reader.readRaw(magic, sizeof(magic)) && (memcmp(magic, gCheckpointMagic, sizeof(magic)) == 0);
+    isOK = isOK && reader.readRaw(&version, sizeof(version)) && (version == gCheckpointVersion);
+    isOK = isOK && reader.readRaw(&bom, sizeof(bom)) && (bom == gCheckpointByteOrderMark);
+    if (!isOK)
+    {
+        pRootSystem->addErrorMessage("Not a compatible Hopsan checkpoint file: "+rFilePath);
+        return false;
+    }
+
+    HString systemName;
+    StateReader block;
+    isOK = reader.readString(systemName) && reader.readBlock(block);
+    if (isOK && (systemName != pRootSystem->getName()))
+    {
+        pRootSystem->addWarningMessage("Checkpoint was written from system: "+systemName);
+    }
+    if (!isOK || !pRootSystem->restoreState(block))
+    {
+        pRootSystem->addErrorMessage("Failed to restore checkpoint: "+rFilePath+" (model or simulation settings differ)");
+        return false;
+    }
+    warnAboutComponentsLackingState(pRootSystem);
+    return true;
+}
+
+
+//! @brief Constructor
+//! @param [in] rFilePath The checkpoint file, it is replaced by each new checkpoint
+//! @param [in] stepInterval Write a checkpoint every stepInterval simulation steps (0 = disabled)
+//! @param [in] wallTimeInterval Write a checkpoint every wallTimeInterval seconds of real time (0 = disabled)
+CheckpointWriter::CheckpointWriter(const HString &rFilePath, const size_t stepInterval, const double wallTimeInterval)
+    : mFilePath(rFilePath), mStepInterval(stepInterval), mNextStep(stepInterval), mWallTimeInterval(wallTimeInterval),
+      mHasCheckedStateSupport(false), mpRootSystem(0)
+{
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    mWriteFailed = false;
+#endif
+    mNextWallTime = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(mWallTimeInterval));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    waitForPendingWrite();
+}
+
+//! @brief Check if it is time for a new checkpoint
+//! @param [in] simStep The total number of taken simulation steps
+bool CheckpointWriter::isDue(const size_t simStep)
+{
+    if ((mStepInterval > 0) && (simStep >= mNextStep))
+    {
+        mNextStep = simStep + mStepInterval;
+        return true;
+    }
+    // Reading the clock every step is not free, so only look at it every 64 steps
+    if ((mWallTimeInterval > 0) && ((simStep & 0x3F) == 0) && (std::chrono::steady_clock::now() >= mNextWallTime))
+    {
+        mNextWallTime = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(mWallTimeInterval));
+        return true;
+    }
+    return false;
+}
+
+//! @brief Capture the current state and write it to file in the background
+//! @param [in] pRootSystem The system to save, must not be simulating in another thread
+void CheckpointWriter::write(ComponentSystem *pRootSystem)
+{
+    waitForPendingWrite();
+    if (!mHasCheckedStateSupport)
+    {
+        warnAboutComponentsLackingState(pRootSystem);
+        mHasCheckedStateSupport = true;
+    }
+
+    StateWriter *pWriter = new StateWriter();
+    captureCheckpoint(pRootSystem, *pWriter);
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    // The message handler is not thread safe, so a failure is only recorded here and reported by waitForPendingWrite()
+    mpRootSystem = pRootSystem;
+    const HString filePath = mFilePath;
+    std::atomic<bool> *pWriteFailed = &mWriteFailed;
+    mWriteThread = std::thread([pWriter, filePath, pWriteFailed]() {
+        if (!writeCheckpointFile(filePath, pWriter->getData()))
+        {
+            *pWriteFailed = true;
+        }
+        delete pWriter;
+    });
+#else
+    if (!writeCheckpointFile(mFilePath, pWriter->getData()))
+    {
+        pRootSystem->addErrorMessage("Could not write checkpoint file: "+mFilePath);
+    }
+    delete pWriter;
+#endif
+}
+
+//! @brief Block until a checkpoint being written in the background is completed, and report if it failed
+//! @details Call this from the simulation thread
+void CheckpointWriter::waitForPendingWrite()
+{
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    if (mWriteThread.joinable())
+    {
+        mWriteThread.join();
+    }
+    if (mWriteFailed.exchange(false) && mpRootSystem)
+    {
+        mpRootSystem->addErrorMessage("Could not write checkpoint file: "+mFilePath);
+    }
+#endif
+}
@@ -0,0 +1,317 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   SimulationProfiler.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the simulation profiling report
+//!
+//$Id$
+
+#include "CoreUtilities/SimulationProfiler.h"
+#include "ComponentSystem.h"
+#include "CoreUtilities/StringUtilities.h"
+
+#include <algorithm>
+#include <string>
+#include <fstream>
+
+using namespace hopsan;
+
+namespace {
+
+bool compareEntryTime(const ProfilingEntry &rA, const ProfilingEntry &rB)
+{
+    return rA.mTime > rB.mTime;
+}
+
+std::string jsonEscaped(const HString &rString)
+{
+    std::string escaped;
+    for (size_t i=0; i<rString.size(); ++i)
+    {
+        const char c = rString[i];
+        if ((c == '"') || (c == '\\'))
+        {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+}
+
+SimulationProfile::SimulationProfile()
+    : mTotalTime(0), mLoggingTime(0), mBarrierTime(0), mNumSteps(0), mSampleInterval(0), mHasCounters(false)
+{
+}
+
+//! @brief Collects the profiling results from a system and all its subsystems, entries are sorted by time
+//! @param [in] pRootSystem The system that was simulated with profiling enabled
+void SimulationProfile::collect(ComponentSystem *pRootSystem)
+{
+    mEntries.clear();
+    mTotalTime = pRootSystem->getProfiledWallTime();
+    mNumSteps = pRootSystem->getNumProfiledSteps();
+    mSampleInterval = pRootSystem->getProfilingSampleInterval();
+    mLoggingTime = 0;
+    mBarrierTime = 0;
+    mHasCounters = false;
+    mCounterStatus.clear();
+
+    ProfilingEntry root;
+    root.mName = pRootSystem->getName();
+    root.mTypeName = pRootSystem->getTypeName();
+    root.mCQSType = pRootSystem->getTypeCQSString();
+    root.mIsSystem = true;
+    root.mNumCalls = 1;
+    root.mNumSamples = 1;
+    root.mTime = mTotalTime;
+    root.mLoggingTime = pRootSystem->getProfiledLoggingTime();
+    root.mBarrierTime = pRootSystem->getProfiledBarrierTime();
+    root.mHasCounters = false;
+    std::fill(root.mCounters, root.mCounters+PerformanceCounters::NumCounters, 0.0);
+    mEntries.push_back(root);
+    mLoggingTime += root.mLoggingTime;
+    mBarrierTime += root.mBarrierTime;
+
+    collectSystem(pRootSystem, HString());
+
+    // Explain why counters are missing if they were requested
+    if (pRootSystem->getProfilingHardwareCounters() && !mHasCounters)
+    {
+        PerformanceCounters counters;
+        counters.open();
+        mCounterStatus = counters.getErrorString().empty() ? HString("no counted samples") : counters.getErrorString();
+    }
+
+    std::stable_sort(mEntries.begin(), mEntries.end(), compareEntryTime);
+}
+
+void SimulationProfile::collectSystem(ComponentSystem *pSystem, const HString &rPrefix)
+{
+    const size_t numCalls = pSystem->getNumProfiledSteps();
+    const std::vector<Component*> components = pSystem->getSubComponents();
+    for (size_t i=0; i<components.size(); ++i)
+    {
+        Component *pComponent = components[i];
+        if (pComponent->getNumProfiledSamples() == 0)
+        {
+            continue;
+        }
+
+        ProfilingEntry entry;
+        entry.mName = rPrefix+pComponent->getName();
+        entry.mTypeName = pComponent->getTypeName();
+        entry.mCQSType = pComponent->getTypeCQSString();
+        entry.mIsSystem = pComponent->isComponentSystem();
+        entry.mNumCalls = numCalls;
+        entry.mNumSamples = pComponent->getNumProfiledSamples();
+        entry.mTime = pComponent->getProfiledTime()*double(numCalls)/double(entry.mNumSamples);
+        entry.mLoggingTime = 0;
+        entry.mBarrierTime = 0;
+        entry.mHasCounters = (pComponent->getNumCountedSamples() > 0);
+        for (int c=0; c<PerformanceCounters::NumCounters; ++c)
+        {
+            entry.mCounters[c] = entry.mHasCounters ? double(pComponent->getProfiledCounter(PerformanceCounters::CounterEnumT(c)))*
+                                                      double(numCalls)/double(pComponent->getNumCountedSamples()) : 0.0;
+        }
+        mHasCounters = mHasCounters || entry.mHasCounters;
+        if (entry.mIsSystem)
+        {
+            ComponentSystem *pSubSystem = static_cast<ComponentSystem*>(pComponent);
+            entry.mLoggingTime = pSubSystem->getProfiledLoggingTime();
+            entry.mBarrierTime = pSubSystem->getProfiledBarrierTime();
+            mLoggingTime += entry.mLoggingTime;
+            mBarrierTime += entry.mBarrierTime;
+        }
+        mEntries.push_back(entry);
+
+        if (entry.mIsSystem)
+        {
+            collectSystem(static_cast<ComponentSystem*>(pComponent), entry.mName+"|");
+        }
+    }
+}
+
+//! @brief Returns all entries sorted by time, the first entry is normally the root system
+const std::vector<ProfilingEntry> &SimulationProfile::getEntries() const
+{
+    return mEntries;
+}
+
+//! @brief Returns the total wall time of the profiled simulation
+double SimulationProfile::getTotalTime() const
+{
+    return mTotalTime;
+}
+
+//! @brief Returns the estimated time spent logging, in all systems
+double SimulationProfile::getLoggingTime() const
+{
+    return mLoggingTime;
+}
+
+//! @brief Returns the estimated time spent waiting at thread barriers, summed over all threads
+double SimulationProfile::getBarrierTime() const
+{
+    return mBarrierTime;
+}
+
+//! @brief Returns the number of steps taken by the root system
+size_t SimulationProfile::getNumSteps() const
+{
+    return mNumSteps;
+}
+
+size_t SimulationProfile::getSampleInterval() const
+{
+    return mSampleInterval;
+}
+
+//! @brief Returns true if hardware counters were measured for any entry
+bool SimulationProfile::hasCounters() const
+{
+    return mHasCounters;
+}
+
+//! @brief Returns the reason why hardware counters are missing, if they were requested but not measured
+const HString &SimulationProfile::getCounterStatus() const
+{
+    return mCounterStatus;
+}
+
+//! @brief Formats the results as a human readable table
+//! @param [in] maxRows Maximum number of rows, 0 = all
+HString SimulationProfile::toTable(const size_t maxRows) const
+{
+    std::string table;
+    table.append(formatString("Profiled %zu steps, sampling every %zu step(s), total time %.6f s\n", mNumSteps, mSampleInterval, mTotalTime));
+    if (mHasCounters)
+    {
+        table.append(formatString("%12s %7s %10s %10s %6s %12s %12s %4s  %-30s %s\n", "Time [s]", "%", "us/call", "Calls", "IPC",
+                                  "CacheMiss/c", "BranchMiss/c", "CQS", "Type", "Name"));
+    }
+    else
+    {
+        table.append(formatString("%12s %7s %10s %10s %4s  %-30s %s\n", "Time [s]", "%", "us/call", "Calls", "CQS", "Type", "Name"));
+    }
+    const size_t nRows = (maxRows > 0) ? std::min(maxRows, mEntries.size()) : mEntries.size();
+    for (size_t i=0; i<nRows; ++i)
+    {
+        const ProfilingEntry &rEntry = mEntries[i];
+        const double percent = (mTotalTime > 0) ? 100.0*rEntry.mTime/mTotalTime : 0.0;
+        const double usPerCall = (rEntry.mNumCalls > 0) ? 1e6*rEntry.mTime/double(rEntry.mNumCalls) : 0.0;
+        if (mHasCounters)
+        {
+            const double calls = (rEntry.mNumCalls > 0) ? double(rEntry.mNumCalls) : 1.0;
+            const double ipc = (rEntry.mCounters[PerformanceCounters::Cycles] > 0) ?
+                        rEntry.mCounters[PerformanceCounters::Instructions]/rEntry.mCounters[PerformanceCounters::Cycles] : 0.0;
+            table.append(formatString("%12.6f %7.2f %10.3f %10zu %6.2f %12.2f %12.2f %4s  %-30s %s%s\n", rEntry.mTime, percent, usPerCall,
+                                      rEntry.mNumCalls, ipc, rEntry.mCounters[PerformanceCounters::CacheMisses]/calls,
+                                      rEntry.mCounters[PerformanceCounters::BranchMisses]/calls, rEntry.mCQSType.c_str(),
+                                      rEntry.mTypeName.c_str(), rEntry.mName.c_str(), rEntry.mIsSystem ? " (system)" : ""));
+        }
+        else
+        {
+            table.append(formatString("%12.6f %7.2f %10.3f %10zu %4s  %-30s %s%s\n", rEntry.mTime, percent, usPerCall, rEntry.mNumCalls,
+                                      rEntry.mCQSType.c_str(), rEntry.mTypeName.c_str(), rEntry.mName.c_str(), rEntry.mIsSystem ? " (system)" : ""));
+        }
+    }
+    if (nRows < mEntries.size())
+    {
+        table.append(formatString("... %zu more entries\n", mEntries.size()-nRows));
+    }
+    table.append(formatString("Logging: %.6f s, Barrier wait (all threads): %.6f s\n", mLoggingTime, mBarrierTime));
+    if (!mCounterStatus.empty())
+    {
+        table.append(formatString("Hardware counters unavailable: %s\n", mCounterStatus.c_str()));
+    }
+    return HString(table.c_str());
+}
+
+//! @brief Formats the results as CSV, one row per entry
+HString SimulationProfile::toCSV() const
+{
+    std::string csv("name,type,cqs,is_system,calls,samples,time,logging_time,barrier_time,cycles,instructions,cache_misses,branch_misses\n");
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        const ProfilingEntry &rEntry = mEntries[i];
+        csv.append(formatString("%s,%s,%s,%d,%zu,%zu,%.9g,%.9g,%.9g,%.0f,%.0f,%.0f,%.0f\n", rEntry.mName.c_str(), rEntry.mTypeName.c_str(),
+                                rEntry.mCQSType.c_str(), int(rEntry.mIsSystem), rEntry.mNumCalls, rEntry.mNumSamples, rEntry.mTime,
+                                rEntry.mLoggingTime, rEntry.mBarrierTime, rEntry.mCounters[0], rEntry.mCounters[1], rEntry.mCounters[2],
+                                rEntry.mCounters[3]));
+    }
+    return HString(csv.c_str());
+}
+
+//! @brief Formats the results as JSON
+HString SimulationProfile::toJSON() const
+{
+    std::string json("{\n");
+    json.append(formatString("  \"total_time\": %.9g,\n  \"logging_time\": %.9g,\n  \"barrier_time\": %.9g,\n  \"steps\": %zu,\n  \"sample_interval\": %zu,\n",
+                             mTotalTime, mLoggingTime, mBarrierTime, mNumSteps, mSampleInterval));
+    json.append(formatString("  \"has_counters\": %s,\n", mHasCounters ? "true" : "false"));
+    if (!mCounterStatus.empty())
+    {
+        json.append("  \"counter_status\": \"").append(jsonEscaped(mCounterStatus)).append("\",\n");
+    }
+    json.append("  \"entries\": [\n");
+    for (size_t i=0; i<mEntries.size(); ++i)
+    {
+        const ProfilingEntry &rEntry = mEntries[i];
+        json.append("    {\"name\": \"").append(jsonEscaped(rEntry.mName)).append("\", \"type\": \"").append(jsonEscaped(rEntry.mTypeName));
+        json.append(formatString("\", \"cqs\": \"%s\", \"is_system\": %s, \"calls\": %zu, \"samples\": %zu, \"time\": %.9g, \"logging_time\": %.9g, \"barrier_time\": %.9g}",
+                                 rEntry.mCQSType.c_str(), rEntry.mIsSystem ? "true" : "false", rEntry.mNumCalls, rEntry.mNumSamples,
+                                 rEntry.mTime, rEntry.mLoggingTime, rEntry.mBarrierTime));
+        if (rEntry.mHasCounters)
+        {
+            json.pop_back();
+            json.append(formatString(", \"cycles\": %.0f, \"instructions\": %.0f, \"cache_misses\": %.0f, \"branch_misses\": %.0f}",
+                                     rEntry.mCounters[0], rEntry.mCounters[1], rEntry.mCounters[2], rEntry.mCounters[3]));
+        }
+        json.append((i+1 < mEntries.size()) ? ",\n" : "\n");
+    }
+    json.append("  ]\n}\n");
+    return HString(json.c_str());
+}
+
+//! @brief Writes the results to file, as JSON if the file name ends with .json otherwise as CSV
+//! @param [in] rFilePath Path to the file
+//! @returns True if the file could be written
+bool SimulationProfile::writeToFile(const HString &rFilePath) const
+{
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        return false;
+    }
+    const bool isJSON = (rFilePath.size() > 5) && (rFilePath.substr(rFilePath.size()-5) == ".json");
+    const HString contents = isJSON ? toJSON() : toCSV();
+    file << contents.c_str();
+    return file.good();
+}
@@ -0,0 +1,251 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   SimulationProgress.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the live simulation progress and throughput metrics
+//!
+//$Id$
+
+#include "CoreUtilities/SimulationProgress.h"
+#include "HopsanCoreMacros.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace hopsan;
+
+namespace {
+
+const char *phaseNames[] = {"Idle", "Initializing", "Initialized", "Simulating", "Finalizing", "Finished", "Aborted"};
+
+long long nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+SimulationProgressMetrics::SimulationProgressMetrics()
+{
+    mPhase = phaseNames[SimulationProgress::Idle];
+    mSimulationTime = 0;
+    mStartTime = 0;
+    mStopTime = 0;
+    mProgress = 0;
+    mNumSteps = 0;
+    mTotalNumSteps = 0;
+    mWallTime = 0;
+    mStepsPerSecond = 0;
+    mRealTimeRatio = 0;
+    mEstimatedTimeRemaining = -1;
+}
+
+//! @brief Formats the metrics as a single line JSON object
+HString SimulationProgressMetrics::toJSON() const
+{
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "{\"phase\": \"%s\", \"time\": %.9g, \"start_time\": %.9g, \"stop_time\": %.9g, \"progress\": %.6f, "
+             "\"steps\": %zu, \"total_steps\": %zu, \"wall_time\": %.6f, \"steps_per_second\": %.6g, \"realtime_ratio\": %.6g, \"eta\": %.3f}",
+             mPhase, mSimulationTime, mStartTime, mStopTime, mProgress, mNumSteps, mTotalNumSteps, mWallTime, mStepsPerSecond,
+             mRealTimeRatio, mEstimatedTimeRemaining);
+    return HString(buffer);
+}
+
+
+SimulationProgress::SimulationProgress()
+{
+    mPhase = Idle;
+    mTime = 0;
+    mStartTime = 0;
+    mStopTime = 0;
+    mTimestep = 0;
+    mSimulationStartTime = 0;
+    mWallStartNs = 0;
+    mWallStopNs = 0;
+    mSimulationStopNs = 0;
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    mStopMonitor = false;
+    mMonitorInterval = 1;
+#endif
+}
+
+SimulationProgress::~SimulationProgress()
+{
+    stopMonitor();
+}
+
+//! @brief Reset the progress at the beginning of initialize
+//! @param [in] startT Simulation start time
+//! @param [in] stopT Simulation stop time
+//! @param [in] timestep The top-level timestep
+void SimulationProgress::beginInitialize(const double startT, const double stopT, const double timestep)
+{
+    mStartTime.store(startT);
+    mStopTime.store(stopT);
+    mTimestep.store(timestep);
+    mTime.store(startT);
+    mSimulationStartTime.store(startT);
+    mWallStartNs.store(nowNs());
+    mWallStopNs.store(0);
+    mPhase.store(Initializing);
+}
+
+//! @brief Mark the start of the simulation phase, throughput is measured from here
+//! @details Calling this when already simulating does nothing, so that simulations done in several calls are measured as one
+void SimulationProgress::beginSimulation()
+{
+    if (mPhase.load() != Simulating)
+    {
+        mSimulationStartTime.store(mTime.load());
+        mWallStartNs.store(nowNs());
+        mSimulationStopNs.store(0);
+        mPhase.store(Simulating);
+    }
+}
+
+//! @brief Mark the return from a simulate call, the phase is not changed since the simulation may be continued
+void SimulationProgress::endSimulation()
+{
+    mSimulationStopNs.store(nowNs());
+}
+
+void SimulationProgress::setPhase(const PhaseEnumT phase)
+{
+    // Stop the wall clock when the simulation ends, so that final metrics stay valid
+    if ((phase >= Finalizing) && (mPhase.load() < Finalizing))
+    {
+        mWallStopNs.store(nowNs());
+    }
+    mPhase.store(phase);
+}
+
+SimulationProgress::PhaseEnumT SimulationProgress::getPhase() const
+{
+    return PhaseEnumT(mPhase.load());
+}
+
+//! @brief Compute the current metrics, can be called from any thread
+SimulationProgressMetrics SimulationProgress::getMetrics() const
+{
+    SimulationProgressMetrics metrics;
+    const PhaseEnumT phase = getPhase();
+    metrics.mPhase = phaseNames[phase];
+    metrics.mSimulationTime = mTime.load(std::memory_order_relaxed);
+    metrics.mStartTime = mStartTime.load();
+    metrics.mStopTime = mStopTime.load();
+
+    const double duration = metrics.mStopTime-metrics.mStartTime;
+    const double timestep = mTimestep.load();
+    const double elapsed = metrics.mSimulationTime-metrics.mStartTime;
+    metrics.mProgress = (duration > 0) ? elapsed/duration : 0.0;
+    if (timestep > 0)
+    {
+        metrics.mNumSteps = size_t(elapsed/timestep+0.5);
+        metrics.mTotalNumSteps = size_t(duration/timestep+0.5);
+    }
+
+    const long long wallEndNs = (phase >= Finalizing) ? mWallStopNs.load() : nowNs();
+    metrics.mWallTime = double(wallEndNs-mWallStartNs.load())*1e-9;
+    if ((phase >= Simulating) && (metrics.mWallTime > 0))
+    {
+        const double simulated = metrics.mSimulationTime-mSimulationStartTime.load();
+        metrics.mRealTimeRatio = simulated/metrics.mWallTime;
+        metrics.mStepsPerSecond = (timestep > 0) ? simulated/timestep/metrics.mWallTime : 0.0;
+        if (phase != Simulating)
+        {
+            metrics.mEstimatedTimeRemaining = 0;
+        }
+        else if (simulated > 0)
+        {
+            metrics.mEstimatedTimeRemaining = (metrics.mStopTime-metrics.mSimulationTime)/metrics.mRealTimeRatio;
+        }
+    }
+    return metrics;
+}
+
+//! @brief Returns the wall time in seconds from the start of the simulation phase until the last simulate call returned
+//! @details While a simulate call is running the time until now is returned
+double SimulationProgress::getSimulationWallTime() const
+{
+    if (getPhase() < Simulating)
+    {
+        return 0;
+    }
+    const long long stopNs = mSimulationStopNs.load();
+    return double(((stopNs > 0) ? stopNs : nowNs())-mWallStartNs.load())*1e-9;
+}
+
+//! @brief Start a thread that calls a function with the current metrics at a fixed interval
+//! @details The callback is called from the monitor thread, once more when the monitor is stopped. A running monitor is stopped first.
+//! Without multi-threading support no monitor is started, poll getMetrics() instead.
+//! @param [in] rCallback The function to call
+//! @param [in] intervalSeconds The wall time between calls
+//! @returns True if the monitor was started, false if multi-threading is not supported
+bool SimulationProgress::startMonitor(const CallbackT &rCallback, const double intervalSeconds)
+{
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    stopMonitor();
+    mCallback = rCallback;
+    mMonitorInterval = (intervalSeconds > 0) ? intervalSeconds : 1.0;
+    mStopMonitor = false;
+    mMonitorThread = std::thread(&SimulationProgress::runMonitor, this);
+    return true;
+#else
+    HOPSAN_UNUSED(rCallback)
+    HOPSAN_UNUSED(intervalSeconds)
+    return false;
+#endif
+}
+
+//! @brief Stop the monitor thread, if running, after a final call to the callback
+void SimulationProgress::stopMonitor()
+{
+#if defined(HOPSANCORE_USEMULTITHREADING)
+    if (mMonitorThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMonitorMutex);
+            mStopMonitor = true;
+        }
+        mMonitorCondition.notify_all();
+        mMonitorThread.join();
+        mCallback(getMetrics());
+    }
+#endif
+}
+
+#if defined(HOPSANCORE_USEMULTITHREADING)
+void SimulationProgress::runMonitor()
+{
+    const std::chrono::duration<double> interval(mMonitorInterval);
+    std::unique_lock<std::mutex> lock(mMonitorMutex);
+    while (!mMonitorCondition.wait_for(lock, interval, [this](){ return mStopMonitor; }))
+    {
+        mCallback(getMetrics());
+    }
+}
+#endif
@@ -0,0 +1,250 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+//!
+//! @file   SimulationTracer.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains the per-thread timeline tracer for multi-threaded simulations
+//!
+//$Id$
+
+#include "CoreUtilities/SimulationTracer.h"
+#include "Component.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace hopsan;
+
+namespace {
+
+//! @brief Upper limit on the number of events kept per thread (the newest are kept)
+const size_t gMaxTraceEventsPerThread = 1 << 20;
+
+const char *phaseName(const SimulationTracePhaseEnum phase)
+{
+    switch (phase)
+    {
+    case TraceSignalComponents : return "Signal components";
+    case TraceCComponents : return "C components";
+    case TraceQComponents : return "Q components";
+    case TraceLogNodes : return "Log nodes";
+    case TraceWaitS : return "Wait S barrier";
+    case TraceWaitC : return "Wait C barrier";
+    case TraceWaitQ : return "Wait Q barrier";
+    case TraceWaitN : return "Wait N barrier";
+    case TraceComponent : return "Component";
+    }
+    return "";
+}
+
+const char *phaseCategory(const SimulationTracePhaseEnum phase)
+{
+    switch (phase)
+    {
+    case TraceWaitS :
+    case TraceWaitC :
+    case TraceWaitQ :
+    case TraceWaitN :
+        return "barrier";
+    case TraceComponent :
+        return "component";
+    default:
+        return "phase";
+    }
+}
+
+void appendJsonEscaped(std::string &rOut, const HString &rString)
+{
+    for (size_t i=0; i<rString.size(); ++i)
+    {
+        const char c = rString[i];
+        if ((c == '"') || (c == '\\'))
+        {
+            rOut.push_back('\\');
+        }
+        rOut.push_back(c);
+    }
+}
+
+void appendMicroSeconds(std::string &rOut, const long long nanoSeconds)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%lld.%03lld", nanoSeconds/1000, nanoSeconds%1000);
+    rOut.append(buffer);
+}
+
+}
+
+SimulationTraceBuffer::SimulationTraceBuffer(const size_t capacity, const ProfilerClockT::time_point &rEpoch, const size_t firstStep, const size_t lastStep, const bool traceComponents)
+    : mEvents(std::max(capacity, size_t(1))), mNumRecorded(0), mCurrentStep(0), mFirstStep(firstStep), mLastStep(lastStep),
+      mTraceComponents(traceComponents), mEpoch(rEpoch)
+{
+}
+
+//! @brief Returns the number of events kept in the buffer
+size_t SimulationTraceBuffer::getNumEvents() const
+{
+    return std::min(mNumRecorded, mEvents.size());
+}
+
+//! @brief Returns the number of old events that have been overwritten since the buffer was full
+size_t SimulationTraceBuffer::getNumDropped() const
+{
+    return mNumRecorded - getNumEvents();
+}
+
+//! @brief Returns a kept event, index 0 is the oldest one
+const SimulationTraceEvent &SimulationTraceBuffer::getEvent(const size_t idx) const
+{
+    return mEvents[(getNumDropped() + idx) % mEvents.size()];
+}
+
+
+//! @brief Constructor
+//! @param [in] firstStep The first step to trace
+//! @param [in] lastStep The last step to trace (inclusive)
+//! @param [in] traceComponents Also record one event per component, not only per phase
+SimulationTracer::SimulationTracer(const size_t firstStep, const size_t lastStep, const bool traceComponents)
+    : mFirstStep(firstStep), mLastStep(std::max(firstStep, lastStep)), mTraceComponents(traceComponents)
+{
+}
+
+//! @brief Allocates one event buffer per thread, large enough for the step window, this clears previously recorded events
+//! @param [in] numThreads The number of simulation threads
+//! @param [in] maxNumComponentsPerThread The largest number of components simulated by any thread
+void SimulationTracer::prepare(const size_t numThreads, const size_t maxNumComponentsPerThread)
+{
+    // Four phases, four barriers and one log event per step
+    const size_t eventsPerStep = 9 + (mTraceComponents ? maxNumComponentsPerThread : 0);
+    const size_t numSteps = mLastStep - mFirstStep + 1;
+    size_t capacity = gMaxTraceEventsPerThread;
+    if (numSteps < gMaxTraceEventsPerThread/eventsPerStep)
+    {
+        capacity = numSteps*eventsPerStep;
+    }
+
+    const ProfilerClockT::time_point epoch = ProfilerClockT::now();
+    mThreadBuffers.clear();
+    mThreadBuffers.reserve(numThreads);
+    for (size_t t=0; t<numThreads; ++t)
+    {
+        mThreadBuffers.push_back(SimulationTraceBuffer(capacity, epoch, mFirstStep, mLastStep, mTraceComponents));
+    }
+}
+
+size_t SimulationTracer::getNumThreads() const
+{
+    return mThreadBuffers.size();
+}
+
+SimulationTraceBuffer *SimulationTracer::getThreadBuffer(const size_t threadIdx)
+{
+    return &mThreadBuffers[threadIdx];
+}
+
+const SimulationTraceBuffer *SimulationTracer::getThreadBuffer(const size_t threadIdx) const
+{
+    return &mThreadBuffers[threadIdx];
+}
+
+size_t SimulationTracer::getFirstStep() const
+{
+    return mFirstStep;
+}
+
+size_t SimulationTracer::getLastStep() const
+{
+    return mLastStep;
+}
+
+bool SimulationTracer::tracesComponents() const
+{
+    return mTraceComponents;
+}
+
+//! @brief Returns the recorded events in the Chrome trace event JSON format
+HString SimulationTracer::toChromeTraceJSON() const
+{
+    std::string json;
+    json.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    json.append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Hopsan simulation\"}}");
+
+    size_t numDropped = 0;
+    char buffer[128];
+    for (size_t t=0; t<mThreadBuffers.size(); ++t)
+    {
+        snprintf(buffer, sizeof(buffer), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s %zu\"}}",
+                 t, (t == 0) ? "Master" : "Slave", t);
+        json.append(buffer);
+
+        const SimulationTraceBuffer &rBuffer = mThreadBuffers[t];
+        numDropped += rBuffer.getNumDropped();
+        for (size_t e=0; e<rBuffer.getNumEvents(); ++e)
+        {
+            const SimulationTraceEvent &rEvent = rBuffer.getEvent(e);
+            json.append(",\n{\"name\":\"");
+            if (rEvent.mpComponent)
+            {
+                appendJsonEscaped(json, rEvent.mpComponent->getName());
+            }
+            else
+            {
+                json.append(phaseName(rEvent.mPhase));
+            }
+            json.append("\",\"cat\":\"");
+            json.append(phaseCategory(rEvent.mPhase));
+            snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":", t);
+            json.append(buffer);
+            appendMicroSeconds(json, rEvent.mBegin);
+            json.append(",\"dur\":");
+            appendMicroSeconds(json, rEvent.mEnd-rEvent.mBegin);
+            snprintf(buffer, sizeof(buffer), ",\"args\":{\"step\":%zu}}", rEvent.mStep);
+            json.append(buffer);
+        }
+    }
+
+    snprintf(buffer, sizeof(buffer), "\n],\"otherData\":{\"firstStep\":%zu,\"lastStep\":%zu,\"droppedEvents\":%zu}}\n",
+             mFirstStep, mLastStep, numDropped);
+    json.append(buffer);
+    return HString(json.c_str());
+}
+
+//! @brief Writes the recorded events to a Chrome trace event JSON file
+//! @param [in] rFilePath The file to write
+//! @returns True if the file was written successfully
+bool SimulationTracer::writeChromeTrace(const HString &rFilePath) const
+{
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << toChromeTraceJSON().c_str();
+    return file.good();
+}
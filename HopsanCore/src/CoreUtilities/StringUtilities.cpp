@@ -32,6 +32,8 @@
 //$Id$
 
 #include "CoreUtilities/StringUtilities.h"
+#include <cstdarg>
+#include <cstdio>
 //#include <stdio.h>
 //#include <iostream>
 //#include <stdlib.h>
@@ -108,3 +110,33 @@ void hopsan::splitString(const HString &rString, const char delim, std::vector<H
         rParts.push_back(item.c_str());
     }
 }
+
+//! @brief Format a string like printf, the result is not limited in length
+//! @details Only for use inside HopsanCore, std::string is not passed over the library interface
+//! @param [in] format The printf format string
+//! @returns The formatted string, empty if the format is invalid
+std::string hopsan::formatString(const char *format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    std::string formatted;
+    if ((length >= 0) && (size_t(length) < sizeof(buffer)))
+    {
+        formatted.assign(buffer, size_t(length));
+    }
+    else if (length >= 0)
+    {
+        // Did not fit in the buffer, format again with the exact size
+        formatted.resize(size_t(length)+1);
+        vsnprintf(&formatted[0], formatted.size(), format, argsCopy);
+        formatted.resize(size_t(length));
+    }
+    va_end(argsCopy);
+    return formatted;
+}
@@ -269,6 +269,33 @@ void Node::preAllocateLogSpace(const size_t nLogSlots)
 }
 
 
+//! @brief Returns the size in bytes of the node data variables
+size_t Node::getDataMemoryUsage() const
+{
+    return mDataValues.capacity()*sizeof(double);
+}
+
+
+//! @brief Returns the size in bytes of the allocated log storage
+size_t Node::getLogDataMemoryUsage() const
+{
+    size_t bytes = mDataStorage.capacity()*sizeof(vector<double>);
+    for (size_t i=0; i<mDataStorage.size(); ++i)
+    {
+        bytes += mDataStorage[i].capacity()*sizeof(double);
+    }
+    return bytes;
+}
+
+
+//! @brief Returns the size in bytes that preAllocateLogSpace() would allocate for a given number of log slots
+//! @param [in] nLogSlots The number of log slots
+size_t Node::estimateLogDataMemoryUsage(const size_t nLogSlots) const
+{
+    return nLogSlots*(sizeof(vector<double>) + mDataValues.size()*sizeof(double));
+}
+
+
 //! @brief Copy current data vector into log storage at given logslot
 //! @warning No bounds check is done
 void Node::logData(const size_t logSlot)
@@ -51,6 +51,8 @@
 #include "CoreUtilities/NumHopHelper.h"
 #include "CoreUtilities/HmfLoader.h"
 #include "CoreUtilities/SaveRestoreSimulationPoint.h"
+#include "CoreUtilities/ResultFile.h"
+#include "CoreUtilities/SimulationProgress.h"
 #include "compiler_info.h"
 
 // Here the HopsanCore object is created
@@ -423,6 +425,12 @@ double CoreSystemAccess::getCurrentTime() const
     return mpCoreComponentSystem->getTime();
 }
 
+//! @brief Returns the wall time in seconds of the last simulation of the system
+double CoreSystemAccess::getSimulationWallTime() const
+{
+    return mpCoreComponentSystem->getSimulationProgress()->getSimulationWallTime();
+}
+
 void CoreSystemAccess::stop()
 {
     mpCoreComponentSystem->stopSimulation();
@@ -1380,6 +1388,62 @@ bool CoreCSVParserAccess::getRow(int row, QVector<double> &rVector)
     }
 }
 
+CoreResultFileAccess::CoreResultFileAccess(QString file)
+{
+    mpReader = new hopsan::ResultFileReader();
+    mpReader->openFile(hopsan::HString(file.toStdString().c_str()));
+}
+
+CoreResultFileAccess::~CoreResultFileAccess()
+{
+    delete mpReader;
+}
+
+bool CoreResultFileAccess::isOk()
+{
+    return mpReader->isOpen();
+}
+
+QString CoreResultFileAccess::getErrorString()
+{
+    return QString(mpReader->getErrorString().c_str());
+}
+
+int CoreResultFileAccess::getNumberOfVariables()
+{
+    return int(mpReader->getNumVariables());
+}
+
+bool CoreResultFileAccess::getVariableInfo(int idx, QString &rName, QString &rAlias, QString &rUnit, QString &rQuantity, int &rTimeVariableIndex)
+{
+    const hopsan::ResultFileVariable *pVariable = mpReader->getVariable(size_t(idx));
+    if (pVariable)
+    {
+        rName = pVariable->mName.c_str();
+        rAlias = pVariable->mAlias.c_str();
+        rUnit = pVariable->mUnit.c_str();
+        rQuantity = pVariable->mQuantity.c_str();
+        rTimeVariableIndex = pVariable->mTimeVariableIndex;
+        return true;
+    }
+    return false;
+}
+
+//! @brief Copy a variable column from the memory mapped file, only the pages of this column are read from disk
+bool CoreResultFileAccess::getVariableData(int idx, QVector<double> &rVector)
+{
+    const double *pData = mpReader->getVariableData(size_t(idx));
+    if (pData)
+    {
+        const int numSamples = int(mpReader->getVariable(size_t(idx))->mNumSamples);
+        rVector.resize(numSamples);
+        memcpy(rVector.data(), pData, numSamples*sizeof(double));
+        return true;
+    }
+    rVector = QVector<double>();
+    return false;
+}
+
 QString getHopsanCoreCompiler()
 {
     return QString::fromStdString(gHopsanCore.getCoreCompiler());
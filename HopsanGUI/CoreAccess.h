@@ -51,6 +51,7 @@ class ComponentSystem;
 class Port;
 class SimulationHandler;
 class CSVParserNG;
+class ResultFileReader;
 }
 
 void initializaHopsanCore(QString logPath);
@@ -69,6 +70,20 @@ private:
     hopsan::CSVParserNG *mpParser;
 };
 
+class CoreResultFileAccess
+{
+public:
+    CoreResultFileAccess(QString file);
+    ~CoreResultFileAccess();
+    bool isOk();
+    QString getErrorString();
+    int getNumberOfVariables();
+    bool getVariableInfo(int idx, QString &rName, QString &rAlias, QString &rUnit, QString &rQuantity, int &rTimeVariableIndex);
+    bool getVariableData(int idx, QVector<double> &rVector);
+private:
+    hopsan::ResultFileReader *mpReader;
+};
+
 
 class CoreLibraryAccess
 {
@@ -246,6 +261,7 @@ public:
     void simulate(double mStartTime, double mFinishTime, int nThreads=-1, bool modelHasNotChanged=false);
     void finalize();
     double getCurrentTime() const;
+    double getSimulationWallTime() const;
     void stop();
     bool writeNodeData(const QString compname, const QString portname, const QString dataname, double data);
 
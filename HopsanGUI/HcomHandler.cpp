@@ -1051,12 +1051,13 @@ void HcomHandler::createCommands()
 
     HcomCommand replCmd;
     replCmd.cmd = "repl";
-    replCmd.description.append("Loads plot files from .csv or .plo");
+    replCmd.description.append("Loads plot files from .csv, .plo or .hrb");
     replCmd.help.append(" Usage: repl [-flags] [filepath]\n");
     replCmd.help.append("  Flags (optional):\n");
     replCmd.help.append("   -csv    Force CSV (, or ;) format\n");
     replCmd.help.append("   -ssp    Force CSV (space separated) format\n");
-    replCmd.help.append("   -plo    Force PLO format");
+    replCmd.help.append("   -plo    Force PLO format\n");
+    replCmd.help.append("   -hrb    Force Hopsan binary result format");
     replCmd.fnc = &HcomHandler::executeLoadVariableCommand;
     replCmd.group = "Plot Commands";
     mCmdList << replCmd;
@@ -4637,10 +4638,11 @@ void HcomHandler::executeLoadVariableCommand(const QString cmd)
         return;
     }
 
-    bool csv,ssv,plo;
+    bool csv,ssv,plo,hrb;
     csv=(flagarg=="-csv");
     ssv=(flagarg=="-ssv");
     plo=(flagarg=="-plo");
+    hrb=(flagarg=="-hrb");
 
     if( flagarg.isEmpty() && (path.endsWith(".csv") || path.endsWith(".CSV")) )
     {
@@ -4650,6 +4652,10 @@ void HcomHandler::executeLoadVariableCommand(const QString cmd)
     {
         plo=true;
     }
+    else if(flagarg.isEmpty() && (path.endsWith(".hrb") || path.endsWith(".HRB")) )
+    {
+        hrb=true;
+    }
     else if (flagarg.isEmpty())
     {
         HCOMWARN("Unknown file extension, assuming that it is a PLO file.");
@@ -4668,6 +4674,10 @@ void HcomHandler::executeLoadVariableCommand(const QString cmd)
     {
         mpModel->getLogDataHandler()->importFromPlainColumnCsv(path,' ');
     }
+    else if (hrb)
+    {
+        mpModel->getViewContainerObject()->getLogDataHandler()->importFromHopsanBinary(path);
+    }
     else
     {
         HCOMERR("Incorrect format");
@@ -7542,6 +7552,24 @@ void HcomHandler::evaluateExpression(QString expr, VariableType desiredType)
             return;
         }
         if(mLocalExpressions.contains(args[0])) {
+            //Use the compiled expression if all variables are local variables, since eval() is often called in loops
+            const SymHop::CompiledExpression compiled = getCompiledExpression(mLocalExpressions[args[0]]);
+            if(compiled.isValid()) {
+                QVector<double> values;
+                for(const QString &variable : compiled.getVariables()) {
+                    LocalVarsMapT::const_iterator it = mLocalVars.constFind(variable);
+                    if(it == mLocalVars.constEnd()) {
+                        break;
+                    }
+                    values.append(it.value());
+                }
+                if(values.size() == compiled.getVariables().size()) {
+                    mAnsScalar = compiled.evaluate(values.constData());
+                    mAnsType = Scalar;
+                    return;
+                }
+            }
+
             bool ok;
             double value = mLocalExpressions[args[0]].evaluate(mLocalVars,&mLocalFunctionoidPtrs, &ok);
             if(ok) {
@@ -7749,6 +7777,12 @@ void HcomHandler::evaluateExpression(QString expr, VariableType desiredType)
         return;
     }
 
+    //Element-wise arithmetic of data vectors and scalars is evaluated in one pass by a compiled expression
+    if(desiredType != Expression && evaluateCompiledExpression(symHopExpr, desiredType))
+    {
+        return;
+    }
+
     //Multiplication between data vector and scalar
     //timer.tic();
     //! @todo this code does pointer lookup, then does it again, and then get names to use string versions of logdatahandler functions, it could lookup once and then use the pointer versions instead
@@ -7991,6 +8025,125 @@ void HcomHandler::evaluateExpression(QString expr, VariableType desiredType)
     return;
 }
 
+//! @brief Evaluates an expression of scalars and equally long data vectors element-wise, using a compiled expression
+//! @param rExpr Expression to evaluate
+//! @param desiredType Desired type of the result
+//! @returns False if the expression can not be evaluated this way, then the answer is undefined
+bool HcomHandler::evaluateCompiledExpression(const SymHop::Expression &rExpr, VariableType desiredType)
+{
+    //Single variables are resolved by evaluateExpression() itself
+    if(rExpr.isSymbol())
+    {
+        return false;
+    }
+
+    const SymHop::CompiledExpression compiled = getCompiledExpression(rExpr);
+    if(!compiled.isValid())
+    {
+        return false;
+    }
+
+    //Resolve the variables to scalars or data vectors
+    const QStringList &rVariables = compiled.getVariables();
+    QVector<double> scalars(rVariables.size(), 0);
+    QVector<QVector<double> > vectors(rVariables.size());
+    QVector<bool> isVector(rVariables.size(), false);
+    SharedVectorVariableT pFirstVector;
+    for(int v=0; v<rVariables.size(); ++v)
+    {
+        evaluateExpression(rVariables[v], (desiredType == Scalar) ? Scalar : Undefined);
+        if(mAnsType == Scalar)
+        {
+            scalars[v] = mAnsScalar;
+        }
+        else if(mAnsType == DataVector && desiredType != Scalar)
+        {
+            if(pFirstVector && mAnsVector->getDataSize() != pFirstVector->getDataSize())
+            {
+                return false;
+            }
+            if(!pFirstVector)
+            {
+                pFirstVector = mAnsVector;
+            }
+            vectors[v] = mAnsVector->getDataVectorCopy();
+            isVector[v] = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if(!pFirstVector)
+    {
+        if(desiredType == DataVector)
+        {
+            return false;
+        }
+        mAnsType = Scalar;
+        mAnsScalar = compiled.evaluate(scalars.constData());
+        return true;
+    }
+
+    if(!mpModel || !mpModel->getViewContainerObject())
+    {
+        return false;
+    }
+    LogDataHandler2 *pLogDataHandler = mpModel->getViewContainerObject()->getLogDataHandler().data();
+
+    QVector<const double*> pointers(rVariables.size());
+    for(int v=0; v<rVariables.size(); ++v)
+    {
+        pointers[v] = isVector[v] ? vectors[v].constData() : scalars.constData()+v;
+    }
+
+    SharedVectorVariableT pResult = pLogDataHandler->createOrphanVariable(rExpr.toString(), pFirstVector->getVariableType());
+    pResult->assignFrom(pFirstVector);
+    QVector<double> *pData = pResult->beginFullVectorOperation();
+    compiled.evaluate(pointers.constData(), isVector.constData(), pData->data(), pData->size());
+    pResult->endFullVectorOperation(pData);
+
+    mAnsType = DataVector;
+    mAnsVector = pResult;
+    return true;
+}
+
+//! @brief Returns the compiled form of an expression, compiled expressions are cached by expression string
+//! @details Expressions with HCOM functions are not compiled, since for example min() and max() operate on whole vectors.
+SymHop::CompiledExpression HcomHandler::getCompiledExpression(const SymHop::Expression &rExpr)
+{
+    const QString exprStr = rExpr.toString();
+    QMap<QString, SymHop::CompiledExpression>::iterator it = mCompiledExpressions.find(exprStr);
+    if(it != mCompiledExpressions.end())
+    {
+        return it.value();
+    }
+
+    SymHop::CompiledExpression compiled;
+    bool hasFunctionoids = false;
+    for(QString function : rExpr.getFunctions())
+    {
+        if(function.startsWith("-"))
+        {
+            function.remove(0,1);
+        }
+        hasFunctionoids = hasFunctionoids || mLocalFunctionoidPtrs.contains(function);
+    }
+    if(!hasFunctionoids)
+    {
+        compiled.compile(rExpr);
+    }
+
+    //Limit the size of the cache, scripts may generate many unique expressions
+    if(mCompiledExpressions.size() > 1000)
+    {
+        mCompiledExpressions.clear();
+    }
+    mCompiledExpressions.insert(exprStr, compiled);
+    return compiled;
+}
+
 //! @brief Evaluate an expressions when the expected result is a scalar, the expression may in turn contain expressions
 double HcomHandler::evaluateScalarExpression(QString expr, bool &rIsOK)
 {
@@ -37,6 +37,7 @@
 
 #include "LogVariable.h"
 #include "SymHop.h"
+#include "CompiledExpression.h"
 #include "PlotCurveStyle.h"
 
 class SystemObject;
@@ -259,6 +260,8 @@ private:
     QString getParameterValue(QString parameterName) const;
 
     bool evaluateArithmeticExpression(QString cmd);
+    bool evaluateCompiledExpression(const SymHop::Expression &rExpr, VariableType desiredType);
+    SymHop::CompiledExpression getCompiledExpression(const SymHop::Expression &rExpr);
 
     void executeGtBuiltInFunction(QString functionCall);
     void executeLtBuiltInFunction(QString functionCall);
@@ -295,6 +298,7 @@ private:
     QMap<QString, SymHop::Expression> mLocalExpressions;
     QMap<QString, SymHopFunctionoid*> mLocalFunctionoidPtrs;
     QMap<QString, QPair<QString, QString> > mLocalFunctionDescriptions;
+    QMap<QString, SymHop::CompiledExpression> mCompiledExpressions;
 
     VariableType mRetvalType;
 
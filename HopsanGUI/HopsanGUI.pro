@@ -286,6 +286,7 @@ SOURCES += main.cpp \
     Widgets/FindWidget.cpp \
     Widgets/PlotWidget2.cpp \
     Utilities/IndexIntervalCollection.cpp \
+    Utilities/LogDataImportParser.cpp \
     LogDataGeneration.cpp \
     RemoteCoreAccess.cpp \
     RemoteSimulationUtils.cpp \
@@ -378,6 +379,7 @@ HEADERS += MainWindow.h \
     GraphicsViewPort.h \
     Widgets/PlotWidget2.h \
     Utilities/IndexIntervalCollection.h \
+    Utilities/LogDataImportParser.h \
     LogDataGeneration.h \
     RemoteCoreAccess.h \
     RemoteSimulationUtils.h \
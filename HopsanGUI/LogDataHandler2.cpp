@@ -36,6 +36,9 @@
 #include <QProgressDialog>
 #include <QDialogButtonBox>
 #include <QPushButton>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
 
 #include "LogDataHandler2.h"
 #include "LogDataGeneration.h"
@@ -52,6 +55,7 @@
 #include "Configuration.h"
 #include "GUIPort.h"
 #include "Utilities/GUIUtilities.h"
+#include "Utilities/LogDataImportParser.h"
 
 #include "PlotWindow.h"
 #include "PlotHandler.h"
@@ -393,15 +397,64 @@ SharedVectorVariableT LogDataHandler2::insertNewVectorVariable(SharedVectorVaria
     return insertVariable(pVariable, "", gen);
 }
 
-class PLOImportData
+//! @brief Thread used to run an import parser without blocking the GUI
+class LogDataImportThread : public QThread
 {
 public:
-      QString mDataName;
-      QString mPlotScale;
-      double startvalue;
-      QVector<double> mDataValues;
+    LogDataImportThread(const std::function<bool()> &rParseFunction) : mParseFunction(rParseFunction), mSuccess(false) {}
+    bool wasSuccessful() const { return mSuccess; }
+
+protected:
+    void run() override
+    {
+        mSuccess = mParseFunction();
+    }
+
+private:
+    std::function<bool()> mParseFunction;
+    bool mSuccess;
 };
 
+//! @brief Runs an import parser in a worker thread, the GUI event loop keeps running and a cancelable progress dialog is shown
+//! @param [in] rParser The parser, used for progress and abort
+//! @param [in] rLabel The progress dialog label
+//! @param [in] rParseFunction The function that runs the parser
+//! @returns True if parsing was successful, false if it failed or was canceled
+bool LogDataHandler2::runImportParser(LogDataImportParser &rParser, const QString &rLabel, const std::function<bool()> &rParseFunction)
+{
+    QProgressDialog progressDialog(rLabel, tr("Cancel"), 0, 1000, gpMainWindowWidget);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(500);
+    progressDialog.setValue(0);
+    connect(&progressDialog, &QProgressDialog::canceled, &progressDialog, [&rParser](){rParser.abort();});
+
+    QTimer progressTimer;
+    connect(&progressTimer, &QTimer::timeout, &progressDialog, [&progressDialog, &rParser](){
+        progressDialog.setValue(int(rParser.getProgress()*1000));
+    });
+
+    LogDataImportThread importThread(rParseFunction);
+    QEventLoop loop;
+    connect(&importThread, &QThread::finished, &loop, &QEventLoop::quit);
+    progressTimer.start(100);
+    importThread.start();
+    loop.exec();
+    importThread.wait();
+    progressTimer.stop();
+
+    if (rParser.wasAborted())
+    {
+        gpMessageHandler->addInfoMessage("Import was canceled");
+        return false;
+    }
+    if (!importThread.wasSuccessful())
+    {
+        gpMessageHandler->addErrorMessage(rParser.getErrorString());
+        return false;
+    }
+    return true;
+}
+
 void LogDataHandler2::importFromPlo(QString importFilePath)
 {
     if(importFilePath.isEmpty())
@@ -416,146 +469,31 @@ void LogDataHandler2::importFromPlo(QString importFilePath)
         return;
     }
 
-    QFile file(importFilePath);
-    QFileInfo fileInfo(file);
+    QFileInfo fileInfo(importFilePath);
     gpConfig->setStringSetting(cfg::dir::plotdata, fileInfo.absolutePath());
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    // Parse the file in a worker thread, the generation is created once parsing has completed
+    LogDataImportParser parser;
+    if (!runImportParser(parser, tr("Importing PLO"), [&parser, importFilePath](){return parser.parsePlo(importFilePath);}))
     {
-        QMessageBox::information(gpMainWindowWidget, gpMainWindowWidget->tr("Hopsan"), "Unable to read .PLO file.");
         return;
     }
-
-    QProgressDialog progressImportBar(tr("Importing PLO"), QString(), 0, 0, gpMainWindowWidget);
-    progressImportBar.setWindowModality(Qt::WindowModal);
-    progressImportBar.show();
-    progressImportBar.setMinimum(0);
-    progressImportBar.setMaximum(0);
-
-    unsigned int nDataRows = 0;
-    int nDataColumns = 0;
-    int ploVersion = 0;
-
-    QVector<PLOImportData> importedPLODataVector;
-
-    // Stream all data and then manipulate
-    QTextStream t(&file);
-
-    // Read header data
-    bool parseOK=true;
-    for (unsigned int lineNum=1; lineNum<7; ++lineNum)
-    {
-        QString line = t.readLine().trimmed();
-        if(!line.isNull())
-        {
-            // Check PLO format version
-            if (lineNum == 1)
-            {
-                // Check if this seems to be a plo file
-                if (line != "'VERSION'")
-                {
-                    gpMessageHandler->addErrorMessage(fileInfo.fileName()+" Does not seem to be a plo file, Aborting import!");
-                    return;
-                }
-            }
-            else if(lineNum == 2)
-            {
-                ploVersion = line.toUInt(&parseOK);
-            }
-            // Else check for num data info
-            else if(lineNum == 4)
-            {
-                bool colOK, rowOK;
-                QStringList colsandrows = line.simplified().split(" ");
-                nDataColumns = colsandrows[0].toUInt(&colOK);
-                nDataRows = colsandrows[1].toUInt(&rowOK);
-                parseOK = (colOK && rowOK);
-                if (parseOK)
-                {
-                    // Reserve memory for reading data
-                    importedPLODataVector.resize(nDataColumns);
-                    for(int c=0; c<nDataColumns; ++c)
-                    {
-                        importedPLODataVector[c].mDataValues.reserve(nDataRows);
-                    }
-                }
-            }
-            // Else check for data header info
-            else if(lineNum == 5)
-            {
-                if ( ((ploVersion == 1) || (ploVersion == 2)) && (line.startsWith("'" TIMEVARIABLENAME) || line.startsWith("'" FREQUENCYVARIABLENAME)) )
-                {
-                    // We add one to include "time or frequency x column"
-                    nDataColumns+=1;
-                    importedPLODataVector.resize(nDataColumns);
-                    for(int c=0; c<nDataColumns; ++c)
-                    {
-                        importedPLODataVector[c].mDataValues.reserve(nDataRows);
-                    }
-                }
-
-                QStringList dataheader = line.split(",");
-                for(int c=0; c<nDataColumns; ++c)
-                {
-                    QString word;
-                    word = dataheader[c].remove('\'');
-                    importedPLODataVector[c].mDataName = word.trimmed();
-                }
-            }
-            // Else check for plot scale
-            else if (lineNum == 6)
-            {
-                // Read plot scales
-                QTextStream linestream(&line);
-                for(int c=0; c<nDataColumns; ++c)
-                {
-                    linestream >> importedPLODataVector[c].mPlotScale;
-                }
-            }
-        }
-        if (!parseOK)
-        {
-            gpMessageHandler->addErrorMessage(QString("A parse error occurred while parsing the header of: ")+fileInfo.fileName()+" Aborting import!");
-            return;
-        }
-    }
-
-    // Read the logged data
-    for (unsigned int lineNum=7; lineNum<7+nDataRows; ++lineNum)
-    {
-        QString line = t.readLine().trimmed();
-        if(!line.isNull())
-        {
-            // We check if data row first since it will happen most often
-            QTextStream linestream(&line);
-            for(int c=0; c<nDataColumns; ++c)
-            {
-                double tmp;
-                linestream >> tmp;
-                importedPLODataVector[c].mDataValues.append(tmp);
-            }
-        }
-    }
-
-    // Ignore the rest of the data for now
-
-    // We are done reading, close the file
-    file.close();
+    QVector<LogDataImportParser::Column> &rImportedColumns = parser.getColumns();
 
     // Insert data into log-data handler
-    if (importedPLODataVector.size() > 0)
+    if (rImportedColumns.size() > 0)
     {
         ++mCurrentGenerationNumber;
         SharedVectorVariableT pTimeVec(0);
         SharedVectorVariableT pFreqVec(0);
 
-        if (importedPLODataVector.first().mDataName == TIMEVARIABLENAME)
+        if (rImportedColumns.first().mName == TIMEVARIABLENAME)
         {
-            pTimeVec = insertTimeVectorVariable(importedPLODataVector.first().mDataValues, fileInfo.absoluteFilePath());
+            pTimeVec = insertTimeVectorVariable(rImportedColumns.first().mData, fileInfo.absoluteFilePath());
         }
-        else if (importedPLODataVector.first().mDataName == FREQUENCYVARIABLENAME)
+        else if (rImportedColumns.first().mName == FREQUENCYVARIABLENAME)
         {
-            pFreqVec = insertFrequencyVectorVariable(importedPLODataVector.first().mDataValues, fileInfo.absoluteFilePath());
+            pFreqVec = insertFrequencyVectorVariable(rImportedColumns.first().mData, fileInfo.absoluteFilePath());
         }
 
         // First decide if we should skip the first column (if time or frequency vector)
@@ -567,16 +505,16 @@ void LogDataHandler2::importFromPlo(QString importFilePath)
         // Go through all imported variable columns, and create the appropriate vector variable type and insert it
         // Note! You can not mix time frequency or plain vector types in the same plo (v1) file
         SharedVectorVariableT pNewData;
-        for (; i<importedPLODataVector.size(); ++i)
+        for (; i<rImportedColumns.size(); ++i)
         {
             SharedVariableDescriptionT pVarDesc = SharedVariableDescriptionT(new VariableDescription);
-            pVarDesc->mDataName = importedPLODataVector[i].mDataName;
+            pVarDesc->mDataName = rImportedColumns[i].mName;
 
             bool isNumber;
-            importedPLODataVector[i].mPlotScale.toDouble(&isNumber);
+            rImportedColumns[i].mPlotScale.toDouble(&isNumber);
             if (!isNumber)
             {
-                pVarDesc->mDataQuantity = importedPLODataVector[i].mPlotScale;
+                pVarDesc->mDataQuantity = rImportedColumns[i].mPlotScale;
                 pVarDesc->mDataUnit = gpConfig->getBaseUnit(pVarDesc->mDataQuantity);
             }
             // Right now we ignore numeric plotscale, as we removed plotscale from data variables, we look for quantities instead
@@ -584,20 +522,22 @@ void LogDataHandler2::importFromPlo(QString importFilePath)
             // Insert time domain variable
             if (pTimeVec)
             {
-                pNewData = insertTimeDomainVariable(pTimeVec, importedPLODataVector[i].mDataValues, pVarDesc, fileInfo.absoluteFilePath());
+                pNewData = insertTimeDomainVariable(pTimeVec, rImportedColumns[i].mData, pVarDesc, fileInfo.absoluteFilePath());
             }
             // Insert frequency domain variable
             else if (pFreqVec)
             {
-                pNewData = insertFrequencyDomainVariable(pFreqVec, importedPLODataVector[i].mDataValues, pVarDesc, fileInfo.absoluteFilePath());
+                pNewData = insertFrequencyDomainVariable(pFreqVec, rImportedColumns[i].mData, pVarDesc, fileInfo.absoluteFilePath());
             }
             // Insert plain vector variables
             else
             {
-                pNewData = SharedVectorVariableT(new ImportedVectorVariable(importedPLODataVector[i].mDataValues, mCurrentGenerationNumber, pVarDesc,
+                pNewData = SharedVectorVariableT(new ImportedVectorVariable(rImportedColumns[i].mData, mCurrentGenerationNumber, pVarDesc,
                                                                             fileInfo.absoluteFilePath(), getGenerationMultiCache(mCurrentGenerationNumber)));
                 insertVariable(pNewData);
             }
+            // Release the parsed data as soon as it has been handed over
+            rImportedColumns[i].mData = QVector<double>();
         }
 
         if(pNewData)
@@ -637,15 +577,25 @@ void LogDataHandler2::importFromCSV_AutoFormat(QString importFilePath)
         }
         QStringList firstRow = firstLine.split(',');
 
+        // Only the first field of the leading lines and of the last line is needed to determine the format,
+        // so the rest of the file is skipped to avoid reading large files twice
         QStringList firstColumn;
         firstColumn.push_back(firstRow.first());
-        while(!ts.atEnd()) {
-            QStringList row = ts.readLine().split(',');
-            if(row.isEmpty()) {
-                firstColumn.push_back(QString());
+        const int maxHeaderLines = 1000;
+        while(!ts.atEnd() && firstColumn.size() < maxHeaderLines) {
+            const QString line = ts.readLine();
+            firstColumn.push_back(line.left(line.indexOf(',')));
+        }
+        if(!ts.atEnd()) {
+            const qint64 tailSize = 65536;
+            file.seek(qMax(ts.pos(), file.size()-tailSize));
+            QStringList tailLines = QString::fromUtf8(file.readAll()).split('\n');
+            if(!tailLines.isEmpty() && tailLines.last().isEmpty()) {
+                tailLines.removeLast();
             }
-            else {
-                firstColumn.push_back(row.first());
+            if(!tailLines.isEmpty()) {
+                const QString lastLine = tailLines.last().trimmed();
+                firstColumn.push_back(lastLine.left(lastLine.indexOf(',')));
             }
         }
         file.close();
@@ -706,91 +656,134 @@ void LogDataHandler2::importHopsanRowCSV(QString importFilePath)
         return;
     }
 
-    QFile file(importFilePath);
-    QFileInfo fileInfo(file);
+    QFileInfo fileInfo(importFilePath);
     gpConfig->setStringSetting(cfg::dir::plotdata, fileInfo.absolutePath());
 
-    bool parseOk = true;
+    // Parse the file in a worker thread, the generation is created once parsing has completed
+    LogDataImportParser parser;
+    if (!runImportParser(parser, tr("Importing CSV"), [&parser, importFilePath](){return parser.parseHopsanRowCsv(importFilePath);}))
+    {
+        return;
+    }
+    QVector<LogDataImportParser::Column> &rImportedColumns = parser.getColumns();
 
-    if (file.open(QFile::ReadOnly))
+    ++mCurrentGenerationNumber;
+
+    // Figure out time
+    SharedVectorVariableT pTimeVec;
+    //! @todo what if multiple subsystems with different time
+    int timeIdx = -1;
+    for (int i=0; i<rImportedColumns.size(); ++i)
     {
-        QStringList allNames, allAlias, allUnits;
-        QList< QVector<double> > allDatas;
-        int nDataValueElements = -1;
-        QTextStream contentStream(&file);
-        while (!contentStream.atEnd())
+        if (rImportedColumns[i].mName == TIMEVARIABLENAME)
         {
-            //! @todo this is not the most clever and speedy implementation
-            QStringList lineFields = contentStream.readLine().split(',');
-            if (lineFields.size() > 3)
-            {
-                // Read metadata
-                allNames.append(lineFields[0]);
-                allAlias.append(lineFields[1]);
-                allUnits.append(lineFields[2]);
-
-                allDatas.append(QVector<double>());
-                QVector<double> &data = allDatas.last();
-                if (nDataValueElements > -1)
-                {
-                    data.reserve(nDataValueElements);
-                }
-                for (int i=3; i<lineFields.size(); ++i)
-                {
-                    bool ok;
-                    data.append(lineFields[i].toDouble(&ok));
-                    if(!ok)
-                    {
-                        parseOk = false;
-                    }
-                }
-                nDataValueElements = data.size();
-            }
+            timeIdx = i;
+            pTimeVec = insertTimeVectorVariable(rImportedColumns[i].mData, fileInfo.absoluteFilePath());
+            break;
         }
+    }
 
-        if (parseOk)
+    SharedVectorVariableT pNewData;
+    for (int i=0; i<rImportedColumns.size(); ++i)
+    {
+        // We already inserted time
+        if (i == timeIdx)
         {
-            ++mCurrentGenerationNumber;
+            continue;
+        }
 
-            // Figure out time
-            SharedVectorVariableT pTimeVec;
-            //! @todo what if multiple subsystems with different time
-            int timeIdx = allNames.indexOf(TIMEVARIABLENAME);
-            if (timeIdx > -1)
-            {
-                pTimeVec = insertTimeVectorVariable(allDatas[timeIdx], fileInfo.absoluteFilePath());
-            }
+        SharedVariableDescriptionT pVarDesc = SharedVariableDescriptionT(new VariableDescription);
+        pVarDesc->mDataName = rImportedColumns[i].mName;
+        pVarDesc->mAliasName = rImportedColumns[i].mAlias;
+        pVarDesc->mDataUnit = rImportedColumns[i].mUnit;
+        pNewData = insertTimeDomainVariable(pTimeVec, rImportedColumns[i].mData, pVarDesc, fileInfo.absoluteFilePath());
+        // Release the parsed data as soon as it has been handed over
+        rImportedColumns[i].mData = QVector<double>();
+    }
 
-            SharedVectorVariableT pNewData;
-            for (int i=0; i<allNames.size(); ++i)
-            {
-                // We already inserted time
-                if (i == timeIdx)
-                {
-                    continue;
-                }
+    if(pNewData)
+    {
+        mImportedGenerationsMap.insert(pNewData->getGeneration(), pNewData->getImportedFileName());
+    }
 
-                SharedVariableDescriptionT pVarDesc = SharedVariableDescriptionT(new VariableDescription);
-                pVarDesc->mDataName = allNames[i];
-                pVarDesc->mAliasName = allAlias[i];
-                pVarDesc->mDataUnit = allUnits[i];
-                pNewData = insertTimeDomainVariable(pTimeVec, allDatas[i], pVarDesc, fileInfo.absoluteFilePath());
-            }
+    // Limit number of plot generations if there are too many
+    limitPlotGenerations();
 
-            if(pNewData)
-            {
-                mImportedGenerationsMap.insert(pNewData->getGeneration(), pNewData->getImportedFileName());
-            }
+    emit dataAdded();
+}
 
-            // Limit number of plot generations if there are too many
-            limitPlotGenerations();
 
-            emit dataAdded();
+void LogDataHandler2::importFromHopsanBinary(QString importFilePath)
+{
+    if(importFilePath.isEmpty())
+    {
+
+        importFilePath = QFileDialog::getOpenFileName(0,tr("Choose .hrb File"),
+                                                       gpConfig->getStringSetting(cfg::dir::plotdata),
+                                                       tr("Hopsan binary result files (*.hrb)"));
+    }
+    if(importFilePath.isEmpty())
+    {
+        return;
+    }
+
+    QFileInfo fileInfo(importFilePath);
+    gpConfig->setStringSetting(cfg::dir::plotdata, fileInfo.absolutePath());
+
+    CoreResultFileAccess resultFile(fileInfo.absoluteFilePath());
+    if (!resultFile.isOk())
+    {
+        gpMessageHandler->addErrorMessage(resultFile.getErrorString());
+        return;
+    }
+
+    ++mCurrentGenerationNumber;
+
+    // Each subsystem has its own time vector, they are inserted as they are first referenced
+    QMap<int, SharedVectorVariableT> timeVectors;
+    SharedVectorVariableT pNewData;
+    const int numVariables = resultFile.getNumberOfVariables();
+    for (int i=0; i<numVariables; ++i)
+    {
+        QString name, alias, unit, quantity;
+        int timeIdx;
+        resultFile.getVariableInfo(i, name, alias, unit, quantity, timeIdx);
+        // Time vectors are inserted together with their first variable
+        if (timeIdx < 0)
+        {
+            continue;
         }
+
+        SharedVectorVariableT pTimeVec = timeVectors.value(timeIdx);
+        if (!pTimeVec)
+        {
+            QVector<double> timeData;
+            resultFile.getVariableData(timeIdx, timeData);
+            pTimeVec = insertTimeVectorVariable(timeData, fileInfo.absoluteFilePath());
+            timeVectors.insert(timeIdx, pTimeVec);
+        }
+
+        SharedVariableDescriptionT pVarDesc = SharedVariableDescriptionT(new VariableDescription);
+        pVarDesc->mDataName = name;
+        pVarDesc->mAliasName = alias;
+        pVarDesc->mDataUnit = unit;
+        pVarDesc->mDataQuantity = quantity;
+
+        QVector<double> data;
+        resultFile.getVariableData(i, data);
+        pNewData = insertTimeDomainVariable(pTimeVec, data, pVarDesc, fileInfo.absoluteFilePath());
+    }
+
+    if(pNewData)
+    {
+        mImportedGenerationsMap.insert(pNewData->getGeneration(), pNewData->getImportedFileName());
     }
-    file.close();
-}
 
+    // Limit number of plot generations if there are too many
+    limitPlotGenerations();
+
+    emit dataAdded();
+}
 
 void LogDataHandler2::importFromPlainColumnCsv(QString importFilePath, const QChar separator, const int rowsToSkip, const int timecolumn)
 {
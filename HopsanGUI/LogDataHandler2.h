@@ -34,6 +34,7 @@
 #include <QColor>
 #include <QObject>
 #include <QDir>
+#include <functional>
 
 #include "LogVariable.h"
 #include "Widgets/ModelWidget.h"
@@ -43,6 +44,7 @@
 class PlotWindow;
 class ModelWidget;
 class LogDataGeneration;
+class LogDataImportParser;
 
 
 class LogDataHandler2 : public QObject
@@ -64,6 +66,7 @@ public:
     void importFromPlo(QString importFilePath=QString());
     void importFromCSV_AutoFormat(QString importFilePath=QString());
     void importHopsanRowCSV(QString importFilePath=QString());
+    void importFromHopsanBinary(QString importFilePath=QString());
     void importFromPlainColumnCsv(QString importFilePath=QString(), const QChar separator=',', const int rowsToSkip=0, const int timecolumn=0);
     void importFromPlainRowCsv(QString importFilePath=QString(), const QChar separator=',', const int columnsToSkip=0, const int timeRow=0);
     void importTimeVariablesFromCSVColumns(const QString csvFilePath, QVector<int> datacolumns, QStringList datanames, QVector<int> timecolumns);
@@ -190,6 +193,7 @@ private:
     SharedVectorVariableT insertFrequencyDomainVariable(SharedVectorVariableT pFrequencyVector, const QVector<double> &rDataVector, SharedVariableDescriptionT pVarDesc, const QString &rImportFileName);
     SharedVectorVariableT insertVariable(SharedVectorVariableT pVariable, QString keyName=QString(), int gen=-1);
 
+    bool runImportParser(LogDataImportParser &rParser, const QString &rLabel, const std::function<bool()> &rParseFunction);
     bool collectLogDataFromSystem(SystemObject *pCurrentSystem, const QStringList &rSystemHieararchy, QMap<std::vector<double> *, SharedVectorVariableT> &rGenTimeVectors);
 
     QString getNewCacheName(const QString &rDesiredName=QString());
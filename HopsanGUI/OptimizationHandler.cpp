@@ -150,11 +150,13 @@ void OptimizationHandler::startOptimization(ModelWidget *pModel, QString &modelP
 #endif
 
         mStartTime = QDateTime::currentDateTime();
+        mpEvaluator->getStatistics().clear();
 
         mpWorker->initialize();
         mpWorker->run();
 
         mpMessageHandler->addInfoMessage("Optimization finished!");
+        mpMessageHandler->addInfoMessage(QString::fromStdString(mpEvaluator->getStatistics().toTable()));
         gpOptimizationDialog->updateTotalProgressBar(/*mpWorker->getMaxNumberOfIterations()*/100);
         this->setIsRunning(false);
         if(mDisconnectedFromModelHandler)
@@ -701,11 +703,13 @@ void OptimizationHandler::setStartValue(const int pointIdx, const int parIdx, co
 
 bool OptimizationHandler::evaluateCandidate(int idx)
 {
+    const double setupStart = Ops::EvaluationStatistics::now();
     mEvalId = idx;
     mpHcomHandler->setModelPtr(mModelPtrs.at(idx));
     mpHcomHandler->executeCommand("opt set evalid "+QString::number(idx));
     mpHcomHandler->executeCommand("call setpars");
 
+    const double simulationStart = Ops::EvaluationStatistics::now();
     bool simOK=false;
     simOK = mModelPtrs.at(idx)->simulate_blocking();
 
@@ -714,10 +718,13 @@ bool OptimizationHandler::evaluateCandidate(int idx)
         return false;
     }
 
+    const double objectiveStart = Ops::EvaluationStatistics::now();
     mpHcomHandler->executeCommand("opt set evalid "+QString::number(idx));
     mpHcomHandler->executeCommand("call obj");
 
     mpHcomHandler->setModelPtr(mModelPtrs.at(0));
+    mpEvaluator->getStatistics().addCandidate(size_t(idx), simulationStart-setupStart, objectiveStart-simulationStart,
+                                              Ops::EvaluationStatistics::now()-objectiveStart);
 
     ++mEvaluations;
 
@@ -727,19 +734,28 @@ bool OptimizationHandler::evaluateCandidate(int idx)
 bool OptimizationHandler::evaluateAllCandidates()
 {
     mNeedsRescheduling = false;
+    Ops::EvaluationStatistics &rStatistics = mpEvaluator->getStatistics();
+    rStatistics.beginGeneration();
 
     //Multi-threading, we cannot use the "evalall" function
+    QVector<double> setupTimes(int(mpWorker->getNumberOfCandidates()), 0.0);
     for(size_t i=0; i<mpWorker->getNumberOfCandidates() && !mpWorker->aborted(); ++i)
     {
+        const double setupStart = Ops::EvaluationStatistics::now();
         mpHcomHandler->setModelPtr(mModelPtrs[i]);
         mpHcomHandler->executeCommand("opt set evalid "+QString::number(i));
         mpHcomHandler->executeCommand("call setpars");
+        setupTimes[int(i)] = Ops::EvaluationStatistics::now()-setupStart;
     }
 
+    // Individual simulation times are only known for models simulated in this process
+    bool localSimulation = true;
+    const double simulationStart = Ops::EvaluationStatistics::now();
     bool simOK=false;
 #ifdef USEZMQ
     if (gpConfig->getBoolSetting(cfg::useremoteoptimization))
     {
+        localSimulation = false;
         if (mpRemoteSimulationQueueHandler && mpRemoteSimulationQueueHandler->hasServers())
         {
             simOK = mpRemoteSimulationQueueHandler->simulateModels(mNeedsRescheduling);
@@ -753,18 +769,24 @@ bool OptimizationHandler::evaluateAllCandidates()
     //! @note The "mid()" function are used to make sure that the number of models simulated equals number of candidates (in case more models are opened)
     simOK = gpModelHandler->simulateMultipleModels_blocking(mModelPtrs.mid(0,mpWorker->getNumberOfCandidates())/*, !firstTime*/);
 #endif
+    rStatistics.setGenerationSimulationTime(Ops::EvaluationStatistics::now()-simulationStart);
     if (!simOK)
     {
+        rStatistics.endGeneration();
         return false;
     }
 
     for(size_t i=0; i<mpWorker->getNumberOfCandidates(); ++i)
     {
+        const double objectiveStart = Ops::EvaluationStatistics::now();
         mpHcomHandler->setModelPtr(mModelPtrs[i]);
         mpHcomHandler->executeCommand("opt set evalid "+QString::number(i));
         mpHcomHandler->executeCommand("call obj");
+        const double simulationTime = localSimulation ? mModelPtrs[i]->getTopLevelSystemContainer()->getCoreSystemAccessPtr()->getSimulationWallTime() : 0.0;
+        rStatistics.addCandidate(i, setupTimes[int(i)], simulationTime, Ops::EvaluationStatistics::now()-objectiveStart);
     }
     mpHcomHandler->setModelPtr(mModelPtrs.at(0));
+    rStatistics.endGeneration();
 
     mEvaluations += mpWorker->getNumberOfCandidates();
 
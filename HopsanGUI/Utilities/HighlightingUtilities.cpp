@@ -457,7 +457,7 @@ QStringList CppHighlighter::getHopsanKeywordPatterns()
                          << "Integrator" << "IntegratorLimited" << "TurbulentFlowFunction"
                          << "ValveHysteresis" << "DoubleIntegratorWithDamping" << "DoubleIntegratorWithDampingAndCoulumbFriction"
                          << "CSVParser" << "CSVParserNG" << "PLOParser"
-                         << "WhiteGaussianNoise" << "EquationSystemSolver" << "NumericalIntegrationSolver"
+                         << "WhiteGaussianNoise" << "RandomStream" << "EquationSystemSolver" << "NumericalIntegrationSolver"
                          << "LookupTable1D" << "LookupTable2D" << "LookupTable3D";
 }
 
@@ -0,0 +1,541 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ The full license is available in the file GPLv3.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   LogDataImportParser.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a GUI independent parser for importing log data files
+//!
+//$Id$
+
+#include "LogDataImportParser.h"
+
+#include <QFileInfo>
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+
+//! @brief Number of rows (or values) parsed between progress updates and abort checks
+const int progressInterval = 4096;
+
+//! @brief Powers of ten that are exactly representable as double
+const double exactPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool isDigit(const char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+inline bool isBlank(const char c)
+{
+    return (c == ' ') || (c == '\t');
+}
+
+inline bool isDelimiter(const char c)
+{
+    return (c == ' ') || (c == '\t') || (c == ',') || (c == '\n') || (c == '\r');
+}
+
+//! @brief Finds the next line in a buffer
+//! @param [in,out] rpPos Current position, moved to the beginning of the following line
+//! @param [in] pEnd End of buffer
+//! @param [out] rpLineBegin Beginning of line
+//! @param [out] rpLineEnd End of line (excluding line break characters)
+//! @returns False if there are no more lines
+bool nextLine(const char *&rpPos, const char *pEnd, const char *&rpLineBegin, const char *&rpLineEnd)
+{
+    if (rpPos >= pEnd)
+    {
+        return false;
+    }
+    rpLineBegin = rpPos;
+    const char *pNewLine = static_cast<const char*>(memchr(rpPos, '\n', size_t(pEnd-rpPos)));
+    if (pNewLine)
+    {
+        rpPos = pNewLine+1;
+    }
+    else
+    {
+        pNewLine = pEnd;
+        rpPos = pEnd;
+    }
+    rpLineEnd = pNewLine;
+    if ((rpLineEnd > rpLineBegin) && (*(rpLineEnd-1) == '\r'))
+    {
+        --rpLineEnd;
+    }
+    return true;
+}
+
+inline void skipBlanks(const char *&rpPos, const char *pEnd)
+{
+    while ((rpPos < pEnd) && isBlank(*rpPos))
+    {
+        ++rpPos;
+    }
+}
+
+}
+
+LogDataImportParser::LogDataImportParser()
+    : mpMappedData(nullptr), mpBegin(nullptr), mpEnd(nullptr), mPloVersion(0), mAbort(false), mBytesParsed(0), mBytesTotal(0)
+{
+}
+
+//! @brief Parses a decimal floating point number
+//! Numbers with at most 19 significant digits and a small exponent are converted exactly using integer arithmetic and
+//! a single floating point operation, other numbers (and nan, inf) fall back to the slower Qt conversion
+//! @param [in,out] rpPos Position to parse from, moved to the first character after the number
+//! @param [in] pEnd End of buffer
+//! @param [out] rValue The parsed value
+//! @returns True if a number was parsed
+bool LogDataImportParser::parseDouble(const char *&rpPos, const char *pEnd, double &rValue)
+{
+    const char *p = rpPos;
+    bool isNegative = false;
+    if ((p < pEnd) && ((*p == '-') || (*p == '+')))
+    {
+        isNegative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int nSignificantDigits = 0;
+    int exponent = 0;
+    bool haveDigits = false;
+    bool isTruncated = false;
+
+    // Integer part
+    while ((p < pEnd) && isDigit(*p))
+    {
+        haveDigits = true;
+        if (nSignificantDigits < 19)
+        {
+            mantissa = mantissa*10 + uint64_t(*p-'0');
+            if (mantissa != 0)
+            {
+                ++nSignificantDigits;
+            }
+        }
+        else
+        {
+            isTruncated = isTruncated || (*p != '0');
+            ++exponent;
+        }
+        ++p;
+    }
+
+    // Fraction part
+    if ((p < pEnd) && (*p == '.'))
+    {
+        ++p;
+        while ((p < pEnd) && isDigit(*p))
+        {
+            haveDigits = true;
+            if (nSignificantDigits < 19)
+            {
+                mantissa = mantissa*10 + uint64_t(*p-'0');
+                if (mantissa != 0)
+                {
+                    ++nSignificantDigits;
+                }
+                --exponent;
+            }
+            else
+            {
+                isTruncated = isTruncated || (*p != '0');
+            }
+            ++p;
+        }
+    }
+
+    // Exponent part
+    if (haveDigits && (p < pEnd) && ((*p == 'e') || (*p == 'E')))
+    {
+        const char *pExp = p+1;
+        bool isExpNegative = false;
+        if ((pExp < pEnd) && ((*pExp == '-') || (*pExp == '+')))
+        {
+            isExpNegative = (*pExp == '-');
+            ++pExp;
+        }
+        if ((pExp < pEnd) && isDigit(*pExp))
+        {
+            int expValue = 0;
+            while ((pExp < pEnd) && isDigit(*pExp))
+            {
+                if (expValue < 10000)
+                {
+                    expValue = expValue*10 + (*pExp-'0');
+                }
+                ++pExp;
+            }
+            exponent += isExpNegative ? -expValue : expValue;
+            p = pExp;
+        }
+    }
+
+    // Fast path, both the mantissa and the power of ten are exact so the result is correctly rounded
+    if (haveDigits && !isTruncated && (mantissa <= (uint64_t(1) << 53)) && (exponent >= -22) && (exponent <= 22) &&
+        ((p == pEnd) || isDelimiter(*p)))
+    {
+        double value = double(mantissa);
+        if (exponent < 0)
+        {
+            value /= exactPowersOfTen[-exponent];
+        }
+        else
+        {
+            value *= exactPowersOfTen[exponent];
+        }
+        rValue = isNegative ? -value : value;
+        rpPos = p;
+        return true;
+    }
+
+    // Slow path
+    p = rpPos;
+    while ((p < pEnd) && !isDelimiter(*p))
+    {
+        ++p;
+    }
+    if (p == rpPos)
+    {
+        return false;
+    }
+    bool isOk;
+    rValue = QByteArray::fromRawData(rpPos, int(p-rpPos)).toDouble(&isOk);
+    if (isOk)
+    {
+        rpPos = p;
+    }
+    return isOk;
+}
+
+//! @brief Parses a Hopsan PLO file (version 1, 2 or 3)
+//! @param [in] rFilePath Path to the file
+//! @returns True if successful, false on error or if aborted
+bool LogDataImportParser::parsePlo(const QString &rFilePath)
+{
+    if (!openFile(rFilePath))
+    {
+        return false;
+    }
+
+    const QString fileName = QFileInfo(rFilePath).fileName();
+    const char *pPos = mpBegin;
+    const char *pLineBegin, *pLineEnd;
+    int nDataColumns = 0;
+    int nDataRows = 0;
+
+    // Read header data
+    for (int lineNum=1; lineNum<7; ++lineNum)
+    {
+        if (!nextLine(pPos, mpEnd, pLineBegin, pLineEnd))
+        {
+            setError(QString("Unexpected end of file in the header of: %1").arg(fileName));
+            return false;
+        }
+        const QString line = QString::fromUtf8(pLineBegin, int(pLineEnd-pLineBegin)).trimmed();
+        bool parseOK = true;
+        // Check if this seems to be a plo file
+        if (lineNum == 1)
+        {
+            if (line != "'VERSION'")
+            {
+                setError(fileName+" Does not seem to be a plo file, Aborting import!");
+                return false;
+            }
+        }
+        // Check PLO format version
+        else if (lineNum == 2)
+        {
+            mPloVersion = line.toInt(&parseOK);
+        }
+        // Check for num data info
+        else if (lineNum == 4)
+        {
+            bool colOK=false, rowOK=false;
+            const QStringList colsandrows = line.simplified().split(" ");
+            if (colsandrows.size() >= 2)
+            {
+                nDataColumns = colsandrows[0].toInt(&colOK);
+                nDataRows = colsandrows[1].toInt(&rowOK);
+            }
+            parseOK = colOK && rowOK && (nDataColumns >= 0) && (nDataRows >= 0);
+        }
+        // Check for data header info
+        else if (lineNum == 5)
+        {
+            // PLO version 1 and 2 does not count the time or frequency column
+            if ( ((mPloVersion == 1) || (mPloVersion == 2)) && (line.startsWith("'Time") || line.startsWith("'Frequency")) )
+            {
+                nDataColumns += 1;
+            }
+            const QStringList dataheader = line.split(",");
+            parseOK = (dataheader.size() >= nDataColumns);
+            if (parseOK)
+            {
+                mColumns.resize(nDataColumns);
+                for (int c=0; c<nDataColumns; ++c)
+                {
+                    QString word = dataheader[c];
+                    mColumns[c].mName = word.remove('\'').trimmed();
+                }
+            }
+        }
+        // Check for plot scales
+        else if (lineNum == 6)
+        {
+            const QStringList scales = line.simplified().split(" ");
+            for (int c=0; c<nDataColumns && c<scales.size(); ++c)
+            {
+                mColumns[c].mPlotScale = scales[c];
+            }
+        }
+
+        if (!parseOK)
+        {
+            setError(QString("A parse error occurred while parsing the header of: ")+fileName+" Aborting import!");
+            return false;
+        }
+    }
+
+    // Preallocate all columns and parse values directly into them
+    QVector<double*> columnData(nDataColumns);
+    for (int c=0; c<nDataColumns; ++c)
+    {
+        mColumns[c].mData.resize(nDataRows);
+        columnData[c] = mColumns[c].mData.data();
+    }
+
+    int r=0;
+    for (; r<nDataRows; ++r)
+    {
+        if (!nextLine(pPos, mpEnd, pLineBegin, pLineEnd))
+        {
+            break;
+        }
+        const char *pValue = pLineBegin;
+        for (int c=0; c<nDataColumns; ++c)
+        {
+            skipBlanks(pValue, pLineEnd);
+            if (!parseDouble(pValue, pLineEnd, columnData[c][r]))
+            {
+                setError(QString("Could not parse value in column %1 on line %2 in: %3").arg(c+1).arg(r+7).arg(fileName));
+                return false;
+            }
+        }
+
+        if ((r % progressInterval) == 0)
+        {
+            mBytesParsed = pPos-mpBegin;
+            if (mAbort)
+            {
+                closeFile();
+                return false;
+            }
+        }
+    }
+
+    // Truncate if file contained fewer rows than specified in the header
+    if (r < nDataRows)
+    {
+        for (int c=0; c<nDataColumns; ++c)
+        {
+            mColumns[c].mData.resize(r);
+        }
+    }
+
+    // Ignore the rest of the data for now
+    closeFile();
+    return true;
+}
+
+//! @brief Parses a Hopsan row based CSV file, each row contains name, alias, unit followed by the data values
+//! @param [in] rFilePath Path to the file
+//! @returns True if successful, false on error or if aborted
+bool LogDataImportParser::parseHopsanRowCsv(const QString &rFilePath)
+{
+    if (!openFile(rFilePath))
+    {
+        return false;
+    }
+
+    const QString fileName = QFileInfo(rFilePath).fileName();
+    const char *pPos = mpBegin;
+    const char *pLineBegin, *pLineEnd;
+    int lineNum = 0;
+    while (nextLine(pPos, mpEnd, pLineBegin, pLineEnd))
+    {
+        ++lineNum;
+
+        // Find the three meta data fields
+        const char *pFields[4];
+        pFields[0] = pLineBegin;
+        int nFields = 1;
+        while (nFields < 4)
+        {
+            const char *pComma = static_cast<const char*>(memchr(pFields[nFields-1], ',', size_t(pLineEnd-pFields[nFields-1])));
+            if (!pComma)
+            {
+                break;
+            }
+            pFields[nFields++] = pComma+1;
+        }
+        // Lines without data are ignored
+        if (nFields < 4)
+        {
+            continue;
+        }
+
+        mColumns.append(Column());
+        Column &rColumn = mColumns.last();
+        rColumn.mName = QString::fromUtf8(pFields[0], int(pFields[1]-pFields[0]-1));
+        rColumn.mAlias = QString::fromUtf8(pFields[1], int(pFields[2]-pFields[1]-1));
+        rColumn.mUnit = QString::fromUtf8(pFields[2], int(pFields[3]-pFields[2]-1));
+
+        // Count values and parse them into a preallocated column
+        const int nValues = 1 + int(std::count(pFields[3], pLineEnd, ','));
+        rColumn.mData.resize(nValues);
+        double *pData = rColumn.mData.data();
+        const char *pValue = pFields[3];
+        for (int i=0; i<nValues; ++i)
+        {
+            skipBlanks(pValue, pLineEnd);
+            if (!parseDouble(pValue, pLineEnd, pData[i]))
+            {
+                setError(QString("Could not parse value %1 on line %2 in: %3").arg(i+1).arg(lineNum).arg(fileName));
+                return false;
+            }
+            skipBlanks(pValue, pLineEnd);
+            if ((pValue < pLineEnd) && (*pValue == ','))
+            {
+                ++pValue;
+            }
+        }
+
+        mBytesParsed = pPos-mpBegin;
+        if (mAbort)
+        {
+            closeFile();
+            return false;
+        }
+    }
+
+    closeFile();
+    return true;
+}
+
+//! @brief Returns the parsed columns, the data can be moved out of the parser
+QVector<LogDataImportParser::Column> &LogDataImportParser::getColumns()
+{
+    return mColumns;
+}
+
+//! @brief Returns the version of the last parsed PLO file
+int LogDataImportParser::getPloVersion() const
+{
+    return mPloVersion;
+}
+
+QString LogDataImportParser::getErrorString() const
+{
+    return mErrorString;
+}
+
+//! @brief Requests the parser to stop, can be called from any thread
+void LogDataImportParser::abort()
+{
+    mAbort = true;
+}
+
+bool LogDataImportParser::wasAborted() const
+{
+    return mAbort;
+}
+
+//! @brief Returns the parse progress (0 to 1), can be called from any thread
+double LogDataImportParser::getProgress() const
+{
+    const qint64 total = mBytesTotal;
+    if (total <= 0)
+    {
+        return 0;
+    }
+    return double(mBytesParsed)/double(total);
+}
+
+//! @brief Opens a file and maps it into memory, if mapping is not possible the file is read into a buffer
+bool LogDataImportParser::openFile(const QString &rFilePath)
+{
+    mColumns.clear();
+    mErrorString.clear();
+    mBytesParsed = 0;
+    mFile.setFileName(rFilePath);
+    if (!mFile.open(QIODevice::ReadOnly))
+    {
+        setError(QString("Could not open file: %1").arg(rFilePath));
+        return false;
+    }
+    mBytesTotal = mFile.size();
+
+    mpMappedData = (mFile.size() > 0) ? mFile.map(0, mFile.size()) : nullptr;
+    if (mpMappedData)
+    {
+        mpBegin = reinterpret_cast<const char*>(mpMappedData);
+    }
+    else
+    {
+        mFileBuffer = mFile.readAll();
+        mpBegin = mFileBuffer.constData();
+    }
+    mpEnd = mpBegin + mBytesTotal;
+    return true;
+}
+
+void LogDataImportParser::closeFile()
+{
+    if (mpMappedData)
+    {
+        mFile.unmap(mpMappedData);
+        mpMappedData = nullptr;
+    }
+    mFile.close();
+    mFileBuffer.clear();
+    mpBegin = nullptr;
+    mpEnd = nullptr;
+    mBytesParsed = qint64(mBytesTotal);
+}
+
+void LogDataImportParser::setError(const QString &rError)
+{
+    mErrorString = rError;
+    closeFile();
+}
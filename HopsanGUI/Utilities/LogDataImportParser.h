@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ The full license is available in the file GPLv3.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   LogDataImportParser.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a GUI independent parser for importing log data files
+//!
+//$Id$
+
+#ifndef LOGDATAIMPORTPARSER_H
+#define LOGDATAIMPORTPARSER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+//! @brief Parses PLO and Hopsan row based CSV files into preallocated columns
+//! The parser only depends on QtCore so it can run in a worker thread, progress and abort are thread-safe
+class LogDataImportParser
+{
+public:
+    class Column
+    {
+    public:
+        QString mName;
+        QString mAlias;
+        QString mUnit;
+        QString mPlotScale;
+        QVector<double> mData;
+    };
+
+    LogDataImportParser();
+
+    bool parsePlo(const QString &rFilePath);
+    bool parseHopsanRowCsv(const QString &rFilePath);
+
+    QVector<Column> &getColumns();
+    int getPloVersion() const;
+    QString getErrorString() const;
+
+    void abort();
+    bool wasAborted() const;
+    double getProgress() const;
+
+    static bool parseDouble(const char *&rpPos, const char *pEnd, double &rValue);
+
+private:
+    bool openFile(const QString &rFilePath);
+    void closeFile();
+    void setError(const QString &rError);
+
+    QFile mFile;
+    uchar *mpMappedData;
+    QByteArray mFileBuffer;
+    const char *mpBegin;
+    const char *mpEnd;
+
+    QVector<Column> mColumns;
+    int mPloVersion;
+    QString mErrorString;
+
+    std::atomic<bool> mAbort;
+    std::atomic<qint64> mBytesParsed;
+    std::atomic<qint64> mBytesTotal;
+};
+
+#endif // LOGDATAIMPORTPARSER_H
@@ -206,7 +206,7 @@ public slots:
     void openImportDataDialog()
     {
         QFileDialog fd(mpParentWidget, tr("Choose Hopsan Data File"), gpConfig->getStringSetting(cfg::dir::plotdata),
-                       tr("Data Files (*.plo *.PLO *.csv *.CSV);; Space-separated Column Data (*.*);; All (Treat as csv) (*.*)"));
+                       tr("Data Files (*.plo *.PLO *.csv *.CSV *.hrb);; Space-separated Column Data (*.*);; All (Treat as csv) (*.*)"));
         fd.setFileMode(QFileDialog::ExistingFiles);
         const auto rc = fd.exec();
         QStringList selectedFiles = fd.selectedFiles();
@@ -220,6 +220,9 @@ public slots:
                 else if (fi.suffix().toLower() == "plo") {
                     mpLogDataHandler->importFromPlo(file);
                 }
+                else if (fi.suffix().toLower() == "hrb") {
+                    mpLogDataHandler->importFromHopsanBinary(file);
+                }
                 else {
                     mpLogDataHandler->importFromCSV_AutoFormat(file);
                 }
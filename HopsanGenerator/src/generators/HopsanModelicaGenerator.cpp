@@ -24,8 +24,10 @@
 
 #include "generators/HopsanModelicaGenerator.h"
 #include "GeneratorUtilities.h"
+#include "ExpressionDag.h"
 #include <QTime>
 #include <QFileInfo>
+#include <QMap>
 
 namespace {
 
@@ -73,6 +75,43 @@ SymHop::Expression concurrentDiff(SymHop::Expression expr)
     return derExpr;
 }
 
+//! @brief A block of the sorted equation system
+struct EquationBlock
+{
+    QList<SymHop::Expression> assignments;              //Explicit assignments, in evaluation order
+    QList<SymHop::Expression> residuals;                //Residual equations for the non-linear solver (empty for explicit blocks)
+    QList<SymHop::Expression> tearVariables;            //Variables solved by the non-linear solver
+    QList<QList<SymHop::Expression> > jacobian;         //Jacobian of the residuals with respect to the tearing variables
+    QStringList jacobianTemporaries;                    //Common subexpressions of the non-zero Jacobian elements, as "name = expression"
+    QStringList jacobianElements;                       //Non-zero Jacobian elements, stored row-wise, using the temporaries
+    int size;                                           //Number of equations in the block before tearing
+};
+
+//! @brief Solves a left-sided equation for a variable, if the equation is linear in the variable
+//! @param [in] equation Left-sided equation (equation = 0)
+//! @param [in] var Variable to solve for
+//! @param [out] result The solution
+//! @returns False if the equation can not be solved explicitly
+bool solveForVariable(const SymHop::Expression &equation, const SymHop::Expression &var, SymHop::Expression &result)
+{
+    bool ok = true;
+    SymHop::Expression coefficient = equation.derivative(var, ok);
+    if(!ok) {
+        return false;
+    }
+    coefficient._simplify(SymHop::Expression::FullSimplification, SymHop::Expression::Recursive);
+    if(coefficient.contains(var) || coefficient == SymHop::Expression(0)) {
+        return false;
+    }
+
+    result = equation;
+    result.replace(var, SymHop::Expression(0));
+    result.divideBy(coefficient);
+    result.changeSign();
+    result._simplify(SymHop::Expression::FullSimplification, SymHop::Expression::Recursive);
+    return !result.contains(var);
+}
+
 } // End anon namespace
 
 using namespace SymHop;
@@ -91,7 +130,7 @@ bool HopsanModelicaGenerator::generateFromModelica(QString path)
     QString code = moFile.readAll();
     moFile.close();
 
-    QString typeName, displayName, cqsType, transform;
+    QString typeName, displayName, cqsType, transform, jacobianType;
     QStringList initAlgorithms, algorithms, equations, finalAlgorithms;
     QList<PortSpecification> portList;
     QList<ParameterSpecification> parametersList;
@@ -102,7 +141,7 @@ bool HopsanModelicaGenerator::generateFromModelica(QString path)
     printMessage("Parsing "+moFile.fileName()+"...");
 
     //Parse Modelica code and generate equation system
-    if(!parseModelicaModel(code, typeName, displayName, cqsType, initAlgorithms, algorithms, equations, portList, parametersList, variablesList, transform)) {
+    if(!parseModelicaModel(code, typeName, displayName, cqsType, initAlgorithms, algorithms, equations, portList, parametersList, variablesList, transform, jacobianType)) {
         printErrorMessage("Failed to parse Modelica model.");
         return false;
     }
@@ -114,7 +153,7 @@ bool HopsanModelicaGenerator::generateFromModelica(QString path)
     logFile.open(QFile::WriteOnly | QFile::Text | QFile::Truncate);
     QTextStream logStream(&logFile);
 
-    bool success = generateComponentObject(comp,typeName,displayName,cqsType,transform,initAlgorithms,algorithms,equations,portList,parametersList,variablesList,logStream);
+    bool success = generateComponentObject(comp,typeName,displayName,cqsType,transform,jacobianType,initAlgorithms,algorithms,equations,portList,parametersList,variablesList,logStream);
 
     logFile.close();
 
@@ -161,7 +200,8 @@ enum ModelicaCodePartT { UndefinedPart, HeaderSection, InitialAlgorithmSection,
 bool HopsanModelicaGenerator::parseModelicaModel(QString code, QString &typeName, QString &displayName, QString &cqsType,
                                                  QStringList &initAlgorithms, QStringList &algorithms, QStringList &equations,
                                                  QList<PortSpecification> &portList, QList<ParameterSpecification> &parametersList,
-                                                 QList<VariableSpecification> &variablesList, QString &transform)
+                                                 QList<VariableSpecification> &variablesList, QString &transform,
+                                                 QString &jacobianType)
 {
     QStringList lines = code.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
     QStringList portNames;
@@ -232,6 +272,13 @@ bool HopsanModelicaGenerator::parseModelicaModel(QString code, QString &typeName
                 if(tempLine.contains("linearTransform=")) {
                     transform = tempLine.section("linearTransform=",1,1).section("\"",1,1);
                 }
+                if(tempLine.contains("hopsanJacobian=")) {
+                    jacobianType = tempLine.section("hopsanJacobian=",1,1).section("\"",1,1);
+                    if(jacobianType != "auto" && jacobianType != "dense" && jacobianType != "sparse") {
+                        printErrorMessage("Unknown Jacobian type: \""+jacobianType+"\" (expected \"auto\", \"dense\" or \"sparse\").");
+                        return false;
+                    }
+                }
             }
             else if(words.at(0) == "parameter")         //"parameter" keyword
             {
@@ -617,7 +664,7 @@ bool HopsanModelicaGenerator::replaceCustomFunctions(Expression &expr) {
 
 
 
-bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &comp, QString &typeName, QString &displayName, QString &cqsType, QString &transform, QStringList &initAlgorithms, QStringList &algorithms, QStringList &plainEquations, QList<PortSpecification> &ports, QList<ParameterSpecification> &parameters, QList<VariableSpecification> &variables, QTextStream &logStream)
+bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &comp, QString &typeName, QString &displayName, QString &cqsType, QString &transform, QString &jacobianType, QStringList &initAlgorithms, QStringList &algorithms, QStringList &plainEquations, QList<PortSpecification> &ports, QList<ParameterSpecification> &parameters, QList<VariableSpecification> &variables, QTextStream &logStream)
 {
     printMessage("Initializing Modelica generator for Kinsol solver.");
 
@@ -987,28 +1034,120 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
         }
     }
 
-    //Differentiate each equation for each state variable to generate the Jacobian matrix
-    QList<QList<Expression> > jacobian;
-    for(int e=0; e<systemEquations.size(); ++e)
-    {
-         //Remove all delay operators, since they shall not be in the Jacobian anyway
-        gTempExpr = systemEquations[e];
-        gTempExpr._simplify(Expression::FullSimplification, Expression::Recursive);
+    //Sort the equation system into block lower triangular form, so that only the coupled algebraic loops are solved by Kinsol
+    QList<QList<int> > dependencies;
+    for(int e=0; e<systemEquations.size(); ++e) {
+        dependencies.append(QList<int>());
+        for(int u=0; u<unknowns.size(); ++u) {
+            if(systemEquations[e].contains(unknowns[u])) {
+                dependencies[e].append(u);
+            }
+        }
+    }
 
-        QList<Expression> result;
-        for(int u=0; u<unknowns.size(); ++u)
-        {
-            result.append(concurrentDiff(unknowns[u]));
-            result.last().expandPowers();
+    QList<EquationBlock> blocks;
+    QList<int> matching;
+    if(!systemEquations.isEmpty() && !findMatching(dependencies, unknowns.size(), matching)) {
+        printWarningMessage("Failed to find block lower triangular form, solving all equations simultaneously.");
+        EquationBlock block;
+        block.residuals = systemEquations;
+        block.tearVariables = unknowns;
+        block.size = systemEquations.size();
+        blocks.append(block);
+    }
+    else if(!systemEquations.isEmpty()) {
+        QList<QList<int> > bltBlocks;
+        findBlockLowerTriangularForm(dependencies, matching, bltBlocks);
+        for(const QList<int> &bltBlock : bltBlocks) {
+            //Find equations that can be solved explicitly for their assigned variable
+            QMap<int, Expression> solutions;
+            for(int e : bltBlock) {
+                Expression solution;
+                if(solveForVariable(systemEquations[e], unknowns[matching[e]], solution)) {
+                    solutions.insert(e, solution);
+                }
+            }
+
+            //Tear algebraic loops, so that only the tearing variables are solved by Kinsol
+            QList<int> residualEquations, explicitEquations;
+            tearBlock(dependencies, matching, bltBlock, solutions.keys(), residualEquations, explicitEquations);
+
+            EquationBlock block;
+            block.size = bltBlock.size();
+            for(int e : explicitEquations) {
+                block.assignments.append(Expression::fromEquation(unknowns[matching[e]], solutions.value(e)));
+            }
+            for(int e : residualEquations) {
+                block.residuals.append(systemEquations[e]);
+                block.tearVariables.append(unknowns[matching[e]]);
+            }
+            blocks.append(block);
         }
+    }
 
-        jacobian.append(result);
+    //Differentiate each residual for each tearing variable to generate the Jacobian matrices
+    for(EquationBlock &block : blocks) {
+        //Derivatives are memoized in a shared expression graph, since residuals in a block share most of their subexpressions
+        ExpressionDag dag;
+        for(const Expression &residual : block.residuals) {
+            //Substitute the explicit assignments in the block, so that the residual only depends on the tearing variables
+            Expression substituted = residual;
+            for(int a=block.assignments.size()-1; a>=0; --a) {
+                substituted.replace(*block.assignments[a].getLeft(), *block.assignments[a].getRight());
+            }
+
+            //Remove all delay operators, since they shall not be in the Jacobian anyway
+            gTempExpr = substituted;
+            gTempExpr._simplify(Expression::FullSimplification, Expression::Recursive);
+
+            QList<Expression> result;
+            for(const Expression &variable : block.tearVariables)
+            {
+                bool ok = true;
+                result.append(dag.derivative(gTempExpr, variable, ok));
+                if(!ok) {
+                    result.last() = concurrentDiff(variable);
+                }
+            }
+
+            block.jacobian.append(result);
+        }
+
+        //Hoist subexpressions that are shared between Jacobian elements into temporary variables
+        QList<int> roots;
+        for(int i=0; i<block.jacobian.size(); ++i) {
+            for(int j=0; j<block.jacobian[i].size(); ++j) {
+                if(block.jacobian[i][j] != Expression(0)) {
+                    roots.append(dag.fromExpression(block.jacobian[i][j]));
+                }
+            }
+        }
+        block.jacobianTemporaries = dag.eliminateCommonSubexpressions(roots, "jacTemp", block.jacobianElements);
+
+        //Expand power functions for performance
+        for(auto &residual : block.residuals) {
+            residual.expandPowers();
+        }
+        for(auto &assignment : block.assignments) {
+            assignment.expandPowers();
+        }
     }
 
-    //Expand power functions for performance
-    for(auto &equation : systemEquations) {
-        equation.expandPowers();
+    //Report the resulting block structure
+    int numExplicitEquations = 0;
+    QStringList blockSizes;
+    QList<int> nonlinearBlocks;
+    for(int b=0; b<blocks.size(); ++b) {
+        if(blocks[b].residuals.isEmpty()) {
+            numExplicitEquations += blocks[b].assignments.size();
+        }
+        else {
+            nonlinearBlocks.append(b);
+            blockSizes.append(QString::number(blocks[b].residuals.size())+" (torn from "+QString::number(blocks[b].size)+")");
+        }
     }
+    printMessage("Sorted equation system into "+QString::number(blocks.size())+" blocks: "+QString::number(numExplicitEquations)+" explicit equations and "+
+                 QString::number(nonlinearBlocks.size())+" algebraic loops"+(blockSizes.isEmpty() ? QString(".") : " of size "+blockSizes.join(", ")+"."));
 
     logStream << "\n--- Initial Algorithms ---\n";
     printMessage("Initial algorithms:");
@@ -1019,9 +1158,16 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
 
     logStream << "\n--- Equation System ---\n";
     printMessage("Equation system:");
-    for(int i=0; i<systemEquations.size(); ++i) {
-            logStream << systemEquations[i].toString() << " = 0\n";
-            printMessage("  "+systemEquations[i].toString()+" = 0");
+    for(int b=0; b<blocks.size(); ++b) {
+        logStream << "Block " << b << " (size " << blocks[b].size << ", " << blocks[b].residuals.size() << " tearing variables)\n";
+        for(const Expression &assignment : blocks[b].assignments) {
+            logStream << assignment.toString() << "\n";
+            printMessage("  "+assignment.toString());
+        }
+        for(const Expression &residual : blocks[b].residuals) {
+            logStream << residual.toString() << " = 0\n";
+            printMessage("  "+residual.toString()+" = 0");
+        }
     }
 
     logStream << "\n--- Final Algorithms ---\n";
@@ -1077,15 +1223,64 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
         comp.varTypes.append("double");
     }
 
-    if(!unknowns.isEmpty()) {
-        comp.varNames << "mpSolver";
+    //Each algebraic loop gets its own solver, and getResiduals() dispatches on the active block if there are more than one
+    auto solverName = [&nonlinearBlocks](int k) {
+        return (nonlinearBlocks.size() > 1) ? "mpSolver"+QString::number(k) : QString("mpSolver");
+    };
+    auto functionSuffix = [&nonlinearBlocks](int k) {
+        return (nonlinearBlocks.size() > 1) ? QString::number(k) : QString();
+    };
+    for(int k=0; k<nonlinearBlocks.size(); ++k) {
+        comp.varNames << solverName(k);
         comp.varInits << "";
         comp.varTypes << "KinsolSolver*";
     }
+    if(nonlinearBlocks.size() > 1) {
+        comp.varNames << "mSolverBlock";
+        comp.varInits << "0";
+        comp.varTypes << "int";
+    }
+
+    //Use a sparse Jacobian for large systems where most Jacobian elements are zero,
+    //unless the model forces a Jacobian type with the hopsanJacobian annotation
+    const int minSparseSystemSize = 20;
+    const double maxSparseDensity = 0.2;
+    QList<bool> useSparseJacobian;
+    for(int k=0; k<nonlinearBlocks.size(); ++k) {
+        const EquationBlock &block = blocks[nonlinearBlocks[k]];
+        const int n = block.residuals.size();
+        QStringList jacobianRowPointers, jacobianColumnIndices;
+        jacobianRowPointers << "0";
+        for(int i=0; i<block.jacobian.size(); ++i) {
+            for(int j=0; j<block.jacobian[i].size(); ++j) {
+                if(block.jacobian[i][j] != Expression(0)) {
+                    jacobianColumnIndices << QString::number(j);
+                }
+            }
+            jacobianRowPointers << QString::number(jacobianColumnIndices.size());
+        }
+        if(jacobianType == "sparse") {
+            useSparseJacobian.append(true);
+        }
+        else if(jacobianType == "dense") {
+            useSparseJacobian.append(false);
+        }
+        else {
+            useSparseJacobian.append((n >= minSparseSystemSize) && (jacobianColumnIndices.size() <= maxSparseDensity*n*n));
+        }
 
-    if(!unknowns.isEmpty()) {
         QString solverMethod = "KinsolSolver::NewtonIteration";
-        comp.initEquations << "mpSolver = new KinsolSolver(this, mTolerance, "+QString::number(systemEquations.size())+", "+solverMethod+");";
+        if(useSparseJacobian.last()) {
+            const QString suffix = functionSuffix(k);
+            comp.initEquations << "static const int jacobianRowPointers"+suffix+"["+QString::number(jacobianRowPointers.size())+"] = {"+jacobianRowPointers.join(",")+"};";
+            comp.initEquations << "static const int jacobianColumnIndices"+suffix+"["+QString::number(jacobianColumnIndices.size())+"] = {"+jacobianColumnIndices.join(",")+"};";
+            comp.initEquations << solverName(k)+" = new KinsolSolver(this, mTolerance, "+QString::number(n)+", "+solverMethod+", "
+                                  "std::vector<int>(jacobianRowPointers"+suffix+", jacobianRowPointers"+suffix+"+"+QString::number(jacobianRowPointers.size())+"), "
+                                  "std::vector<int>(jacobianColumnIndices"+suffix+", jacobianColumnIndices"+suffix+"+"+QString::number(jacobianColumnIndices.size())+"));";
+        }
+        else {
+            comp.initEquations << solverName(k)+" = new KinsolSolver(this, mTolerance, "+QString::number(n)+", "+solverMethod+");";
+        }
     }
 
     for(int i=0; i<delayTerms.size(); ++i)
@@ -1116,21 +1311,45 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
         comp.simEquations << "";
     }
 
-    if(!unknowns.isEmpty()) {
+    for(int b=0; b<blocks.size(); ++b) {
+        const EquationBlock &block = blocks[b];
+        if(block.residuals.isEmpty()) {
+            for(const Expression &assignment : block.assignments) {
+                comp.simEquations << assignment.toString()+";";
+            }
+            continue;
+        }
+
+        const int k = nonlinearBlocks.indexOf(b);
+        const QString solver = solverName(k);
+        comp.simEquations << "";
         comp.simEquations << "//Provide Kinsol with updated state variables";
-        for(int u=0; u<unknowns.size(); ++u) {
-            comp.simEquations << "mpSolver->setState("+QString::number(u)+","+unknowns[u].toString()+");";
+        if(nonlinearBlocks.size() > 1) {
+            comp.simEquations << "mSolverBlock = "+QString::number(k)+";";
+        }
+        for(int u=0; u<block.tearVariables.size(); ++u) {
+            comp.simEquations << solver+"->setState("+QString::number(u)+","+block.tearVariables[u].toString()+");";
         }
         comp.simEquations << "";
         comp.simEquations << "//Solve algebraic equation system";
-        comp.simEquations << "mpSolver->solve();";
+        comp.simEquations << solver+"->solve();";
         comp.simEquations << "";
         comp.simEquations << "//Obtain new state variables from Kinsol";
-        for(int u=0; u<unknowns.size(); ++u) {
-            comp.simEquations << unknowns[u].toString()+" = mpSolver->getState("+QString::number(u)+");";
+        for(int u=0; u<block.tearVariables.size(); ++u) {
+            comp.simEquations << block.tearVariables[u].toString()+" = "+solver+"->getState("+QString::number(u)+");";
+        }
+        if(!block.assignments.isEmpty()) {
+            comp.simEquations << "";
+            comp.simEquations << "//Compute torn variables from the solution";
+            for(const Expression &assignment : block.assignments) {
+                comp.simEquations << assignment.toString()+";";
+            }
         }
         comp.simEquations << "";
     }
+    if(!blocks.isEmpty() && nonlinearBlocks.isEmpty()) {
+        comp.simEquations << "";
+    }
 
     if(!finalAlgorithms.isEmpty()) {
         comp.simEquations << "//Final algorithm section";
@@ -1193,18 +1412,28 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
     }
 
 
-    if(!unknowns.isEmpty()) {
+    for(int k=0; k<nonlinearBlocks.size(); ++k) {
+        const EquationBlock &block = blocks[nonlinearBlocks[k]];
+        const QString suffix = functionSuffix(k);
+        const int n = block.tearVariables.size();
+
+        if(!comp.auxiliaryFunctions.isEmpty()) {
+            comp.auxiliaryFunctions << "";
+        }
         comp.auxiliaryFunctions << "//! @brief Returns the residuals for speed and position";
         comp.auxiliaryFunctions << "//! @param [in] y Array of state variables from previous iteration";
         comp.auxiliaryFunctions << "//! @param [out] res Array of residuals or new state variables";
-        comp.auxiliaryFunctions << "void getResiduals(double *y, double *res)";
+        comp.auxiliaryFunctions << "void getResiduals"+suffix+"(double *y, double *res)";
         comp.auxiliaryFunctions << "{";
-        for(int u=0; u<unknowns.size(); ++u) {
-            comp.auxiliaryFunctions << "    double "+unknowns[u].toString()+" = y["+QString::number(u)+"];";
+        for(int u=0; u<n; ++u) {
+            comp.auxiliaryFunctions << "    double "+block.tearVariables[u].toString()+" = y["+QString::number(u)+"];";
+        }
+        for(const Expression &assignment : block.assignments) {
+            comp.auxiliaryFunctions << "    double "+assignment.toString()+";";
         }
         comp.auxiliaryFunctions << "    ";
-        for(int e=0; e<systemEquations.size(); ++e) {
-            comp.auxiliaryFunctions << "    res["+QString::number(e)+"] = "+systemEquations[e].toString()+";";
+        for(int e=0; e<block.residuals.size(); ++e) {
+            comp.auxiliaryFunctions << "    res["+QString::number(e)+"] = "+block.residuals[e].toString()+";";
         }
         comp.auxiliaryFunctions << "}";
 
@@ -1213,22 +1442,75 @@ bool HopsanModelicaGenerator::generateComponentObject(ComponentSpecification &co
         comp.auxiliaryFunctions << "//! @param [in] y Array of state variables from previous iteration";
         comp.auxiliaryFunctions << "//! @param [in] f Array of function values (f(y))";
         comp.auxiliaryFunctions << "//! @param [out] J Array of Jacobian elements, stored column-wise";
-        comp.auxiliaryFunctions << "void getJacobian(double *y, double *f, double *J)";
+        comp.auxiliaryFunctions << "void getJacobian"+suffix+"(double *y, double *f, double *J)";
         comp.auxiliaryFunctions << "{";
-        for(int u=0; u<unknowns.size(); ++u) {
-            comp.auxiliaryFunctions << "    double "+unknowns[u].toString()+" = y["+QString::number(u)+"];";
+        for(int u=0; u<n; ++u) {
+            comp.auxiliaryFunctions << "    double "+block.tearVariables[u].toString()+" = y["+QString::number(u)+"];";
         }
         comp.auxiliaryFunctions << "    ";
 
+        for(const QString &temporary : block.jacobianTemporaries) {
+            comp.auxiliaryFunctions << "    double "+temporary+";";
+        }
+
         //Only compute Jacobian elements that are non-zero for best performance
-        for(int i=0; i<jacobian.size(); ++i) {
-            for(int j=0; j<jacobian[i].size(); ++j) {
-                if(jacobian[i][j] != Expression(0)) {
-                    comp.auxiliaryFunctions << QString("    J[%2*%3+%1] = ").arg(i).arg(j).arg(unknowns.size()) + jacobian[i][j].toString() + ";";
+        int nz=0;
+        for(int i=0; i<block.jacobian.size(); ++i) {
+            for(int j=0; j<block.jacobian[i].size(); ++j) {
+                if(block.jacobian[i][j] != Expression(0)) {
+                    comp.auxiliaryFunctions << QString("    J[%2*%3+%1] = ").arg(i).arg(j).arg(n) + block.jacobianElements[nz] + ";";
+                    ++nz;
                 }
             }
         }
         comp.auxiliaryFunctions << "}";
+
+        if(useSparseJacobian[k]) {
+            comp.auxiliaryFunctions << "";
+            comp.auxiliaryFunctions << "//! @brief Returns the non-zero Jacobian elements";
+            comp.auxiliaryFunctions << "//! @param [in] y Array of state variables from previous iteration";
+            comp.auxiliaryFunctions << "//! @param [in] f Array of function values (f(y))";
+            comp.auxiliaryFunctions << "//! @param [out] J Array of non-zero Jacobian elements, stored row-wise in the order of the sparsity pattern";
+            comp.auxiliaryFunctions << "void getSparseJacobian"+suffix+"(double *y, double *f, double *J)";
+            comp.auxiliaryFunctions << "{";
+            for(int u=0; u<n; ++u) {
+                comp.auxiliaryFunctions << "    double "+block.tearVariables[u].toString()+" = y["+QString::number(u)+"];";
+            }
+            comp.auxiliaryFunctions << "    ";
+            for(const QString &temporary : block.jacobianTemporaries) {
+                comp.auxiliaryFunctions << "    double "+temporary+";";
+            }
+            for(int e=0; e<block.jacobianElements.size(); ++e) {
+                comp.auxiliaryFunctions << QString("    J[%1] = ").arg(e) + block.jacobianElements[e] + ";";
+            }
+            comp.auxiliaryFunctions << "}";
+        }
+    }
+
+    //Dispatch the solver callbacks to the active algebraic loop
+    if(nonlinearBlocks.size() > 1) {
+        QStringList functions, arguments;
+        functions << "getResiduals" << "getJacobian" << "getSparseJacobian";
+        arguments << "double *y, double *res" << "double *y, double *f, double *J" << "double *y, double *f, double *J";
+        for(int f=0; f<functions.size(); ++f) {
+            if(functions[f] == "getSparseJacobian" && !useSparseJacobian.contains(true)) {
+                continue;
+            }
+            comp.auxiliaryFunctions << "";
+            comp.auxiliaryFunctions << "void "+functions[f]+"("+arguments[f]+")";
+            comp.auxiliaryFunctions << "{";
+            comp.auxiliaryFunctions << "    switch(mSolverBlock) {";
+            for(int k=0; k<nonlinearBlocks.size(); ++k) {
+                if(functions[f] == "getSparseJacobian" && !useSparseJacobian[k]) {
+                    continue;
+                }
+                comp.auxiliaryFunctions << "    case "+QString::number(k)+":";
+                comp.auxiliaryFunctions << "        "+functions[f]+functionSuffix(k)+"("+QString(arguments[f]).remove("double *")+");";
+                comp.auxiliaryFunctions << "        break;";
+            }
+            comp.auxiliaryFunctions << "    }";
+            comp.auxiliaryFunctions << "}";
+        }
     }
 
     printMessage("Component specification succesfully generated!");
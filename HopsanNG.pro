@@ -1,13 +1,15 @@
 TEMPLATE = subdirs
 
-SUBDIRS = HopsanCore componentLibraries SymHop Ops HopsanGenerator hopsangeneratorgui hopsanremote hopsanhdf5exporter HopsanGUI HopsanCLI UnitTests hopsanc hopsandcp
+SUBDIRS = HopsanCore componentLibraries SymHop Ops HopsanGenerator hopsangeneratorgui hopsanremote hopsanhdf5exporter HopsanGUI HopsanCLI hopsanbenchmark UnitTests hopsanc hopsandcp
 
 componentLibraries.depends = HopsanCore
 hopsandcp.depends = HopsanCore
 HopsanGenerator.depends = HopsanCore SymHop
 HopsanCLI.depends = HopsanCore HopsanGenerator hopsanhdf5exporter Ops
+hopsanbenchmark.depends = HopsanCore
 HopsanGUI.depends = hopsandcp HopsanCore hopsangeneratorgui hopsanhdf5exporter hopsanremote Ops
 hopsanc.depends = HopsanCore
+Ops.depends = HopsanCore
 hopsanhdf5exporter.depends = HopsanCore
 hopsanremote.depends = HopsanCore
 UnitTests.depends = HopsanCore HopsanGenerator componentLibraries
@@ -21,6 +21,13 @@ QMAKE_CXXFLAGS *= -U__STRICT_ANSI__ -Wno-c++0x-compat
 INCLUDEPATH *= $${PWD}/include/
 #--------------------------------------------------
 
+#--------------------------------------------------
+# Add the include path to (HopsanCore)
+INCLUDEPATH *= $${PWD}/../HopsanCore/include/
+LIBS *= -L$${PWD}/../bin -lhopsancore$${DEBUG_EXT}
+DEFINES *= HOPSANCORE_DLLIMPORT
+#--------------------------------------------------
+
 # -------------------------------------------------
 # Non platform specific HopsanCompGen options
 # -------------------------------------------------
@@ -38,6 +45,11 @@ win32 {
     DEFINES += OPS_DLLEXPORT
     DEFINES -= UNICODE
 }
+unix {
+    # Add runtime search path so that hopsancore in the same directory can be found.
+    # Note! QMAKE_LFLAGS_RPATH and QMAKE_RPATHDIR does not seem hande $$ORIGIN, adding manually to LFLAGS
+    QMAKE_LFLAGS *= -Wl,-rpath,\'\$$ORIGIN/./\'
+}
 
 # -------------------------------------------------
 # Project files
@@ -49,6 +61,7 @@ SOURCES += \
     src/OpsWorkerComplexRF.cpp \
     src/OpsWorkerNelderMead.cpp \
     src/OpsEvaluator.cpp \
+    src/OpsEvaluationStatistics.cpp \
     src/OpsWorkerParticleSwarm.cpp \
     src/OpsWorkerComplexRFP.cpp \
     src/OpsWorkerParamterSweep.cpp \
@@ -65,6 +78,7 @@ HEADERS += \
     include/OpsWorkerComplexRF.h \
     include/OpsWorkerNelderMead.h \
     include/OpsEvaluator.h \
+    include/OpsEvaluationStatistics.h \
     include/OpsWorkerParticleSwarm.h \
     include/OpsWorkerComplexRFP.h \
     include/OpsWorkerParameterSweep.h \
@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   OpsEvaluationStatistics.h
+//! @date   2026-10-19
+//!
+//! @brief Contains timing statistics for optimization evaluations
+//!
+//$Id$
+
+#ifndef OPSEVALUATIONSTATISTICS_H
+#define OPSEVALUATIONSTATISTICS_H
+
+#include <vector>
+#include <string>
+#include "OpsWin32DLL.h"
+
+namespace Ops {
+
+//! @brief The parts of one candidate evaluation
+enum EvaluationPhaseT {EvaluationSetup, EvaluationSimulation, EvaluationObjective, NumEvaluationPhases};
+
+//! @brief Timing of one candidate evaluation, in seconds
+class OPS_DLLAPI CandidateTiming
+{
+public:
+    CandidateTiming();
+    double getTotalTime() const;
+
+    size_t mGeneration;                 //!< Index of the generation (batch of candidates) the evaluation belongs to
+    size_t mCandidate;                  //!< Candidate index
+    double mTime[NumEvaluationPhases];  //!< Setting parameters, simulating and computing the objective
+};
+
+//! @brief Timing of one generation, all candidates evaluated by one call to Evaluator::evaluateAllCandidates() or one single evaluation
+class OPS_DLLAPI GenerationTiming
+{
+public:
+    GenerationTiming();
+
+    size_t mNumCandidates;      //!< Number of evaluated candidates
+    double mWallTime;           //!< Wall time of the whole generation
+    double mSimulationTime;     //!< Wall time of the simulation of the generation, candidates may be simulated in parallel
+    double mStragglerWaitTime;  //!< Time the generation waited for its slowest candidate, beyond the mean candidate simulation time
+};
+
+//! @brief Collects timing of optimization evaluations, to find out if an optimization is limited by simulation, objective evaluation, parameter setting or straggling candidates
+//! @details Evaluators record the time of each phase with addCandidate(). Batches of candidates are enclosed in beginGeneration() and endGeneration(),
+//! candidates added outside of a generation are counted as a generation of their own.
+//! @see Evaluator::getStatistics()
+class OPS_DLLAPI EvaluationStatistics
+{
+public:
+    EvaluationStatistics();
+    void clear();
+
+    static double now();
+
+    void beginGeneration();
+    void addCandidate(const size_t candidate, const double setupTime, const double simulationTime, const double objectiveTime);
+    void setGenerationSimulationTime(const double seconds);
+    void endGeneration();
+
+    size_t getNumEvaluations() const;
+    size_t getNumGenerations() const;
+    const std::vector<CandidateTiming> &getCandidateTimings() const;
+    const std::vector<GenerationTiming> &getGenerationTimings() const;
+
+    double getTotalTime(const EvaluationPhaseT phase) const;
+    double getTotalWallTime() const;
+    double getTotalStragglerWaitTime() const;
+    double getEvaluationsPerSecond() const;
+    double getPercentile(const EvaluationPhaseT phase, const double fraction) const;
+
+    std::string toTable() const;
+    std::string toCSV() const;
+    bool writeCSV(const std::string &rFilePath) const;
+
+private:
+    void finishGeneration(GenerationTiming &rGeneration, const size_t firstCandidate);
+
+    std::vector<CandidateTiming> mCandidates;
+    std::vector<GenerationTiming> mGenerations;
+    bool mInGeneration;
+    double mGenerationStart;
+    double mGenerationSimulationTime;
+    size_t mGenerationFirstCandidate;
+};
+
+}
+
+#endif // OPSEVALUATIONSTATISTICS_H
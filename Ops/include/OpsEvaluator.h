@@ -40,6 +40,7 @@
 
 #include "OpsWin32DLL.h"
 #include "matrix.h"
+#include "OpsEvaluationStatistics.h"
 
 namespace Ops {
 
@@ -60,8 +61,11 @@ public:
     bool evaluateAllCandidatesWithSurrogateModel();
     void evaluateCandidateWithSurrogateModel(size_t idx);
 
+    EvaluationStatistics &getStatistics();
+
 protected:
     Worker *mpWorker;
+    EvaluationStatistics mStatistics;
 
 private:
     void updateSurrogateModel();
@@ -0,0 +1,366 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   OpsEvaluationStatistics.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains timing statistics for optimization evaluations
+//!
+//$Id$
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+#include "OpsEvaluationStatistics.h"
+#include "CoreUtilities/StringUtilities.h"
+
+using namespace Ops;
+using hopsan::formatString;
+
+namespace {
+
+const char *phaseNames[NumEvaluationPhases] = {"Setup", "Simulation", "Objective"};
+
+}
+
+CandidateTiming::CandidateTiming()
+{
+    mGeneration = 0;
+    mCandidate = 0;
+    for(size_t p=0; p<NumEvaluationPhases; ++p)
+    {
+        mTime[p] = 0;
+    }
+}
+
+double CandidateTiming::getTotalTime() const
+{
+    return mTime[EvaluationSetup]+mTime[EvaluationSimulation]+mTime[EvaluationObjective];
+}
+
+
+GenerationTiming::GenerationTiming()
+{
+    mNumCandidates = 0;
+    mWallTime = 0;
+    mSimulationTime = 0;
+    mStragglerWaitTime = 0;
+}
+
+
+EvaluationStatistics::EvaluationStatistics()
+{
+    clear();
+}
+
+void EvaluationStatistics::clear()
+{
+    mCandidates.clear();
+    mGenerations.clear();
+    mInGeneration = false;
+    mGenerationStart = 0;
+    mGenerationSimulationTime = -1;
+    mGenerationFirstCandidate = 0;
+}
+
+//! @brief Returns a monotonic time stamp in seconds, use differences between two calls to measure phases
+double EvaluationStatistics::now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//! @brief Begin a generation, call before evaluating a batch of candidates
+void EvaluationStatistics::beginGeneration()
+{
+    if(mInGeneration)
+    {
+        endGeneration();
+    }
+    mInGeneration = true;
+    mGenerationStart = now();
+    mGenerationSimulationTime = -1;
+    mGenerationFirstCandidate = mCandidates.size();
+}
+
+//! @brief Record the evaluation of one candidate
+//! @param [in] candidate The candidate index
+//! @param [in] setupTime Time spent setting parameters
+//! @param [in] simulationTime Time spent initializing and simulating the candidate model
+//! @param [in] objectiveTime Time spent computing the objective function
+void EvaluationStatistics::addCandidate(const size_t candidate, const double setupTime, const double simulationTime, const double objectiveTime)
+{
+    CandidateTiming timing;
+    timing.mGeneration = mGenerations.size();
+    timing.mCandidate = candidate;
+    timing.mTime[EvaluationSetup] = setupTime;
+    timing.mTime[EvaluationSimulation] = simulationTime;
+    timing.mTime[EvaluationObjective] = objectiveTime;
+    mCandidates.push_back(timing);
+
+    if(!mInGeneration)
+    {
+        GenerationTiming generation;
+        generation.mWallTime = timing.getTotalTime();
+        generation.mSimulationTime = simulationTime;
+        finishGeneration(generation, mCandidates.size()-1);
+    }
+}
+
+//! @brief Set the wall time of the simulation of the current generation, when candidates are simulated in parallel
+//! @details If this is not called, the simulation time of the generation is the sum of the candidate simulation times
+void EvaluationStatistics::setGenerationSimulationTime(const double seconds)
+{
+    mGenerationSimulationTime = seconds;
+}
+
+//! @brief End the current generation, call after the objectives of the batch have been computed
+void EvaluationStatistics::endGeneration()
+{
+    if(!mInGeneration)
+    {
+        return;
+    }
+    mInGeneration = false;
+
+    GenerationTiming generation;
+    generation.mWallTime = now()-mGenerationStart;
+    if(mGenerationSimulationTime >= 0)
+    {
+        generation.mSimulationTime = mGenerationSimulationTime;
+    }
+    else
+    {
+        for(size_t i=mGenerationFirstCandidate; i<mCandidates.size(); ++i)
+        {
+            generation.mSimulationTime += mCandidates[i].mTime[EvaluationSimulation];
+        }
+    }
+    finishGeneration(generation, mGenerationFirstCandidate);
+}
+
+size_t EvaluationStatistics::getNumEvaluations() const
+{
+    return mCandidates.size();
+}
+
+size_t EvaluationStatistics::getNumGenerations() const
+{
+    return mGenerations.size();
+}
+
+const std::vector<CandidateTiming> &EvaluationStatistics::getCandidateTimings() const
+{
+    return mCandidates;
+}
+
+const std::vector<GenerationTiming> &EvaluationStatistics::getGenerationTimings() const
+{
+    return mGenerations;
+}
+
+//! @brief Returns the sum of one phase over all candidates
+//! @note When candidates are simulated in parallel the sum of the simulation times is larger than the wall time spent simulating
+double EvaluationStatistics::getTotalTime(const EvaluationPhaseT phase) const
+{
+    double total = 0;
+    for(size_t i=0; i<mCandidates.size(); ++i)
+    {
+        total += mCandidates[i].mTime[phase];
+    }
+    return total;
+}
+
+double EvaluationStatistics::getTotalWallTime() const
+{
+    double total = 0;
+    for(size_t g=0; g<mGenerations.size(); ++g)
+    {
+        total += mGenerations[g].mWallTime;
+    }
+    return total;
+}
+
+double EvaluationStatistics::getTotalStragglerWaitTime() const
+{
+    double total = 0;
+    for(size_t g=0; g<mGenerations.size(); ++g)
+    {
+        total += mGenerations[g].mStragglerWaitTime;
+    }
+    return total;
+}
+
+double EvaluationStatistics::getEvaluationsPerSecond() const
+{
+    const double wallTime = getTotalWallTime();
+    if(wallTime <= 0)
+    {
+        return 0;
+    }
+    return double(mCandidates.size())/wallTime;
+}
+
+//! @brief Returns a percentile of the candidate times of one phase
+//! @param [in] phase The evaluation phase
+//! @param [in] fraction The percentile as a fraction, 0.5 for the median
+double EvaluationStatistics::getPercentile(const EvaluationPhaseT phase, const double fraction) const
+{
+    if(mCandidates.empty())
+    {
+        return 0;
+    }
+    std::vector<double> times(mCandidates.size());
+    for(size_t i=0; i<mCandidates.size(); ++i)
+    {
+        times[i] = mCandidates[i].mTime[phase];
+    }
+    // Nearest rank
+    const double position = std::ceil(fraction*double(times.size()));
+    const size_t rank = (position < 1.0) ? 0 : std::min(times.size(), size_t(position))-1;
+    std::nth_element(times.begin(), times.begin()+rank, times.end());
+    return times[rank];
+}
+
+//! @brief Formats a summary with the wall time breakdown, per-phase latency percentiles and a histogram of the simulation latency
+std::string EvaluationStatistics::toTable() const
+{
+    const double wallTime = getTotalWallTime();
+    double simulationWallTime = 0;
+    for(size_t g=0; g<mGenerations.size(); ++g)
+    {
+        simulationWallTime += mGenerations[g].mSimulationTime;
+    }
+    const double setupTime = getTotalTime(EvaluationSetup);
+    const double objectiveTime = getTotalTime(EvaluationObjective);
+    const double stragglerTime = getTotalStragglerWaitTime();
+    const double otherTime = std::max(0.0, wallTime-setupTime-simulationWallTime-objectiveTime);
+    const double toPercent = (wallTime > 0) ? 100.0/wallTime : 0.0;
+
+    std::string table;
+    table.append(formatString("Optimization evaluations: %zu evaluations in %zu generations, wall time %.3f s, %.2f evaluations/s\n",
+                              mCandidates.size(), mGenerations.size(), wallTime, getEvaluationsPerSecond()));
+    table.append(formatString("%-22s %12s %8s\n", "Wall time", "Total [s]", "Share"));
+    table.append(formatString("%-22s %12.3f %7.1f%%\n", "Setting parameters", setupTime, setupTime*toPercent));
+    table.append(formatString("%-22s %12.3f %7.1f%%\n", "Simulation", simulationWallTime, simulationWallTime*toPercent));
+    table.append(formatString("%-22s %12.3f %7.1f%%\n", "  of which stragglers", stragglerTime, stragglerTime*toPercent));
+    table.append(formatString("%-22s %12.3f %7.1f%%\n", "Objective functions", objectiveTime, objectiveTime*toPercent));
+    table.append(formatString("%-22s %12.3f %7.1f%%\n", "Other", otherTime, otherTime*toPercent));
+
+    table.append(formatString("%-22s %12s %12s %12s %12s\n", "Candidate latency", "Median [ms]", "P90 [ms]", "P99 [ms]", "Max [ms]"));
+    for(size_t p=0; p<NumEvaluationPhases; ++p)
+    {
+        const EvaluationPhaseT phase = EvaluationPhaseT(p);
+        table.append(formatString("%-22s %12.3f %12.3f %12.3f %12.3f\n", phaseNames[p], 1e3*getPercentile(phase, 0.5),
+                                  1e3*getPercentile(phase, 0.9), 1e3*getPercentile(phase, 0.99), 1e3*getPercentile(phase, 1.0)));
+    }
+
+    // Histogram of the simulation latency in power of two buckets of milliseconds
+    std::vector<size_t> buckets;
+    size_t firstBucket = 0;
+    for(size_t i=0; i<mCandidates.size(); ++i)
+    {
+        const double ms = 1e3*mCandidates[i].mTime[EvaluationSimulation];
+        const int b = (ms >= 1.0) ? int(std::floor(std::log2(ms)))+1 : 0;
+        if(size_t(b) >= buckets.size())
+        {
+            buckets.resize(size_t(b)+1, 0);
+        }
+        ++buckets[size_t(b)];
+    }
+    while((firstBucket < buckets.size()) && (buckets[firstBucket] == 0))
+    {
+        ++firstBucket;
+    }
+    if(!buckets.empty())
+    {
+        const size_t maxCount = *std::max_element(buckets.begin(), buckets.end());
+        table.append("Simulation latency histogram\n");
+        for(size_t b=firstBucket; b<buckets.size(); ++b)
+        {
+            const std::string range = (b == 0) ? std::string("< 1 ms") : formatString("%g - %g ms", std::ldexp(1.0, int(b)-1), std::ldexp(1.0, int(b)));
+            table.append(formatString("%22s %8zu ", range.c_str(), buckets[b]));
+            table.append(std::string(size_t(40.0*double(buckets[b])/double(maxCount)+0.5), '#'));
+            table.append("\n");
+        }
+    }
+    return table;
+}
+
+//! @brief Formats the timing of each candidate evaluation as CSV, times in seconds
+std::string EvaluationStatistics::toCSV() const
+{
+    std::string csv("generation,candidate,setup,simulation,objective,total,generation_wall,generation_simulation,generation_straggler_wait\n");
+    for(size_t i=0; i<mCandidates.size(); ++i)
+    {
+        const CandidateTiming &rCandidate = mCandidates[i];
+        GenerationTiming generation;
+        if(rCandidate.mGeneration < mGenerations.size())
+        {
+            generation = mGenerations[rCandidate.mGeneration];
+        }
+        csv.append(formatString("%zu,%zu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g\n", rCandidate.mGeneration, rCandidate.mCandidate,
+                                rCandidate.mTime[EvaluationSetup], rCandidate.mTime[EvaluationSimulation], rCandidate.mTime[EvaluationObjective],
+                                rCandidate.getTotalTime(), generation.mWallTime, generation.mSimulationTime, generation.mStragglerWaitTime));
+    }
+    return csv;
+}
+
+//! @brief Write the CSV to a file
+//! @returns False if the file could not be written
+bool EvaluationStatistics::writeCSV(const std::string &rFilePath) const
+{
+    std::ofstream file(rFilePath.c_str());
+    if(!file.good())
+    {
+        return false;
+    }
+    file << toCSV();
+    return file.good();
+}
+
+//! @brief Computes the straggler wait of a generation and stores it
+//! @param [in,out] rGeneration The generation, wall and simulation times must be set
+//! @param [in] firstCandidate Index of the first candidate of the generation
+void EvaluationStatistics::finishGeneration(GenerationTiming &rGeneration, const size_t firstCandidate)
+{
+    rGeneration.mNumCandidates = mCandidates.size()-firstCandidate;
+    if(rGeneration.mNumCandidates > 1)
+    {
+        double maxTime = 0;
+        double sumTime = 0;
+        for(size_t i=firstCandidate; i<mCandidates.size(); ++i)
+        {
+            maxTime = std::max(maxTime, mCandidates[i].mTime[EvaluationSimulation]);
+            sumTime += mCandidates[i].mTime[EvaluationSimulation];
+        }
+        rGeneration.mStragglerWaitTime = maxTime-sumTime/double(rGeneration.mNumCandidates);
+    }
+    if(rGeneration.mNumCandidates > 0)
+    {
+        mGenerations.push_back(rGeneration);
+    }
+}
@@ -71,6 +71,13 @@ void Evaluator::setWorker(Worker *pWorker)
 }
 
 
+//! @brief Returns the timing statistics of the evaluations, recorded by evaluator implementations
+EvaluationStatistics &Evaluator::getStatistics()
+{
+    return mStatistics;
+}
+
+
 
 void Evaluator::evaluateAllPoints()
 {
@@ -121,10 +128,12 @@ void Evaluator::evaluateCandidate(size_t idx)
 
 void Evaluator::evaluateAllCandidates()
 {
+    mStatistics.beginGeneration();
     for(size_t i=0; i<mpWorker->mNumCandidates && !mpWorker->aborted(); ++i)
     {
         evaluateCandidate(i);
     }
+    mStatistics.endGeneration();
 }
 
 
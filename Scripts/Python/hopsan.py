@@ -56,3 +56,132 @@ class hopsan:
         import ctypes
         self.hdll.setNumberOfLogSamples.argtypes = [ctypes.c_int]
         self.hdll.setNumberOfLogSamples(value)
+
+    def loadModelInstance(self, path):
+        # Returns an independent model instance, see hopsanmodel
+        return hopsanmodel(self.hdll, path)
+
+    def openResultFile(self, path):
+        self.hdll.openResultFile(path.encode())
+
+    def closeResultFile(self):
+        self.hdll.closeResultFile()
+
+    def getResultFileData(self, name):
+        import ctypes
+        data = ctypes.POINTER(ctypes.c_double)()
+        time = ctypes.POINTER(ctypes.c_double)()
+        samples = ctypes.c_size_t()
+        self.hdll.getResultFileDataPtr(name.encode(), ctypes.byref(data), ctypes.byref(time), ctypes.byref(samples))
+        # Note! The returned arrays point into the mapped file and are only valid until the result file is closed
+        if samples.value == 0:
+            return (None, None)
+        arrayType = ctypes.c_double * samples.value
+        t = arrayType.from_address(ctypes.addressof(time.contents)) if time else None
+        x = arrayType.from_address(ctypes.addressof(data.contents))
+        return (t, x)
+
+
+class hopsanmodel:
+    # An independent model instance, several instances can be simulated concurrently from different threads
+    def __init__(self, hdll, path):
+        import ctypes
+        self.hdll = hdll
+        self.hdll.modelLoad.restype = ctypes.c_void_p
+        self.hdll.modelFree.argtypes = [ctypes.c_void_p]
+        self.hdll.modelGetNumberOfLogSamples.restype = ctypes.c_size_t
+        self.hdll.modelGetNumberOfLogSamples.argtypes = [ctypes.c_void_p]
+        self.hdll.modelGetTime.restype = ctypes.c_double
+        self.hdll.modelGetTime.argtypes = [ctypes.c_void_p]
+        self.hdll.modelGetTimeVectorPtr.restype = ctypes.POINTER(ctypes.c_double)
+        self.hdll.modelGetTimeVectorPtr.argtypes = [ctypes.c_void_p]
+        self.hdll.modelGetDataVectorPtr.restype = ctypes.POINTER(ctypes.c_double)
+        self.hdll.modelGetDataVectorPtr.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        self.hdll.modelSimulateTo.argtypes = [ctypes.c_void_p, ctypes.c_double]
+        self.hdll.modelSetParameterDouble.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_double]
+        self.hdll.modelSetStartTime.argtypes = [ctypes.c_void_p, ctypes.c_double]
+        self.hdll.modelSetTimeStep.argtypes = [ctypes.c_void_p, ctypes.c_double]
+        self.hdll.modelSetStopTime.argtypes = [ctypes.c_void_p, ctypes.c_double]
+        self.handle = self.hdll.modelLoad(path.encode())
+
+    def __del__(self):
+        if self.handle:
+            self.hdll.modelFree(self.handle)
+            self.handle = None
+
+    def getMessages(self):
+        import ctypes
+        msgs = []
+        buf = ctypes.create_string_buffer(1024)
+        while self.hdll.modelGetMessage(ctypes.c_void_p(self.handle), buf, ctypes.c_size_t(len(buf))) == 0:
+            msgs.append(buf.value.decode())
+        return msgs
+
+    def setParameter(self, name, value):
+        import ctypes
+        if isinstance(value, str):
+            return self.hdll.modelSetParameter(ctypes.c_void_p(self.handle), name.encode(), value.encode())
+        return self.hdll.modelSetParameterDouble(self.handle, name.encode(), value)
+
+    def setStartTime(self, value):
+        self.hdll.modelSetStartTime(self.handle, value)
+
+    def setTimeStep(self, value):
+        self.hdll.modelSetTimeStep(self.handle, value)
+
+    def setStopTime(self, value):
+        self.hdll.modelSetStopTime(self.handle, value)
+
+    def simulate(self):
+        import ctypes
+        return self.hdll.modelSimulate(ctypes.c_void_p(self.handle))
+
+    def initialize(self):
+        import ctypes
+        return self.hdll.modelInitialize(ctypes.c_void_p(self.handle))
+
+    def simulateTo(self, time):
+        return self.hdll.modelSimulateTo(self.handle, time)
+
+    def finalize(self):
+        import ctypes
+        return self.hdll.modelFinalize(ctypes.c_void_p(self.handle))
+
+    def getTime(self):
+        return self.hdll.modelGetTime(self.handle)
+
+    def getValues(self, names):
+        import ctypes
+        n = len(names)
+        cnames = (ctypes.c_char_p * n)(*[name.encode() for name in names])
+        values = (ctypes.c_double * n)()
+        self.hdll.modelGetValues(ctypes.c_void_p(self.handle), cnames, values, ctypes.c_size_t(n))
+        return list(values)
+
+    def setValues(self, names, values):
+        import ctypes
+        n = len(names)
+        cnames = (ctypes.c_char_p * n)(*[name.encode() for name in names])
+        cvalues = (ctypes.c_double * n)(*values)
+        return self.hdll.modelSetValues(ctypes.c_void_p(self.handle), cnames, cvalues, ctypes.c_size_t(n))
+
+    def getTimeVector(self):
+        # Note! The returned array points into the model and is only valid until the model is initialized again
+        samples = self.hdll.modelGetNumberOfLogSamples(self.handle)
+        ptr = self.hdll.modelGetTimeVectorPtr(self.handle)
+        if samples == 0 or not ptr:
+            return None
+        import ctypes
+        arrayType = ctypes.c_double * samples
+        return arrayType.from_address(ctypes.addressof(ptr.contents))
+
+    def getDataVector(self, name):
+        # Note! The returned array points into the model and is only valid until the model is simulated again
+        samples = self.hdll.modelGetNumberOfLogSamples(self.handle)
+        ptr = self.hdll.modelGetDataVectorPtr(self.handle, name.encode())
+        if samples == 0 or not ptr:
+            return None
+        import ctypes
+        arrayType = ctypes.c_double * samples
+        return arrayType.from_address(ctypes.addressof(ptr.contents))
+
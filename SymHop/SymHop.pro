@@ -42,7 +42,11 @@ win32 {
 # Project files
 # -------------------------------------------------
 
-SOURCES += src/SymHop.cpp
+SOURCES += src/SymHop.cpp \
+    src/ExpressionDag.cpp \
+    src/CompiledExpression.cpp
 
 HEADERS += include/SymHop.h \
+    include/ExpressionDag.h \
+    include/CompiledExpression.h \
     include/symhop_win32dll.h
@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   CompiledExpression.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a compiled form of SymHop expressions, for fast repeated and element-wise evaluation
+//!
+//$Id$
+
+#ifndef COMPILEDEXPRESSION_H
+#define COMPILEDEXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "SymHop.h"
+#include "symhop_win32dll.h"
+
+namespace SymHop {
+
+//! @brief An expression compiled to a flat list of instructions, where variables are resolved to slots
+//! @details Common subexpressions are only evaluated once. Variables are given as an array in the order of getVariables().
+//! Element-wise evaluation processes the instructions over blocks of elements, so that each instruction is a tight loop
+//! over contiguous data that the compiler can vectorize.
+class SYMHOP_DLLAPI CompiledExpression
+{
+public:
+    CompiledExpression();
+    CompiledExpression(const Expression &expr);
+
+    bool compile(const Expression &expr);
+    bool isValid() const;
+    const QStringList &getVariables() const;
+
+    double evaluate(const double *pValues) const;
+    void evaluate(const double *const *pValues, const bool *pIsVector, double *pResult, const int n) const;
+
+private:
+    enum OperatorT {Constant, Variable, Add, Multiply, Divide, Negate, Power, Square, Sqrt,
+                    Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, Log, Exp, Abs, Integer, Floor, Ceil, Round, Sign,
+                    Min, Max, Mod, Atan2, Equal, NotEqual, LogicalOr, LogicalAnd, GreaterThan, GreaterThanOrEqual,
+                    SmallerThan, SmallerThanOrEqual, Limit};
+
+    struct Instruction
+    {
+        OperatorT op;
+        int result;
+        int args[3];
+        double constant;
+    };
+
+    int addInstruction(const OperatorT op, const int arg0=-1, const int arg1=-1, const int arg2=-1, const double constant=0);
+    void allocateRegisters();
+    void execute(const double *const *pValues, const bool *pIsVector, double *pResult, const int start, const int n,
+                 double *pRegisters, const int stride) const;
+
+    QVector<Instruction> mInstructions;
+    QStringList mVariables;
+    int mNumRegisters;
+    bool mIsValid;
+};
+
+}
+
+#endif // COMPILEDEXPRESSION_H
@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   ExpressionDag.h
+//! @date   2026-10-19
+//!
+//! @brief Contains a hash-consed expression graph for SymHop, with memoized derivatives and common subexpression elimination
+//!
+//$Id$
+
+#ifndef EXPRESSIONDAG_H
+#define EXPRESSIONDAG_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include "SymHop.h"
+#include "symhop_win32dll.h"
+
+namespace SymHop {
+
+//! @brief A directed acyclic graph of expression nodes, where each distinct subexpression is stored only once
+//! @details Nodes are hash-consed, so two structurally equal subexpressions (also with terms or factors in different order)
+//! get the same node id. Nodes are owned by the graph and are never removed, so ids stay valid during the lifetime of the
+//! graph. Children always have lower ids than their parents, so ascending id order is a valid evaluation order.
+//! Derivatives are computed on the graph and memoized for each node and variable, so shared subexpressions are only
+//! differentiated once.
+class SYMHOP_DLLAPI ExpressionDag
+{
+public:
+    enum NodeTypeT {Number, Symbol, Sum, Product, Power, Function, Equation, Opaque};
+
+    ExpressionDag();
+
+    int fromExpression(const Expression &expr);
+    Expression toExpression(const int node) const;
+    Expression toExpression(const int node, const QMap<int, QString> &temporaries) const;
+
+    int derivative(const int node, const QString &variable, bool &ok);
+    Expression derivative(const Expression &expr, const Expression &variable, bool &ok);
+
+    QList<int> findCommonSubexpressions(const QList<int> &roots) const;
+    QStringList eliminateCommonSubexpressions(const QList<int> &roots, const QString &prefix, QStringList &rRootStrings) const;
+
+    NodeTypeT getType(const int node) const;
+    QString getName(const int node) const;
+    double getValue(const int node) const;
+    QList<int> getOperands(const int node) const;
+    QList<int> getDivisors(const int node) const;
+    int getNumNodes() const;
+
+private:
+    struct Node
+    {
+        NodeTypeT type;
+        QString name;               //Symbol name, function name or number string
+        double value;               //Used for numbers
+        QList<int> operands;        //Terms, factors, arguments, base and power, or left and right side
+        QList<int> divisors;        //Used for products
+        Expression opaque;          //Used for expressions that can not be represented by the graph
+    };
+
+    int addNode(const Node &node);
+    int makeNumber(const double value);
+    int makeSymbol(const QString &name);
+    int makeSum(QList<int> terms);
+    int makeProduct(QList<int> factors, QList<int> divisors=QList<int>());
+    int makePower(const int base, const int power);
+    int makeFunction(const QString &name, const QList<int> &arguments);
+    int makeEquation(const int left, const int right);
+    int makeOpaque(const Expression &expr);
+
+    bool isZero(const int node) const;
+    bool isOne(const int node) const;
+    Expression toExpression(const int node, const QMap<int, QString> &temporaries, const bool isRoot) const;
+
+    QList<Node> mNodes;
+    QHash<QString, int> mUniqueTable;
+    QMap<QString, QHash<int, int> > mDerivatives;
+    int mZero;
+    int mOne;
+    int mMinusOne;
+};
+
+}
+
+#endif // EXPRESSIONDAG_H
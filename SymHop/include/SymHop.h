@@ -200,6 +200,9 @@ QStringList SYMHOP_DLLAPI getCustomFunctionList();
 
 bool SYMHOP_DLLAPI findPath(QList<int> &order, QList<QList<int> > dependencies, int level=0, QList<int> preferredPath=QList<int>());
 bool SYMHOP_DLLAPI sortEquationSystem(QList<Expression> &equations, QList<QList<Expression> > &jacobian, QList<Expression> stateVars, QList<int> &limitedVariableEquations, QList<int> &limitedDerivativeEquations, QList<int> preferredOrder);
+bool SYMHOP_DLLAPI findMatching(const QList<QList<int> > &dependencies, const int numVariables, QList<int> &matching);
+void SYMHOP_DLLAPI findBlockLowerTriangularForm(const QList<QList<int> > &dependencies, const QList<int> &matching, QList<QList<int> > &blocks);
+void SYMHOP_DLLAPI tearBlock(const QList<QList<int> > &dependencies, const QList<int> &matching, const QList<int> &block, const QList<int> &solvableEquations, QList<int> &residualEquations, QList<int> &explicitEquations);
 void SYMHOP_DLLAPI removeDuplicates(QList<Expression> &rSet);
 
 bool SYMHOP_DLLAPI isWhole(const double value);
@@ -0,0 +1,552 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   CompiledExpression.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a compiled form of SymHop expressions, for fast repeated and element-wise evaluation
+//!
+//$Id$
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "CompiledExpression.h"
+#include "ExpressionDag.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace SymHop;
+
+namespace {
+
+//! @brief Number of elements that are evaluated per instruction in element-wise evaluation, chosen so that the registers fit in cache
+const int BlockSize = 256;
+
+template <typename FuncT>
+inline void applyUnary(double *pResult, const double *pA, const int n, FuncT func)
+{
+    for(int i=0; i<n; ++i)
+    {
+        pResult[i] = func(pA[i]);
+    }
+}
+
+template <typename FuncT>
+inline void applyBinary(double *pResult, const double *pA, const double *pB, const int n, FuncT func)
+{
+    for(int i=0; i<n; ++i)
+    {
+        pResult[i] = func(pA[i], pB[i]);
+    }
+}
+
+}
+
+
+//! @class SymHop::CompiledExpression
+//! @brief Creates an invalid compiled expression
+CompiledExpression::CompiledExpression()
+{
+    mNumRegisters = 0;
+    mIsValid = false;
+}
+
+
+//! @brief Compiles an expression, use isValid() to check the result
+CompiledExpression::CompiledExpression(const Expression &expr)
+{
+    compile(expr);
+}
+
+
+//! @brief Compiles an expression
+//! @details Supports the same operators and built-in functions as Expression::evaluate(), but not external functions.
+//! @param expr Expression to compile
+//! @returns False if the expression contains something that can not be compiled
+bool CompiledExpression::compile(const Expression &expr)
+{
+    mInstructions.clear();
+    mVariables.clear();
+    mNumRegisters = 0;
+    mIsValid = false;
+
+    //Equal subexpressions share nodes in the graph, so they are only evaluated once
+    ExpressionDag dag;
+    const int root = dag.fromExpression(expr);
+
+    //Find the nodes that the root depends on, children have lower ids than their parents
+    QVector<bool> used(root+1, false);
+    used[root] = true;
+    for(int node=root; node>=0; --node)
+    {
+        if(used[node])
+        {
+            for(int child : dag.getOperands(node) + dag.getDivisors(node))
+            {
+                used[child] = true;
+            }
+        }
+    }
+
+    QVector<int> values(root+1, -1);
+    for(int node=0; node<=root; ++node)
+    {
+        if(!used[node])
+        {
+            continue;
+        }
+
+        QList<int> args;
+        for(int child : dag.getOperands(node))
+        {
+            args.append(values[child]);
+        }
+
+        switch(dag.getType(node))
+        {
+        case ExpressionDag::Number:
+            values[node] = addInstruction(Constant, -1, -1, -1, dag.getValue(node));
+            break;
+        case ExpressionDag::Symbol:
+            if(!mVariables.contains(dag.getName(node)))
+            {
+                mVariables.append(dag.getName(node));
+            }
+            values[node] = addInstruction(Variable, mVariables.indexOf(dag.getName(node)));
+            break;
+        case ExpressionDag::Sum:
+        {
+            int sum = args[0];
+            for(int i=1; i<args.size(); ++i)
+            {
+                sum = addInstruction(Add, sum, args[i]);
+            }
+            values[node] = sum;
+            break;
+        }
+        case ExpressionDag::Product:
+        {
+            int product = args[0];
+            for(int i=1; i<args.size(); ++i)
+            {
+                product = addInstruction(Multiply, product, args[i]);
+            }
+            for(int divisor : dag.getDivisors(node))
+            {
+                product = addInstruction(Divide, product, values[divisor]);
+            }
+            values[node] = product;
+            break;
+        }
+        case ExpressionDag::Power:
+        {
+            const int power = dag.getOperands(node)[1];
+            if(dag.getType(power) == ExpressionDag::Number && dag.getValue(power) == 2)
+            {
+                values[node] = addInstruction(Square, args[0]);
+            }
+            else if(dag.getType(power) == ExpressionDag::Number && dag.getValue(power) == 0.5)
+            {
+                values[node] = addInstruction(Sqrt, args[0]);
+            }
+            else
+            {
+                values[node] = addInstruction(Power, args[0], args[1]);
+            }
+            break;
+        }
+        case ExpressionDag::Function:
+        {
+            QString func = dag.getName(node);
+            const bool negative = func.startsWith('-');
+            if(negative)
+            {
+                func = func.right(func.size()-1);
+            }
+
+            int value = -1;
+            if(args.size() == 0)
+            {
+                if(func == "pi") { value = addInstruction(Constant, -1, -1, -1, M_PI); }
+            }
+            else if(func == "der") { value = addInstruction(Constant, -1, -1, -1, 0); }
+            else if(args.size() == 1)
+            {
+                if(func == "sin") { value = addInstruction(Sin, args[0]); }
+                else if(func == "cos") { value = addInstruction(Cos, args[0]); }
+                else if(func == "tan") { value = addInstruction(Tan, args[0]); }
+                else if(func == "asin") { value = addInstruction(Asin, args[0]); }
+                else if(func == "acos") { value = addInstruction(Acos, args[0]); }
+                else if(func == "atan") { value = addInstruction(Atan, args[0]); }
+                else if(func == "sinh") { value = addInstruction(Sinh, args[0]); }
+                else if(func == "cosh") { value = addInstruction(Cosh, args[0]); }
+                else if(func == "tanh") { value = addInstruction(Tanh, args[0]); }
+                else if(func == "log") { value = addInstruction(Log, args[0]); }
+                else if(func == "exp") { value = addInstruction(Exp, args[0]); }
+                else if(func == "sqrt") { value = addInstruction(Sqrt, args[0]); }
+                else if(func == "abs") { value = addInstruction(Abs, args[0]); }
+                else if(func == "integer") { value = addInstruction(Integer, args[0]); }
+                else if(func == "floor") { value = addInstruction(Floor, args[0]); }
+                else if(func == "ceil") { value = addInstruction(Ceil, args[0]); }
+                else if(func == "round") { value = addInstruction(Round, args[0]); }
+                else if(func == "sign") { value = addInstruction(Sign, args[0]); }
+                else if(func == "r2d") { value = addInstruction(Multiply, args[0], addInstruction(Constant, -1, -1, -1, 180.0/M_PI)); }
+                else if(func == "d2r") { value = addInstruction(Multiply, args[0], addInstruction(Constant, -1, -1, -1, M_PI/180.0)); }
+            }
+            else if(args.size() == 2)
+            {
+                if(func == "min") { value = addInstruction(Min, args[0], args[1]); }
+                else if(func == "max") { value = addInstruction(Max, args[0], args[1]); }
+                else if(func == "rem" || func == "mod") { value = addInstruction(Mod, args[0], args[1]); }
+                else if(func == "div") { value = addInstruction(Divide, args[0], args[1]); }
+                else if(func == "atan2") { value = addInstruction(Atan2, args[0], args[1]); }
+                else if(func == "pow") { value = addInstruction(Power, args[0], args[1]); }
+                else if(func == "equal" || func == "eq") { value = addInstruction(Equal, args[0], args[1]); }
+                else if(func == "notEqual") { value = addInstruction(NotEqual, args[0], args[1]); }
+                else if(func == "logicalOr") { value = addInstruction(LogicalOr, args[0], args[1]); }
+                else if(func == "logicalAnd") { value = addInstruction(LogicalAnd, args[0], args[1]); }
+                else if(func == "greaterThan") { value = addInstruction(GreaterThan, args[0], args[1]); }
+                else if(func == "greaterThanOrEqual") { value = addInstruction(GreaterThanOrEqual, args[0], args[1]); }
+                else if(func == "smallerThan") { value = addInstruction(SmallerThan, args[0], args[1]); }
+                else if(func == "smallerThanOrEqual") { value = addInstruction(SmallerThanOrEqual, args[0], args[1]); }
+            }
+            else if(args.size() == 3 && func == "limit")
+            {
+                value = addInstruction(Limit, args[0], args[1], args[2]);
+            }
+
+            if(value < 0)
+            {
+                //Unknown or external function
+                mInstructions.clear();
+                mVariables.clear();
+                return false;
+            }
+            values[node] = negative ? addInstruction(Negate, value) : value;
+            break;
+        }
+        case ExpressionDag::Equation:
+            values[node] = addInstruction(Equal, args[0], args[1]);
+            break;
+        default:
+            mInstructions.clear();
+            mVariables.clear();
+            return false;
+        }
+    }
+
+    allocateRegisters();
+    mIsValid = true;
+    return true;
+}
+
+
+//! @brief Tells whether or not the expression was successfully compiled
+bool CompiledExpression::isValid() const
+{
+    return mIsValid;
+}
+
+
+//! @brief Returns the names of the variables, in the order they shall be given to evaluate()
+const QStringList &CompiledExpression::getVariables() const
+{
+    return mVariables;
+}
+
+
+//! @brief Evaluates the expression for one set of variable values
+//! @param pValues Array of variable values, in the order of getVariables()
+double CompiledExpression::evaluate(const double *pValues) const
+{
+    if(!mIsValid)
+    {
+        return 0;
+    }
+
+    QVector<const double*> pointers(mVariables.size());
+    QVector<bool> isVector(mVariables.size(), true);
+    for(int v=0; v<mVariables.size(); ++v)
+    {
+        pointers[v] = pValues+v;
+    }
+    std::vector<double> registers(mNumRegisters);
+    double result = 0;
+    execute(pointers.data(), isVector.data(), &result, 0, 1, registers.data(), 1);
+    return result;
+}
+
+
+//! @brief Evaluates the expression element-wise
+//! @param pValues Array of pointers to the variable data, in the order of getVariables()
+//! @param pIsVector Tells for each variable if it is a vector with n elements or a scalar
+//! @param pResult Array where the n results are stored
+//! @param n Number of elements
+void CompiledExpression::evaluate(const double *const *pValues, const bool *pIsVector, double *pResult, const int n) const
+{
+    if(!mIsValid)
+    {
+        return;
+    }
+
+    std::vector<double> registers(size_t(mNumRegisters)*BlockSize);
+    for(int start=0; start<n; start+=BlockSize)
+    {
+        execute(pValues, pIsVector, pResult+start, start, std::min(BlockSize, n-start), registers.data(), BlockSize);
+    }
+}
+
+
+//! @brief Appends an instruction
+//! @returns Index of the instruction, used as argument to following instructions
+int CompiledExpression::addInstruction(const OperatorT op, const int arg0, const int arg1, const int arg2, const double constant)
+{
+    Instruction instruction;
+    instruction.op = op;
+    instruction.result = -1;
+    instruction.args[0] = arg0;
+    instruction.args[1] = arg1;
+    instruction.args[2] = arg2;
+    instruction.constant = constant;
+    mInstructions.append(instruction);
+    return mInstructions.size()-1;
+}
+
+
+//! @brief Assigns registers to the instruction results and arguments, registers are reused when a value is no longer needed
+void CompiledExpression::allocateRegisters()
+{
+    const int numInstructions = mInstructions.size();
+    QVector<int> lastUse(numInstructions, -1);
+    for(int i=0; i<numInstructions; ++i)
+    {
+        if(mInstructions[i].op == Variable) continue;
+        for(int a=0; a<3; ++a)
+        {
+            if(mInstructions[i].args[a] >= 0)
+            {
+                lastUse[mInstructions[i].args[a]] = i;
+            }
+        }
+    }
+    lastUse[numInstructions-1] = numInstructions;
+
+    QVector<int> freeRegisters;
+    mNumRegisters = 0;
+    for(int i=0; i<numInstructions; ++i)
+    {
+        Instruction &rInstruction = mInstructions[i];
+        if(rInstruction.op != Variable)
+        {
+            for(int a=0; a<3; ++a)
+            {
+                const int arg = rInstruction.args[a];
+                if(arg >= 0)
+                {
+                    rInstruction.args[a] = mInstructions[arg].result;
+                    //Element-wise operations can write to one of their arguments, so the register can be reused at once
+                    if(lastUse[arg] == i && !freeRegisters.contains(rInstruction.args[a]))
+                    {
+                        freeRegisters.append(rInstruction.args[a]);
+                    }
+                }
+            }
+        }
+
+        if(freeRegisters.isEmpty())
+        {
+            rInstruction.result = mNumRegisters++;
+        }
+        else
+        {
+            rInstruction.result = freeRegisters.takeLast();
+        }
+    }
+}
+
+
+//! @brief Executes the instructions for a block of elements
+//! @param pValues Array of pointers to the variable data
+//! @param pIsVector Tells for each variable if it is a vector or a scalar
+//! @param pResult Array where the results of the block are stored
+//! @param start Index of the first element in the block
+//! @param n Number of elements in the block
+//! @param pRegisters Register memory
+//! @param stride Number of elements per register
+void CompiledExpression::execute(const double *const *pValues, const bool *pIsVector, double *pResult, const int start, const int n, double *pRegisters, const int stride) const
+{
+    for(const Instruction &rInstruction : mInstructions)
+    {
+        double *r = pRegisters + rInstruction.result*stride;
+        const double *a = pRegisters + std::max(rInstruction.args[0], 0)*stride;
+        const double *b = pRegisters + std::max(rInstruction.args[1], 0)*stride;
+        const double *c = pRegisters + std::max(rInstruction.args[2], 0)*stride;
+
+        switch(rInstruction.op)
+        {
+        case Constant:
+            for(int i=0; i<n; ++i) { r[i] = rInstruction.constant; }
+            break;
+        case Variable:
+        {
+            const int v = rInstruction.args[0];
+            if(pIsVector[v])
+            {
+                const double *pData = pValues[v]+start;
+                for(int i=0; i<n; ++i) { r[i] = pData[i]; }
+            }
+            else
+            {
+                const double value = pValues[v][0];
+                for(int i=0; i<n; ++i) { r[i] = value; }
+            }
+            break;
+        }
+        case Add:
+            for(int i=0; i<n; ++i) { r[i] = a[i]+b[i]; }
+            break;
+        case Multiply:
+            for(int i=0; i<n; ++i) { r[i] = a[i]*b[i]; }
+            break;
+        case Divide:
+            for(int i=0; i<n; ++i) { r[i] = a[i]/b[i]; }
+            break;
+        case Negate:
+            for(int i=0; i<n; ++i) { r[i] = -a[i]; }
+            break;
+        case Square:
+            for(int i=0; i<n; ++i) { r[i] = a[i]*a[i]; }
+            break;
+        case Power:
+            applyBinary(r, a, b, n, [](double x, double y) { return pow(x, y); });
+            break;
+        case Sqrt:
+            applyUnary(r, a, n, [](double x) { return sqrt(x); });
+            break;
+        case Sin:
+            applyUnary(r, a, n, [](double x) { return sin(x); });
+            break;
+        case Cos:
+            applyUnary(r, a, n, [](double x) { return cos(x); });
+            break;
+        case Tan:
+            applyUnary(r, a, n, [](double x) { return tan(x); });
+            break;
+        case Asin:
+            applyUnary(r, a, n, [](double x) { return asin(x); });
+            break;
+        case Acos:
+            applyUnary(r, a, n, [](double x) { return acos(x); });
+            break;
+        case Atan:
+            applyUnary(r, a, n, [](double x) { return atan(x); });
+            break;
+        case Sinh:
+            applyUnary(r, a, n, [](double x) { return sinh(x); });
+            break;
+        case Cosh:
+            applyUnary(r, a, n, [](double x) { return cosh(x); });
+            break;
+        case Tanh:
+            applyUnary(r, a, n, [](double x) { return tanh(x); });
+            break;
+        case Log:
+            applyUnary(r, a, n, [](double x) { return log(x); });
+            break;
+        case Exp:
+            applyUnary(r, a, n, [](double x) { return exp(x); });
+            break;
+        case Abs:
+            applyUnary(r, a, n, [](double x) { return fabs(x); });
+            break;
+        case Integer:
+            applyUnary(r, a, n, [](double x) { return double(int(x)); });
+            break;
+        case Floor:
+            applyUnary(r, a, n, [](double x) { return floor(x); });
+            break;
+        case Ceil:
+            applyUnary(r, a, n, [](double x) { return ceil(x); });
+            break;
+        case Round:
+            applyUnary(r, a, n, [](double x) { return round(x); });
+            break;
+        case Sign:
+            applyUnary(r, a, n, [](double x) { return (x >= 0.0) ? 1.0 : -1.0; });
+            break;
+        case Min:
+            applyBinary(r, a, b, n, [](double x, double y) { return fmin(x, y); });
+            break;
+        case Max:
+            applyBinary(r, a, b, n, [](double x, double y) { return fmax(x, y); });
+            break;
+        case Mod:
+            applyBinary(r, a, b, n, [](double x, double y) { return fmod(x, y); });
+            break;
+        case Atan2:
+            applyBinary(r, a, b, n, [](double x, double y) { return atan2(x, y); });
+            break;
+        case Equal:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x == y) ? 1.0 : 0.0; });
+            break;
+        case NotEqual:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x == y) ? 0.0 : 1.0; });
+            break;
+        case LogicalOr:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x != 0.0 || y != 0.0) ? 1.0 : 0.0; });
+            break;
+        case LogicalAnd:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x != 0.0 && y != 0.0) ? 1.0 : 0.0; });
+            break;
+        case GreaterThan:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x > y) ? 1.0 : 0.0; });
+            break;
+        case GreaterThanOrEqual:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x >= y) ? 1.0 : 0.0; });
+            break;
+        case SmallerThan:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x < y) ? 1.0 : 0.0; });
+            break;
+        case SmallerThanOrEqual:
+            applyBinary(r, a, b, n, [](double x, double y) { return (x <= y) ? 1.0 : 0.0; });
+            break;
+        case Limit:
+            for(int i=0; i<n; ++i)
+            {
+                r[i] = (a[i] > c[i]) ? c[i] : ((a[i] < b[i]) ? b[i] : a[i]);
+            }
+            break;
+        }
+    }
+
+    const double *pLast = pRegisters + mInstructions.last().result*stride;
+    for(int i=0; i<n; ++i)
+    {
+        pResult[i] = pLast[i];
+    }
+}
@@ -0,0 +1,718 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   ExpressionDag.cpp
+//! @date   2026-10-19
+//!
+//! @brief Contains a hash-consed expression graph for SymHop, with memoized derivatives and common subexpression elimination
+//!
+//$Id$
+
+#include <algorithm>
+#include "ExpressionDag.h"
+
+using namespace SymHop;
+
+namespace {
+
+//! @brief Returns the node ids as a string, used in hash keys
+QString idsToString(const QList<int> &ids)
+{
+    QString ret;
+    for(int i=0; i<ids.size(); ++i)
+    {
+        ret.append(QString::number(ids.at(i)));
+        ret.append(',');
+    }
+    return ret;
+}
+
+//! @brief Tells whether a function has zero derivative, see Expression::derivative()
+bool hasZeroDerivative(const QString &func)
+{
+    return (func == "greaterThan" || func == "smallerThan" || func == "greaterThanOrEqual" || func == "smallerThanOrEqual" ||
+            func == "notEqual" || func == "equal" || func == "mod" || func == "rem" || func == "sign" || func == "re" ||
+            func == "ceil" || func == "floor" || func == "int" || func == "dxLimit" || func == "dxLimit3" ||
+            func.startsWith("mDelay") || (func.startsWith("delay_") && func.contains(".getIdx")));
+}
+
+//! @brief Tells whether a function is differentiated with the plain chain rule, see Expression::derivative()
+bool usesChainRule(const QString &func)
+{
+    return (!getFunctionDerivative(func).isEmpty() && func != "tan" && func != "atan" && func != "atan2" && func != "asin" &&
+            func != "acos" && func != "sqrt" && func != "pow" && func != "max" && func != "ifElse" && func != "log" && func != "exp");
+}
+
+}
+
+
+//! @class SymHop::ExpressionDag
+ExpressionDag::ExpressionDag()
+{
+    mZero = makeNumber(0);
+    mOne = makeNumber(1);
+    mMinusOne = makeNumber(-1);
+}
+
+
+//! @brief Adds a node to the graph, or returns the id of an existing equal node
+int ExpressionDag::addNode(const Node &node)
+{
+    QString key = QString::number(int(node.type))+":"+node.name+"("+idsToString(node.operands)+"/"+idsToString(node.divisors)+")";
+    if(node.type == Opaque)
+    {
+        key.append(node.opaque.toString());
+    }
+    const int existing = mUniqueTable.value(key, -1);
+    if(existing >= 0)
+    {
+        return existing;
+    }
+    mNodes.append(node);
+    mUniqueTable.insert(key, mNodes.size()-1);
+    return mNodes.size()-1;
+}
+
+
+int ExpressionDag::makeNumber(const double value)
+{
+    Node node;
+    node.type = Number;
+    node.value = (value == 0) ? 0 : value;  //Avoid negative zero
+    node.name = QString::number(node.value, 'g', 17);
+    return addNode(node);
+}
+
+
+int ExpressionDag::makeSymbol(const QString &name)
+{
+    Node node;
+    node.type = Symbol;
+    node.value = 0;
+    node.name = name;
+    return addNode(node);
+}
+
+
+//! @brief Creates a sum node, removes zero terms and adds numerical terms
+int ExpressionDag::makeSum(QList<int> terms)
+{
+    double constant = 0;
+    QList<int> symbolic;
+    for(int i=0; i<terms.size(); ++i)
+    {
+        if(mNodes.at(terms.at(i)).type == Number)
+        {
+            constant += mNodes.at(terms.at(i)).value;
+        }
+        else
+        {
+            symbolic.append(terms.at(i));
+        }
+    }
+    if(constant != 0)
+    {
+        symbolic.append(makeNumber(constant));
+    }
+
+    if(symbolic.isEmpty())
+    {
+        return mZero;
+    }
+    if(symbolic.size() == 1)
+    {
+        return symbolic.first();
+    }
+    std::sort(symbolic.begin(), symbolic.end());
+
+    Node node;
+    node.type = Sum;
+    node.value = 0;
+    node.operands = symbolic;
+    return addNode(node);
+}
+
+
+//! @brief Creates a product node, removes unit factors and multiplies numerical factors
+int ExpressionDag::makeProduct(QList<int> factors, QList<int> divisors)
+{
+    double constant = 1;
+    QList<int> symbolicFactors, symbolicDivisors;
+    for(int i=0; i<factors.size(); ++i)
+    {
+        if(mNodes.at(factors.at(i)).type == Number)
+        {
+            constant *= mNodes.at(factors.at(i)).value;
+        }
+        else
+        {
+            symbolicFactors.append(factors.at(i));
+        }
+    }
+    for(int i=0; i<divisors.size(); ++i)
+    {
+        if(mNodes.at(divisors.at(i)).type == Number && mNodes.at(divisors.at(i)).value != 0)
+        {
+            constant /= mNodes.at(divisors.at(i)).value;
+        }
+        else
+        {
+            symbolicDivisors.append(divisors.at(i));
+        }
+    }
+
+    if(constant == 0)
+    {
+        return mZero;
+    }
+    if(constant != 1 || symbolicFactors.isEmpty())
+    {
+        symbolicFactors.append(makeNumber(constant));
+    }
+    if(symbolicFactors.size() == 1 && symbolicDivisors.isEmpty())
+    {
+        return symbolicFactors.first();
+    }
+    std::sort(symbolicFactors.begin(), symbolicFactors.end());
+    std::sort(symbolicDivisors.begin(), symbolicDivisors.end());
+
+    Node node;
+    node.type = Product;
+    node.value = 0;
+    node.operands = symbolicFactors;
+    node.divisors = symbolicDivisors;
+    return addNode(node);
+}
+
+
+int ExpressionDag::makePower(const int base, const int power)
+{
+    if(isZero(power))
+    {
+        return mOne;
+    }
+    if(isOne(power))
+    {
+        return base;
+    }
+    Node node;
+    node.type = Power;
+    node.value = 0;
+    node.operands << base << power;
+    return addNode(node);
+}
+
+
+int ExpressionDag::makeFunction(const QString &name, const QList<int> &arguments)
+{
+    Node node;
+    node.type = Function;
+    node.value = 0;
+    node.name = name;
+    node.operands = arguments;
+    return addNode(node);
+}
+
+
+int ExpressionDag::makeEquation(const int left, const int right)
+{
+    Node node;
+    node.type = Equation;
+    node.value = 0;
+    node.operands << left << right;
+    return addNode(node);
+}
+
+
+//! @brief Stores an expression that is not supported by the graph as a single node
+int ExpressionDag::makeOpaque(const Expression &expr)
+{
+    Node node;
+    node.type = Opaque;
+    node.value = 0;
+    node.opaque = expr;
+    return addNode(node);
+}
+
+
+bool ExpressionDag::isZero(const int node) const
+{
+    return (mNodes.at(node).type == Number && mNodes.at(node).value == 0);
+}
+
+
+bool ExpressionDag::isOne(const int node) const
+{
+    return (mNodes.at(node).type == Number && mNodes.at(node).value == 1);
+}
+
+
+//! @brief Adds an expression to the graph
+//! @param expr Expression to add
+//! @returns Id of the root node of the expression
+int ExpressionDag::fromExpression(const Expression &expr)
+{
+    if(expr.isEquation())
+    {
+        return makeEquation(fromExpression(*expr.getLeft()), fromExpression(*expr.getRight()));
+    }
+    else if(expr.isFunction())
+    {
+        QList<int> arguments;
+        for(const Expression &argument : expr.mArguments)
+        {
+            arguments.append(fromExpression(argument));
+        }
+        return makeFunction(expr.mFunction, arguments);
+    }
+    else if(expr.isAdd())
+    {
+        QList<int> terms;
+        for(const Expression &term : expr.mTerms)
+        {
+            terms.append(fromExpression(term));
+        }
+        return makeSum(terms);
+    }
+    else if(expr.isMultiplyOrDivide() && expr.mpDividend == nullptr)
+    {
+        QList<int> factors, divisors;
+        for(const Expression &factor : expr.mFactors)
+        {
+            factors.append(fromExpression(factor));
+        }
+        for(const Expression &divisor : expr.mDivisors)
+        {
+            divisors.append(fromExpression(divisor));
+        }
+        return makeProduct(factors, divisors);
+    }
+    else if(expr.isPower())
+    {
+        return makePower(fromExpression(*expr.getBase()), fromExpression(*expr.getPower()));
+    }
+    else if(expr.isNumericalSymbol())
+    {
+        return makeNumber(expr.toDouble());
+    }
+    else if(expr.isSymbol())
+    {
+        return makeSymbol(expr.mString);
+    }
+    return makeOpaque(expr);
+}
+
+
+//! @brief Converts a node to an expression
+//! @param node Node id
+Expression ExpressionDag::toExpression(const int node) const
+{
+    return toExpression(node, QMap<int, QString>(), true);
+}
+
+
+//! @brief Converts a node to an expression, where subexpressions are replaced by temporary variables
+//! @param node Node id
+//! @param temporaries Map from node ids to names of temporary variables, the node itself is never replaced
+Expression ExpressionDag::toExpression(const int node, const QMap<int, QString> &temporaries) const
+{
+    return toExpression(node, temporaries, true);
+}
+
+
+Expression ExpressionDag::toExpression(const int node, const QMap<int, QString> &temporaries, const bool isRoot) const
+{
+    if(!isRoot && temporaries.contains(node))
+    {
+        return Expression(temporaries.value(node));
+    }
+
+    const Node &rNode = mNodes.at(node);
+    QList<Expression> operands, divisors;
+    for(int i=0; i<rNode.operands.size(); ++i)
+    {
+        const Node &rOperand = mNodes.at(rNode.operands.at(i));
+        if(rNode.type == Product && rOperand.type == Number && rOperand.value < 0)
+        {
+            //Negative factors are stored as a separate -1 factor by SymHop
+            operands.append(Expression("-1"));
+            if(rOperand.value != -1)
+            {
+                operands.append(Expression(-rOperand.value));
+            }
+        }
+        else
+        {
+            operands.append(toExpression(rNode.operands.at(i), temporaries, false));
+        }
+    }
+    for(int i=0; i<rNode.divisors.size(); ++i)
+    {
+        divisors.append(toExpression(rNode.divisors.at(i), temporaries, false));
+    }
+
+    switch(rNode.type)
+    {
+    case Number:
+        return Expression(rNode.value);
+    case Symbol:
+        return Expression(rNode.name);
+    case Sum:
+        return Expression::fromTerms(operands);
+    case Product:
+        return Expression::fromFactorsDivisors(operands, divisors);
+    case Power:
+        return Expression::fromBasePower(operands[0], operands[1]);
+    case Function:
+        return Expression::fromFunctionArguments(rNode.name, operands);
+    case Equation:
+        return Expression::fromEquation(operands[0], operands[1]);
+    default:
+        return rNode.opaque;
+    }
+}
+
+
+//! @brief Returns the derivative of a node with respect to a variable, the result is memoized
+//! @details Follows the same differentiation rules as Expression::derivative(), special functions are delegated to it.
+//! @param node Node id
+//! @param variable Name of the variable to differentiate with respect to
+//! @param ok False if the derivative could not be computed
+//! @returns Id of the derivative node
+int ExpressionDag::derivative(const int node, const QString &variable, bool &ok)
+{
+    QHash<int, int> &rMemo = mDerivatives[variable];
+    const int memoized = rMemo.value(node, -1);
+    if(memoized >= 0)
+    {
+        return memoized;
+    }
+
+    //Copy the node, since the node list may grow during differentiation
+    const Node thisNode = mNodes.at(node);
+    int ret = mZero;
+    bool success = true;
+
+    switch(thisNode.type)
+    {
+    case Number:
+        ret = mZero;
+        break;
+    case Symbol:
+        ret = (thisNode.name == variable) ? mOne : mZero;
+        break;
+    case Sum:
+    {
+        QList<int> terms;
+        for(int i=0; i<thisNode.operands.size(); ++i)
+        {
+            terms.append(derivative(thisNode.operands.at(i), variable, success));
+            ok = ok && success;
+        }
+        ret = makeSum(terms);
+        break;
+    }
+    case Product:
+    {
+        //Derivative of Z is zero
+        for(int i=0; i<thisNode.operands.size(); ++i)
+        {
+            if(mNodes.at(thisNode.operands.at(i)).type == Symbol && mNodes.at(thisNode.operands.at(i)).name == "Z")
+            {
+                rMemo.insert(node, mZero);
+                return mZero;
+            }
+        }
+
+        //Product rule for factors and divisors, (f1*f2*...)' = f1'*f2*... + f1*f2'*... + ...
+        QList<int> dFactorTerms;
+        for(int i=0; i<thisNode.operands.size(); ++i)
+        {
+            int df = derivative(thisNode.operands.at(i), variable, success);
+            ok = ok && success;
+            if(!isZero(df))
+            {
+                QList<int> factors = thisNode.operands;
+                factors[i] = df;
+                dFactorTerms.append(makeProduct(factors));
+            }
+        }
+        int dN = makeSum(dFactorTerms);
+        if(thisNode.divisors.isEmpty())
+        {
+            ret = dN;
+            break;
+        }
+
+        QList<int> dDivisorTerms;
+        for(int i=0; i<thisNode.divisors.size(); ++i)
+        {
+            int dd = derivative(thisNode.divisors.at(i), variable, success);
+            ok = ok && success;
+            if(!isZero(dd))
+            {
+                QList<int> divisors = thisNode.divisors;
+                divisors[i] = dd;
+                dDivisorTerms.append(makeProduct(divisors));
+            }
+        }
+        int dD = makeSum(dDivisorTerms);
+        if(isZero(dD))
+        {
+            ret = makeProduct(QList<int>() << dN, thisNode.divisors);
+        }
+        else
+        {
+            //Quotient rule, (N/D)' = (N'*D - N*D')/(D*D)
+            int N = makeProduct(thisNode.operands);
+            int D = makeProduct(thisNode.divisors);
+            int numerator = makeSum(QList<int>() << makeProduct(QList<int>() << dN << D) << makeProduct(QList<int>() << mMinusOne << N << dD));
+            ret = makeProduct(QList<int>() << numerator, QList<int>() << D << D);
+        }
+        break;
+    }
+    case Power:
+    {
+        //d/dx(f^g) = f^(g-1)*(g*f' + f*log(f)*g')
+        const int f = thisNode.operands[0];
+        const int g = thisNode.operands[1];
+        int df = derivative(f, variable, success);
+        ok = ok && success;
+        int dg = derivative(g, variable, success);
+        ok = ok && success;
+        int factor = makePower(f, makeSum(QList<int>() << g << mMinusOne));
+        int term1 = makeProduct(QList<int>() << g << df);
+        int term2 = isZero(dg) ? mZero : makeProduct(QList<int>() << f << makeFunction("log", QList<int>() << f) << dg);
+        ret = makeProduct(QList<int>() << factor << makeSum(QList<int>() << term1 << term2));
+        break;
+    }
+    case Function:
+    {
+        QString func = thisNode.name;
+        bool negative = func.startsWith('-');
+        if(negative)
+        {
+            func = func.right(func.size()-1);
+        }
+
+        if(hasZeroDerivative(func))
+        {
+            ret = mZero;
+            break;
+        }
+        else if((func == "limit" || func.startsWith("nonZero")) && !thisNode.operands.isEmpty())
+        {
+            ret = derivative(thisNode.operands.first(), variable, success);
+            ok = ok && success;
+        }
+        else if(usesChainRule(func) && !thisNode.operands.isEmpty())
+        {
+            int dg = derivative(thisNode.operands.first(), variable, success);
+            ok = ok && success;
+            ret = isZero(dg) ? mZero : makeProduct(QList<int>() << makeFunction(getFunctionDerivative(func), thisNode.operands) << dg);
+        }
+        else
+        {
+            //Special functions are differentiated by SymHop
+            Expression expr = Expression::fromFunctionArguments(func, toExpression(node).getArguments());
+            Expression der = expr.derivative(Expression(variable), success);
+            ok = ok && success;
+            ret = fromExpression(der);
+        }
+
+        if(negative)
+        {
+            ret = makeProduct(QList<int>() << mMinusOne << ret);
+        }
+        break;
+    }
+    case Equation:
+    {
+        int left = derivative(thisNode.operands[0], variable, success);
+        ok = ok && success;
+        int right = derivative(thisNode.operands[1], variable, success);
+        ok = ok && success;
+        ret = makeEquation(left, right);
+        break;
+    }
+    default:
+    {
+        Expression der = thisNode.opaque.derivative(Expression(variable), success);
+        ok = ok && success;
+        ret = fromExpression(der);
+        break;
+    }
+    }
+
+    mDerivatives[variable].insert(node, ret);
+    return ret;
+}
+
+
+//! @brief Returns the simplified derivative of an expression, intermediate results are memoized in the graph
+//! @param expr Expression to differentiate
+//! @param variable Variable to differentiate with respect to
+//! @param ok True if successful, otherwise false
+Expression ExpressionDag::derivative(const Expression &expr, const Expression &variable, bool &ok)
+{
+    ok = true;
+    int node = derivative(fromExpression(expr), variable.toString(), ok);
+    Expression ret = toExpression(node);
+    ret._simplify(Expression::FullSimplification, Expression::Recursive);
+    return ret;
+}
+
+
+//! @brief Finds subexpressions that are used more than once by a set of root expressions
+//! @param roots List of root node ids
+//! @returns Shared node ids in evaluation order (children before parents)
+QList<int> ExpressionDag::findCommonSubexpressions(const QList<int> &roots) const
+{
+    QList<int> useCount;
+    QList<bool> visited;
+    for(int i=0; i<mNodes.size(); ++i)
+    {
+        useCount.append(0);
+        visited.append(false);
+    }
+
+    QList<int> stack;
+    for(int i=0; i<roots.size(); ++i)
+    {
+        ++useCount[roots.at(i)];
+        stack.append(roots.at(i));
+    }
+    while(!stack.isEmpty())
+    {
+        int node = stack.takeLast();
+        if(visited.at(node))
+        {
+            continue;
+        }
+        visited[node] = true;
+        const Node &rNode = mNodes.at(node);
+        for(int i=0; i<rNode.operands.size(); ++i)
+        {
+            ++useCount[rNode.operands.at(i)];
+            stack.append(rNode.operands.at(i));
+        }
+        for(int i=0; i<rNode.divisors.size(); ++i)
+        {
+            ++useCount[rNode.divisors.at(i)];
+            stack.append(rNode.divisors.at(i));
+        }
+    }
+
+    QList<int> ret;
+    for(int i=0; i<mNodes.size(); ++i)
+    {
+        const Node &rNode = mNodes.at(i);
+        bool trivial = (rNode.type == Number || rNode.type == Symbol || rNode.type == Equation);
+        bool negation = (rNode.type == Product && rNode.divisors.isEmpty() && rNode.operands.size() == 2 &&
+                         (rNode.operands.contains(mMinusOne)));
+        if(useCount.at(i) > 1 && !trivial && !negation)
+        {
+            ret.append(i);
+        }
+    }
+    return ret;
+}
+
+
+//! @brief Hoists subexpressions that are used more than once into temporary variables
+//! @param roots List of root node ids
+//! @param prefix Name prefix for the temporary variables
+//! @param rRootStrings Reference to list with the root expressions as strings, using the temporary variables
+//! @returns List of assignments of the temporary variables ("name = expression"), in evaluation order
+QStringList ExpressionDag::eliminateCommonSubexpressions(const QList<int> &roots, const QString &prefix, QStringList &rRootStrings) const
+{
+    QList<int> common = findCommonSubexpressions(roots);
+    QMap<int, QString> temporaries;
+    QStringList assignments;
+    for(int i=0; i<common.size(); ++i)
+    {
+        const QString name = prefix+QString::number(i);
+        Expression expr = toExpression(common.at(i), temporaries);
+        expr.expandPowers();
+        assignments.append(name+" = "+expr.toString());
+        temporaries.insert(common.at(i), name);
+    }
+
+    rRootStrings.clear();
+    for(int i=0; i<roots.size(); ++i)
+    {
+        if(temporaries.contains(roots.at(i)))
+        {
+            rRootStrings.append(temporaries.value(roots.at(i)));
+        }
+        else
+        {
+            Expression expr = toExpression(roots.at(i), temporaries);
+            expr.expandPowers();
+            rRootStrings.append(expr.toString());
+        }
+    }
+    return assignments;
+}
+
+
+ExpressionDag::NodeTypeT ExpressionDag::getType(const int node) const
+{
+    return mNodes.at(node).type;
+}
+
+
+//! @brief Returns the name of a symbol or function node
+QString ExpressionDag::getName(const int node) const
+{
+    return mNodes.at(node).name;
+}
+
+
+//! @brief Returns the value of a number node
+double ExpressionDag::getValue(const int node) const
+{
+    return mNodes.at(node).value;
+}
+
+
+//! @brief Returns the operands of a node (terms, factors, base and power, function arguments or left and right side)
+QList<int> ExpressionDag::getOperands(const int node) const
+{
+    return mNodes.at(node).operands;
+}
+
+
+//! @brief Returns the divisors of a product node
+QList<int> ExpressionDag::getDivisors(const int node) const
+{
+    return mNodes.at(node).divisors;
+}
+
+
+int ExpressionDag::getNumNodes() const
+{
+    return mNodes.size();
+}
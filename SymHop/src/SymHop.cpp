@@ -34,6 +34,7 @@
 #include <cassert>
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <QMap>
 
 #include "SymHop.h"
 
@@ -3890,6 +3891,271 @@ bool SymHop::sortEquationSystem(QList<Expression> &equations, QList<QList<Expres
 }
 
 
+namespace {
+
+//! @brief Tries to find an augmenting path from an equation in the bipartite equation-variable graph (Kuhn's algorithm)
+bool augmentMatching(const QList<QList<int> > &dependencies, int equation, QList<int> &equationOfVariable, QList<bool> &visited)
+{
+    for(int i=0; i<dependencies.at(equation).size(); ++i)
+    {
+        int var = dependencies.at(equation).at(i);
+        if(visited.at(var))
+        {
+            continue;
+        }
+        visited[var] = true;
+        if(equationOfVariable.at(var) < 0 || augmentMatching(dependencies, equationOfVariable.at(var), equationOfVariable, visited))
+        {
+            equationOfVariable[var] = equation;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//! @brief Help struct for Tarjan's strongly connected components algorithm
+struct TarjanData
+{
+    QList<int> index;
+    QList<int> lowLink;
+    QList<bool> onStack;
+    QList<int> stack;
+    int counter;
+};
+
+
+//! @brief Recursive part of Tarjan's algorithm, components are appended after all components they depend on
+void strongConnect(const QList<QList<int> > &graph, int node, TarjanData &data, QList<QList<int> > &components)
+{
+    data.index[node] = data.counter;
+    data.lowLink[node] = data.counter;
+    ++data.counter;
+    data.stack.append(node);
+    data.onStack[node] = true;
+
+    for(int i=0; i<graph.at(node).size(); ++i)
+    {
+        int next = graph.at(node).at(i);
+        if(data.index.at(next) < 0)
+        {
+            strongConnect(graph, next, data, components);
+            data.lowLink[node] = qMin(data.lowLink.at(node), data.lowLink.at(next));
+        }
+        else if(data.onStack.at(next))
+        {
+            data.lowLink[node] = qMin(data.lowLink.at(node), data.index.at(next));
+        }
+    }
+
+    if(data.lowLink.at(node) == data.index.at(node))
+    {
+        QList<int> component;
+        int member;
+        do
+        {
+            member = data.stack.takeLast();
+            data.onStack[member] = false;
+            component.prepend(member);
+        } while(member != node);
+        components.append(component);
+    }
+}
+
+
+//! @brief Finds the strongly connected components of a directed graph, in dependency order
+//! @param graph Adjacency list, graph[i] contains the nodes that node i depends on
+//! @param components Reference to list of components
+void findStronglyConnectedComponents(const QList<QList<int> > &graph, QList<QList<int> > &components)
+{
+    TarjanData data;
+    data.counter = 0;
+    for(int i=0; i<graph.size(); ++i)
+    {
+        data.index.append(-1);
+        data.lowLink.append(-1);
+        data.onStack.append(false);
+    }
+    components.clear();
+    for(int i=0; i<graph.size(); ++i)
+    {
+        if(data.index.at(i) < 0)
+        {
+            strongConnect(graph, i, data, components);
+        }
+    }
+}
+
+}
+
+
+//! @brief Assigns one variable to each equation, so that each equation can be used to solve for its variable
+//! @details Unlike findPath(), this uses augmenting paths and does not require backtracking, so it is fast also for large systems
+//! @param dependencies List with the indexes of the variables used in each equation
+//! @param numVariables Number of variables
+//! @param matching Reference to list with the variable index assigned to each equation
+//! @returns False if the system is structurally singular
+bool SymHop::findMatching(const QList<QList<int> > &dependencies, const int numVariables, QList<int> &matching)
+{
+    QList<int> equationOfVariable;
+    for(int v=0; v<numVariables; ++v)
+    {
+        equationOfVariable.append(-1);
+    }
+
+    for(int e=0; e<dependencies.size(); ++e)
+    {
+        QList<bool> visited;
+        for(int v=0; v<numVariables; ++v)
+        {
+            visited.append(false);
+        }
+        if(!augmentMatching(dependencies, e, equationOfVariable, visited))
+        {
+            gSymHopMessages << "In findMatching(): Equation system is structurally singular.";
+            return false;
+        }
+    }
+
+    matching.clear();
+    for(int e=0; e<dependencies.size(); ++e)
+    {
+        matching.append(-1);
+    }
+    for(int v=0; v<numVariables; ++v)
+    {
+        if(equationOfVariable.at(v) >= 0)
+        {
+            matching[equationOfVariable.at(v)] = v;
+        }
+    }
+    return true;
+}
+
+
+//! @brief Sorts an equation system into block lower triangular form
+//! @details Each block is a set of equations that must be solved simultaneously. Blocks are ordered so that each block only
+//! depends on variables from itself and from earlier blocks.
+//! @param dependencies List with the indexes of the variables used in each equation
+//! @param matching List with the variable assigned to each equation, from findMatching()
+//! @param blocks Reference to list of blocks with equation indexes
+void SymHop::findBlockLowerTriangularForm(const QList<QList<int> > &dependencies, const QList<int> &matching, QList<QList<int> > &blocks)
+{
+    QMap<int,int> equationOfVariable;
+    for(int e=0; e<matching.size(); ++e)
+    {
+        equationOfVariable.insert(matching.at(e), e);
+    }
+
+    //Equation e depends on the equation that solves each variable used in e
+    QList<QList<int> > graph;
+    for(int e=0; e<dependencies.size(); ++e)
+    {
+        graph.append(QList<int>());
+        for(int i=0; i<dependencies.at(e).size(); ++i)
+        {
+            int other = equationOfVariable.value(dependencies.at(e).at(i), e);
+            if(other != e)
+            {
+                graph[e].append(other);
+            }
+        }
+    }
+
+    findStronglyConnectedComponents(graph, blocks);
+}
+
+
+//! @brief Tears an algebraic loop, so that most of its equations can be solved explicitly in sequence
+//! @details Tearing variables are selected greedily, by choosing the variable used by most other equations in each remaining loop.
+//! The equations assigned to the tearing variables become residual equations for the non-linear solver.
+//! @param dependencies List with the indexes of the variables used in each equation
+//! @param matching List with the variable assigned to each equation
+//! @param block List with equation indexes in the block
+//! @param solvableEquations Equations in the block that can be solved explicitly for their assigned variable
+//! @param residualEquations Reference to list of equations that must be solved by the non-linear solver
+//! @param explicitEquations Reference to list of equations that are solved explicitly, in evaluation order
+void SymHop::tearBlock(const QList<QList<int> > &dependencies, const QList<int> &matching, const QList<int> &block, const QList<int> &solvableEquations, QList<int> &residualEquations, QList<int> &explicitEquations)
+{
+    residualEquations.clear();
+    for(int i=0; i<block.size(); ++i)
+    {
+        if(!solvableEquations.contains(block.at(i)))
+        {
+            residualEquations.append(block.at(i));
+        }
+    }
+
+    while(true)
+    {
+        //Build the dependency graph for the remaining equations
+        QList<int> remaining;
+        for(int i=0; i<block.size(); ++i)
+        {
+            if(!residualEquations.contains(block.at(i)))
+            {
+                remaining.append(block.at(i));
+            }
+        }
+        QList<QList<int> > graph;
+        for(int i=0; i<remaining.size(); ++i)
+        {
+            graph.append(QList<int>());
+            for(int j=0; j<remaining.size(); ++j)
+            {
+                if(i != j && dependencies.at(remaining.at(i)).contains(matching.at(remaining.at(j))))
+                {
+                    graph[i].append(j);
+                }
+            }
+        }
+
+        QList<QList<int> > components;
+        findStronglyConnectedComponents(graph, components);
+
+        //Tear one variable in each remaining loop
+        bool foundLoop = false;
+        for(int c=0; c<components.size(); ++c)
+        {
+            if(components.at(c).size() < 2)
+            {
+                continue;
+            }
+            foundLoop = true;
+            int bestEquation = -1;
+            int bestCount = -1;
+            for(int i=0; i<components.at(c).size(); ++i)
+            {
+                int count = 0;
+                for(int j=0; j<components.at(c).size(); ++j)
+                {
+                    if(graph.at(components.at(c).at(j)).contains(components.at(c).at(i)))
+                    {
+                        ++count;
+                    }
+                }
+                if(count > bestCount)
+                {
+                    bestCount = count;
+                    bestEquation = remaining.at(components.at(c).at(i));
+                }
+            }
+            residualEquations.append(bestEquation);
+        }
+
+        if(!foundLoop)
+        {
+            explicitEquations.clear();
+            for(int c=0; c<components.size(); ++c)
+            {
+                explicitEquations.append(remaining.at(components.at(c).first()));
+            }
+            return;
+        }
+    }
+}
+
+
 //! @brief Removes all duplicates in a list of expressions
 //! @param rList Reference to the list
 void SymHop::removeDuplicates(QList<Expression> &rSet)
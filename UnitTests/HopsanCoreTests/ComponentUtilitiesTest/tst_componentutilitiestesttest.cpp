@@ -31,6 +31,52 @@ using namespace hopsan;
 
 Q_DECLARE_METATYPE(QVector<double>)
 
+//! @brief Harmonic oscillator for testing the NumericalIntegrationSolver, with either the bulk or the per-state derivative interface
+class TestOscillator : public ComponentSignal
+{
+public:
+    TestOscillator(const bool bulk, const double timestep) : mBulk(bulk)
+    {
+        mTimestep = timestep;
+        mStateVars.push_back(1.0);
+        mStateVars.push_back(0.0);
+        solveSystem();
+    }
+
+    void configure() {}
+    void simulateOneTimestep() {}
+
+    bool computeDerivatives(const double *y, double *dydt)
+    {
+        if(!mBulk)
+        {
+            return false;
+        }
+        dydt[0] = y[1];
+        dydt[1] = -9.0*y[0];
+        return true;
+    }
+
+    void reInitializeValuesFromNodes() {}
+
+    void solveSystem()
+    {
+        mDerivatives[0] = mStateVars[1];
+        mDerivatives[1] = -9.0*mStateVars[0];
+    }
+
+    double getStateVariableDerivative(int i)
+    {
+        return mDerivatives[i];
+    }
+
+    std::vector<double> mStateVars;
+
+private:
+    bool mBulk;
+    double mDerivatives[2];
+};
+
 class ComponentUtilitiesTestTest : public QObject
 {
     Q_OBJECT
@@ -485,6 +531,129 @@ private Q_SLOTS:
     }
 
 
+    void Delay_Memory_Estimate()
+    {
+        QFETCH(double, timeDelay);
+        QFETCH(double, dt);
+        QFETCH(size_t, res);
+
+        Delay x;
+        x.initialize(timeDelay, dt, 0.0);
+        QVERIFY2(x.getMemoryUsage() == res*sizeof(double), "Delay reported wrong memory usage.");
+        QVERIFY2(Delay::estimateMemoryUsage(timeDelay, dt) == x.getMemoryUsage(), "Delay memory estimate differs from allocation.");
+    }
+
+    void Delay_Memory_Estimate_data()
+    {
+        QTest::addColumn<double>("timeDelay");
+        QTest::addColumn<double>("dt");
+        QTest::addColumn<size_t>("res");
+        // The capacity is rounded up to a power of two
+        QTest::newRow("0") << 1.0 << 0.001 << size_t(1024);
+        QTest::newRow("1") << 0.0015 << 0.001 << size_t(2);
+        QTest::newRow("2") << 0.0 << 0.001 << size_t(1);
+        QTest::newRow("3") << -1.0 << 0.001 << size_t(1);
+    }
+
+
+
+    void Delay_Interpolation()
+    {
+        QFETCH(double, timeDelay);
+        QFETCH(int, interpolation);
+        QFETCH(double, tolerance);
+
+        // Delay a sine wave with a delay that is not a multiple of the time step
+        const double dt = 0.001;
+        Delay x;
+        x.initialize(timeDelay, dt, 0.0, Delay::InterpolationEnumT(interpolation));
+        QVERIFY2(Delay::estimateMemoryUsage(timeDelay, dt, Delay::InterpolationEnumT(interpolation)) == x.getMemoryUsage(), "Delay memory estimate differs from allocation.");
+        double maxError = 0;
+        for (int i=0; i<1000; ++i)
+        {
+            const double t = i*dt;
+            const double y = x.update(sin(20.0*t));
+            if (t > 0.1)
+            {
+                maxError = std::max(maxError, std::fabs(y-sin(20.0*(t-timeDelay))));
+            }
+        }
+        QVERIFY2(maxError < tolerance, QString("Delay interpolation error %1 is too large.").arg(maxError).toStdString().c_str());
+    }
+
+    void Delay_Interpolation_data()
+    {
+        QTest::addColumn<double>("timeDelay");
+        QTest::addColumn<int>("interpolation");
+        QTest::addColumn<double>("tolerance");
+        QTest::newRow("0") << 0.0123 << int(Delay::NoInterpolation) << 1e-2;
+        QTest::newRow("1") << 0.0123 << int(Delay::LinearInterpolation) << 1e-4;
+        QTest::newRow("2") << 0.0123 << int(Delay::LagrangeInterpolation) << 1e-8;
+        QTest::newRow("3") << 0.0004 << int(Delay::LagrangeInterpolation) << 1e-8;
+        QTest::newRow("4") << 0.0 << int(Delay::LinearInterpolation) << 1e-15;
+    }
+
+    void Filter_Bank()
+    {
+        QFETCH(int, numFilters);
+        QFETCH(double, limit);
+
+        // Each filter has its own input and output, and the same filter is updated on its own for reference
+        const double dt = 0.001;
+        std::vector<FirstOrderTransferFunction> firstOrder(numFilters), firstOrderRef(numFilters);
+        std::vector<SecondOrderTransferFunction> secondOrder(numFilters), secondOrderRef(numFilters);
+        std::vector<double> inputs(2*numFilters), outputs(2*numFilters);
+        FilterBank bank;
+        for (int i=0; i<numFilters; ++i)
+        {
+            double num1[2] = {1.0, 0.0};
+            double den1[2] = {1.0, 1.0/(10.0+i)};
+            double num2[3] = {1.0, 0.01*i, 0.0};
+            double den2[3] = {1.0, 0.02, 1.0/((20.0+i)*(20.0+i))};
+            firstOrder[i].initialize(dt, num1, den1, 0, 0, -limit, limit);
+            firstOrderRef[i].initialize(dt, num1, den1, 0, 0, -limit, limit);
+            secondOrder[i].initialize(dt, num2, den2, 0, 0, -limit, limit);
+            secondOrderRef[i].initialize(dt, num2, den2, 0, 0, -limit, limit);
+            bank.addFilter(&firstOrder[i], &inputs[2*i], &outputs[2*i]);
+            bank.addFilter(&secondOrder[i], &inputs[2*i+1], &outputs[2*i+1]);
+        }
+        QCOMPARE(bank.size(), size_t(2*numFilters));
+
+        bank.loadStates();
+        for (int step=0; step<500; ++step)
+        {
+            for (int i=0; i<2*numFilters; ++i)
+            {
+                inputs[i] = sin(0.01*step*(1+i%7)) + ((step > 250) ? 1.0 : 0.0);
+            }
+            bank.update();
+            for (int i=0; i<numFilters; ++i)
+            {
+                QVERIFY2(outputs[2*i] == firstOrderRef[i].update(inputs[2*i]), "First order filter bank output differs.");
+                QVERIFY2(outputs[2*i+1] == secondOrderRef[i].update(inputs[2*i+1]), "Second order filter bank output differs.");
+            }
+        }
+        bank.storeStates();
+
+        for (int i=0; i<numFilters; ++i)
+        {
+            QVERIFY2(firstOrder[i].value() == firstOrderRef[i].value(), "First order filter state was not stored.");
+            QVERIFY2(firstOrder[i].delayedU() == firstOrderRef[i].delayedU(), "First order filter state was not stored.");
+            QVERIFY2(firstOrder[i].isSaturated() == firstOrderRef[i].isSaturated(), "First order filter saturation differs.");
+            QVERIFY2(secondOrder[i].value() == secondOrderRef[i].value(), "Second order filter state was not stored.");
+            QVERIFY2(secondOrder[i].delayed2Y() == secondOrderRef[i].delayed2Y(), "Second order filter state was not stored.");
+            QVERIFY2(secondOrder[i].isSaturated() == secondOrderRef[i].isSaturated(), "Second order filter saturation differs.");
+        }
+    }
+
+    void Filter_Bank_data()
+    {
+        QTest::addColumn<int>("numFilters");
+        QTest::addColumn<double>("limit");
+        QTest::newRow("0") << 1 << 1.5E+300;
+        QTest::newRow("1") << 37 << 1.5E+300;
+        QTest::newRow("2") << 37 << 0.8;
+    }
 
     void Integrator_Limited_Test()
     {
@@ -615,6 +784,170 @@ private Q_SLOTS:
         QTest::newRow("plo2 4") << ploData2 << "notExist" << "y" << true << -1 << 2 << 40.0;
 
     }
+
+    void Numerical_Integration_Solver()
+    {
+        QFETCH(int, solverType);
+        QFETCH(double, maxError);
+
+        // Integrate y'' = -9y from y(0)=1 to t=1, both derivative interfaces must give the same result
+        TestOscillator bulk(true, 0.01), perState(false, 0.01);
+        NumericalIntegrationSolver bulkSolver(&bulk, &bulk.mStateVars, 1e-8);
+        NumericalIntegrationSolver perStateSolver(&perState, &perState.mStateVars, 1e-8);
+        for(int i=0; i<100; ++i)
+        {
+            bulkSolver.solve(solverType);
+            perStateSolver.solve(solverType);
+        }
+        QVERIFY2(bulk.mStateVars == perState.mStateVars, "Bulk and per-state derivatives give different results.");
+        QVERIFY2(fabs(bulk.mStateVars[0] - cos(3.0)) < maxError, "Numerical integration is not accurate enough.");
+    }
+
+    void Numerical_Integration_Solver_data()
+    {
+        QTest::addColumn<int>("solverType");
+        QTest::addColumn<double>("maxError");
+        QTest::newRow("Forward Euler") << 0 << 0.1;
+        QTest::newRow("Midpoint Method") << 1 << 1e-3;
+        QTest::newRow("Runge-Kutta") << 2 << 1e-7;
+        QTest::newRow("Dormand-Prince") << 3 << 1e-9;
+        QTest::newRow("Backward Euler") << 4 << 0.1;
+        QTest::newRow("Trapezoid Rule") << 5 << 1e-3;
+        QTest::newRow("Dormand-Prince (adaptive)") << 6 << 1e-9;
+    }
+
+    void Numerical_Integration_Solver_Dense_Output()
+    {
+        // One long time step, the adaptive solver must take sub-steps and interpolate between them
+        TestOscillator osc(true, 0.5);
+        NumericalIntegrationSolver solver(&osc, &osc.mStateVars, 1e-9);
+        solver.solveDormandPrinceAdaptive();
+        QVERIFY2(solver.getNumSubSteps() > 1, "Adaptive solver did not take any sub-steps.");
+        QVERIFY2(fabs(osc.mStateVars[0] - cos(1.5)) < 1e-7, "Adaptive solver is not accurate enough.");
+
+        double y[2];
+        for(int i=0; i<=10; ++i)
+        {
+            solver.getDenseOutput(i/10.0, y);
+            QVERIFY2(fabs(y[0] - cos(0.15*i)) < 1e-7, "Dense output is not accurate enough.");
+        }
+    }
+
+    void Random_Stream()
+    {
+        // Known answer test of the Philox4x32-10 generator
+        const uint32_t ctr0[4] = {0, 0, 0, 0};
+        const uint32_t key0[2] = {0, 0};
+        const uint32_t ctr1[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+        const uint32_t key1[2] = {0xffffffff, 0xffffffff};
+        uint32_t r0[4], r1[4];
+        RandomStream::philox4x32(ctr0, key0, r0);
+        RandomStream::philox4x32(ctr1, key1, r1);
+        QVERIFY2(r0[0] == 0x6627e8d5 && r0[1] == 0xe169c58d && r0[2] == 0xbc57ac4c && r0[3] == 0x9b00dbd8, "Philox known answer test 0 failed.");
+        QVERIFY2(r1[0] == 0x408f276d && r1[1] == 0x41c83b0e && r1[2] == 0xa20bc7c6 && r1[3] == 0x6d5451fd, "Philox known answer test 1 failed.");
+
+        // Same seed and name gives the same stream, other names or seeds give other streams
+        RandomStream a(42, RandomStream::streamIdFromName("Noise")), b(42, RandomStream::streamIdFromName("Noise"));
+        RandomStream c(42, RandomStream::streamIdFromName("Noise_1")), d(43, RandomStream::streamIdFromName("Noise"));
+        bool sameAB=true, sameAC=true, sameAD=true;
+        for (int i=0; i<100; ++i)
+        {
+            const uint64_t x = a.nextUInt64();
+            sameAB = sameAB && (x == b.nextUInt64());
+            sameAC = sameAC && (x == c.nextUInt64());
+            sameAD = sameAD && (x == d.nextUInt64());
+        }
+        QVERIFY2(sameAB, "Streams with the same seed and id differ.");
+        QVERIFY2(!sameAC && !sameAD, "Streams with different seeds or ids are equal.");
+
+        // The bulk functions give the same values as the scalar ones, also from an odd position
+        std::vector<double> uniform(1001);
+        a.nextUInt64();
+        b.nextUniform();
+        a.fillUniform(uniform.data(), uniform.size());
+        bool sameFill=true;
+        for (size_t i=0; i<uniform.size(); ++i)
+        {
+            sameFill = sameFill && (uniform[i] == b.nextUniform()) && (uniform[i] >= 0.0) && (uniform[i] < 1.0);
+        }
+        QVERIFY2(sameFill, "fillUniform differs from nextUniform.");
+
+        // Mean and variance of the normal distribution
+        std::vector<double> normal(200000);
+        a.fillNormal(normal.data(), normal.size());
+        double mean=0, var=0;
+        for (size_t i=0; i<normal.size(); ++i)
+        {
+            mean += normal[i];
+            var += normal[i]*normal[i];
+        }
+        mean /= double(normal.size());
+        var = var/double(normal.size()) - mean*mean;
+        QVERIFY2(fabs(mean) < 0.01 && fabs(var-1.0) < 0.02, "Normal distributed values have the wrong mean or variance.");
+
+        // Continue from a saved state
+        StateWriter writer;
+        a.saveState(writer);
+        std::vector<double> expected(10);
+        for (size_t i=0; i<expected.size(); ++i)
+        {
+            expected[i] = a.nextNormal();
+        }
+        RandomStream restored;
+        StateReader reader(writer.getData().data(), writer.getData().size());
+        QVERIFY2(restored.restoreState(reader), "Could not restore the random stream state.");
+        bool sameRestored=true;
+        for (size_t i=0; i<expected.size(); ++i)
+        {
+            sameRestored = sameRestored && (expected[i] == restored.nextNormal());
+        }
+        QVERIFY2(sameRestored, "Restored random stream differs.");
+    }
+
+    void Sparse_LU()
+    {
+        // Tridiagonal system with a zero on the first diagonal element, so that a row swap is needed
+        const int n=30;
+        std::vector<int> rowPtrs(1, 0), colIdx;
+        std::vector<double> values;
+        for (int i=0; i<n; ++i)
+        {
+            for (int j=std::max(i-1, 0); j<=std::min(i+1, n-1); ++j)
+            {
+                colIdx.push_back(j);
+                values.push_back((i == j) ? ((i == 0) ? 0.0 : 4.0+i) : -1.0-0.1*j);
+            }
+            rowPtrs.push_back(int(colIdx.size()));
+        }
+
+        // Right-hand side from the known solution x_i = i+1
+        std::vector<double> x(n, 0.0);
+        for (int i=0; i<n; ++i)
+        {
+            for (int k=rowPtrs[i]; k<rowPtrs[i+1]; ++k)
+            {
+                x[i] += values[k]*(colIdx[k]+1);
+            }
+        }
+
+        SparseLU lu;
+        QVERIFY2(lu.analyze(n, rowPtrs.data(), colIdx.data()), "Could not analyze the sparsity pattern.");
+        QVERIFY2(lu.factorize(values.data()), "Could not factorize the matrix.");
+        lu.solve(x.data());
+        double maxError=0;
+        for (int i=0; i<n; ++i)
+        {
+            maxError = std::max(maxError, std::fabs(x[i]-(i+1)));
+        }
+        QVERIFY2(maxError < 1e-10, QString("Sparse LU solution error %1 is too large.").arg(maxError).toStdString().c_str());
+
+        // A singular matrix with the same pattern must be detected
+        for (int k=rowPtrs[1]; k<rowPtrs[2]; ++k)
+        {
+            values[k] = 0.0;
+        }
+        QVERIFY2(!lu.factorize(values.data()), "Singular matrix was not detected.");
+    }
 };
 
 
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 SUBDIRS = HStringTest HVectorTest SimulationTest \
     LookupTableTest \
     UtilitiesTest \
-    ComponentUtilitiesTest
+    ComponentUtilitiesTest \
+    PerformanceTest
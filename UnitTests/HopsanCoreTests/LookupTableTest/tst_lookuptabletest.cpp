@@ -30,6 +30,7 @@
 
 
 #include "ComponentUtilities/LookupTable.h"
+#include "ComponentUtilities/LookupTableCache.h"
 
 #ifndef TEST_DATA_ROOT
 const QString relpath = "../UnitTests/HopsanCoreTests/LookupTableTest/";
@@ -114,6 +115,9 @@ private Q_SLOTS:
     void lookup2D_data();
     void lookup3D();
     void lookup3D_data();
+    void sharedLookupTableCache();
+    void intervalSearch();
+    void interpolateMany();
 };
 
 LookupTableTest::LookupTableTest()
@@ -480,6 +484,249 @@ void LookupTableTest::lookup3D_data()
 
 }
 
+void LookupTableTest::sharedLookupTableCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), "Could not create temporary directory");
+    const QString filePath = tempDir.path()+"/shared_table.csv";
+    QFile file(filePath);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Text), "Could not create test data file");
+    file.write("1,10\n2,20\n3,30\n");
+    file.close();
+
+    int numLoads=0;
+    auto loader = [&numLoads]()
+    {
+        ++numLoads;
+        LookupTable1D *pTable = new LookupTable1D();
+        pTable->getIndexDataRef() = {1, 2, 3};
+        pTable->getValueDataRef() = {10, 20, 30};
+        pTable->isDataOK();
+        return pTable;
+    };
+
+    const hopsan::HString path = filePath.toStdString().c_str();
+    std::shared_ptr<const LookupTable1D> pTable1 = hopsan::getSharedLookupTable<LookupTable1D>(path, "test", loader);
+    std::shared_ptr<const LookupTable1D> pTable2 = hopsan::getSharedLookupTable<LookupTable1D>(path, "test", loader);
+    QVERIFY2(pTable1 && (pTable1 == pTable2), "Instances using the same file and options should share data");
+    QCOMPARE(numLoads, 1);
+    QVERIFY2(fc(pTable2->interpolate(2.5), 25.0), "Interpolate on shared table returned the wrong result");
+
+    // Different parse options must not share data
+    std::shared_ptr<const LookupTable1D> pTable3 = hopsan::getSharedLookupTable<LookupTable1D>(path, "other", loader);
+    QCOMPARE(numLoads, 2);
+    QVERIFY2(pTable3 != pTable1, "Different parse options should not share data");
+    QCOMPARE(hopsan::LookupTableCache::getNumCachedTables(), size_t(2));
+
+    // Data should be released when the last user lets go of it, and be reloaded on next request
+    pTable1.reset();
+    pTable2.reset();
+    pTable3.reset();
+    QCOMPARE(hopsan::LookupTableCache::getNumCachedTables(), size_t(0));
+    pTable1 = hopsan::getSharedLookupTable<LookupTable1D>(path, "test", loader);
+    QCOMPARE(numLoads, 3);
+
+    // A file rewritten with the same size within the same second must not reuse the old data
+    const QDateTime wholeSecond = QDateTime::fromSecsSinceEpoch(QDateTime::currentSecsSinceEpoch()+10);
+    QVERIFY2(file.open(QIODevice::ReadWrite), "Could not open test data file");
+    QVERIFY2(file.setFileTime(wholeSecond, QFileDevice::FileModificationTime), "Could not set file time");
+    file.close();
+    pTable1 = hopsan::getSharedLookupTable<LookupTable1D>(path, "test", loader);
+    QCOMPARE(numLoads, 4);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Text), "Could not open test data file");
+    file.write("1,11\n2,21\n3,31\n");
+    QVERIFY2(file.setFileTime(wholeSecond.addMSecs(500), QFileDevice::FileModificationTime), "Could not set file time");
+    file.close();
+    pTable2 = hopsan::getSharedLookupTable<LookupTable1D>(path, "test", loader);
+    QCOMPARE(numLoads, 5);
+    QVERIFY2(pTable2 != pTable1, "A modified file should not share data with its previous version");
+}
+
+void LookupTableTest::intervalSearch()
+{
+    // One uniformly and one non-uniformly spaced index vector
+    LookupTable1D uniform, nonUniform;
+    for (int i=0; i<50; ++i)
+    {
+        uniform.getIndexDataRef().push_back(0.1*i);
+        nonUniform.getIndexDataRef().push_back(i+0.25*sin(double(i)));
+        uniform.getValueDataRef().push_back(i*i);
+        nonUniform.getValueDataRef().push_back(i*i);
+    }
+    QVERIFY(uniform.isDataOK());
+    QVERIFY(nonUniform.isDataOK());
+    QVERIFY2(uniform.isIndexUniform(0), "Uniform index spacing was not detected");
+    QVERIFY2(!nonUniform.isIndexUniform(0), "Non-uniform index spacing was detected as uniform");
+
+    // The hunting and uniform searches must find an interval containing x, for slowly varying, jumping and exact index input
+    LookupTable1D *tables[] = {&uniform, &nonUniform};
+    for (LookupTable1D *pTable : tables)
+    {
+        const std::vector<double> &rIndex = pTable->getIndexDataRef();
+        const double first = rIndex.front();
+        const double last = rIndex.back();
+        size_t hint=0;
+        for (int k=0; k<2000; ++k)
+        {
+            double x = first + (last-first)*(0.5-0.5*cos(0.01*k));
+            if (k%5 == 0)
+            {
+                x = first + (last-first)*double(rand())/double(RAND_MAX);
+            }
+            else if (k%7 == 0)
+            {
+                x = rIndex[size_t(rand()) % rIndex.size()];
+            }
+            x = std::min(x, last);
+
+            const size_t i = pTable->findIndexAlongDim(0, x);
+            const size_t h = pTable->findIndexAlongDim(0, x, hint);
+            QVERIFY2((rIndex[i] <= x) && (x <= rIndex[i+1]), QString("Wrong interval %1 for x=%2").arg(i).arg(x).toLatin1());
+            QVERIFY2((rIndex[h] <= x) && (x <= rIndex[h+1]), QString("Wrong hunted interval %1 for x=%2").arg(h).arg(x).toLatin1());
+            QCOMPARE(hint, h);
+
+            const size_t b = pTable->findIndexAlongDimBisection(0, x);
+            const double ref = interp1(x, rIndex[b], rIndex[b+1], pTable->interpolate(rIndex[b]), pTable->interpolate(rIndex[b+1]));
+            size_t hint2 = h;
+            QVERIFY2(fc(pTable->interpolate(x), ref, 1e-6), "Interpolate differs from bisection");
+            QVERIFY2(fc(pTable->interpolate(x, hint2), ref, 1e-6), "Interpolate with hint differs from bisection");
+        }
+    }
+
+    // 2D and 3D tables with hints must give the same result as without
+    LookupTable2D lookup2d;
+    lookup2d.getIndexDataRef(0) = {0, 1, 2, 3};
+    lookup2d.getIndexDataRef(1) = {0, 0.5, 2, 2.5, 7};
+    for (int i=0; i<20; ++i)
+    {
+        lookup2d.getValueDataRef().push_back(i*i);
+    }
+    QVERIFY(lookup2d.isDataOK());
+    QVERIFY(lookup2d.isIndexUniform(0));
+    QVERIFY(!lookup2d.isIndexUniform(1));
+
+    LookupTable3D lookup3d;
+    lookup3d.getIndexDataRef(0) = {0, 1, 2};
+    lookup3d.getIndexDataRef(1) = {0, 1, 4};
+    lookup3d.getIndexDataRef(2) = {-1, 0, 1, 2};
+    for (int i=0; i<36; ++i)
+    {
+        lookup3d.getValueDataRef().push_back(sin(double(i)));
+    }
+    QVERIFY(lookup3d.isDataOK());
+
+    size_t rowHint2d=0, colHint2d=0, rowHint=0, colHint=0, planeHint=0;
+    for (int k=0; k<500; ++k)
+    {
+        const double r = 1.5+1.6*sin(0.03*k);
+        const double c = 3.5+3.6*cos(0.05*k);
+        const double p = 0.5+1.6*sin(0.07*k);
+        QVERIFY2(fc(lookup2d.interpolate(r, c, rowHint2d, colHint2d), lookup2d.interpolate(r, c)), "2D interpolate with hints differs");
+        QVERIFY2(fc(lookup3d.interpolate(r, c, p, rowHint, colHint, planeHint), lookup3d.interpolate(r, c, p)), "3D interpolate with hints differs");
+    }
+}
+
+//! @brief Check that values are bitwise identical, or both NaN
+inline bool identical(const double a, const double b)
+{
+    return (a == b) || (std::isnan(a) && std::isnan(b));
+}
+
+void LookupTableTest::interpolateMany()
+{
+#if defined(LOOKUPTABLETEST_REQUIRE_AVX2) && !defined(HOPSAN_LOOKUPTABLE_AVX2)
+    QFAIL("The test is built for AVX2 but the AVX2 interpolation is not enabled");
+#endif
+    for (int uniform=0; uniform<2; ++uniform)
+    {
+        // Odd sizes so that the AVX2 remainder and several batches are exercised
+        LookupTable1D lookup1d;
+        for (int i=0; i<301; ++i)
+        {
+            lookup1d.getIndexDataRef().push_back(uniform ? 0.1*i-3 : i+0.25*sin(double(i)));
+            lookup1d.getValueDataRef().push_back(100*sin(0.3*i));
+        }
+        QVERIFY(lookup1d.isDataOK());
+        QCOMPARE(lookup1d.isIndexUniform(0), bool(uniform));
+
+        // Ordered values, random values with some outside the range, exact index values and NaN
+        const std::vector<double> &rIndex = lookup1d.getIndexDataRef();
+        const double first = rIndex.front();
+        const double last = rIndex.back();
+        std::vector<double> x;
+        for (int k=0; k<1003; ++k)
+        {
+            x.push_back(first + (last-first)*k/1002.0);
+        }
+        for (int k=0; k<1003; ++k)
+        {
+            x.push_back(first-1 + (last-first+2)*double(rand())/double(RAND_MAX));
+            x.push_back(rIndex[size_t(rand()) % rIndex.size()]);
+        }
+        x.push_back(std::nan(""));
+
+        std::vector<double> y;
+        lookup1d.interpolateMany(x, y);
+        QCOMPARE(y.size(), x.size());
+        for (size_t k=0; k<x.size(); ++k)
+        {
+            QVERIFY2(identical(y[k], lookup1d.interpolate(x[k])), QString("interpolateMany differs from interpolate for x=%1").arg(x[k]).toLatin1());
+        }
+
+        // In place
+        lookup1d.interpolateMany(x.data(), x.data(), x.size());
+        for (size_t k=0; k<x.size(); ++k)
+        {
+            QVERIFY2(identical(x[k], y[k]), "In place interpolateMany gave a different result");
+        }
+
+        LookupTable2D lookup2d;
+        for (int i=0; i<17; ++i)
+        {
+            lookup2d.getIndexDataRef(0).push_back(uniform ? i : i+0.3*sin(double(i)));
+        }
+        for (int i=0; i<13; ++i)
+        {
+            lookup2d.getIndexDataRef(1).push_back(uniform ? 0.5*i : i*i+0.5);
+        }
+        for (int i=0; i<17*13; ++i)
+        {
+            lookup2d.getValueDataRef().push_back(cos(0.7*i));
+        }
+        QVERIFY(lookup2d.isDataOK());
+
+        LookupTable3D lookup3d;
+        for (int d=0; d<3; ++d)
+        {
+            for (int i=0; i<5; ++i)
+            {
+                lookup3d.getIndexDataRef(d).push_back(uniform ? i : i*i);
+            }
+        }
+        for (int i=0; i<125; ++i)
+        {
+            lookup3d.getValueDataRef().push_back(sin(double(i)));
+        }
+        QVERIFY(lookup3d.isDataOK());
+
+        const size_t n=999;
+        std::vector<double> r(n), c(n), p(n), y2(n), y3(n);
+        for (size_t k=0; k<n; ++k)
+        {
+            r[k] = -2 + 20*double(rand())/double(RAND_MAX);
+            c[k] = (k%3 == 0) ? lookup2d.getIndexDataRef(1)[size_t(rand()) % 13] : -2 + 150*double(k)/double(n);
+            p[k] = -1 + 20*double(rand())/double(RAND_MAX);
+        }
+        lookup2d.interpolateMany(r.data(), c.data(), y2.data(), n);
+        lookup3d.interpolateMany(r.data(), c.data(), p.data(), y3.data(), n);
+        for (size_t k=0; k<n; ++k)
+        {
+            QVERIFY2(identical(y2[k], lookup2d.interpolate(r[k], c[k])), "2D interpolateMany differs from interpolate");
+            QVERIFY2(identical(y3[k], lookup3d.interpolate(r[k], c[k], p[k])), "3D interpolateMany differs from interpolate");
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(LookupTableTest)
 
 #include "tst_lookuptabletest.moc"
@@ -0,0 +1,390 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+// Performance regression tests, simulation time per step normalised by a calibration loop is compared to a checked-in baseline
+// Run separately with: ctest -L performance, or exclude with: ctest -LE performance
+// Environment variables:
+//   HOPSAN_PERF_TOLERANCE       Allowed relative slowdown compared to the baseline (default: 0.25)
+//   HOPSAN_PERF_WRITE_BASELINE  Write the measured values to this file, to be used as new baseline
+
+#include <QtTest>
+
+#include "HopsanEssentials.h"
+#include "ComponentSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef DEFAULT_LIBRARY_ROOT
+#define DEFAULT_LIBRARY_ROOT "../componentLibraries/defaultLibrary"
+#endif
+
+#ifndef MODELS_ROOT
+#define MODELS_ROOT "../Models/"
+#endif
+
+#ifndef TEST_DATA_ROOT
+#define TEST_DATA_ROOT "../UnitTests/HopsanCoreTests/PerformanceTest/"
+#endif
+
+#ifndef HOPSAN_INTERNALDEFAULTCOMPONENTS
+#define DEFAULTLIBFILE SHAREDLIB_PREFIX "defaultcomponentlibrary" HOPSAN_DEBUG_POSTFIX "." SHAREDLIB_SUFFIX
+const std::string defaultLibraryFilePath = DEFAULT_LIBRARY_ROOT "/" DEFAULTLIBFILE;
+#else
+const std::string defaultLibraryFilePath = "";
+#endif
+
+using namespace hopsan;
+
+namespace {
+
+typedef std::chrono::steady_clock ClockT;
+
+//! @brief Minimum total measured time per model, short models are repeated until this is reached
+const double minMeasureTime = 0.5;
+const size_t maxRepetitions = 20;
+
+volatile double gCalibrationSink;
+
+double secondsSince(const ClockT::time_point &rStart)
+{
+    return std::chrono::duration<double>(ClockT::now()-rStart).count();
+}
+
+// The calibration loop mimics a simulation step: virtual calls on many small objects that read and write shared data
+class CalibrationBlock
+{
+public:
+    CalibrationBlock(size_t in, size_t out) : mIn(in), mOut(out), mState(0) {}
+    virtual ~CalibrationBlock() {}
+    virtual void step(std::vector<double> &rData) = 0;
+protected:
+    size_t mIn, mOut;
+    double mState;
+};
+
+class CalibrationLowPass : public CalibrationBlock
+{
+public:
+    CalibrationLowPass(size_t in, size_t out) : CalibrationBlock(in, out) {}
+    void step(std::vector<double> &rData)
+    {
+        mState = 0.9*mState + 0.1*rData[mIn];
+        rData[mOut] = mState;
+    }
+};
+
+class CalibrationWave : public CalibrationBlock
+{
+public:
+    CalibrationWave(size_t in, size_t out) : CalibrationBlock(in, out) {}
+    void step(std::vector<double> &rData)
+    {
+        mState += 1e-3;
+        rData[mOut] = rData[mIn]*0.5 + std::sin(mState)/(1.0+std::fabs(rData[mOut]));
+    }
+};
+
+//! @brief Run the calibration workload
+//! @returns The best wall time in seconds of a number of runs
+double measureCalibrationTime()
+{
+    const size_t nBlocks = 512;
+    const size_t nSteps = 20000;
+    std::vector<double> data(2*nBlocks, 1.0);
+    std::vector<std::unique_ptr<CalibrationBlock> > blocks;
+    for (size_t i=0; i<nBlocks; ++i)
+    {
+        // Scatter the data access a bit, as nodes are not laid out in simulation order
+        const size_t in = (i*7919) % data.size();
+        const size_t out = (i*104729+1) % data.size();
+        if (i % 3 == 0)
+        {
+            blocks.emplace_back(new CalibrationWave(in, out));
+        }
+        else
+        {
+            blocks.emplace_back(new CalibrationLowPass(in, out));
+        }
+    }
+
+    double best = 1e300;
+    for (int run=0; run<5; ++run)
+    {
+        const ClockT::time_point start = ClockT::now();
+        for (size_t s=0; s<nSteps; ++s)
+        {
+            for (size_t b=0; b<blocks.size(); ++b)
+            {
+                blocks[b]->step(data);
+            }
+        }
+        best = std::min(best, secondsSince(start));
+    }
+    // Make sure that the result is used
+    gCalibrationSink = data[0];
+    return best;
+}
+
+//! @brief Create a synthetic model with sine wave sources feeding many independent filters
+ComponentSystem *createSyntheticFilterModel(HopsanEssentials &rHopsanCore, const HString &rFilterType, const size_t numFilters,
+                                            std::vector<Component*> &rFilters)
+{
+    const size_t numSources = 10;
+    ComponentSystem *pSystem = rHopsanCore.createComponentSystem();
+    pSystem->setDesiredTimestep(0.001);
+    pSystem->setNumLogSamples(100);
+    std::vector<Component*> sources;
+    for (size_t i=0; i<numSources; ++i)
+    {
+        Component *pSource = rHopsanCore.createComponent("SignalSineWave");
+        pSystem->addComponent(pSource);
+        pSource->setParameterValue("f", std::to_string(i+1).c_str());
+        sources.push_back(pSource);
+    }
+    for (size_t i=0; i<numFilters; ++i)
+    {
+        Component *pFilter = rHopsanCore.createComponent(rFilterType);
+        pSystem->addComponent(pFilter);
+        pFilter->setParameterValue("omega", std::to_string(10+i%50).c_str());
+        pSystem->connect(sources[i%numSources]->getName(), "out", pFilter->getName(), "in");
+        rFilters.push_back(pFilter);
+    }
+    return pSystem;
+}
+
+//! @brief Read the baseline file, lines with: model;normalised time per step
+std::map<std::string, double> readBaseline(const std::string &rFilePath)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(rFilePath.c_str());
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        const size_t sep = line.find(';');
+        if (sep != std::string::npos)
+        {
+            baseline[line.substr(0, sep)] = atof(line.substr(sep+1).c_str());
+        }
+    }
+    return baseline;
+}
+
+}
+
+class PerformanceTests : public QObject
+{
+    Q_OBJECT
+
+private:
+    HopsanEssentials mHopsanCore;
+    double mCalibrationTime = 0;
+    double mTolerance = 0.25;
+    std::map<std::string, double> mBaseline;
+    std::map<std::string, double> mMeasured;
+
+private slots:
+    void initTestCase()
+    {
+        bool did_load = mHopsanCore.loadExternalComponentLib(defaultLibraryFilePath.c_str());
+        QVERIFY2(did_load, qPrintable(QString("Could not load default component library: ")+QString::fromStdString(defaultLibraryFilePath)));
+
+        if (qEnvironmentVariableIsSet("HOPSAN_PERF_TOLERANCE"))
+        {
+            mTolerance = qgetenv("HOPSAN_PERF_TOLERANCE").toDouble();
+        }
+        mBaseline = readBaseline(TEST_DATA_ROOT "performanceBaseline.txt");
+        mCalibrationTime = measureCalibrationTime();
+        QVERIFY(mCalibrationTime > 0);
+        qDebug() << "Calibration time:" << mCalibrationTime << "s";
+    }
+
+    void cleanupTestCase()
+    {
+        if (qEnvironmentVariableIsSet("HOPSAN_PERF_WRITE_BASELINE"))
+        {
+            std::ofstream file(qgetenv("HOPSAN_PERF_WRITE_BASELINE").constData());
+            file << "# Simulation wall time per step divided by the calibration loop time, written by tst_performancetest\n";
+            for (std::map<std::string, double>::const_iterator it=mMeasured.begin(); it!=mMeasured.end(); ++it)
+            {
+                file << it->first << ";" << it->second << "\n";
+            }
+        }
+    }
+
+    void Simulation_Throughput()
+    {
+        QFETCH(QString, model);
+        QFETCH(int, numThreads);
+
+        const std::string modelPath = std::string(MODELS_ROOT)+model.toStdString();
+        double startT, stopT;
+        ComponentSystem *pSystem = mHopsanCore.loadHMFModelFile(modelPath.c_str(), startT, stopT);
+        QVERIFY2(pSystem, qPrintable("Could not load model: "+QString::fromStdString(modelPath)));
+
+        // Only the simulation is timed, initialize is repeated for each run so that every run does the same work
+        double bestTimePerStep = 1e300;
+        double totalTime = 0;
+        for (size_t r=0; (r<maxRepetitions) && ((r < 2) || (totalTime < minMeasureTime)); ++r)
+        {
+            QVERIFY2(pSystem->initialize(startT, stopT), "Failed to initialize model");
+            const ClockT::time_point start = ClockT::now();
+            if (numThreads > 1)
+            {
+                pSystem->simulateMultiThreaded(startT, stopT, size_t(numThreads));
+            }
+            else
+            {
+                pSystem->simulate(stopT);
+            }
+            const double time = secondsSince(start);
+            const size_t nSteps = size_t((stopT-startT)/pSystem->getTimestep()+0.5);
+            pSystem->finalize();
+            QVERIFY2(!pSystem->wasSimulationAborted(), "Simulation was aborted");
+            QVERIFY(nSteps > 0);
+            totalTime += time;
+            bestTimePerStep = std::min(bestTimePerStep, time/double(nSteps));
+        }
+        mHopsanCore.removeComponent(pSystem);
+
+        const std::string key = model.toStdString()+((numThreads > 1) ? "/threads"+std::to_string(numThreads) : "");
+        const double normalised = bestTimePerStep/mCalibrationTime;
+        mMeasured[key] = normalised;
+        qDebug() << qPrintable(QString::fromStdString(key)) << "time per step:" << bestTimePerStep*1e6 << "us, normalised:" << normalised;
+
+        std::map<std::string, double>::const_iterator it = mBaseline.find(key);
+        if (it == mBaseline.end())
+        {
+            if (qEnvironmentVariableIsSet("HOPSAN_PERF_WRITE_BASELINE"))
+            {
+                QSKIP("No baseline value for this model, measured value is written to the new baseline");
+            }
+            QFAIL("No baseline value for this model, add it to performanceBaseline.txt");
+        }
+        const double limit = it->second*(1.0+mTolerance);
+        QVERIFY2(normalised <= limit, qPrintable(QString("Throughput regression: normalised time %1 exceeds baseline %2 + %3%")
+                                                 .arg(normalised).arg(it->second).arg(mTolerance*100)));
+    }
+
+    void Simulation_Throughput_data()
+    {
+        QTest::addColumn<QString>("model");
+        QTest::addColumn<int>("numThreads");
+        QTest::newRow("PistonsValidation") << "Animation Validation/PistonsValidation.hmf" << 1;
+        QTest::newRow("PistonsValidation-threads4") << "Animation Validation/PistonsValidation.hmf" << 4;
+        QTest::newRow("Hydrostatic Transmission") << "Example Models/Hydrostatic Transmission.hmf" << 1;
+        QTest::newRow("Pressure Controlled Pump") << "Example Models/Pressure Controlled Pump.hmf" << 1;
+        QTest::newRow("Hydraulic43ValveTest") << "Component Test/HydraulicComponent Test/Hydraulic43ValveTest.hmf" << 1;
+        QTest::newRow("HydraulicAckumulatorTest") << "Component Test/HydraulicComponent Test/HydraulicAckumulatorTest.hmf" << 1;
+        QTest::newRow("MechanicVehicleTest") << "Component Test/MechanicComponent Test/MechanicVehicleTest.hmf" << 1;
+        QTest::newRow("SignalPIDTest") << "Component Test/SignalComponent Test/Control/SignalPIDTest.hmf" << 1;
+    }
+
+    void FilterBank_Throughput()
+    {
+        QFETCH(QString, filterType);
+        QFETCH(bool, useFilterBanks);
+
+        const size_t numFilters = 1000;
+        const double stopT = 2.0;
+        std::vector<Component*> filters;
+        ComponentSystem *pSystem = createSyntheticFilterModel(mHopsanCore, filterType.toStdString().c_str(), numFilters, filters);
+        QVERIFY(filters.size() == numFilters);
+
+        // Reference results simulated one component at a time
+        pSystem->setFilterBanksEnabled(false);
+        QVERIFY2(pSystem->initialize(0, stopT), "Failed to initialize model");
+        pSystem->simulate(stopT);
+        pSystem->finalize();
+        std::vector<std::vector<double> > reference;
+        for (size_t f=0; f<numFilters; ++f)
+        {
+            reference.push_back(filters[f]->getPort("out")->getLogDataVectorPtr()->back());
+        }
+
+        pSystem->setFilterBanksEnabled(useFilterBanks);
+        double bestTimePerStep = 1e300;
+        double totalTime = 0;
+        for (size_t r=0; (r<maxRepetitions) && ((r < 2) || (totalTime < minMeasureTime)); ++r)
+        {
+            QVERIFY2(pSystem->initialize(0, stopT), "Failed to initialize model");
+            QVERIFY(pSystem->getNumFilterBankComponents() == (useFilterBanks ? numFilters : 0));
+            const ClockT::time_point start = ClockT::now();
+            pSystem->simulate(stopT);
+            const double time = secondsSince(start);
+            const size_t nSteps = size_t(stopT/pSystem->getTimestep()+0.5);
+            pSystem->finalize();
+            totalTime += time;
+            bestTimePerStep = std::min(bestTimePerStep, time/double(nSteps));
+        }
+        for (size_t f=0; f<numFilters; ++f)
+        {
+            QVERIFY2(filters[f]->getPort("out")->getLogDataVectorPtr()->back() == reference[f], "Filter banks changed the simulation results");
+        }
+        mHopsanCore.removeComponent(pSystem);
+
+        const std::string key = "SyntheticFilters-1000/"+filterType.toStdString()+(useFilterBanks ? "/filterbanks" : "");
+        const double normalised = bestTimePerStep/mCalibrationTime;
+        mMeasured[key] = normalised;
+        qDebug() << qPrintable(QString::fromStdString(key)) << "time per step:" << bestTimePerStep*1e6 << "us, normalised:" << normalised;
+
+        std::map<std::string, double>::const_iterator it = mBaseline.find(key);
+        if (it == mBaseline.end())
+        {
+            if (qEnvironmentVariableIsSet("HOPSAN_PERF_WRITE_BASELINE"))
+            {
+                QSKIP("No baseline value for this model, measured value is written to the new baseline");
+            }
+            QFAIL("No baseline value for this model, add it to performanceBaseline.txt");
+        }
+        const double limit = it->second*(1.0+mTolerance);
+        QVERIFY2(normalised <= limit, qPrintable(QString("Throughput regression: normalised time %1 exceeds baseline %2 + %3%")
+                                                 .arg(normalised).arg(it->second).arg(mTolerance*100)));
+    }
+
+    void FilterBank_Throughput_data()
+    {
+        QTest::addColumn<QString>("filterType");
+        QTest::addColumn<bool>("useFilterBanks");
+        QTest::newRow("SignalLP1Filter") << "SignalLP1Filter" << false;
+        QTest::newRow("SignalLP1Filter-filterbanks") << "SignalLP1Filter" << true;
+        QTest::newRow("SignalLP2Filter") << "SignalLP2Filter" << false;
+        QTest::newRow("SignalLP2Filter-filterbanks") << "SignalLP2Filter" << true;
+    }
+};
+
+QTEST_APPLESS_MAIN(PerformanceTests)
+
+#include "tst_performancetest.moc"
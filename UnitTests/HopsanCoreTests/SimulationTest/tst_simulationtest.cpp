@@ -28,6 +28,8 @@
 #include "HopsanCoreVersion.h"
 #include "CoreUtilities/HopsanCoreMessageHandler.h"
 #include "CoreUtilities/HmfLoader.h"
+#include "CoreUtilities/SimulationCheckpoint.h"
+#include "CoreUtilities/SimulationProgress.h"
 
 #include <assert.h>
 #include <algorithm>
@@ -1090,6 +1092,232 @@ private slots:
         QVERIFY2(multiResults3 == singleResults3, "Single-threaded and multi-threaded simulation gave different results!");
     }
 
+    void System_Filter_Banks()
+    {
+        // Two filters that can share a bank, and one with a smaller timestep that must be sub-stepped on its own
+        ComponentSystem *pSystem = mHopsanCore.createComponentSystem();
+        pSystem->setDesiredTimestep(0.001);
+        pSystem->setNumLogSamples(1000);
+        std::vector<Component*> filters;
+        for (size_t i=0; i<3; ++i)
+        {
+            Component *pSource = mHopsanCore.createComponent("SignalSineWave");
+            QVERIFY(pSource);
+            pSystem->addComponent(pSource);
+            Component *pFilter = mHopsanCore.createComponent("SignalLP1Filter");
+            QVERIFY(pFilter);
+            pSystem->addComponent(pFilter);
+            QVERIFY(pFilter->setParameterValue("omega", "100"));
+            QVERIFY(pSystem->connect(pSource->getName(), "out", pFilter->getName(), "in"));
+            filters.push_back(pFilter);
+        }
+        filters[2]->setInheritTimestep(false);
+        filters[2]->setDesiredTimestep(0.0001);
+
+        pSystem->setFilterBanksEnabled(false);
+        QVERIFY(pSystem->initialize(0, 1.0));
+        QCOMPARE(pSystem->getNumFilterBankComponents(), size_t(0));
+        pSystem->simulate(1.0);
+        pSystem->finalize();
+        std::vector<std::vector<std::vector<double>>> referenceResults;
+        for (size_t i=0; i<filters.size(); ++i)
+        {
+            referenceResults.push_back(*filters[i]->getPort("out")->getLogDataVectorPtr());
+        }
+        QVERIFY2(referenceResults[2] != referenceResults[0], "The sub-stepped filter should differ from the other filters");
+
+        pSystem->setFilterBanksEnabled(true);
+        QVERIFY(pSystem->initialize(0, 1.0));
+        QCOMPARE(pSystem->getNumFilterBankComponents(), size_t(2));
+        pSystem->simulate(1.0);
+        pSystem->finalize();
+        for (size_t i=0; i<filters.size(); ++i)
+        {
+            QVERIFY2(*filters[i]->getPort("out")->getLogDataVectorPtr() == referenceResults[i], "Filter banks changed the simulation results!");
+        }
+        mHopsanCore.removeComponent(pSystem);
+    }
+
+    void System_Scheduling_Report()
+    {
+        // Statistics are only measured when enabled
+        QCOMPARE(mpSystemFromFile->getSchedulingSampleInterval(), size_t(0));
+        mpSystemFromFile->setSchedulingSampleInterval(4);
+        QVERIFY(mpSystemFromFile->initialize(0, 10.0));
+        mpSystemFromFile->simulateMultiThreaded(0, 10.0, 2);
+        mpSystemFromFile->finalize();
+
+        const SchedulingReport &rReport = mpSystemFromFile->getSchedulingReport();
+        QVERIFY2(!rReport.isEmpty(), "No scheduling statistics after multi-threaded simulation!");
+        QVERIFY(rReport.getNumSteps() > 0);
+        size_t numComponents = 0;
+        for (size_t t=0; t<rReport.getNumThreads(); ++t)
+        {
+            const SchedulingThreadStatistics &rThread = rReport.getThreadStatistics(t);
+            QCOMPARE(rThread.mNumSteps, rReport.getNumSteps());
+            QCOMPARE(rThread.mNumSampledSteps, (rThread.mNumSteps+3)/4);
+            QVERIFY(rThread.getTotalBusyTime() >= 0);
+            QVERIFY(rThread.getTotalWaitTime() >= 0);
+            numComponents += rThread.mNumComponents[SchedulingSignalPhase]+rThread.mNumComponents[SchedulingCPhase]+rThread.mNumComponents[SchedulingQPhase];
+        }
+        QVERIFY(numComponents > 0);
+        QVERIFY(rReport.getWallTime() > 0);
+        QVERIFY(rReport.getParallelEfficiency() >= 0);
+        QVERIFY(rReport.getLoadImbalance(SchedulingCPhase) >= 1.0);
+        QVERIFY(rReport.toCSV().substr(0, 7) == "thread,");
+
+        // Statistics can be disabled
+        mpSystemFromFile->setSchedulingSampleInterval(0);
+        QVERIFY(mpSystemFromFile->initialize(0, 10.0));
+        mpSystemFromFile->simulateMultiThreaded(0, 10.0, 2);
+        mpSystemFromFile->finalize();
+        QVERIFY(mpSystemFromFile->getSchedulingReport().isEmpty());
+    }
+
+    void System_Checkpoint_Restart()
+    {
+        // A local system with a filter, so that component internal state is part of the checkpoint
+        ComponentSystem *pSystem = mHopsanCore.createComponentSystem();
+        pSystem->setDesiredTimestep(0.001);
+        pSystem->setNumLogSamples(2048);
+        Component *pStep = mHopsanCore.createComponent("SignalStep");
+        Component *pFilter = mHopsanCore.createComponent("SignalLP2Filter");
+        QVERIFY(pStep);
+        QVERIFY(pFilter);
+        pSystem->addComponent(pStep);
+        pSystem->addComponent(pFilter);
+        QVERIFY(pSystem->connect(pStep->getName(), "out", pFilter->getName(), "in"));
+        QVERIFY(pFilter->setParameterValue("omega", "10"));
+
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const HString checkpointFile = QString(tempDir.path()+"/checkpoint.hck").toStdString().c_str();
+
+        QVERIFY(pSystem->initialize(0, 10.0));
+        pSystem->simulate(4.0);
+        QVERIFY(saveCheckpoint(checkpointFile, pSystem));
+        pSystem->simulate(10.0);
+        pSystem->finalize();
+        const std::vector<std::vector<double>> referenceResults = *pFilter->getPort("out")->getLogDataVectorPtr();
+        const std::vector<double> referenceTime = *pSystem->getLogTimeVector();
+
+        QVERIFY(pSystem->initialize(0, 10.0));
+        QVERIFY(restoreCheckpoint(checkpointFile, pSystem));
+        QCOMPARE(pSystem->getTime(), 4.0);
+        pSystem->simulate(10.0);
+        pSystem->finalize();
+
+        QCOMPARE(pSystem->getNumActuallyLoggedSamples(), size_t(2048));
+        QVERIFY2(*pSystem->getLogTimeVector() == referenceTime, "Restarted simulation gave different log time!");
+        QVERIFY2(*pFilter->getPort("out")->getLogDataVectorPtr() == referenceResults, "Restarted simulation gave different results!");
+        mHopsanCore.removeComponent(pSystem);
+    }
+
+    void System_Checkpoint_State_Support()
+    {
+        // Components that keep internal state outside of the nodes must restore it from the checkpoint
+        ComponentSystem *pSystem = mHopsanCore.createComponentSystem();
+        pSystem->setDesiredTimestep(0.001);
+        pSystem->setNumLogSamples(1000);
+        Component *pSource = mHopsanCore.createComponent("SignalSineWave");
+        QVERIFY(pSource);
+        pSystem->addComponent(pSource);
+        std::vector<Component*> components;
+        components.push_back(mHopsanCore.createComponent("SignalHysteresis"));
+        components.push_back(mHopsanCore.createComponent("SignalVariableTimeDelay"));
+        for (size_t i=0; i<components.size(); ++i)
+        {
+            QVERIFY(components[i]);
+            QCOMPARE(components[i]->getStateSupport(), Component::SupportsInternalState);
+            pSystem->addComponent(components[i]);
+            QVERIFY(pSystem->connect(pSource->getName(), "out", components[i]->getName(), "in"));
+        }
+        QVERIFY(components[0]->setParameterValue("y_h#Value", "0.5"));
+        QVERIFY(components[1]->setParameterValue("dT#Value", "0.05"));
+
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const HString checkpointFile = QString(tempDir.path()+"/checkpoint.hck").toStdString().c_str();
+
+        QVERIFY(pSystem->initialize(0, 2.0));
+        pSystem->simulate(0.7);
+        size_t numWarnings = mHopsanCore.getNumWarningMessages();
+        QVERIFY(saveCheckpoint(checkpointFile, pSystem));
+        QCOMPARE(mHopsanCore.getNumWarningMessages(), numWarnings);
+        pSystem->simulate(2.0);
+        pSystem->finalize();
+        std::vector<std::vector<std::vector<double>>> referenceResults;
+        for (size_t i=0; i<components.size(); ++i)
+        {
+            referenceResults.push_back(*components[i]->getPort("out")->getLogDataVectorPtr());
+        }
+
+        QVERIFY(pSystem->initialize(0, 2.0));
+        QVERIFY(restoreCheckpoint(checkpointFile, pSystem));
+        pSystem->simulate(2.0);
+        pSystem->finalize();
+        for (size_t i=0; i<components.size(); ++i)
+        {
+            QVERIFY2(*components[i]->getPort("out")->getLogDataVectorPtr() == referenceResults[i], "Restarted simulation gave different results!");
+        }
+
+        // A component with internal state that is not saved gives a warning
+        Component *pCounter = mHopsanCore.createComponent("SignalCounter");
+        QVERIFY(pCounter);
+        QCOMPARE(pCounter->getStateSupport(), Component::LacksInternalState);
+        pSystem->addComponent(pCounter);
+        QVERIFY(pSystem->connect(pSource->getName(), "out", pCounter->getName(), "in"));
+        QVERIFY(pSystem->initialize(0, 2.0));
+        pSystem->simulate(0.7);
+        numWarnings = mHopsanCore.getNumWarningMessages();
+        QVERIFY(saveCheckpoint(checkpointFile, pSystem));
+        QCOMPARE(mHopsanCore.getNumWarningMessages(), numWarnings+1);
+        pSystem->finalize();
+        mHopsanCore.removeComponent(pSystem);
+    }
+
+    void System_Checkpoint_Write_Failure()
+    {
+        // Checkpoints are written in the background, a failure is reported from the simulation thread
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const HString checkpointFile = QString(tempDir.path()+"/missing/checkpoint.hck").toStdString().c_str();
+        mpSystemFromFile->enableCheckpoints(checkpointFile, 1000);
+        const size_t numErrors = mHopsanCore.getNumErrorMessages();
+        QVERIFY(mpSystemFromFile->initialize(0, 10.0));
+        mpSystemFromFile->simulate(10.0);
+        mpSystemFromFile->finalize();
+        mpSystemFromFile->disableCheckpoints();
+        QVERIFY2(mHopsanCore.getNumErrorMessages() > numErrors, "A failed checkpoint write was not reported!");
+    }
+
+    void System_Progress()
+    {
+        SimulationProgress *pProgress = mpSystemFromFile->getSimulationProgress();
+        std::atomic<int> numCallbacks(0);
+        const bool monitorStarted = pProgress->startMonitor([&numCallbacks](const SimulationProgressMetrics &/*rMetrics*/){ ++numCallbacks; }, 0.01);
+
+        QVERIFY(mpSystemFromFile->initialize(0, 10.0));
+        QCOMPARE(pProgress->getPhase(), SimulationProgress::Initialized);
+        mpSystemFromFile->simulate(10.0);
+        QCOMPARE(pProgress->getPhase(), SimulationProgress::Simulating);
+
+        const SimulationProgressMetrics metrics = pProgress->getMetrics();
+        QCOMPARE(metrics.mSimulationTime, mpSystemFromFile->getTime());
+        QVERIFY(qAbs(metrics.mProgress-1.0) < 1e-9);
+        QCOMPARE(metrics.mNumSteps, metrics.mTotalNumSteps);
+        QCOMPARE(metrics.mNumSteps, size_t(10.0/mpSystemFromFile->getTimestep()+0.5));
+        QVERIFY(metrics.mStepsPerSecond > 0);
+
+        mpSystemFromFile->finalize();
+        QCOMPARE(pProgress->getPhase(), SimulationProgress::Finished);
+        pProgress->stopMonitor();
+        if (monitorStarted)
+        {
+            QVERIFY2(numCallbacks > 0, "The progress callback was never called!");
+        }
+    }
+
     void Component_Set_Parameter()
     {
         QFETCH(QString, compName);
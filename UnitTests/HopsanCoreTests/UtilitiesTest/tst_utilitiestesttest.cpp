@@ -29,6 +29,7 @@
 #include "CoreUtilities/HopsanCoreMessageHandler.h"
 #include "CoreUtilities/StringUtilities.h"
 #include "CoreUtilities/MultiThreadingUtilities.h"
+#include "CoreUtilities/ResultFile.h"
 
 using namespace hopsan;
 
@@ -222,6 +223,100 @@ private Q_SLOTS:
         QTest::newRow("7") << 8;
         QTest::newRow("8") << 9;
     }
+
+    void Result_File_Write_Read()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const HString filePath = QString(tempDir.path()+"/results.hrb").toStdString().c_str();
+
+        const size_t numSamples = 1001;
+        ResultFileWriter writer;
+        const size_t timeIdx = writer.addVariable("Time", "", "s", "Time", numSamples, [](double *pColumn, size_t n) {
+            for (size_t i=0; i<n; ++i) { pColumn[i] = 0.001*i; }
+        });
+        writer.addVariable("Pump#P1#p", "pump_pressure", "Pa", "Pressure", numSamples, [](double *pColumn, size_t n) {
+            for (size_t i=0; i<n; ++i) { pColumn[i] = 1e5+i; }
+        }, int(timeIdx));
+        // Odd length to make sure that the following column is still aligned
+        writer.addVariable("Short#out#y", "", "", "", 3, [](double *pColumn, size_t n) {
+            for (size_t i=0; i<n; ++i) { pColumn[i] = -double(i); }
+        }, int(timeIdx));
+        QVERIFY2(writer.writeToFile(filePath), writer.getErrorString().c_str());
+
+        ResultFileReader reader;
+        QVERIFY2(reader.openFile(filePath), reader.getErrorString().c_str());
+        QCOMPARE(reader.getNumVariables(), size_t(3));
+
+        const int pressureIdx = reader.findVariable("pump_pressure");
+        QCOMPARE(pressureIdx, 1);
+        QCOMPARE(reader.findVariable("Pump#P1#p"), 1);
+        QCOMPARE(reader.findVariable("NoSuchVariable"), -1);
+        const ResultFileVariable *pVariable = reader.getVariable(size_t(pressureIdx));
+        QVERIFY(pVariable->mUnit == "Pa");
+        QVERIFY(pVariable->mQuantity == "Pressure");
+        QCOMPARE(pVariable->mNumSamples, numSamples);
+        QCOMPARE(pVariable->mTimeVariableIndex, int(timeIdx));
+        QVERIFY(reinterpret_cast<size_t>(reader.getVariableData(2)) % sizeof(double) == 0);
+        QCOMPARE(reader.getVariableData(2)[2], -2.0);
+
+        const double *pData = reader.getVariableData(size_t(pressureIdx));
+        QCOMPARE(pData[0], 1e5);
+        QCOMPARE(pData[numSamples-1], 1e5+numSamples-1);
+        QCOMPARE(reader.getTimeData(size_t(pressureIdx))[500], 0.5);
+
+        size_t first, count;
+        QVERIFY(reader.findTimeWindow(size_t(pressureIdx), 0.1, 0.2, first, count));
+        QCOMPARE(first, size_t(100));
+        QCOMPARE(count, size_t(101));
+        std::vector<double> window(count);
+        QCOMPARE(reader.copyVariableData(size_t(pressureIdx), first, count, window.data()), count);
+        QCOMPARE(window.back(), 1e5+200);
+
+        reader.closeFile();
+        QVERIFY(!reader.isOpen());
+        QVERIFY(reader.getVariableData(0) == nullptr);
+        QVERIFY(!reader.openFile(QString(tempDir.path()+"/missing.hrb").toStdString().c_str()));
+    }
+
+    void Result_File_Corrupt_Header()
+    {
+        QFETCH(int, offset);
+        QFETCH(quint64, value);
+
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const QString filePath = tempDir.path()+"/results.hrb";
+        ResultFileWriter writer;
+        writer.addVariable("Time", "", "s", "Time", 101, [](double *pColumn, size_t n) {
+            for (size_t i=0; i<n; ++i) { pColumn[i] = 0.01*i; }
+        });
+        QVERIFY2(writer.writeToFile(filePath.toStdString().c_str()), writer.getErrorString().c_str());
+
+        // Overwrite one of the header fields, or the sample count of the variable, with a bad value
+        QFile file(filePath);
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.seek(offset));
+        QCOMPARE(file.write(reinterpret_cast<const char*>(&value), sizeof(value)), qint64(sizeof(value)));
+        file.close();
+
+        ResultFileReader reader;
+        QVERIFY2(!reader.openFile(filePath.toStdString().c_str()), "A corrupt result file was accepted!");
+        QVERIFY(!reader.getErrorString().empty());
+    }
+
+    void Result_File_Corrupt_Header_data()
+    {
+        QTest::addColumn<int>("offset");
+        QTest::addColumn<quint64>("value");
+
+        // Header: number of variables at 16, variable table offset at 24 and size at 32, the table starts at 64
+        QTest::newRow("table inside header") << 24 << quint64(8);
+        QTest::newRow("table offset overflow") << 24 << quint64(0xFFFFFFFFFFFFFFF0ull);
+        QTest::newRow("table size overflow") << 32 << quint64(0xFFFFFFFFFFFFFFF0ull);
+        QTest::newRow("too many variables") << 16 << quint64(1ull << 60);
+        QTest::newRow("sample count overflow") << 64+8 << quint64(1ull << 61);
+    }
 };
 QTEST_APPLESS_MAIN(UtilitiesTestTest)
 
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Headless test of the GUI log data import parser
+#
+#-------------------------------------------------
+QT       += testlib
+QT       -= gui
+
+#Determine debug extension
+include( ../../Common.prf )
+
+TARGET = tst_logdataimporttest$${DEBUG_EXT}
+CONFIG   += console
+CONFIG   -= app_bundle
+DESTDIR = $${PWD}/../../bin
+
+TEMPLATE = app
+
+INCLUDEPATH += $${PWD}/../../HopsanGUI/Utilities/
+
+QMAKE_CXXFLAGS += -std=c++14
+
+SOURCES += \
+    tst_logdataimporttest.cpp \
+    $${PWD}/../../HopsanGUI/Utilities/LogDataImportParser.cpp
+
+HEADERS += \
+    $${PWD}/../../HopsanGUI/Utilities/LogDataImportParser.h
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,214 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+
+#include <QString>
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <cmath>
+
+#include "LogDataImportParser.h"
+
+class LogDataImportTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    //! @brief Generates a deterministic test value for a given row and column
+    static double testValue(int row, int col)
+    {
+        return (col == 0) ? row*1e-3 : std::sin(row*1e-3*(col+1))*std::pow(10.0, col%7-3);
+    }
+
+    static void writePlo(const QString &rPath, int nRows, int nCols, int precision=17)
+    {
+        QFile file(rPath);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream ts(&file);
+        ts << "    'VERSION'\n    3\n    'test.PLO' 'test.hmf'\n";
+        ts << "    " << nCols << "    " << nRows << "\n";
+        ts << "    'Time'";
+        for (int c=1; c<nCols; ++c)
+        {
+            ts << ",    'Comp.port.x" << c << "'";
+        }
+        ts << "\n   ";
+        for (int c=0; c<nCols; ++c)
+        {
+            ts << " 1";
+        }
+        ts << "\n";
+        ts.setRealNumberNotation(QTextStream::ScientificNotation);
+        ts.setRealNumberPrecision(precision);
+        for (int r=0; r<nRows; ++r)
+        {
+            for (int c=0; c<nCols; ++c)
+            {
+                ts << "    " << testValue(r, c);
+            }
+            ts << "\n";
+        }
+    }
+
+    static void writeHopsanRowCsv(const QString &rPath, int nRows, int nCols)
+    {
+        QFile file(rPath);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream ts(&file);
+        ts.setRealNumberPrecision(17);
+        for (int c=0; c<nCols; ++c)
+        {
+            ts << ((c == 0) ? QString("Time,,s") : QString("Comp.port.x%1,alias%1,m").arg(c));
+            for (int r=0; r<nRows; ++r)
+            {
+                ts << "," << testValue(r, c);
+            }
+            ts << "\n";
+        }
+    }
+
+private Q_SLOTS:
+    void Parse_Double()
+    {
+        QFETCH(QString, text);
+        QFETCH(bool, ok);
+
+        const QByteArray data = text.toLatin1();
+        const char *pPos = data.constData();
+        double value = 0;
+        QCOMPARE(LogDataImportParser::parseDouble(pPos, data.constData()+data.size(), value), ok);
+        if (ok)
+        {
+            QCOMPARE(value, data.toDouble());
+            QVERIFY(pPos == data.constData()+data.size());
+        }
+    }
+
+    void Parse_Double_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<bool>("ok");
+        QTest::newRow("0") << "0" << true;
+        QTest::newRow("1") << "-1.5" << true;
+        QTest::newRow("2") << "+2.25e-3" << true;
+        QTest::newRow("3") << "1.0000000000000002" << true;
+        QTest::newRow("4") << "0.1" << true;
+        QTest::newRow("5") << "-.5E2" << true;
+        QTest::newRow("6") << "1.7976931348623157e308" << true;
+        QTest::newRow("7") << "123456789012345678901234" << true;
+        QTest::newRow("8") << "abc" << false;
+        QTest::newRow("9") << "1.5x" << false;
+        QTest::newRow("10") << "" << false;
+    }
+
+    void Import_Plo()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const QString path = tempDir.path()+"/test.plo";
+        const int nRows = 1000, nCols = 4;
+        writePlo(path, nRows, nCols);
+
+        LogDataImportParser parser;
+        QVERIFY2(parser.parsePlo(path), parser.getErrorString().toStdString().c_str());
+        QCOMPARE(parser.getPloVersion(), 3);
+        QVector<LogDataImportParser::Column> &rColumns = parser.getColumns();
+        QCOMPARE(rColumns.size(), nCols);
+        QCOMPARE(rColumns[0].mName, QString("Time"));
+        QCOMPARE(rColumns[2].mName, QString("Comp.port.x2"));
+        for (int c=0; c<nCols; ++c)
+        {
+            QCOMPARE(rColumns[c].mData.size(), nRows);
+            for (int r=0; r<nRows; ++r)
+            {
+                QCOMPARE(rColumns[c].mData[r], testValue(r, c));
+            }
+        }
+        QCOMPARE(parser.getProgress(), 1.0);
+    }
+
+    void Import_Hopsan_Row_Csv()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const QString path = tempDir.path()+"/test.csv";
+        const int nRows = 1000, nCols = 3;
+        writeHopsanRowCsv(path, nRows, nCols);
+
+        LogDataImportParser parser;
+        QVERIFY2(parser.parseHopsanRowCsv(path), parser.getErrorString().toStdString().c_str());
+        QVector<LogDataImportParser::Column> &rColumns = parser.getColumns();
+        QCOMPARE(rColumns.size(), nCols);
+        QCOMPARE(rColumns[1].mName, QString("Comp.port.x1"));
+        QCOMPARE(rColumns[1].mAlias, QString("alias1"));
+        QCOMPARE(rColumns[1].mUnit, QString("m"));
+        for (int c=0; c<nCols; ++c)
+        {
+            QCOMPARE(rColumns[c].mData.size(), nRows);
+            for (int r=0; r<nRows; ++r)
+            {
+                QCOMPARE(rColumns[c].mData[r], testValue(r, c));
+            }
+        }
+    }
+
+    void Import_Aborted()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const QString path = tempDir.path()+"/test.plo";
+        writePlo(path, 100, 2);
+
+        LogDataImportParser parser;
+        parser.abort();
+        QVERIFY(!parser.parsePlo(path));
+        QVERIFY(parser.wasAborted());
+    }
+
+    void Import_Throughput()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const QString path = tempDir.path()+"/throughput.plo";
+        const int nRows = 200000, nCols = 10;
+        // Same precision as used by PLO export in the GUI
+        writePlo(path, nRows, nCols, 6);
+        const double megaBytes = QFileInfo(path).size()/1e6;
+
+        LogDataImportParser parser;
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(parser.parsePlo(path));
+        const double seconds = qMax(timer.nsecsElapsed()*1e-9, 1e-9);
+        QCOMPARE(parser.getColumns().last().mData.size(), nRows);
+
+        qDebug() << QString("Imported %1 MB PLO in %2 s (%3 MB/s, %4 values/s)").arg(megaBytes, 0, 'f', 1).arg(seconds, 0, 'f', 3)
+                    .arg(megaBytes/seconds, 0, 'f', 1).arg(double(nRows)*nCols/seconds, 0, 'g', 3);
+    }
+};
+
+QTEST_APPLESS_MAIN(LogDataImportTest)
+
+#include "tst_logdataimporttest.moc"
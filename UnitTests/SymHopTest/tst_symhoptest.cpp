@@ -24,6 +24,8 @@
 
 #include <QtTest>
 #include "SymHop.h"
+#include "ExpressionDag.h"
+#include "CompiledExpression.h"
 
 using namespace SymHop;
 
@@ -927,6 +929,142 @@ private Q_SLOTS:
         QTest::newRow("1") << "5*(3-1))" << false;
         QTest::newRow("2") << "" << false;
     }
+
+    void SymHop_Block_Lower_Triangular_Form()
+    {
+        //Equations: e0(x0), e1(x0,x1), e2(x1,x2,x3), e3(x2,x3), e4(x2,x3,x4)
+        QList<QList<int> > dependencies;
+        dependencies << (QList<int>() << 0) << (QList<int>() << 0 << 1) << (QList<int>() << 1 << 2 << 3) << (QList<int>() << 2 << 3) << (QList<int>() << 2 << 3 << 4);
+        QList<int> matching;
+        QVERIFY2(findMatching(dependencies, 5, matching), "Failure! Could not find a matching.");
+        for(int e=0; e<dependencies.size(); ++e) {
+            QVERIFY2(dependencies[e].contains(matching[e]) && matching.count(matching[e]) == 1, "Failure! Invalid matching.");
+        }
+
+        QList<QList<int> > blocks;
+        findBlockLowerTriangularForm(dependencies, matching, blocks);
+        QVERIFY2(blocks.size() == 4, "Failure! Wrong number of blocks.");
+        QVERIFY2(blocks[0] == QList<int>() << 0 && blocks[1] == QList<int>() << 1 && blocks[3] == QList<int>() << 4, "Failure! Wrong block order.");
+        QVERIFY2(blocks[2].size() == 2 && blocks[2].contains(2) && blocks[2].contains(3), "Failure! Algebraic loop not found.");
+
+        //Structurally singular system
+        QList<QList<int> > singular;
+        singular << (QList<int>() << 0) << (QList<int>() << 0);
+        QVERIFY2(!findMatching(singular, 2, matching), "Failure! Singular system was not detected.");
+    }
+
+    void SymHop_Tear_Block()
+    {
+        //A loop of four equations, e(i) uses x(i) and x(i-1), tearing one variable makes the rest explicit
+        QList<QList<int> > dependencies;
+        dependencies << (QList<int>() << 0 << 3) << (QList<int>() << 1 << 0) << (QList<int>() << 2 << 1) << (QList<int>() << 3 << 2);
+        QList<int> matching = QList<int>() << 0 << 1 << 2 << 3;
+        QList<int> block = QList<int>() << 0 << 1 << 2 << 3;
+        QList<int> residuals, explicitEquations;
+        tearBlock(dependencies, matching, block, block, residuals, explicitEquations);
+        QVERIFY2(residuals.size() == 1, "Failure! Wrong number of tearing variables.");
+        QVERIFY2(explicitEquations.size() == 3, "Failure! Wrong number of explicit equations.");
+        for(int i=1; i<explicitEquations.size(); ++i) {
+            QVERIFY2(explicitEquations[i] == (explicitEquations[i-1]+1)%4, "Failure! Explicit equations are not in evaluation order.");
+        }
+
+        //Equations that can not be solved explicitly are always residuals
+        tearBlock(dependencies, matching, block, QList<int>() << 0 << 1 << 3, residuals, explicitEquations);
+        QVERIFY2(residuals == QList<int>() << 2, "Failure! Non-solvable equation was not used as residual.");
+        QVERIFY2(explicitEquations == QList<int>() << 3 << 0 << 1, "Failure! Wrong explicit equation order.");
+    }
+
+    void SymHop_Dag_Derivative()
+    {
+        QFETCH(Expression, expr);
+        QFETCH(Expression, der);
+
+        //The graph derivative shall have the same value as the expression derivative
+        QMap<QString, double> variables;
+        variables.insert("x", 0.7);
+        variables.insert("y", 1.3);
+        bool ok1, ok2, ok3, ok4;
+        ExpressionDag dag;
+        double value1 = expr.derivative(der, ok1).evaluate(variables, 0, &ok3);
+        double value2 = dag.derivative(expr, der, ok2).evaluate(variables, 0, &ok4);
+        QVERIFY2(ok1 && ok2 && ok3 && ok4 && fuzzyEqual(value2, value1), "Failure! ExpressionDag::derivative() did something wrong.");
+    }
+
+    void SymHop_Dag_Derivative_data()
+    {
+        QTest::addColumn<Expression>("expr");
+        QTest::addColumn<Expression>("der");
+        QTest::newRow("0") << Expression("x*y+sin(x^2)/y") << Expression("x");
+        QTest::newRow("1") << Expression("limit(x*y,0,1)*exp(x)+limit(x*y,0,1)") << Expression("x");
+        QTest::newRow("2") << Expression("cos(x*y)/(1+x)") << Expression("x");
+        QTest::newRow("3") << Expression("-sin(x)*x^3") << Expression("x");
+        QTest::newRow("4") << Expression("x^y") << Expression("y");
+        QTest::newRow("5") << Expression("log(x)/y-atan2(x,y)") << Expression("y");
+    }
+
+    void SymHop_Dag_Common_Subexpressions()
+    {
+        ExpressionDag dag;
+        QList<int> roots;
+        roots << dag.fromExpression(Expression("limit(x*y,0,1)*a+b"));
+        roots << dag.fromExpression(Expression("limit(x*y,0,1)*c-sin(x*y)"));
+        roots << dag.fromExpression(Expression("sin(x*y)*x"));
+        QVERIFY2(dag.fromExpression(Expression("b+a*limit(y*x,0,1)")) == roots[0], "Failure! Equal expressions are not shared.");
+
+        QStringList rootStrings;
+        QStringList temporaries = dag.eliminateCommonSubexpressions(roots, "tmp", rootStrings);
+        QVERIFY2(temporaries.size() == 3, "Failure! Wrong number of common subexpressions.");
+        QVERIFY2(temporaries[0] == "tmp0 = x*y", "Failure! Wrong common subexpression.");
+        QVERIFY2(rootStrings.size() == 3 && Expression(rootStrings[1]) == Expression("tmp1*c-tmp2"), "Failure! Common subexpressions were not replaced.");
+    }
+
+    void SymHop_Compiled_Evaluate()
+    {
+        QFETCH(Expression, expr);
+
+        //The compiled expression shall give the same value as evaluate(), also element-wise
+        CompiledExpression compiled(expr);
+        QVERIFY2(compiled.isValid(), "Failure! Expression could not be compiled.");
+
+        QMap<QString, double> variables;
+        variables.insert("x", 0.7);
+        variables.insert("y", 1.3);
+        variables.insert("z", -2.1);
+        QVector<double> values;
+        for(int v=0; v<compiled.getVariables().size(); ++v) {
+            values.append(variables.value(compiled.getVariables()[v]));
+        }
+        bool ok;
+        double value = expr.evaluate(variables, 0, &ok);
+        QVERIFY2(ok && fuzzyEqual(compiled.evaluate(values.data()), value), "Failure! CompiledExpression::evaluate() did something wrong.");
+
+        const int n = 1000;
+        QVector<double> x(n), result(n);
+        QVector<const double*> pointers;
+        QVector<bool> isVector;
+        for(int i=0; i<n; ++i) {
+            x[i] = 0.5+0.001*i;
+        }
+        for(int v=0; v<compiled.getVariables().size(); ++v) {
+            isVector.append(compiled.getVariables()[v] == "x");
+            pointers.append(isVector[v] ? x.data() : values.data()+v);
+        }
+        compiled.evaluate(pointers.data(), isVector.data(), result.data(), n);
+        variables.insert("x", x[n-1]);
+        value = expr.evaluate(variables, 0, &ok);
+        QVERIFY2(ok && fuzzyEqual(result[n-1], value), "Failure! Element-wise CompiledExpression::evaluate() did something wrong.");
+    }
+
+    void SymHop_Compiled_Evaluate_data()
+    {
+        QTest::addColumn<Expression>("expr");
+        QTest::newRow("0") << Expression("x*y+sin(x^2)/y");
+        QTest::newRow("1") << Expression("limit(x*y,0,1)*exp(x)+limit(x*y,0,1)");
+        QTest::newRow("2") << Expression("-sin(x)*x^3-y-2*z");
+        QTest::newRow("3") << Expression("log(x)/y-atan2(x,y)+x^y");
+        QTest::newRow("4") << Expression("greaterThan(x,y)+max(x,y)*r2d(x)");
+        QTest::newRow("5") << Expression("abs(x-y)/(x*y*z)+sqrt(x)");
+    }
 };
 
 QTEST_APPLESS_MAIN(SymHopTests)
@@ -39,6 +39,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
 
     }
 
@@ -241,6 +242,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
         addConstant("path", "Path to functional mockup unit (FMU)", mFmuPath);
         addConstant("reinstantiate", "Create a new FMU instance for every simulation", "", mReinstantiate, mReinstantiate);
         setReconfigurationParameter("path");
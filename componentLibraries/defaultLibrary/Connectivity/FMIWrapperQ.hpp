@@ -41,6 +41,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
 
     }
 
@@ -245,6 +246,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
         addConstant("path", "Path to functional mockup unit (FMU)", mFmuPath);
         addConstant("portspecs", "Port specifications", "", mPortSpecs);
         addConstant("reinstantiate", "Create a new FMU instance for every simulation", "", mReinstantiate, mReinstantiate);
@@ -116,6 +116,7 @@ public:
 
      void configure()
      {
+        setStateSupport(LacksInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -99,6 +99,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -206,6 +207,20 @@ public:
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(cel1);
+        rWriter.writeDouble(cel2);
+        rWriter.writeDouble(Zcel1);
+        rWriter.writeDouble(Zcel2);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        return rReader.readDouble(cel1) && rReader.readDouble(cel2) && rReader.readDouble(Zcel1) && rReader.readDouble(Zcel2);
+    }
+
     void deconfigure()
     {
         delete mpSolver;
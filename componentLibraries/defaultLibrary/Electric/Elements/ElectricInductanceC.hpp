@@ -102,6 +102,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -222,6 +223,20 @@ s)/V",0.,&mpCp);
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(cel1);
+        rWriter.writeDouble(cel2);
+        rWriter.writeDouble(Zcel1);
+        rWriter.writeDouble(Zcel2);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        return rReader.readDouble(cel1) && rReader.readDouble(cel2) && rReader.readDouble(Zcel1) && rReader.readDouble(Zcel2);
+    }
+
     void deconfigure()
     {
         delete mpSolver;
@@ -82,6 +82,8 @@ class HydraulicCylinderC : public ComponentC
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
+
             // Set member variables
             mWfak = 0.1;
             mAlpha = 0.1;
@@ -349,6 +351,19 @@ class HydraulicCylinderC : public ComponentC
             (*mpQLeak) = qLeak;
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(ci1);
+            rWriter.writeDouble(cl1);
+            rWriter.writeDouble(ci2);
+            rWriter.writeDouble(cl2);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return rReader.readDouble(ci1) && rReader.readDouble(cl1) && rReader.readDouble(ci2) && rReader.readDouble(cl2);
+        }
+
 
         //This function was translated from old HOPSAN using F2C. A few manual adjustments were necessary.
 
@@ -85,6 +85,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
             mpP3 = addPowerPort("P3", "NodeMechanic");
@@ -255,6 +256,19 @@ namespace hopsan {
             (*mpP3_x) = x3;
             (*mpP3_v) = v3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mPositionTF.saveState(rWriter);
+            mVelocityTF.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mPositionTF.restoreState(rReader);
+            ok = ok && mVelocityTF.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
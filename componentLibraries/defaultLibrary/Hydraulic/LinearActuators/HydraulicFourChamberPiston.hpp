@@ -72,6 +72,8 @@ class HydraulicFourChamberPiston : public ComponentC
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
+
             //Set member attributes
             wfak = 0.1;
             alpha = 0.1;
@@ -451,6 +453,27 @@ class HydraulicFourChamberPiston : public ComponentC
             (*mpZx5) = Zx5;
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(CxLim);
+            rWriter.writeDouble(ci1);
+            rWriter.writeDouble(ci2);
+            rWriter.writeDouble(ci3);
+            rWriter.writeDouble(ci4);
+            rWriter.writeDouble(cl1);
+            rWriter.writeDouble(cl2);
+            rWriter.writeDouble(cl3);
+            rWriter.writeDouble(cl4);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = rReader.readDouble(CxLim);
+            ok = ok && rReader.readDouble(ci1) && rReader.readDouble(ci2) && rReader.readDouble(ci3) && rReader.readDouble(ci4);
+            ok = ok && rReader.readDouble(cl1) && rReader.readDouble(cl2) && rReader.readDouble(cl3) && rReader.readDouble(cl4);
+            return ok;
+        }
+
         /* ---------------------------------------------------------------- */
         /*     Function that simulate the end of the stroke. If X is        */
         /*     smaller than 0 or greater than SL a large spring force will  */
@@ -72,6 +72,8 @@ class HydraulicSpringLoadedPistonC : public ComponentC
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
+
             //Set member attributes
             wfak = 0.1;
             alpha = 0.1;
@@ -318,6 +320,19 @@ class HydraulicSpringLoadedPistonC : public ComponentC
             (*mpc3) = c3-Fs;
             (*mpZx3) = Zx3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(ci1);
+            rWriter.writeDouble(cl1);
+            rWriter.writeDouble(ci2);
+            rWriter.writeDouble(cl2);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return rReader.readDouble(ci1) && rReader.readDouble(cl1) && rReader.readDouble(ci2) && rReader.readDouble(cl2);
+        }
         
         void limitStroke(double &CxLim, double &ZxLim, double x3, double v3, double me, double sl)
         {
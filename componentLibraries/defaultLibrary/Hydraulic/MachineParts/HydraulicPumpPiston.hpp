@@ -68,6 +68,8 @@ class HydraulicPumpPiston : public ComponentC
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
+
             //Set member attributes
             wfak = 0.1;
             alpha = 0.1;
@@ -200,6 +202,17 @@ class HydraulicPumpPiston : public ComponentC
             (*mpP3_c) = c3;
             (*mpP3_Zx) = Zx3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(ci1);
+            rWriter.writeDouble(cl1);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return rReader.readDouble(ci1) && rReader.readDouble(cl1);
+        }
     };
 }
 
@@ -73,6 +73,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Register changeable parameters to the HOPSAN++ core
             addInputVariable("phi_P", "Length of grooves", "deg", 160, &mpPhiP);
             addInputVariable("phi_1", "Length of first pre-compression chamber", "deg", 6, &mpPhi1);
@@ -221,6 +222,16 @@ namespace hopsan {
             (*mpND_qb) = qb;
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
+
 
 //        double groove(double x, double start, double sep, double dAlpha, double precL1, double precW1, double precL2, double precW2)
 //        {
@@ -74,6 +74,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("B", "Viscous Friction", "Nms/rad", 10.0, &mpB);
             addInputVariable("r", "Swivel Radius", "m", 0.05, &mpR);
             addInputVariable("theta_offset", "Angle Offset", "m", 0.0, &mpOffset);
@@ -224,6 +225,21 @@ namespace hopsan {
             (*mpND_a2) = a2;
             (*mpND_w2) = w2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterX.saveState(rWriter);
+            mFilterV.saveState(rWriter);
+            rWriter.writeDouble(a2);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilterX.restoreState(rReader);
+            ok = ok && mFilterV.restoreState(rReader);
+            ok = ok && rReader.readDouble(a2);
+            return ok;
+        }
     };
 }
 
@@ -68,6 +68,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Register changeable parameters to the HOPSAN++ core
             addInputVariable("r", "Swivel Radius", "m", 0.05, &mpR);
             addInputVariable("theta_offset", "Angle Offset", "m", 0.0, &mpOffset);
@@ -161,6 +162,16 @@ namespace hopsan {
                 (*mvpND_v1[i]) = v1[i];
             }
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
@@ -65,6 +65,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("D_m", "Displacement", "m^3/rev", 0.00005, &mpDm);
             addInputVariable("B_m", "Viscous friction", "Nm/rad", 0.0, &mpBm);
             addInputVariable("C_lm", "Leakage coefficient", "LeakageCoefficient", 1e-12, &mpClm);
@@ -159,6 +160,16 @@ namespace hopsan {
             (*mpND_a3) = a3;
             (*mpND_w3) = w3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
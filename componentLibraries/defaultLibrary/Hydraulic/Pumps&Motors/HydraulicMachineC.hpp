@@ -69,6 +69,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
             mpP3 = addPowerPort("P3", "NodeMechanicRotational");
@@ -272,6 +273,30 @@ namespace hopsan {
             (*mpND_c3) = c3;
             (*mpND_Zx3) = Zx3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(cp1);
+            rWriter.writeDouble(cp2);
+            mDelayedC1.saveState(rWriter);
+            mDelayedC2.saveState(rWriter);
+            mDelayedCp1.saveState(rWriter);
+            mDelayedCp2.saveState(rWriter);
+            mDelayedCp1e.saveState(rWriter);
+            mDelayedCp2e.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = rReader.readDouble(cp1) && rReader.readDouble(cp2);
+            ok = ok && mDelayedC1.restoreState(rReader);
+            ok = ok && mDelayedC2.restoreState(rReader);
+            ok = ok && mDelayedCp1.restoreState(rReader);
+            ok = ok && mDelayedCp2.restoreState(rReader);
+            ok = ok && mDelayedCp1e.restoreState(rReader);
+            ok = ok && mDelayedCp2e.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
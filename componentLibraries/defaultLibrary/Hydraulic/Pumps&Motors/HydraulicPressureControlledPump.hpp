@@ -65,6 +65,8 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
+
             pnom = 7e6;
             movementnom = 125;
 
@@ -221,6 +223,19 @@ namespace hopsan {
             (*mpA) += movement*mTimestep;
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            rWriter.writeDouble(y1);
+            rWriter.writeDouble(u1);
+            rWriter.writeDouble(yd);
+            rWriter.writeDouble(ud);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return rReader.readDouble(y1) && rReader.readDouble(u1) && rReader.readDouble(yd) && rReader.readDouble(ud);
+        }
+
 
         //High pass filter times an integration, with separate minimum and maximum values for input and output variables. Converted from old Hopsan.
 
@@ -63,6 +63,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
             mpP3 = addPowerPort("P3", "NodeMechanicRotational");
@@ -159,6 +160,16 @@ namespace hopsan {
             (*mpND_a3) = a3;
             (*mpND_w3) = w3;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
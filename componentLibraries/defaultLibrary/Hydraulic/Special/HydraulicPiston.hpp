@@ -143,6 +143,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -332,6 +333,26 @@ NodeMechanic::EquivalentMass);
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(c1f);
+        rWriter.writeDouble(cp1f);
+        rWriter.writeDouble(c2f);
+        rWriter.writeDouble(cp2f);
+        rWriter.writeDouble(c1);
+        rWriter.writeDouble(cp1);
+        rWriter.writeDouble(c2);
+        rWriter.writeDouble(cp2);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = rReader.readDouble(c1f) && rReader.readDouble(cp1f) && rReader.readDouble(c2f) && rReader.readDouble(cp2f);
+        ok = ok && rReader.readDouble(c1) && rReader.readDouble(cp1) && rReader.readDouble(c2) && rReader.readDouble(cp2);
+        return ok;
+    }
+
     void deconfigure()
     {
         delete mpSolver;
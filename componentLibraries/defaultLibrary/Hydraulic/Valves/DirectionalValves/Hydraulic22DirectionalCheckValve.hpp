@@ -62,6 +62,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Register constant parameters
             addConstant("omega_h", "Resonance Frequency", "Frequency", 100, mOmega_h);
             addConstant("delta_h", "Damping Factor", "-", 1, mDelta_h);
@@ -202,6 +203,16 @@ namespace hopsan {
             (*mpP2_p) = P2_p;
             (*mpOut) = outnom;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mValveSpoolPosFilter.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mValveSpoolPosFilter.restoreState(rReader);
+        }
     };
 }
 
@@ -68,6 +68,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
 
@@ -188,6 +189,16 @@ namespace hopsan {
             (*mpP2_q) = q2;
             (*mpOut_xv) = xnom;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mValveSpoolPosFilter.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mValveSpoolPosFilter.restoreState(rReader);
+        }
     };
 }
 
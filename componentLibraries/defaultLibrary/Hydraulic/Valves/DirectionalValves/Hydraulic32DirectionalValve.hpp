@@ -67,6 +67,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpPP = addPowerPort("PP", "NodeHydraulic");
             mpPT = addPowerPort("PT", "NodeHydraulic");
             mpPA = addPowerPort("PA", "NodeHydraulic");
@@ -216,6 +217,16 @@ namespace hopsan {
             (*mpPT_q) = qt;
             (*mpXv) = xv;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mSpoolPosTF.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mSpoolPosTF.restoreState(rReader);
+        }
     };
 }
 
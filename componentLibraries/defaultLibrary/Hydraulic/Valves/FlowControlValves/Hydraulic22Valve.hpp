@@ -68,6 +68,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpPP = addPowerPort("PP", "NodeHydraulic");
             mpPA = addPowerPort("PA", "NodeHydraulic");
 
@@ -186,6 +187,16 @@ namespace hopsan {
             (*mpPA_q) = qa;
             (*mpOut_xv) = xv;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            filter.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return filter.restoreState(rReader);
+        }
     };
 }
 
@@ -70,6 +70,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpAN = addPowerPort("PN", "NodeHydraulic");
             mpAS = addPowerPort("PS", "NodeHydraulic");
             mpAC = addPowerPort("PC", "NodeHydraulic");
@@ -209,6 +210,16 @@ namespace hopsan {
             (*mpAC_q) = qAC;
             (*mpXvout) = xIntegrator.value();
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            xIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return xIntegrator.restoreState(rReader);
+        }
     };
 }
 
@@ -69,6 +69,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpPP = addPowerPort("PP", "NodeHydraulic");
             mpPT = addPowerPort("PT", "NodeHydraulic");
             mpPA = addPowerPort("PA", "NodeHydraulic");
@@ -215,6 +216,16 @@ namespace hopsan {
             (*mpPT_q) = qt;
             (*mpXvout) = xv;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            xIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return xIntegrator.restoreState(rReader);
+        }
     };
 }
 
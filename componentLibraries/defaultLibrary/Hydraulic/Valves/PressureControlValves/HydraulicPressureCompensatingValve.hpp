@@ -71,6 +71,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
             mpPOpen = addPowerPort("P_OPEN", "NodeHydraulic");
@@ -192,6 +193,19 @@ namespace hopsan {
             (*mpPClose_p) = p_close;
             (*mpXv) = x0;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterLP.saveState(rWriter);
+            rWriter.writeDouble(mPrevX0);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilterLP.restoreState(rReader);
+            ok = ok && rReader.readDouble(mPrevX0);
+            return ok;
+        }
     };
 }
 
@@ -77,6 +77,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Register constant parameters
             addConstant("omega_h", "Resonance frequency", "Frequency", 100, mOmega_h);
             addConstant("delta_h", "Damping factor", "-", 1, mDelta_h);
@@ -274,6 +275,16 @@ namespace hopsan {
             (*mpPC_q) = qc;
             (*mpX_v) = xv;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mSpoolPosTF.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mSpoolPosTF.restoreState(rReader);
+        }
     };
 }
 
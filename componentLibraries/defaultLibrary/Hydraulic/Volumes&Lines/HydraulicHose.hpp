@@ -77,6 +77,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(LacksInternalState);
             //Add ports to the component
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
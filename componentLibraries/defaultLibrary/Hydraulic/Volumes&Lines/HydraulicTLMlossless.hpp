@@ -48,6 +48,7 @@ namespace hopsan {
 
     private:
         double mTimeDelay;
+        int mInterpolation;
         double *mpAlpha, *mpZc;
 
         double *mpP1_p, *mpP1_q, *mpP1_c, *mpP1_Zc, *mpP2_p, *mpP2_q, *mpP2_c, *mpP2_Zc;
@@ -64,6 +65,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeHydraulic");
             mpP2 = addPowerPort("P2", "NodeHydraulic");
 
@@ -72,6 +74,12 @@ namespace hopsan {
 
             addConstant("deltat", "Time delay", "s",   0.1, mTimeDelay);
 
+            std::vector<HString> interpolationMethods;
+            interpolationMethods.push_back("Round to time step");
+            interpolationMethods.push_back("Linear interpolation");
+            interpolationMethods.push_back("Lagrange interpolation");
+            addConditionalConstant("interpolation", "Interpolation of time delays that are not a multiple of the time step", interpolationMethods, 0, mInterpolation);
+
             disableStartValue(mpP1, NodeHydraulic::WaveVariable);
             disableStartValue(mpP1, NodeHydraulic::CharImpedance);
             disableStartValue(mpP2, NodeHydraulic::WaveVariable);
@@ -112,9 +120,9 @@ namespace hopsan {
 
             // Initialize delay
             // We use -Ts to make the delay one step shorter as the TLM already have one built in time step delay
-            //! @todo for Td=Ts the delay will actually be 2Ts (the delay and inherited) need if check to avoid using delays if Td=Ts
-            mDelayedC1.initialize(mTimeDelay-mTimestep, mTimestep, (*mpP1_c));
-            mDelayedC2.initialize(mTimeDelay-mTimestep, mTimestep, (*mpP2_c));
+            //! @todo for Td=Ts the delay will actually be 2Ts (the delay and inherited) need if check to avoid using delays if Td=Ts, or use interpolation
+            mDelayedC1.initialize(mTimeDelay-mTimestep, mTimestep, (*mpP1_c), Delay::InterpolationEnumT(mInterpolation));
+            mDelayedC2.initialize(mTimeDelay-mTimestep, mTimestep, (*mpP2_c), Delay::InterpolationEnumT(mInterpolation));
         }
 
 
@@ -146,6 +154,30 @@ namespace hopsan {
             (*mpP2_Zc) = Zc;
 
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mDelayedC1.saveState(rWriter);
+            mDelayedC2.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mDelayedC1.restoreState(rReader) &&
+                   mDelayedC2.restoreState(rReader);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double timestep) const
+        {
+            if (rReport.isEstimate())
+            {
+                rReport.addComponentData(2*Delay::estimateMemoryUsage(mTimeDelay-timestep, timestep, Delay::InterpolationEnumT(mInterpolation)));
+            }
+            else
+            {
+                rReport.addComponentData(mDelayedC1.getMemoryUsage()+mDelayedC2.getMemoryUsage());
+            }
+        }
     };
 }
 
@@ -63,6 +63,7 @@ public:
 
     void configure()
     {
+        setStateSupport(SupportsInternalState);
         //Add ports to the component
         mpP1 = addPowerPort("Pm1", "NodeMechanic");
         addInputVariable("B", "Viscous Friction", "Ns/m", 0.001, &mpB); // B, Must not be zero - velocity will become very oscillatory
@@ -140,6 +141,19 @@ public:
         (*mpP1_x) = x1;
         (*mpP1_v) = v1;
     }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        mFilterX.saveState(rWriter);
+        mFilterV.saveState(rWriter);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = mFilterX.restoreState(rReader);
+        ok = ok && mFilterV.restoreState(rReader);
+        return ok;
+    }
 };
 }
 
@@ -63,6 +63,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Add ports to the component
             mpP1 = addPowerMultiPort("P1", "NodeMechanic");
             mpP2 = addPowerMultiPort("P2", "NodeMechanic");
@@ -233,6 +234,16 @@ namespace hopsan {
                 (*mvpP2_me[i]) = m;
             }
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
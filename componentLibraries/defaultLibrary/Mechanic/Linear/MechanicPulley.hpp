@@ -70,6 +70,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Add ports to the component
             mpP1 = addPowerPort("P1", "NodeMechanic");
             mpP2 = addPowerPort("P2", "NodeMechanic");
@@ -153,6 +154,19 @@ namespace hopsan {
             (*mpND_x2) = x2;
             (*mpND_v2) = v2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterTheta.saveState(rWriter);
+            mFilterOmega.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilterTheta.restoreState(rReader);
+            ok = ok && mFilterOmega.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
@@ -111,6 +111,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -249,6 +250,20 @@ public:
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(cm1f);
+        rWriter.writeDouble(cm2f);
+        rWriter.writeDouble(cm1);
+        rWriter.writeDouble(cm2);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        return rReader.readDouble(cm1f) && rReader.readDouble(cm2f) && rReader.readDouble(cm1) && rReader.readDouble(cm2);
+    }
+
     void deconfigure()
     {
         delete mpSolver;
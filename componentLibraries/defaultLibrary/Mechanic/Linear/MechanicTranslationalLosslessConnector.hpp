@@ -63,6 +63,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Set member attributes
 
             //Add ports to the component
@@ -128,6 +129,16 @@ namespace hopsan {
             (*mpP2_x) = x2;
             (*mpP2_v) = v2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mInt.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mInt.restoreState(rReader);
+        }
     };
 }
 
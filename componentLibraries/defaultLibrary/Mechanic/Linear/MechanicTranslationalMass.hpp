@@ -69,6 +69,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Add ports to the component
             mpP1 = addPowerPort("P1", "NodeMechanic");
             mpP2 = addPowerPort("P2", "NodeMechanic");
@@ -189,6 +190,18 @@ namespace hopsan {
             (*mpP1_me) = mMass;
             (*mpP2_me) = mMass;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterX.saveState(rWriter);
+            mFilterV.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mFilterX.restoreState(rReader) &&
+                   mFilterV.restoreState(rReader);
+        }
     };
 }
 
@@ -67,6 +67,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //! @todo set eqmass to some good values, should consider lever.
 
             //Set member attributes
@@ -155,6 +156,16 @@ namespace hopsan {
             (*mpND_v2) = v2;
             (*mpND_me2) = m;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
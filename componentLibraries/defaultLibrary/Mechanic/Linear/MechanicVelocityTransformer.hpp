@@ -55,6 +55,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Add ports to the component
             mpPm1 = addPowerPort("Pm1", "NodeMechanic");
 
@@ -119,6 +120,16 @@ namespace hopsan {
             (*mpPm1_x) = x;
             (*mpPm1_v) = v;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mInt.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mInt.restoreState(rReader);
+        }
     };
 }
 
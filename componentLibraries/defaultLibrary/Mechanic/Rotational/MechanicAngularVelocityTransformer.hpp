@@ -60,6 +60,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpOut = addPowerPort("out", "NodeMechanicRotational");
             addInputVariable("omega", "Generated angular velocity", "AngularVelocity", 0.0, &mpW);
         }
@@ -94,6 +95,16 @@ namespace hopsan {
             (*mpOut_a) = a;
             (*mpOut_w) = w;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mInt.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mInt.restoreState(rReader);
+        }
     };
 }
 
@@ -111,6 +111,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -254,6 +255,20 @@ alpha)*gearRatio);
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(cmr1f);
+        rWriter.writeDouble(cmr2f);
+        rWriter.writeDouble(cmr1);
+        rWriter.writeDouble(cmr2);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        return rReader.readDouble(cmr1f) && rReader.readDouble(cmr2f) && rReader.readDouble(cmr1) && rReader.readDouble(cmr2);
+    }
+
     void deconfigure()
     {
         delete mpSolver;
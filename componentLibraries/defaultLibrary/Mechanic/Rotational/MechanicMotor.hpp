@@ -65,6 +65,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("omega_ref", "Desired Angular Velocity", "-", 0.0, &mpWref);
             addInputVariable("K_p", "Proportional Controller Gain", "-", 10.0, &mpKp);
             addInputVariable("K_i", "Integrating Controller Gain", "-", 100.0, &mpKi);
@@ -123,6 +124,19 @@ namespace hopsan {
             (*mpND_c1) = c1;
             (*mpND_Zc1) = Zc1;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+            mDerivator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mIntegrator.restoreState(rReader);
+            ok = ok && mDerivator.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
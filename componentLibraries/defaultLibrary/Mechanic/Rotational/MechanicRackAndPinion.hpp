@@ -66,6 +66,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeMechanic");
             mpP2 = addPowerPort("P2", "NodeMechanicRotational");
 
@@ -148,6 +149,19 @@ namespace hopsan {
             (*mpND_a2) = a2;
             (*mpND_w2) = w2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilter.saveState(rWriter);
+            mInt.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilter.restoreState(rReader);
+            ok = ok && mInt.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
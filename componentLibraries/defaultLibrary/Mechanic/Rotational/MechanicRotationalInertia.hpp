@@ -64,6 +64,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeMechanicRotational");
             mpP2 = addPowerPort("P2", "NodeMechanicRotational");
             addConstant("J", "Moment of Inertia", "MomentOfInertia", 0.1, J);
@@ -162,6 +163,18 @@ namespace hopsan {
             (*mpND_a2) = a2;
             (*mpND_w2) = w2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterX.saveState(rWriter);
+            mFilterV.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mFilterX.restoreState(rReader) &&
+                   mFilterV.restoreState(rReader);
+        }
     };
 }
 
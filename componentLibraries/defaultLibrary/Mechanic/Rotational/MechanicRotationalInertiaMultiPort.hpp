@@ -61,6 +61,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             //Add ports to the component
             mpP1 = addPowerMultiPort("P1", "NodeMechanicRotational");
             mpP2 = addPowerMultiPort("P2", "NodeMechanicRotational");
@@ -271,6 +272,16 @@ namespace hopsan {
                 (*mvpN_me2[i]) = J;
             }
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
@@ -75,6 +75,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpP1 = addPowerPort("P1", "NodeMechanicRotational");
             mpP2 = addPowerPort("P2", "NodeMechanicRotational");
             addInputVariable("omega", "Gear ratio", "-", 1.0, &mpGearRatio);
@@ -156,6 +157,19 @@ namespace hopsan {
             (*mpP2_a) = a2;
             (*mpP2_w) = w2;
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterTheta.saveState(rWriter);
+            mFilterOmega.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilterTheta.restoreState(rReader);
+            ok = ok && mFilterOmega.restoreState(rReader);
+            return ok;
+        }
     };
 }
 
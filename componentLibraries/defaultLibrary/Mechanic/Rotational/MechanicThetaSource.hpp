@@ -72,6 +72,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
         // Add inputVariables ports to the component
         mpPthetain=addInputVariable("thetain","Angle", "rad", 0, &mpIn_theta);
         mpPwin=addInputVariable("omega","Angular Velocity", "AngularVelocity", 0, &mpIn_w);
@@ -139,5 +140,15 @@ public:
         (*mpPmr1_theta)=theta_out;
         (*mpPmr1_w)=w_in;
      }
+
+     void saveState(StateWriter &rWriter) const
+     {
+         mInt.saveState(rWriter);
+     }
+
+     bool restoreState(StateReader &rReader)
+     {
+         return mInt.restoreState(rReader);
+     }
 };
 #endif // MECHANICTHETASOURCE_HPP_INCLUDED
@@ -86,6 +86,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(LacksInternalState);
             mpPpn1 = addPowerMultiPort("Ppn1", "NodePetriNet");
 	   mpPpn2=addPowerPort("Ppn2","NodePetriNet");
 			
@@ -102,6 +102,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -246,6 +247,25 @@ yref),umin,umax);
         mDelayedPart31.update(delayParts3[1]);
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        // The previous solution is the starting point for the Newton-Raphson iteration
+        rWriter.writeDouble(u);
+        rWriter.writeDouble(Ierr);
+        rWriter.writeDouble(uI);
+        rWriter.writeDouble(delayParts3[1]);
+        mDelayedPart31.saveState(rWriter);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = rReader.readDouble(u) && rReader.readDouble(Ierr) && rReader.readDouble(uI);
+        ok = ok && rReader.readDouble(delayParts3[1]) && mDelayedPart31.restoreState(rReader);
+        delayedPart[3][1] = delayParts3[1];
+        return ok;
+    }
+
     void deconfigure()
     {
         delete mpSolver;
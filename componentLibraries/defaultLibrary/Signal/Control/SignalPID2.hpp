@@ -61,6 +61,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
         addInputVariable("e", "Control error", "", 0, &mpErr);
         addInputVariable("de", "Derivative signal input", "", 0, &mpDerr);
         addOutputVariable("u", "Control signal", "", &mpOut);
@@ -110,6 +110,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -284,6 +285,30 @@ mTimestep*w21*w22);
         mDelayedPart41.update(delayParts4[1]);
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        // The previous solution is the starting point for the Newton-Raphson iteration
+        rWriter.writeDouble(err);
+        rWriter.writeDouble(u);
+        rWriter.writeDouble(Ierr);
+        rWriter.writeDouble(uI);
+        rWriter.writeDouble(delayParts1[1]);
+        rWriter.writeDouble(delayParts4[1]);
+        mDelayedPart11.saveState(rWriter);
+        mDelayedPart41.saveState(rWriter);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        bool ok = rReader.readDouble(err) && rReader.readDouble(u) && rReader.readDouble(Ierr) && rReader.readDouble(uI);
+        ok = ok && rReader.readDouble(delayParts1[1]) && rReader.readDouble(delayParts4[1]);
+        ok = ok && mDelayedPart11.restoreState(rReader) && mDelayedPart41.restoreState(rReader);
+        delayedPart[1][1] = delayParts1[1];
+        delayedPart[4][1] = delayParts4[1];
+        return ok;
+    }
+
     void deconfigure()
     {
         delete mpSolver;
@@ -60,6 +60,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in", "","",0.0,&mpIn);
             addOutputVariable("out","Filtered value","",0.0,&mpOut);
 
@@ -84,6 +85,22 @@ namespace hopsan {
         {
             (*mpOut) = mTF.update(*mpIn);
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mTF.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mTF.restoreState(rReader);
+        }
+
+        bool addToFilterBank(FilterBank &rBank)
+        {
+            rBank.addFilter(&mTF, mpIn, mpOut);
+            return true;
+        }
     };
 }
 
@@ -59,6 +59,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in","","", 0.0, &mpIn);
             addOutputVariable("out", "","",0.0, &mpOut);
 
@@ -91,6 +92,22 @@ namespace hopsan {
         {
             (*mpOut) = mTF2.update((*mpIn));
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mTF2.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mTF2.restoreState(rReader);
+        }
+
+        bool addToFilterBank(FilterBank &rBank)
+        {
+            rBank.addFilter(&mTF2, mpIn, mpOut);
+            return true;
+        }
     };
 }
 
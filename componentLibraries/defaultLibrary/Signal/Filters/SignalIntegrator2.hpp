@@ -58,6 +58,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in", "", "", 0.0, &mpIn);
             addOutputVariable("out", "", "", 0.0, &mpOut);
         }
@@ -76,6 +77,16 @@ namespace hopsan {
             //Filter equation
            (*mpOut) = mIntegrator.update((*mpIn));
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mIntegrator.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mIntegrator.restoreState(rReader);
+        }
     };
 }
 
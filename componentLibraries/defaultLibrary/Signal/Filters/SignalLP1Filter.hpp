@@ -59,6 +59,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in","","", 0.0, &mpIn);
             addOutputVariable("out", "","",0.0, &mpOut);
 
@@ -89,6 +90,22 @@ namespace hopsan {
             //Write new values to nodes
             (*mpOut) = mTF.update((*mpIn));
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mTF.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mTF.restoreState(rReader);
+        }
+
+        bool addToFilterBank(FilterBank &rBank)
+        {
+            rBank.addFilter(&mTF, mpIn, mpOut);
+            return true;
+        }
     };
 }
 
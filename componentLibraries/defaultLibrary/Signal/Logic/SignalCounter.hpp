@@ -55,6 +55,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
         addConstant("r", "Count rising flags", "", true, mR);
         addConstant("f", "Count falling flags", "", true, mF);
         addInputVariable("in", "", "", 0, &mpIn);
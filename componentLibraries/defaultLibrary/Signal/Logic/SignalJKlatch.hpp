@@ -79,6 +79,7 @@ public:
 
      void configure()
      {
+        setStateSupport(SupportsInternalState);
 //==This code has been autogenerated using Compgen==
 
         mNstep=9;
@@ -156,6 +157,17 @@ limit(setCond,0,1)),0,1),0,1),0,1);
         //Update the delayed variabels
 
      }
+
+    void saveState(StateWriter &rWriter) const
+    {
+        rWriter.writeDouble(oldQstate);
+    }
+
+    bool restoreState(StateReader &rReader)
+    {
+        return rReader.readDouble(oldQstate);
+    }
+
     void deconfigure()
     {
         delete mpSolver;
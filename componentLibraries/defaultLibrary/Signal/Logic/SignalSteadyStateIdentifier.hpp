@@ -51,6 +51,8 @@ namespace hopsan {
         double *mpIn, *mpOut, *mpTol, *mpWl, *mpSd, *mpL1, *mpL2, *mpL3;
         int mMethod;
         std::vector<double> mWindow;
+        std::vector<double> mNoise;
+        RandomStream mRandom;
         size_t mWindowId;
         double mDelayedX;
         double mDelayedXf;
@@ -64,6 +66,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(LacksInternalState);
             addInputVariable("in", "", "", 0.0, &mpIn);
             addOutputVariable("out", "1 if steadystate, else 0", "", &mpOut);
 
@@ -87,6 +90,8 @@ namespace hopsan {
         {
             mWindowId = 0;
             mWindow.resize(*mpWl/mTimestep, 0);
+            mNoise.resize(mWindow.size());
+            seedRandomStream(mRandom);
 
             mDelayedX = (*mpIn);
             mDelayedXf = (*mpIn);
@@ -137,8 +142,9 @@ namespace hopsan {
 
                 //Randomize window
                 std::vector<double> randWindow = mWindow;
+                mRandom.fillNormal(mNoise.data(), mNoise.size());
                 for(size_t i=0; i<randWindow.size(); ++i) {
-                    randWindow[i] = randWindow[i] + (*mpSd)*WhiteGaussianNoise::getValue();
+                    randWindow[i] = randWindow[i] + (*mpSd)*mNoise[i];
                 }
 
                 //Compute average of window
@@ -188,7 +194,7 @@ namespace hopsan {
                 double sd = (*mpSd);
                 double dfold = mDelayedDf;
 
-                x = x+sd*WhiteGaussianNoise::getValue();
+                x = x+sd*mRandom.nextNormal();
 
                 double vf = l2*(x-xf)*(x-xf);
                 double s1 = (2.0-l1)/2.0*vf;
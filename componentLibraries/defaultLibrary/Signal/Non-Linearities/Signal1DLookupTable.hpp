@@ -58,8 +58,8 @@ namespace hopsan {
         HTextBlock mTextInput;
         HString mSeparatorChar;
         HString mCommentChar;
-        CSVParserNG mCSVParser;
-        LookupTable1D mLookupTable;
+        std::shared_ptr<const LookupTable1D> mpLookupTable;
+        size_t mIndexHint; // Interval found in the previous time step, where the search starts
 
     public:
         static Component *Creator()
@@ -89,111 +89,150 @@ namespace hopsan {
         {
             mUseTextInput = !mTextInput.empty();
 
-            if ( mLookupTable.isEmpty() || mReloadCSV )
+            if ( !mpLookupTable || mReloadCSV )
             {
-                bool isOK=false;
-                mLookupTable.clear();
-
+                mNumLinesToSkip = std::max(mNumLinesToSkip, 0);
                 if (mUseTextInput) {
-                    isOK = mCSVParser.openText(mTextInput);
+                    mpLookupTable.reset(loadLookupTable());
                 }
                 else {
-                    isOK = mCSVParser.openFile(findFilePath(mFileName));
+                    // Share the parsed data with all other instances using the same file and settings
+                    mpLookupTable = getSharedLookupTable<LookupTable1D>(findFilePath(mFileName), getParseOptions(),
+                                                                        [this](){ return loadLookupTable(); });
                 }
 
-                if (isOK)
+                if (!mpLookupTable)
                 {
-                    mNumLinesToSkip = std::max(mNumLinesToSkip, 0);
-                    if (!mCommentChar.empty()) {
-                        if (mCommentChar.size()>1) {
-                            addErrorMessage("Comment character must be one character");
-                            isOK = false;
-                        }
-                        else {
-                            mCSVParser.setCommentChar(mCommentChar[0]);
-                        }
-                    }
-
-                    if(isOK) {
-                        if (mSeparatorChar.size() == 1) {
-                            mCSVParser.setLinesToSkip(mNumLinesToSkip);
-                            mCSVParser.setFieldSeparator(mSeparatorChar[0]);
-                            mCSVParser.indexFile();
-                            isOK = true;
-                        }
-                        else {
-                            addErrorMessage("Separator character must be ONE character");
-                            isOK = false;
-                        }
-                    }
-                }
-                if(!isOK)
-                {
-                    HString msg = mUseTextInput ? "Unable to initialize CSV parser: "+mCSVParser.getErrorString() :
-                                                  "Unable to initialize CSV file: "+mFileName+", "+mCSVParser.getErrorString();
-                    addErrorMessage(msg);
                     stopSimulation();
-                    mCSVParser.closeFile();
                     return;
                 }
-                else
-                {
-                    // Make sure that selected data vector is in range
-                    size_t minCols, maxCols;
-                    mCSVParser.getMinMaxNumCols(minCols, maxCols);
-                    if ( mInDataId >= int(maxCols) || mOutDataId >= int(maxCols) )
-                    {
-                        HString ss;
-                        ss = "inid: "+to_hstring(mInDataId)+" or outid:"+to_hstring(mOutDataId)+" is out of range!";
-                        addErrorMessage(ss);
-                        stopSimulation();
-                        mCSVParser.closeFile();
-                        return;
-                    }
+            }
+            mIndexHint = 0;
+            simulateOneTimestep();
+        }
+
+
+        void simulateOneTimestep()
+        {
+            (*mpOut) = mpLookupTable->interpolate(*mpIn, mIndexHint);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double /*timestep*/) const
+        {
+            // Tables loaded from file are shared, identify them by file and parse options so that they are only counted once
+            const HString key = mTextInput.empty() ? findFilePath(mFileName)+"|"+getParseOptions() : HString();
+            if (mpLookupTable)
+            {
+                rReport.addLookupData(key, mpLookupTable->getMemoryUsage());
+            }
+            else
+            {
+                rReport.addLookupData(key, mTextInput.empty() ? LookupTableCache::estimateMemoryUsage(findFilePath(mFileName)) : mTextInput.size());
+            }
+        }
 
-                    isOK = mCSVParser.copyColumn(mInDataId, mLookupTable.getIndexDataRef());
-                    isOK = isOK && mCSVParser.copyColumn(mOutDataId, mLookupTable.getValueDataRef());
-                    // Now the data is in the lookuptable and we can close the csv file and clear the index
-                    mCSVParser.closeFile();
+    private:
+        //! @brief The settings affecting how the data file is parsed, used to identify the shared table data
+        HString getParseOptions() const
+        {
+            return HString("Signal1DLookupTable;")+mSeparatorChar+";"+mCommentChar+";"+to_hstring(mInDataId)+ ";"+to_hstring(mOutDataId)+";"+to_hstring(mNumLinesToSkip);
+        }
+
+        //! @brief Parse the csv data into a new lookup table
+        //! @returns The new table or nullptr if data could not be loaded (errors are reported)
+        LookupTable1D *loadLookupTable()
+        {
+            bool isOK=false;
+            CSVParserNG csvParser;
 
-                    if (!isOK)
-                    {
-                        addErrorMessage("There were parsing errors in either the input or output data columns");
-                        stopSimulation();
-                        return;
+            if (mUseTextInput) {
+                isOK = csvParser.openText(mTextInput);
+            }
+            else {
+                isOK = csvParser.openFile(findFilePath(mFileName));
+            }
+
+            if (isOK)
+            {
+                if (!mCommentChar.empty()) {
+                    if (mCommentChar.size()>1) {
+                        addErrorMessage("Comment character must be one character");
+                        isOK = false;
                     }
+                    else {
+                        csvParser.setCommentChar(mCommentChar[0]);
+                    }
+                }
 
-                    // Make sure strictly increasing (no sorting will be done if that is already the case)
-                    mLookupTable.sortIncreasing();
-
-                    // Check if data is OK before we continue
-                    isOK = mLookupTable.isDataOK();
-                    if(!isOK)
-                    {
-                        HString msg = "The LookupTable data is not OK";
-                        if (!mUseTextInput) {
-                            msg.append(" after reading from file: "+mFileName);
-                        }
-                        addErrorMessage(msg);
-                        if (!mLookupTable.isDataSizeOK())
-                        {
-                            addErrorMessage("Something is wrong with the size of the index or data vectors");
-                        }
-                        if (!mLookupTable.allIndexStrictlyIncreasing())
-                        {
-                            addErrorMessage("Even after sorting, the index column is still not strictly increasing");
-                        }
-                        stopSimulation();
+                if(isOK) {
+                    if (mSeparatorChar.size() == 1) {
+                        csvParser.setLinesToSkip(mNumLinesToSkip);
+                        csvParser.setFieldSeparator(mSeparatorChar[0]);
+                        csvParser.indexFile();
+                        isOK = true;
+                    }
+                    else {
+                        addErrorMessage("Separator character must be ONE character");
+                        isOK = false;
                     }
                 }
             }
-            simulateOneTimestep();
-        }
+            if(!isOK)
+            {
+                HString msg = mUseTextInput ? "Unable to initialize CSV parser: "+csvParser.getErrorString() :
+                                              "Unable to initialize CSV file: "+mFileName+", "+csvParser.getErrorString();
+                addErrorMessage(msg);
+                return nullptr;
+            }
 
+            // Make sure that selected data vector is in range
+            size_t minCols, maxCols;
+            csvParser.getMinMaxNumCols(minCols, maxCols);
+            if ( mInDataId >= int(maxCols) || mOutDataId >= int(maxCols) )
+            {
+                HString ss;
+                ss = "inid: "+to_hstring(mInDataId)+" or outid:"+to_hstring(mOutDataId)+" is out of range!";
+                addErrorMessage(ss);
+                return nullptr;
+            }
 
-        void simulateOneTimestep()
-        {
-            (*mpOut) = mLookupTable.interpolate(*mpIn);
+            LookupTable1D *pLookupTable = new LookupTable1D();
+            isOK = csvParser.copyColumn(mInDataId, pLookupTable->getIndexDataRef());
+            isOK = isOK && csvParser.copyColumn(mOutDataId, pLookupTable->getValueDataRef());
+            // Now the data is in the lookuptable and we can close the csv file and clear the index
+            csvParser.closeFile();
+
+            if (!isOK)
+            {
+                addErrorMessage("There were parsing errors in either the input or output data columns");
+                delete pLookupTable;
+                return nullptr;
+            }
+
+            // Make sure strictly increasing (no sorting will be done if that is already the case)
+            pLookupTable->sortIncreasing();
+
+            // Check if data is OK before we continue
+            isOK = pLookupTable->isDataOK();
+            if(!isOK)
+            {
+                HString msg = "The LookupTable data is not OK";
+                if (!mUseTextInput) {
+                    msg.append(" after reading from file: "+mFileName);
+                }
+                addErrorMessage(msg);
+                if (!pLookupTable->isDataSizeOK())
+                {
+                    addErrorMessage("Something is wrong with the size of the index or data vectors");
+                }
+                if (!pLookupTable->allIndexStrictlyIncreasing())
+                {
+                    addErrorMessage("Even after sorting, the index column is still not strictly increasing");
+                }
+                delete pLookupTable;
+                return nullptr;
+            }
+            return pLookupTable;
         }
     };
 }
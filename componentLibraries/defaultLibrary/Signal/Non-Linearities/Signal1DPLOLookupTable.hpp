@@ -56,8 +56,8 @@ namespace hopsan {
         bool mUseTextInput;
         HFilePath mPloFileName;
         HTextBlock mTextInput;
-        PLOParser mPLOParser;
-        LookupTable1D mLookupTable;
+        std::shared_ptr<const LookupTable1D> mpLookupTable;
+        size_t mIndexHint; // Interval found in the previous time step, where the search starts
 
     public:
         static Component *Creator()
@@ -82,78 +82,119 @@ namespace hopsan {
         {
             mUseTextInput = !mTextInput.empty();
 
-            if ( mLookupTable.isEmpty() || mReloadPLO )
+            if ( !mpLookupTable || mReloadPLO )
             {
-                bool isOK=false;
-                mLookupTable.clear();
-
                 if (mUseTextInput) {
-                    isOK = mPLOParser.readText(mTextInput);
+                    mpLookupTable.reset(loadLookupTable());
                 }
                 else {
-                    isOK = mPLOParser.readFile(findFilePath(mPloFileName));
+                    // Share the parsed data with all other instances using the same file and settings
+                    mpLookupTable = getSharedLookupTable<LookupTable1D>(findFilePath(mPloFileName), getParseOptions(),
+                                                                        [this](){ return loadLookupTable(); });
                 }
 
-                if(!isOK)
+                if (!mpLookupTable)
                 {
-                    HString msg = mUseTextInput ? "Unable to initialize PLO parser: "+mPLOParser.getErrorString() :
-                                                  "Unable to initialize PLO file: "+mPloFileName+", "+mPLOParser.getErrorString();
-                    addErrorMessage(msg);
                     stopSimulation();
                     return;
                 }
-                else
-                {
-                    // Make sure that selected data vectors are in range
-                    int inId, outId;
-                    inId = mPLOParser.getColIdxForDataName(mInDataName);
-                    outId = mPLOParser.getColIdxForDataName(mOutDataName);
-
-                    if ( inId < 0 || outId < 0 )
-                    {
-                        HString ss;
-                        ss = "invar: "+mInDataName+" or outvar: "+mOutDataName+" does not exist in specified file!";
-                        addErrorMessage(ss);
-                        stopSimulation();
-                        return;
-                    }
-
-                    mPLOParser.copyColumn(inId, mLookupTable.getIndexDataRef());
-                    mPLOParser.copyColumn(outId, mLookupTable.getValueDataRef());
-                    // Now the data is in the lookuptable and we can throw away the plo data to conserve memory
-                    mPLOParser.clearData();
-
-                    // Make sure strictly increasing (no sorting will be done if that is already the case)
-                    mLookupTable.sortIncreasing();
-
-                    // Check if data is OK before we continue
-                    isOK = mLookupTable.isDataOK();
-                    if(!isOK)
-                    {
-                        HString msg = "The LookupTable data is not OK";
-                        if (!mUseTextInput) {
-                            msg.append(" after reading from file: "+mPloFileName);
-                        }
-                        addErrorMessage(msg);
-                        if (!mLookupTable.isDataSizeOK())
-                        {
-                            addErrorMessage("Something is wrong with the size of the index or data vectors");
-                        }
-                        if (!mLookupTable.allIndexStrictlyIncreasing())
-                        {
-                            addErrorMessage("Even after sorting, the index column is still not strictly increasing");
-                        }
-                        stopSimulation();
-                    }
-                }
             }
+            mIndexHint = 0;
             simulateOneTimestep();
         }
 
 
         void simulateOneTimestep()
         {
-            (*mpOut) = mLookupTable.interpolate(*mpIn);
+            (*mpOut) = mpLookupTable->interpolate(*mpIn, mIndexHint);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double /*timestep*/) const
+        {
+            // Tables loaded from file are shared, identify them by file and parse options so that they are only counted once
+            const HString key = mTextInput.empty() ? findFilePath(mPloFileName)+"|"+getParseOptions() : HString();
+            if (mpLookupTable)
+            {
+                rReport.addLookupData(key, mpLookupTable->getMemoryUsage());
+            }
+            else
+            {
+                rReport.addLookupData(key, mTextInput.empty() ? LookupTableCache::estimateMemoryUsage(findFilePath(mPloFileName)) : mTextInput.size());
+            }
+        }
+
+    private:
+        //! @brief The settings affecting how the data file is parsed, used to identify the shared table data
+        HString getParseOptions() const
+        {
+            return HString("Signal1DPLOLookupTable;")+mInDataName+";"+mOutDataName;
+        }
+
+        //! @brief Parse the plo data into a new lookup table
+        //! @returns The new table or nullptr if data could not be loaded (errors are reported)
+        LookupTable1D *loadLookupTable()
+        {
+            bool isOK=false;
+            PLOParser ploParser;
+
+            if (mUseTextInput) {
+                isOK = ploParser.readText(mTextInput);
+            }
+            else {
+                isOK = ploParser.readFile(findFilePath(mPloFileName));
+            }
+
+            if(!isOK)
+            {
+                HString msg = mUseTextInput ? "Unable to initialize PLO parser: "+ploParser.getErrorString() :
+                                              "Unable to initialize PLO file: "+mPloFileName+", "+ploParser.getErrorString();
+                addErrorMessage(msg);
+                return nullptr;
+            }
+
+            // Make sure that selected data vectors are in range
+            int inId, outId;
+            inId = ploParser.getColIdxForDataName(mInDataName);
+            outId = ploParser.getColIdxForDataName(mOutDataName);
+
+            if ( inId < 0 || outId < 0 )
+            {
+                HString ss;
+                ss = "invar: "+mInDataName+" or outvar: "+mOutDataName+" does not exist in specified file!";
+                addErrorMessage(ss);
+                return nullptr;
+            }
+
+            LookupTable1D *pLookupTable = new LookupTable1D();
+            ploParser.copyColumn(inId, pLookupTable->getIndexDataRef());
+            ploParser.copyColumn(outId, pLookupTable->getValueDataRef());
+            // Now the data is in the lookuptable and we can throw away the plo data to conserve memory
+            ploParser.clearData();
+
+            // Make sure strictly increasing (no sorting will be done if that is already the case)
+            pLookupTable->sortIncreasing();
+
+            // Check if data is OK before we continue
+            isOK = pLookupTable->isDataOK();
+            if(!isOK)
+            {
+                HString msg = "The LookupTable data is not OK";
+                if (!mUseTextInput) {
+                    msg.append(" after reading from file: "+mPloFileName);
+                }
+                addErrorMessage(msg);
+                if (!pLookupTable->isDataSizeOK())
+                {
+                    addErrorMessage("Something is wrong with the size of the index or data vectors");
+                }
+                if (!pLookupTable->allIndexStrictlyIncreasing())
+                {
+                    addErrorMessage("Even after sorting, the index column is still not strictly increasing");
+                }
+                delete pLookupTable;
+                return nullptr;
+            }
+            return pLookupTable;
         }
     };
 }
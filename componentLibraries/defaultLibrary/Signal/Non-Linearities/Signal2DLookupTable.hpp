@@ -57,8 +57,8 @@ namespace hopsan {
         HFilePath mFileName;
         HString mCommentChar;
         HTextBlock mTextInput;
-        CSVParserNG mCSVParser;
-        LookupTable2D mLookupTable;
+        std::shared_ptr<const LookupTable2D> mpLookupTable;
+        size_t mRowHint, mColHint; // Intervals found in the previous time step, where the searches start
 
     public:
         static Component *Creator()
@@ -84,144 +84,185 @@ namespace hopsan {
         {
             mUseTextInput = !mTextInput.empty();
 
-            if ( mLookupTable.isEmpty() || mReloadCSV )
+            if ( !mpLookupTable || mReloadCSV )
             {
-                bool isOK=false;
-                mLookupTable.clear();
-
+                mNumLinesToSkip = std::max(mNumLinesToSkip, 0);
                 if (mUseTextInput) {
-                    isOK = mCSVParser.openText(mTextInput);
+                    mpLookupTable.reset(loadLookupTable());
                 }
                 else {
-                    isOK = mCSVParser.openFile(findFilePath(mFileName));
+                    // Share the parsed data with all other instances using the same file and settings
+                    mpLookupTable = getSharedLookupTable<LookupTable2D>(findFilePath(mFileName), getParseOptions(),
+                                                                        [this](){ return loadLookupTable(); });
                 }
 
-                mNumLinesToSkip = std::max(mNumLinesToSkip, 0);
-                if (!mCommentChar.empty()) {
-                    if (mCommentChar.size()>1) {
-                        addErrorMessage("Comment character must be one character");
-                        isOK = false;
-                    }
-                    else {
-                        mCSVParser.setCommentChar(mCommentChar[0]);
-                    }
+                if (!mpLookupTable)
+                {
+                    stopSimulation();
+                    return;
                 }
+            }
+            mRowHint = mColHint = 0;
+            simulateOneTimestep();
+        }
 
-                if (isOK)
-                {
-                    mCSVParser.indexFile();
-                    isOK = true;
+
+        void simulateOneTimestep()
+        {
+            (*mpOut) = mpLookupTable->interpolate(*mpInRow, *mpInCol, mRowHint, mColHint);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double /*timestep*/) const
+        {
+            // Tables loaded from file are shared, identify them by file and parse options so that they are only counted once
+            const HString key = mTextInput.empty() ? findFilePath(mFileName)+"|"+getParseOptions() : HString();
+            if (mpLookupTable)
+            {
+                rReport.addLookupData(key, mpLookupTable->getMemoryUsage());
+            }
+            else
+            {
+                rReport.addLookupData(key, mTextInput.empty() ? LookupTableCache::estimateMemoryUsage(findFilePath(mFileName)) : mTextInput.size());
+            }
+        }
+
+    private:
+        //! @brief The settings affecting how the data file is parsed, used to identify the shared table data
+        HString getParseOptions() const
+        {
+            return HString("Signal2DLookupTable;")+mCommentChar+";"+to_hstring(mNumLinesToSkip);
+        }
+
+        //! @brief Parse the csv data into a new lookup table
+        //! @returns The new table or nullptr if data could not be loaded (errors are reported)
+        LookupTable2D *loadLookupTable()
+        {
+            bool isOK=false;
+            CSVParserNG csvParser;
+            LookupTable2D *pLookupTable = new LookupTable2D();
+
+            if (mUseTextInput) {
+                isOK = csvParser.openText(mTextInput);
+            }
+            else {
+                isOK = csvParser.openFile(findFilePath(mFileName));
+            }
+
+            if (!mCommentChar.empty()) {
+                if (mCommentChar.size()>1) {
+                    addErrorMessage("Comment character must be one character");
+                    isOK = false;
                 }
-                if(!isOK)
+                else {
+                    csvParser.setCommentChar(mCommentChar[0]);
+                }
+            }
+
+            if (isOK)
+            {
+                csvParser.indexFile();
+                isOK = true;
+            }
+            if(!isOK)
+            {
+                HString msg = mUseTextInput ? "Unable to initialize CSV parser: "+csvParser.getErrorString() :
+                                              "Unable to initialize CSV file: "+mFileName+", "+csvParser.getErrorString();
+                addErrorMessage(msg);
+                delete pLookupTable;
+                return nullptr;
+            }
+            else
+            {
+                // Make sure that selected data vector is in range
+                const size_t nDataCols = csvParser.getNumDataCols();
+                if ( !csvParser.allRowsHaveSameNumCols() || nDataCols != 3 )
                 {
-                    HString msg = mUseTextInput ? "Unable to initialize CSV parser: "+mCSVParser.getErrorString() :
-                                                  "Unable to initialize CSV file: "+mFileName+", "+mCSVParser.getErrorString();
-                    addErrorMessage(msg);
-                    stopSimulation();
-                    mCSVParser.closeFile();
-                    return;
+                    addErrorMessage(HString("Wrong number of data columns: ")+to_hstring(nDataCols)+" != 3");
+                    delete pLookupTable;
+                    return nullptr;
                 }
-                else
+
+                std::vector<long int> rowscols;
+                isOK = csvParser.copyRow(csvParser.getNumDataRows()-1,rowscols);
+                if (!isOK)
                 {
-                    // Make sure that selected data vector is in range
-                    const size_t nDataCols = mCSVParser.getNumDataCols();
-                    if ( !mCSVParser.allRowsHaveSameNumCols() || nDataCols != 3 )
-                    {
-                        addErrorMessage(HString("Wrong number of data columns: ")+to_hstring(nDataCols)+" != 3");
-                        stopSimulation();
-                        mCSVParser.closeFile();
-                        return;
+                    HString msg = "Could not parse the number of rows and columns (last line)";
+                    if (!mUseTextInput) {
+                        msg.append(" from CSV file: "+mFileName);
                     }
+                    addErrorMessage(msg);
+                    delete pLookupTable;
+                    return nullptr;
+                }
 
-                    std::vector<long int> rowscols;
-                    isOK = mCSVParser.copyRow(mCSVParser.getNumDataRows()-1,rowscols);
-                    if (!isOK)
-                    {
-                        HString msg = "Could not parse the number of rows and columns (last line)";
-                        if (!mUseTextInput) {
-                            msg.append(" from CSV file: "+mFileName);
-                        }
-                        addErrorMessage(msg);
-                        stopSimulation();
-                        return;
-                    }
+                size_t nRows = rowscols[0];
+                size_t nCols = rowscols[1];
 
-                    size_t nRows = rowscols[0];
-                    size_t nCols = rowscols[1];
+                // Copy row and column index vectors (ignoring the final row with nRows and nCols)
+                isOK = csvParser.copyEveryNthFromColumn(0, nCols, pLookupTable->getIndexDataRef(0));
+                isOK = isOK && csvParser.copyRangeFromColumn(1, 0, nCols, pLookupTable->getIndexDataRef(1));
 
-                    // Copy row and column index vectors (ignoring the final row with nRows and nCols)
-                    isOK = mCSVParser.copyEveryNthFromColumn(0, nCols, mLookupTable.getIndexDataRef(0));
-                    isOK = isOK && mCSVParser.copyRangeFromColumn(1, 0, nCols, mLookupTable.getIndexDataRef(1));
+                if (!isOK)
+                {
+                    addErrorMessage("Could not parse one or both of the csv index columns");
+                    delete pLookupTable;
+                    return nullptr;
+                }
 
-                    if (!isOK)
-                    {
-                        addErrorMessage("Could not parse one or both of the csv index columns");
-                        stopSimulation();
-                        mCSVParser.closeFile();
-                        return;
-                    }
+                // Remove "extra element (num rows)" from row index column, cols not needed since we did not even fetch all values
+                if (pLookupTable->getDimSize(0) == nRows+1)
+                {
+                    pLookupTable->getIndexDataRef(0).pop_back();
+                }
 
-                    // Remove "extra element (num rows)" from row index column, cols not needed since we did not even fetch all values
-                    if (mLookupTable.getDimSize(0) == nRows+1)
-                    {
-                        mLookupTable.getIndexDataRef(0).pop_back();
-                    }
+                // Copy values
+                isOK = csvParser.copyRangeFromColumn(2, 0, csvParser.getNumDataRows()-1, pLookupTable->getValueDataRef());
+                if (!isOK)
+                {
+                    addErrorMessage("Could not parse the csv value column");
+                    delete pLookupTable;
+                    return nullptr;
+                }
 
-                    // Copy values
-                    isOK = mCSVParser.copyRangeFromColumn(2, 0, mCSVParser.getNumDataRows()-1, mLookupTable.getValueDataRef());
-                    if (!isOK)
-                    {
-                        addErrorMessage("Could not parse the csv value column");
-                        stopSimulation();
-                        mCSVParser.closeFile();
-                        return;
-                    }
+                // Now the data is in the lookup table and we can throw away the csv data to conserve memory
+                csvParser.closeFile();
+
+                // Make sure the correct number of rows and columns are available
+                if ( (nRows != pLookupTable->getDimSize(0)) || (nCols != pLookupTable->getDimSize(1)) )
+                {
+                    addErrorMessage(HString("The actual number of extracted rows: "+to_hstring(pLookupTable->getDimSize(0))+
+                                            " and cols: "+to_hstring(pLookupTable->getDimSize(1))+
+                                            ", Does not match the specification (last line): "+to_hstring(nRows)+
+                                            " "+to_hstring(nCols)));
+                    delete pLookupTable;
+                    return nullptr;
+                }
 
-                    // Now the data is in the lookup table and we can throw away the csv data to conserve memory
-                    mCSVParser.closeFile();
+                // Make sure strictly increasing (no sorting will be done if that is already the case)
+                pLookupTable->sortIncreasing();
 
-                    // Make sure the correct number of rows and columns are available
-                    if ( (nRows != mLookupTable.getDimSize(0)) || (nCols != mLookupTable.getDimSize(1)) )
+                // Check if data is OK before we continue
+                isOK = pLookupTable->isDataOK();
+                if(!isOK)
+                {
+                    HString msg = "The LookupTable data is not OK";
+                    if (!mUseTextInput) {
+                        msg.append(" after reading from file: "+mFileName);
+                    }
+                    addErrorMessage(msg);
+                    if (!pLookupTable->isDataSizeOK())
                     {
-                        addErrorMessage(HString("The actual number of extracted rows: "+to_hstring(mLookupTable.getDimSize(0))+
-                                                " and cols: "+to_hstring(mLookupTable.getDimSize(1))+
-                                                ", Does not match the specification (last line): "+to_hstring(nRows)+
-                                                " "+to_hstring(nCols)));
-                        stopSimulation();
-                        return;
+                        addErrorMessage("Something is wrong with the size of the index or data vectors");
                     }
-
-                    // Make sure strictly increasing (no sorting will be done if that is already the case)
-                    mLookupTable.sortIncreasing();
-
-                    // Check if data is OK before we continue
-                    isOK = mLookupTable.isDataOK();
-                    if(!isOK)
+                    if (!pLookupTable->allIndexStrictlyIncreasing())
                     {
-                        HString msg = "The LookupTable data is not OK";
-                        if (!mUseTextInput) {
-                            msg.append(" after reading from file: "+mFileName);
-                        }
-                        addErrorMessage(msg);
-                        if (!mLookupTable.isDataSizeOK())
-                        {
-                            addErrorMessage("Something is wrong with the size of the index or data vectors");
-                        }
-                        if (!mLookupTable.allIndexStrictlyIncreasing())
-                        {
-                            addErrorMessage("Even after sorting, one or more index columns are still not strictly increasing");
-                        }
-                        stopSimulation();
+                        addErrorMessage("Even after sorting, one or more index columns are still not strictly increasing");
                     }
+                    delete pLookupTable;
+                    return nullptr;
                 }
             }
-            simulateOneTimestep();
-        }
-
-
-        void simulateOneTimestep()
-        {
-            (*mpOut) = mLookupTable.interpolate(*mpInRow, *mpInCol);
+            return pLookupTable;
         }
     };
 }
@@ -48,7 +48,7 @@ namespace hopsan {
 
     private:
 
-        WhiteGaussianNoise noise;
+        RandomStream mRandom;
         double *mpND_in, *mpND_out, *mpND_stdDev;
 
     public:
@@ -59,6 +59,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in", "", "", 0.0, &mpND_in);
             addInputVariable("std_dev", "Amplitude Variance", "", 1.0, &mpND_stdDev);
 
@@ -68,13 +69,25 @@ namespace hopsan {
 
         void initialize()
         {
+            seedRandomStream(mRandom);
             simulateOneTimestep();
         }
 
 
         void simulateOneTimestep()
         {
-             (*mpND_out) = (*mpND_in) + (*mpND_stdDev)*noise.getValue();
+             (*mpND_out) = (*mpND_in) + (*mpND_stdDev)*mRandom.nextNormal();
+        }
+
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mRandom.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mRandom.restoreState(rReader);
         }
     };
 }
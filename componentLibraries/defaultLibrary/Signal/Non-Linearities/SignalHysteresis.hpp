@@ -60,6 +60,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("in", "", "", 0.0, &mpND_in);
             addInputVariable("y_h", "Width of the Hysteresis", "", 1.0, &mpHysteresisWidth);
 
@@ -80,6 +81,16 @@ namespace hopsan {
             (*mpND_out) = mHyst.getValue((*mpND_in), (*mpHysteresisWidth), mDelayedInput.getOldest());
             mDelayedInput.update((*mpND_out));
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mDelayedInput.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mDelayedInput.restoreState(rReader);
+        }
     };
 }
 
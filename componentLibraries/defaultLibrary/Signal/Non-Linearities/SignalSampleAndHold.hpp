@@ -52,6 +52,7 @@ public:
 
     void configure()
     {
+        setStateSupport(LacksInternalState);
         addInputVariable("f_s", "Sampling Frequency", "Hz", 100, &mpFs);
         addInputVariable("in", "", "", 0, &mpIn);
         addOutputVariable("out", "", "", &mpOut);
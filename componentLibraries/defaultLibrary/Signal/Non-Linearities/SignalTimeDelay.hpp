@@ -60,6 +60,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addConstant("deltat", "Time delay", "s", 1.0, mTimeDelay);
 
             addInputVariable("in", "", "", 0.0, &mpND_in);
@@ -78,6 +79,21 @@ namespace hopsan {
         {
             (*mpND_out) =  mDelay.update(*mpND_in);
         }
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mDelay.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mDelay.restoreState(rReader);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double timestep) const
+        {
+            rReport.addComponentData(rReport.isEstimate() ? Delay::estimateMemoryUsage(mTimeDelay, timestep) : mDelay.getMemoryUsage());
+        }
     };
 }
 
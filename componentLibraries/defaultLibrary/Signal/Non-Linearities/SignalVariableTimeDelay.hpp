@@ -61,6 +61,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             mpDelay = 0;
 
             addInputVariable("dT", "Time delay", "s", 1.0, &mpTimeDelay);
@@ -160,6 +161,41 @@ namespace hopsan {
             }
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            // The delay length follows the delay input, so it is saved with the buffer
+            rWriter.writeSize(mpDelay->getSize());
+            mpDelay->saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            size_t nSamps;
+            if (!rReader.readSize(nSamps))
+            {
+                return false;
+            }
+            if (nSamps != mpDelay->getSize())
+            {
+                delete mpDelay;
+                mpDelay = new Delay();
+                if (nSamps != 0)
+                {
+                    mpDelay->initialize(int(nSamps), 0);
+                }
+            }
+            return mpDelay->restoreState(rReader);
+        }
+
+        void reportMemoryUsage(MemoryReport &rReport, const double /*timestep*/) const
+        {
+            // The buffer size follows the delay input, so it can only be reported once allocated
+            if (mpDelay && !rReport.isEstimate())
+            {
+                rReport.addComponentData(mpDelay->getMemoryUsage());
+            }
+        }
+
         void finalize()
         {
             if (mpDelay)
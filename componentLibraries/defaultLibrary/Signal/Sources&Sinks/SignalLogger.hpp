@@ -71,6 +71,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(LacksInternalState);
             std::vector<HString> filetypes;
             filetypes.push_back("Plain column-wise CSV");
             filetypes.push_back("Plain row-wise CSV");
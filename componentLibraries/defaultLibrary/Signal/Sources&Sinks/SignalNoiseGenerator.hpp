@@ -47,7 +47,7 @@ namespace hopsan {
     {
 
     private:
-        WhiteGaussianNoise noise;
+        RandomStream mRandom;
         double *mpOut, *mpStdDev;
 
     public:
@@ -58,6 +58,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
             addInputVariable("std_dev", "Standard deviation", "", 1.0, &mpStdDev);
             addOutputVariable("out", "", "", 0.0, &mpOut);
         }
@@ -65,13 +66,25 @@ namespace hopsan {
 
         void initialize()
         {
+            seedRandomStream(mRandom);
             simulateOneTimestep();
         }
 
 
         void simulateOneTimestep()
         {
-             (*mpOut) = (*mpStdDev)*noise.getValue();
+             (*mpOut) = (*mpStdDev)*mRandom.nextNormal();
+        }
+
+
+        void saveState(StateWriter &rWriter) const
+        {
+            mRandom.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            return mRandom.restoreState(rReader);
         }
     };
 }
@@ -82,6 +82,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(LacksInternalState);
             //Add ports to the component
 
             //Add inputVariables to the component
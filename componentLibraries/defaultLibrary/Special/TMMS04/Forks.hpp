@@ -77,6 +77,7 @@ namespace hopsan {
 
         void configure()
         {
+            setStateSupport(SupportsInternalState);
 
             addConstant("r", "Radius (traverse)", "", 0.1, mR);
             addConstant("m", "Mass (traverse)", "kg",                      100.0, mM);
@@ -273,6 +274,23 @@ namespace hopsan {
             (*mpA) = a;
         }
 
+        void saveState(StateWriter &rWriter) const
+        {
+            mFilterX.saveState(rWriter);
+            mFilterV.saveState(rWriter);
+            mFilterA.saveState(rWriter);
+            mFilterW.saveState(rWriter);
+        }
+
+        bool restoreState(StateReader &rReader)
+        {
+            bool ok = mFilterX.restoreState(rReader);
+            ok = ok && mFilterV.restoreState(rReader);
+            ok = ok && mFilterA.restoreState(rReader);
+            ok = ok && mFilterW.restoreState(rReader);
+            return ok;
+        }
+
 
         void finalize()
         {
@@ -0,0 +1,51 @@
+# -------------------------------------------------
+# Global project options
+# -------------------------------------------------
+include( ../Common.prf )
+
+TARGET = hopsanbenchmark
+TEMPLATE = app
+DESTDIR = $${PWD}/../bin
+
+QT       -= core gui
+
+TARGET = $${TARGET}$${DEBUG_EXT}
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+#--------------------------------------------------------
+# Set the tclap and rapidxml include path
+INCLUDEPATH *= $${PWD}/../dependencies/tclap/include
+INCLUDEPATH *= $${PWD}/../HopsanCore/dependencies/rapidxml
+#--------------------------------------------------------
+
+#--------------------------------------------------------
+# The result export and console helpers are shared with HopsanCLI
+INCLUDEPATH *= $${PWD}/../HopsanCLI
+#--------------------------------------------------------
+
+#--------------------------------------------------------
+# Set hopsan core paths
+INCLUDEPATH *= $${PWD}/../HopsanCore/include
+LIBS *= -L$${PWD}/../bin -lhopsancore$${DEBUG_EXT}
+DEFINES *= HOPSANCORE_DLLIMPORT
+#--------------------------------------------------------
+
+# -------------------------------------------------
+# Platform specific additional project options
+# -------------------------------------------------
+unix {
+    QMAKE_LFLAGS *= -Wl,-rpath,\'\$$ORIGIN/./\'
+    !macx:LIBS *= -lrt
+}
+
+# -------------------------------------------------
+# Project files
+# -------------------------------------------------
+SOURCES += main.cpp \
+    ../HopsanCLI/CliUtilities.cpp \
+    ../HopsanCLI/ModelUtilities.cpp \
+    ../HopsanCLI/core_cli.cpp
+
+OTHER_FILES += benchmarkModels.txt
@@ -0,0 +1,867 @@
+/*-----------------------------------------------------------------------------
+
+ Copyright 2017 Hopsan Group
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+
+ The full license is available in the file LICENSE.
+ For details about the 'Hopsan Group' or information about Authors and
+ Contributors see the HOPSANGROUP and AUTHORS files that are located in
+ the Hopsan source code root directory.
+
+-----------------------------------------------------------------------------*/
+
+//!
+//! @file   hopsanbenchmark/main.cpp
+//! @date   2026-10-19
+//!
+//! @brief Benchmark executable measuring the simulation phases of a set of models
+//!
+//! Each phase is run a number of warm-up times and then measured a number of times. The median and percentiles
+//! of each phase are written to a JSON file (one result per line), that can be used as baseline for later runs.
+//! Individual component types can also be benchmarked alone, to measure their cost per time step, and the
+//! interval search methods of the lookup tables can be compared.
+//!
+
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <tclap/CmdLine.h>
+
+#include "HopsanEssentials.h"
+#include "HopsanCoreMacros.h"
+#include "HopsanCoreVersion.h"
+#include "CoreUtilities/SimulationHandler.h"
+#include "ComponentUtilities/AuxiliarySimulationFunctions.h"
+#include "ComponentUtilities/LookupTable.h"
+#include "CliUtilities.h"
+#include "ModelUtilities.h"
+#include "core_cli.h"
+
+#ifndef DEFAULT_LIBRARY_ROOT
+#define DEFAULT_LIBRARY_ROOT "../componentLibraries/defaultLibrary"
+#endif
+
+#ifndef HOPSAN_INTERNALDEFAULTCOMPONENTS
+#define DEFAULTLIBFILE SHAREDLIB_PREFIX "defaultcomponentlibrary" HOPSAN_DEBUG_POSTFIX "." SHAREDLIB_SUFFIX
+const std::string default_library = DEFAULT_LIBRARY_ROOT "/" DEFAULTLIBFILE;
+#endif
+
+using namespace std;
+using namespace hopsan;
+
+HopsanEssentials gHopsanCore;
+
+namespace {
+
+typedef std::chrono::steady_clock ClockT;
+
+//! @brief Summary of a set of measured times in seconds
+struct Statistics
+{
+    size_t numSamples;
+    double min, p10, median, p90, max, mean;
+};
+
+//! @brief One benchmark result, the key identifies the result when comparing with a baseline
+struct BenchmarkResult
+{
+    string key;
+    string model;
+    string phase;
+    string algorithm;
+    size_t numThreads;
+    Statistics stats;
+};
+
+struct AlgorithmName
+{
+    ParallelAlgorithmT algorithm;
+    const char *name;
+};
+
+const AlgorithmName gAlgorithms[] = {{APrioriScheduling, "APrioriScheduling"},
+                                     {TaskPoolAlgorithm, "TaskPoolAlgorithm"},
+                                     {TaskStealingAlgorithm, "TaskStealingAlgorithm"},
+                                     {ForkJoinAlgorithm, "ForkJoinAlgorithm"},
+                                     {ClusteredForkJoinAlgorithm, "ClusteredForkJoinAlgorithm"}};
+
+//! @brief Returns the value at a given fraction of sorted samples, using linear interpolation between samples
+double percentile(const vector<double> &rSorted, const double fraction)
+{
+    const double pos = fraction*double(rSorted.size()-1);
+    const size_t lower = size_t(pos);
+    const size_t upper = std::min(lower+1, rSorted.size()-1);
+    return rSorted[lower] + (pos-double(lower))*(rSorted[upper]-rSorted[lower]);
+}
+
+Statistics computeStatistics(vector<double> samples)
+{
+    Statistics stats = {samples.size(), 0, 0, 0, 0, 0, 0};
+    if (samples.empty())
+    {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.p10 = percentile(samples, 0.1);
+    stats.median = percentile(samples, 0.5);
+    stats.p90 = percentile(samples, 0.9);
+    for (size_t i=0; i<samples.size(); ++i)
+    {
+        stats.mean += samples[i];
+    }
+    stats.mean /= double(samples.size());
+    return stats;
+}
+
+//! @brief Runs a function numWarmup times without measuring it, and then numRepetitions times measuring its wall time
+//! @details The function returns false if it failed, then the measurement is aborted
+//! @returns The measured times in seconds, empty if the function failed
+vector<double> measure(const size_t numWarmup, const size_t numRepetitions, const std::function<bool()> &rFunction)
+{
+    vector<double> times;
+    for (size_t i=0; i<numWarmup; ++i)
+    {
+        if (!rFunction())
+        {
+            return vector<double>();
+        }
+    }
+    for (size_t i=0; i<numRepetitions; ++i)
+    {
+        const ClockT::time_point start = ClockT::now();
+        if (!rFunction())
+        {
+            return vector<double>();
+        }
+        times.push_back(std::chrono::duration<double>(ClockT::now()-start).count());
+    }
+    return times;
+}
+
+string modelBaseName(const string &rModelPath)
+{
+    string basePath, fileName;
+    splitFilePath(rModelPath, basePath, fileName);
+    return fileName;
+}
+
+void addResult(vector<BenchmarkResult> &rResults, const string &rModel, const string &rPhase, const vector<double> &rTimes,
+               const string &rAlgorithm="", const size_t numThreads=1, const double displayScale=1, const char *displayUnit="s")
+{
+    if (rTimes.empty())
+    {
+        printWarningMessage("Phase "+rPhase+" failed for model "+rModel+", it is not included in the results");
+        return;
+    }
+    BenchmarkResult result;
+    result.model = rModel;
+    result.phase = rPhase;
+    result.algorithm = rAlgorithm;
+    result.numThreads = numThreads;
+    result.key = ((rPhase == "kernel") || (rPhase == "lookup")) ? rPhase+"/"+rModel : modelBaseName(rModel)+"/"+rPhase;
+    if (!rAlgorithm.empty())
+    {
+        result.key += "/"+rAlgorithm+"/"+to_string(numThreads);
+    }
+    result.stats = computeStatistics(rTimes);
+    rResults.push_back(result);
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%-60s median: %10.6f %s  p10: %10.6f %s  p90: %10.6f %s", result.key.c_str(),
+             displayScale*result.stats.median, displayUnit, displayScale*result.stats.p10, displayUnit, displayScale*result.stats.p90, displayUnit);
+    cout << buffer << endl;
+}
+
+//! @brief Runs all benchmark phases for one model
+void benchmarkModel(const string &rModelPath, const size_t numWarmup, const size_t numRepetitions, const size_t maxNumThreads,
+                    const vector<AlgorithmName> &rAlgorithms, const string &rExportDir, vector<BenchmarkResult> &rResults)
+{
+    double startTime=0, stopTime=1;
+
+    // Load
+    vector<double> times = measure(numWarmup, numRepetitions, [&]() {
+        ComponentSystem *pSystem = gHopsanCore.loadHMFModelFile(rModelPath.c_str(), startTime, stopTime);
+        const bool ok = pSystem && (gHopsanCore.getNumErrorMessages() + gHopsanCore.getNumFatalMessages() == 0);
+        printWaitingMessages(false);
+        delete pSystem;
+        return ok;
+    });
+    addResult(rResults, rModelPath, "load", times);
+    if (times.empty())
+    {
+        return;
+    }
+
+    ComponentSystem *pSystem = gHopsanCore.loadHMFModelFile(rModelPath.c_str(), startTime, stopTime);
+    printWaitingMessages(false);
+    if (!pSystem || !pSystem->checkModelBeforeSimulation())
+    {
+        printWaitingMessages(false);
+        printErrorMessage("Model check failed for: "+rModelPath);
+        delete pSystem;
+        return;
+    }
+
+    // Initialize, simulate and export single-threaded, each repetition needs a fresh initialization
+    auto initialize = [&]() {
+        const bool ok = pSystem->initialize(startTime, stopTime);
+        printWaitingMessages(false);
+        return ok;
+    };
+    auto simulate = [&]() {
+        if (!initialize())
+        {
+            return false;
+        }
+        pSystem->simulate(stopTime);
+        pSystem->finalize();
+        printWaitingMessages(false);
+        return !pSystem->wasSimulationAborted();
+    };
+
+    times = measure(numWarmup, numRepetitions, [&]() {
+        const bool ok = initialize();
+        pSystem->finalize();
+        return ok;
+    });
+    addResult(rResults, rModelPath, "initialize", times);
+
+    // The simulate phase is measured without initialization and finalization
+    vector<double> simulateTimes, simulateNoLogTimes;
+    const size_t numLogSamples = pSystem->getNumLogSamples();
+    for (size_t i=0; i<numWarmup+numRepetitions; ++i)
+    {
+        for (int log=1; log>=0; --log)
+        {
+            pSystem->setNumLogSamples(log ? numLogSamples : 0);
+            if (!initialize())
+            {
+                break;
+            }
+            const ClockT::time_point start = ClockT::now();
+            pSystem->simulate(stopTime);
+            const double time = std::chrono::duration<double>(ClockT::now()-start).count();
+            pSystem->finalize();
+            printWaitingMessages(false);
+            if ((i >= numWarmup) && !pSystem->wasSimulationAborted())
+            {
+                (log ? simulateTimes : simulateNoLogTimes).push_back(time);
+            }
+        }
+    }
+    pSystem->setNumLogSamples(numLogSamples);
+    addResult(rResults, rModelPath, "simulate", simulateTimes);
+    addResult(rResults, rModelPath, "simulate_nolog", simulateNoLogTimes);
+
+    // The logging overhead is the difference between simulating with and without logging
+    if (!simulateTimes.empty() && (simulateTimes.size() == simulateNoLogTimes.size()))
+    {
+        vector<double> loggingTimes;
+        for (size_t i=0; i<simulateTimes.size(); ++i)
+        {
+            loggingTimes.push_back(simulateTimes[i]-simulateNoLogTimes[i]);
+        }
+        addResult(rResults, rModelPath, "logging", loggingTimes);
+    }
+
+    // Export the results of the last simulation with logging
+    if (simulate())
+    {
+        const string csvPath = rExportDir+"hopsanbenchmark_export.csv";
+        const string binaryPath = rExportDir+"hopsanbenchmark_export.hrb";
+        const vector<string> noFilter;
+        times = measure(numWarmup, numRepetitions, [&]() {
+            saveResultsToCSV(pSystem, csvPath, Full, noFilter);
+            return true;
+        });
+        addResult(rResults, rModelPath, "export_csv", times);
+        times = measure(numWarmup, numRepetitions, [&]() {
+            saveResultsToBinary(pSystem, binaryPath, noFilter);
+            return true;
+        });
+        addResult(rResults, rModelPath, "export_binary", times);
+        std::remove(csvPath.c_str());
+        std::remove(binaryPath.c_str());
+    }
+
+    // Multi-threaded simulation with each algorithm and number of threads
+    for (size_t a=0; a<rAlgorithms.size(); ++a)
+    {
+        for (size_t nThreads=1; nThreads<=maxNumThreads; ++nThreads)
+        {
+            vector<double> mtTimes;
+            for (size_t i=0; i<numWarmup+numRepetitions; ++i)
+            {
+                if (!initialize())
+                {
+                    break;
+                }
+                const ClockT::time_point start = ClockT::now();
+                pSystem->simulateMultiThreaded(startTime, stopTime, nThreads, false, rAlgorithms[a].algorithm);
+                const double time = std::chrono::duration<double>(ClockT::now()-start).count();
+                pSystem->finalize();
+                printWaitingMessages(false);
+                if ((i >= numWarmup) && !pSystem->wasSimulationAborted())
+                {
+                    mtTimes.push_back(time);
+                }
+            }
+            addResult(rResults, rModelPath, "simulate_parallel", mtTimes, rAlgorithms[a].name, nThreads);
+        }
+    }
+
+    delete pSystem;
+}
+
+//! @brief A value written to a node variable before each step of a kernel benchmark: offset + amplitude*sin(2*pi*frequency*t)
+struct BoundarySignal
+{
+    string portName;
+    string variableName;
+    double offset, amplitude, frequency;
+};
+
+//! @brief Parses a boundary signal given as Port#Variable=offset[,amplitude,frequency]
+bool parseBoundarySignal(const string &rSpec, BoundarySignal &rSignal)
+{
+    const size_t hashPos = rSpec.find('#');
+    const size_t eqPos = rSpec.find('=');
+    if ((hashPos == string::npos) || (eqPos == string::npos) || (eqPos < hashPos))
+    {
+        return false;
+    }
+    rSignal.portName = rSpec.substr(0, hashPos);
+    rSignal.variableName = rSpec.substr(hashPos+1, eqPos-hashPos-1);
+    vector<string> values;
+    splitStringOnDelimiter(rSpec.substr(eqPos+1), ',', values);
+    if ((values.size() != 1) && (values.size() != 3))
+    {
+        return false;
+    }
+    rSignal.offset = atof(values[0].c_str());
+    rSignal.amplitude = (values.size() == 3) ? atof(values[1].c_str()) : 0;
+    rSignal.frequency = (values.size() == 3) ? atof(values[2].c_str()) : 0;
+    return true;
+}
+
+//! @brief Measures the cost per time step of one component type, simulated alone in a system
+//! @details Each port gets its own node, multiports are connected to numSubPorts system ports to get one node per subport.
+//! The component's simulate() is called once per step, the same way as in a system.
+void benchmarkComponentKernel(const string &rTypeName, const size_t numSteps, const double timestep, const size_t numSubPorts,
+                              const vector<BoundarySignal> &rBoundaries, const size_t numWarmup, const size_t numRepetitions,
+                              vector<BenchmarkResult> &rResults)
+{
+    ComponentSystem *pSystem = gHopsanCore.createComponentSystem();
+    pSystem->setDesiredTimestep(timestep);
+    pSystem->setNumLogSamples(0);
+    Component *pComponent = gHopsanCore.createComponent(rTypeName.c_str());
+    if (!pComponent || pComponent->isComponentSystem() || (pComponent->getTypeCQS() == Component::UndefinedCQSType))
+    {
+        printWaitingMessages(false);
+        printWarningMessage("Skipping component type: "+rTypeName);
+        if (pComponent)
+        {
+            gHopsanCore.removeComponent(pComponent);
+        }
+        delete pSystem;
+        return;
+    }
+    pSystem->addComponent(pComponent);
+
+    const vector<Port*> ports = pComponent->getPortPtrVector();
+    for (size_t p=0; p<ports.size(); ++p)
+    {
+        if (ports[p]->isMultiPort())
+        {
+            for (size_t s=0; s<numSubPorts; ++s)
+            {
+                Port *pSystemPort = pSystem->addSystemPort(ports[p]->getName()+HString(to_string(s).c_str()), "", Port::NotRequired);
+                pSystem->connect(ports[p], pSystemPort);
+            }
+        }
+    }
+
+    // Resolve boundary signals to node data pointers, all subports of multiports get the same value
+    vector< pair<double*, const BoundarySignal*> > boundaryTargets;
+    for (size_t b=0; b<rBoundaries.size(); ++b)
+    {
+        Port *pPort = pComponent->getPort(rBoundaries[b].portName.c_str());
+        if (!pPort)
+        {
+            continue;
+        }
+        const int dataId = pPort->getNodeDataIdFromName(rBoundaries[b].variableName.c_str());
+        if (dataId < 0)
+        {
+            continue;
+        }
+        const size_t numPorts = pPort->isMultiPort() ? pPort->getNumPorts() : 1;
+        for (size_t s=0; s<numPorts; ++s)
+        {
+            boundaryTargets.push_back(make_pair(pPort->getNodeDataPtr(size_t(dataId), s), &rBoundaries[b]));
+        }
+    }
+
+    vector<double> stepTimes;
+    for (size_t i=0; i<numWarmup+numRepetitions; ++i)
+    {
+        if (!pSystem->initialize(0, double(numSteps)*timestep))
+        {
+            break;
+        }
+        double time = 0;
+        const ClockT::time_point start = ClockT::now();
+        for (size_t n=0; n<numSteps; ++n)
+        {
+            time += timestep;
+            for (size_t b=0; b<boundaryTargets.size(); ++b)
+            {
+                const BoundarySignal *pSignal = boundaryTargets[b].second;
+                *boundaryTargets[b].first = (pSignal->amplitude == 0) ? pSignal->offset :
+                                            pSignal->offset + pSignal->amplitude*sin(2*hopsan::pi*pSignal->frequency*time);
+            }
+            pComponent->simulate(time);
+        }
+        const double elapsed = std::chrono::duration<double>(ClockT::now()-start).count();
+        pSystem->finalize();
+        if (pSystem->wasSimulationAborted())
+        {
+            break;
+        }
+        if (i >= numWarmup)
+        {
+            stepTimes.push_back(elapsed/double(numSteps));
+        }
+    }
+    printWaitingMessages(false);
+    if (stepTimes.size() == numRepetitions)
+    {
+        addResult(rResults, rTypeName, "kernel", stepTimes, "", 1, 1e9, "ns/step");
+    }
+    else
+    {
+        printWarningMessage("Kernel benchmark failed for component type: "+rTypeName);
+    }
+
+    delete pSystem;
+}
+
+//! @brief Fills a lookup table with nPerDim index values in each dimension, uniformly spaced or slightly perturbed
+void fillLookupTable(LookupTableNDBase &rTable, const size_t numDims, const size_t nPerDim, const bool uniform)
+{
+    size_t numValues = 1;
+    for (size_t d=0; d<numDims; ++d)
+    {
+        vector<double> &rIndex = rTable.getIndexDataRef(d);
+        rIndex.resize(nPerDim);
+        for (size_t k=0; k<nPerDim; ++k)
+        {
+            rIndex[k] = uniform ? double(k) : double(k)+0.25*sin(double(k));
+        }
+        numValues *= nPerDim;
+    }
+    vector<double> &rValues = rTable.getValueDataRef();
+    rValues.resize(numValues);
+    for (size_t i=0; i<numValues; ++i)
+    {
+        rValues[i] = sin(0.01*double(i));
+    }
+    rTable.isDataOK();
+}
+
+inline double lookupOne(const LookupTable1D &rTable, const vector<double> *pX, const size_t i, size_t *pHints, const bool useHints)
+{
+    return useHints ? rTable.interpolate(pX[0][i], pHints[0]) : rTable.interpolate(pX[0][i]);
+}
+
+inline double lookupOne(const LookupTable2D &rTable, const vector<double> *pX, const size_t i, size_t *pHints, const bool useHints)
+{
+    return useHints ? rTable.interpolate(pX[0][i], pX[1][i], pHints[0], pHints[1]) : rTable.interpolate(pX[0][i], pX[1][i]);
+}
+
+inline double lookupOne(const LookupTable3D &rTable, const vector<double> *pX, const size_t i, size_t *pHints, const bool useHints)
+{
+    return useHints ? rTable.interpolate(pX[0][i], pX[1][i], pX[2][i], pHints[0], pHints[1], pHints[2]) :
+                      rTable.interpolate(pX[0][i], pX[1][i], pX[2][i]);
+}
+
+inline void lookupMany(const LookupTable1D &rTable, const vector<double> *pX, vector<double> &rOut)
+{
+    rTable.interpolateMany(pX[0].data(), rOut.data(), rOut.size());
+}
+
+inline void lookupMany(const LookupTable2D &rTable, const vector<double> *pX, vector<double> &rOut)
+{
+    rTable.interpolateMany(pX[0].data(), pX[1].data(), rOut.data(), rOut.size());
+}
+
+inline void lookupMany(const LookupTable3D &rTable, const vector<double> *pX, vector<double> &rOut)
+{
+    rTable.interpolateMany(pX[0].data(), pX[1].data(), pX[2].data(), rOut.data(), rOut.size());
+}
+
+//! @brief Compares the interval search methods of a lookup table type, the cost is measured per lookup
+//! @details Bisection is used on tables with non-uniform index without search hints, hunting uses the interval from the previous
+//! lookup as hint and uniform tables compute the interval directly. The batched methods interpolate all inputs in one call.
+//! Each method is run with a slowly varying input, as from a simulated signal, and with random input.
+template <typename TableT>
+void benchmarkLookupTable(const size_t numDims, const size_t numElements, const size_t numLookups, const size_t numWarmup,
+                          const size_t numRepetitions, vector<BenchmarkResult> &rResults)
+{
+    const size_t nPerDim = std::max(size_t(2), size_t(std::pow(double(numElements), 1.0/double(numDims))+0.5));
+    TableT nonUniformTable, uniformTable;
+    fillLookupTable(nonUniformTable, numDims, nPerDim, false);
+    fillLookupTable(uniformTable, numDims, nPerDim, true);
+
+    struct Method
+    {
+        const char *name;
+        const TableT *pTable;
+        bool useHints;
+        bool isBatched;
+    };
+    const Method methods[] = {{"bisection", &nonUniformTable, false, false},
+                              {"hunt", &nonUniformTable, true, false},
+                              {"uniform", &uniformTable, false, false},
+                              {"batched", &nonUniformTable, false, true},
+                              {"batched_uniform", &uniformTable, false, true}};
+    const char *inputNames[] = {"sweep", "random"};
+
+    for (size_t in=0; in<2; ++in)
+    {
+        // Each dimension gets a phase shifted sweep, inputs are kept within the index range of both tables
+        vector<double> inputs[3];
+        for (size_t d=0; d<numDims; ++d)
+        {
+            inputs[d].resize(numLookups);
+            for (size_t i=0; i<numLookups; ++i)
+            {
+                const double u = (in == 0) ? 0.5-0.5*cos(2*hopsan::pi*(double(i)/double(numLookups) + double(d)/3.0)) : double(rand())/double(RAND_MAX);
+                inputs[d][i] = u*(double(nPerDim)-1.25);
+            }
+        }
+        vector<double> outputs(numLookups);
+
+        for (size_t m=0; m<sizeof(methods)/sizeof(methods[0]); ++m)
+        {
+            const Method &rMethod = methods[m];
+            double sum = 0;
+            vector<double> times = measure(numWarmup, numRepetitions, [&]()
+            {
+                if (rMethod.isBatched)
+                {
+                    lookupMany(*rMethod.pTable, inputs, outputs);
+                    sum += outputs.back();
+                }
+                else
+                {
+                    size_t hints[3] = {0, 0, 0};
+                    for (size_t i=0; i<numLookups; ++i)
+                    {
+                        sum += lookupOne(*rMethod.pTable, inputs, i, hints, rMethod.useHints);
+                    }
+                }
+                // The sum is checked so that the lookups are not optimized away
+                return std::isfinite(sum);
+            });
+            for (size_t t=0; t<times.size(); ++t)
+            {
+                times[t] /= double(numLookups);
+            }
+            addResult(rResults, to_string(numDims)+"D/"+rMethod.name+"_"+inputNames[in], "lookup", times, "", 1, 1e9, "ns/lookup");
+        }
+    }
+}
+
+bool writeResults(const string &rFilePath, const vector<BenchmarkResult> &rResults, const size_t numWarmup, const size_t numRepetitions)
+{
+    ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << "{\"hopsanCoreVersion\":\"" << gHopsanCore.getCoreVersion() << "\",\"warmup\":" << numWarmup
+         << ",\"repetitions\":" << numRepetitions << ",\"results\":[\n";
+    char buffer[512];
+    for (size_t i=0; i<rResults.size(); ++i)
+    {
+        const BenchmarkResult &r = rResults[i];
+        const Statistics &s = r.stats;
+        // Keep one result per line, the baseline reader depends on it
+        snprintf(buffer, sizeof(buffer), "{\"key\":\"%s\",\"phase\":\"%s\",\"algorithm\":\"%s\",\"threads\":%zu,\"samples\":%zu,"
+                 "\"median\":%.9g,\"p10\":%.9g,\"p90\":%.9g,\"min\":%.9g,\"max\":%.9g,\"mean\":%.9g}%s\n",
+                 r.key.c_str(), r.phase.c_str(), r.algorithm.c_str(), r.numThreads, s.numSamples,
+                 s.median, s.p10, s.p90, s.min, s.max, s.mean, (i+1 < rResults.size()) ? "," : "");
+        file << buffer;
+    }
+    file << "]}\n";
+    return file.good();
+}
+
+//! @brief Reads the median of each result from a result file written by writeResults()
+bool readBaseline(const string &rFilePath, map<string, double> &rMedians)
+{
+    ifstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        return false;
+    }
+    string line;
+    while (getline(file, line))
+    {
+        const size_t keyPos = line.find("{\"key\":\"");
+        const size_t medianPos = line.find("\"median\":");
+        if ((keyPos == string::npos) || (medianPos == string::npos))
+        {
+            continue;
+        }
+        const size_t keyBegin = keyPos+8;
+        const size_t keyEnd = line.find('"', keyBegin);
+        rMedians[line.substr(keyBegin, keyEnd-keyBegin)] = atof(line.c_str()+medianPos+9);
+    }
+    return true;
+}
+
+//! @brief Compares results with a baseline, a result is a regression if its median is slower by more than both tolerances
+//! @returns The number of regressions
+size_t compareWithBaseline(const vector<BenchmarkResult> &rResults, const map<string, double> &rBaseline, const double relTolerance,
+                           const double absTolerance)
+{
+    size_t numRegressions = 0;
+    char buffer[256];
+    for (size_t i=0; i<rResults.size(); ++i)
+    {
+        map<string, double>::const_iterator it = rBaseline.find(rResults[i].key);
+        if (it == rBaseline.end())
+        {
+            continue;
+        }
+        const double current = rResults[i].stats.median;
+        const double baseline = it->second;
+        const double change = (baseline > 0) ? (current-baseline)/baseline : 0;
+        snprintf(buffer, sizeof(buffer), "%-60s baseline: %10.6f s  current: %10.6f s  change: %+7.1f %%", rResults[i].key.c_str(),
+                 baseline, current, 100*change);
+        if ((current > baseline*(1+relTolerance)) && (current-baseline > absTolerance))
+        {
+            printColorMessage(Red, string(buffer)+"  REGRESSION");
+            ++numRegressions;
+        }
+        else
+        {
+            printMessage(buffer);
+        }
+    }
+    return numRegressions;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        TCLAP::CmdLine cmd("hopsanbenchmark", ' ', HOPSANCOREVERSION);
+
+        TCLAP::MultiArg<std::string> modelOption("m", "hmf", "A Hopsan model file to benchmark, can be given multiple times", false, "Path to file", cmd);
+        TCLAP::ValueArg<std::string> modelListOption("", "modelList", "A text file with one model file path per line, relative to the list file", false, "", "Path to file", cmd);
+        TCLAP::ValueArg<int> warmupOption("w", "warmup", "Number of unmeasured warm-up runs of each phase (default: 1)", false, 1, "integer", cmd);
+        TCLAP::ValueArg<int> repeatOption("r", "repeat", "Number of measured runs of each phase (default: 5)", false, 5, "integer", cmd);
+        TCLAP::ValueArg<int> threadsOption("t", "maxThreads", "Benchmark parallel simulation with 1 to this many threads, 0 means number of cores, -1 disables parallel simulation (default: 0)", false, 0, "integer", cmd);
+        TCLAP::MultiArg<std::string> algorithmOption("a", "algorithm", "Parallel algorithm to benchmark, can be given multiple times (default: all)", false, "string", cmd);
+        TCLAP::ValueArg<std::string> outputOption("o", "output", "Write the results as JSON to this file", false, "hopsanbenchmark.json", "Path to file", cmd);
+        TCLAP::ValueArg<std::string> baselineOption("b", "baseline", "Compare the results with a previous output file, and exit with code 1 if any phase has regressed", false, "", "Path to file", cmd);
+        TCLAP::ValueArg<double> toleranceOption("", "tolerance", "Relative slowdown of the median that counts as a regression (default: 0.1)", false, 0.1, "real", cmd);
+        TCLAP::ValueArg<double> minDifferenceOption("", "minDifference", "Smallest absolute slowdown in seconds that counts as a regression (default: 0.001)", false, 0.001, "real", cmd);
+        TCLAP::ValueArg<std::string> exportDirOption("", "exportDir", "Directory for temporary result export files (default: current directory)", false, "", "Path to directory", cmd);
+        TCLAP::MultiArg<std::string> kernelOption("k", "kernel", "Benchmark the cost per time step of this component type alone, can be given multiple times", false, "Component type name", cmd);
+        TCLAP::SwitchArg kernelAllOption("", "kernelAll", "Benchmark the cost per time step of all registered component types", cmd);
+        TCLAP::MultiArg<std::string> kernelExcludeOption("", "kernelExclude", "Component type to exclude from --kernelAll, can be given multiple times", false, "Component type name", cmd);
+        TCLAP::ValueArg<int> kernelStepsOption("", "kernelSteps", "Number of time steps in each kernel benchmark run (default: 1000000)", false, 1000000, "integer", cmd);
+        TCLAP::ValueArg<double> kernelTimestepOption("", "kernelTimestep", "Time step used in kernel benchmarks (default: 0.001)", false, 0.001, "real", cmd);
+        TCLAP::ValueArg<int> kernelSubPortsOption("", "kernelSubPorts", "Number of connections to each multiport in kernel benchmarks (default: 2)", false, 2, "integer", cmd);
+        TCLAP::MultiArg<std::string> kernelBoundaryOption("", "kernelBoundary", "Value written to a port variable before each kernel step as Port#Variable=offset[,amplitude,frequency], can be given multiple times", false, "string", cmd);
+        TCLAP::SwitchArg lookupOption("", "lookup", "Benchmark the interval search methods of 1D, 2D and 3D lookup tables", cmd);
+        TCLAP::ValueArg<int> lookupSizeOption("", "lookupSize", "Number of data values in each lookup table benchmark (default: 10000)", false, 10000, "integer", cmd);
+        TCLAP::ValueArg<int> lookupCountOption("", "lookupCount", "Number of lookups in each lookup table benchmark run (default: 1000000)", false, 1000000, "integer", cmd);
+        TCLAP::MultiArg<std::string> extLibPathsOption("e", "externalLib", "Path to a .dll/.so/.dylib externalComponentLib. Can be given multiple times", false, "Path to file", cmd);
+
+        cmd.parse(argc, argv);
+
+        vector<string> models = modelOption.getValue();
+        if (modelListOption.isSet())
+        {
+            ifstream listFile(modelListOption.getValue().c_str());
+            if (!listFile.is_open())
+            {
+                printErrorMessage("Could not open model list: "+modelListOption.getValue());
+                return -1;
+            }
+            // Relative paths in the list are relative to the list file
+            string listDir, listFileName;
+            splitFilePath(modelListOption.getValue(), listDir, listFileName);
+            string line;
+            while (getline(listFile, line))
+            {
+                if (!line.empty() && (line[line.size()-1] == '\r'))
+                {
+                    line.erase(line.size()-1);
+                }
+                if (!line.empty() && (line[0] != '#'))
+                {
+                    const bool isAbsolute = (line[0] == '/') || (line[0] == '\\') || ((line.size() > 1) && (line[1] == ':'));
+                    models.push_back(isAbsolute ? line : listDir+line);
+                }
+            }
+        }
+        const bool doKernels = kernelOption.isSet() || kernelAllOption.getValue();
+        if (models.empty() && !doKernels && !lookupOption.getValue())
+        {
+            printErrorMessage("No models or component types given, use -m, --modelList, --kernel, --kernelAll or --lookup");
+            return -1;
+        }
+
+        vector<BoundarySignal> boundaries;
+        for (size_t i=0; i<kernelBoundaryOption.getValue().size(); ++i)
+        {
+            BoundarySignal signal;
+            if (!parseBoundarySignal(kernelBoundaryOption.getValue()[i], signal))
+            {
+                printErrorMessage("Invalid kernel boundary: "+kernelBoundaryOption.getValue()[i]);
+                return -1;
+            }
+            boundaries.push_back(signal);
+        }
+
+        const size_t numWarmup = size_t(std::max(warmupOption.getValue(), 0));
+        const size_t numRepetitions = size_t(std::max(repeatOption.getValue(), 1));
+        size_t maxNumThreads = 0;
+        if (threadsOption.getValue() == 0)
+        {
+            maxNumThreads = getNumAvailibleCores();
+        }
+        else if (threadsOption.getValue() > 0)
+        {
+            maxNumThreads = size_t(threadsOption.getValue());
+        }
+
+        vector<AlgorithmName> algorithms;
+        for (size_t a=0; a<sizeof(gAlgorithms)/sizeof(gAlgorithms[0]); ++a)
+        {
+            const vector<string> &rSelected = algorithmOption.getValue();
+            if (rSelected.empty() || (std::find(rSelected.begin(), rSelected.end(), gAlgorithms[a].name) != rSelected.end()))
+            {
+                algorithms.push_back(gAlgorithms[a]);
+            }
+        }
+
+        string exportDir = exportDirOption.getValue();
+        if (!exportDir.empty() && (exportDir[exportDir.size()-1] != '/'))
+        {
+            exportDir.push_back('/');
+        }
+
+#ifndef HOPSAN_INTERNALDEFAULTCOMPONENTS
+        gHopsanCore.loadExternalComponentLib((getCurrentExecPath()+"/"+default_library).c_str());
+#endif
+        for (size_t i=0; i<extLibPathsOption.getValue().size(); ++i)
+        {
+            if (!gHopsanCore.loadExternalComponentLib(extLibPathsOption.getValue()[i].c_str()))
+            {
+                printErrorMessage("Failed to load External library: "+extLibPathsOption.getValue()[i]);
+            }
+        }
+        printWaitingMessages(false);
+
+        vector<BenchmarkResult> results;
+        for (size_t m=0; m<models.size(); ++m)
+        {
+            cout << "Benchmarking: " << models[m] << endl;
+            benchmarkModel(models[m], numWarmup, numRepetitions, maxNumThreads, algorithms, exportDir, results);
+        }
+
+        if (doKernels)
+        {
+            vector<string> types = kernelOption.getValue();
+            if (kernelAllOption.getValue())
+            {
+                const vector<HString> registered = gHopsanCore.getRegisteredComponentTypes();
+                const vector<string> &rExcluded = kernelExcludeOption.getValue();
+                for (size_t i=0; i<registered.size(); ++i)
+                {
+                    if (std::find(rExcluded.begin(), rExcluded.end(), registered[i].c_str()) == rExcluded.end())
+                    {
+                        types.push_back(registered[i].c_str());
+                    }
+                }
+            }
+            const size_t numSteps = size_t(std::max(kernelStepsOption.getValue(), 1));
+            const size_t numSubPorts = size_t(std::max(kernelSubPortsOption.getValue(), 1));
+            for (size_t i=0; i<types.size(); ++i)
+            {
+                benchmarkComponentKernel(types[i], numSteps, kernelTimestepOption.getValue(), numSubPorts, boundaries,
+                                         numWarmup, numRepetitions, results);
+            }
+        }
+
+        if (lookupOption.getValue())
+        {
+            const size_t numElements = size_t(std::max(lookupSizeOption.getValue(), 2));
+            const size_t numLookups = size_t(std::max(lookupCountOption.getValue(), 1));
+            benchmarkLookupTable<LookupTable1D>(1, numElements, numLookups, numWarmup, numRepetitions, results);
+            benchmarkLookupTable<LookupTable2D>(2, numElements, numLookups, numWarmup, numRepetitions, results);
+            benchmarkLookupTable<LookupTable3D>(3, numElements, numLookups, numWarmup, numRepetitions, results);
+        }
+
+        if (!writeResults(outputOption.getValue(), results, numWarmup, numRepetitions))
+        {
+            printErrorMessage("Could not write results to: "+outputOption.getValue());
+            return -1;
+        }
+        cout << "Results written to: " << outputOption.getValue() << endl;
+
+        if (baselineOption.isSet())
+        {
+            map<string, double> baseline;
+            if (!readBaseline(baselineOption.getValue(), baseline))
+            {
+                printErrorMessage("Could not read baseline: "+baselineOption.getValue());
+                return -1;
+            }
+            const size_t numRegressions = compareWithBaseline(results, baseline, toleranceOption.getValue(), minDifferenceOption.getValue());
+            if (numRegressions > 0)
+            {
+                printErrorMessage(to_string(numRegressions)+" benchmark results have regressed compared to the baseline");
+                return 1;
+            }
+        }
+    }
+    catch (TCLAP::ArgException &e)
+    {
+        std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
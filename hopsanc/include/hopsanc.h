@@ -33,6 +33,38 @@ extern "C" {
     HOPSANC_DLLAPI int getTimeVector(double *data);
     HOPSANC_DLLAPI int getDataVector(const char *variable, double *data);
     HOPSANC_DLLAPI size_t getNumberOfLogSamples();
+    HOPSANC_DLLAPI int openResultFile(const char* path);
+    HOPSANC_DLLAPI int closeResultFile();
+    HOPSANC_DLLAPI size_t getResultFileNumberOfVariables();
+    HOPSANC_DLLAPI int getResultFileVariableName(size_t index, char* buf, size_t bufSize);
+    HOPSANC_DLLAPI int getResultFileDataPtr(const char* variable, const double **data, const double **time, size_t *numSamples);
+    HOPSANC_DLLAPI int getResultFileDataWindow(const char* variable, double startTime, double stopTime, double *data, size_t bufSize, size_t *numSamples);
+
+    // Handle based API, each handle is an independent model instance that can be used from its own thread
+    typedef struct HopsanModel HopsanModel;
+
+    HOPSANC_DLLAPI HopsanModel* modelLoad(const char* path);
+    HOPSANC_DLLAPI void modelFree(HopsanModel* model);
+    HOPSANC_DLLAPI int modelGetMessage(HopsanModel* model, char* buf, size_t bufSize);
+    HOPSANC_DLLAPI int modelSetParameter(HopsanModel* model, const char* name, const char* value);
+    HOPSANC_DLLAPI int modelSetParameterDouble(HopsanModel* model, const char* name, double value);
+    HOPSANC_DLLAPI int modelSetParameterInt(HopsanModel* model, const char* name, int value);
+    HOPSANC_DLLAPI int modelSetParametersDouble(HopsanModel* model, const char** names, const double* values, size_t count);
+    HOPSANC_DLLAPI int modelSetStartTime(HopsanModel* model, double value);
+    HOPSANC_DLLAPI int modelSetTimeStep(HopsanModel* model, double value);
+    HOPSANC_DLLAPI int modelSetStopTime(HopsanModel* model, double value);
+    HOPSANC_DLLAPI int modelSetNumberOfLogSamples(HopsanModel* model, size_t value);
+    HOPSANC_DLLAPI int modelSimulate(HopsanModel* model);
+    HOPSANC_DLLAPI int modelInitialize(HopsanModel* model);
+    HOPSANC_DLLAPI int modelSimulateTo(HopsanModel* model, double time);
+    HOPSANC_DLLAPI int modelFinalize(HopsanModel* model);
+    HOPSANC_DLLAPI double modelGetTime(HopsanModel* model);
+    HOPSANC_DLLAPI size_t modelGetNumberOfLogSamples(HopsanModel* model);
+    HOPSANC_DLLAPI const double* modelGetTimeVectorPtr(HopsanModel* model);
+    HOPSANC_DLLAPI const double* modelGetDataVectorPtr(HopsanModel* model, const char* variable);
+    HOPSANC_DLLAPI int modelGetDataVectorPtrs(HopsanModel* model, const char** variables, const double** data, size_t count);
+    HOPSANC_DLLAPI int modelGetValues(HopsanModel* model, const char** variables, double* values, size_t count);
+    HOPSANC_DLLAPI int modelSetValues(HopsanModel* model, const char** variables, const double* values, size_t count);
 
 #ifdef __cplusplus
 }
@@ -2,23 +2,41 @@
 #include <iostream>
 #include <string.h>
 #include <vector>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "HopsanCore.h"
 #include "HopsanEssentials.h"
 #include "ComponentSystem.h"
 #include "ComponentUtilities/num2string.hpp"
+#include "CoreUtilities/HopsanCoreMessageHandler.h"
+#include "CoreUtilities/ResultFile.h"
 
 static hopsan::ComponentSystem *spCoreComponentSystem = nullptr;
 static hopsan::HopsanEssentials gHopsanCore;
 
+static hopsan::ResultFileReader gResultFile;
+
 static double startTime, stopTime;
 
-std::vector<hopsan::HString> msgVec;
+//! @brief Protects the shared HopsanEssentials instance (component factory, library loading and message queue)
+static std::mutex gCoreMutex;
+
+//! @brief Protects the message queue used by printMessage() and getMessage()
+static std::mutex gMessageMutex;
+
+static std::vector<hopsan::HString> msgVec;
+
+typedef std::function<void(const hopsan::HString&)> MessageFunctionT;
 
 //! @brief Puts specified message in message queue and prints it to cout
 //! The queue is used by host environments that does not support printing couts, e.g. Matlab
 //! @param [in] msg Message string
 void printMessage(hopsan::HString msg) {
+    std::lock_guard<std::mutex> lock(gMessageMutex);
     msgVec.push_back(msg);
     std::cout << msg.c_str() << "\n";
 }
@@ -30,6 +48,7 @@ void printWaitingMessages(hopsan::HopsanEssentials& hopsanCore, bool printDebug,
 {
     if(silent) return;
 
+    std::lock_guard<std::mutex> lock(gCoreMutex);
     hopsan::HString msg, type, tag;
     while (hopsanCore.checkMessage() > 0) {
         hopsanCore.getMessage(msg,type,tag);
@@ -52,6 +71,7 @@ void printWaitingMessages(hopsan::HopsanEssentials& hopsanCore, bool printDebug,
 //! @returns Status (0 = success)
 int getMessage(char* buf, size_t bufSize) {
 
+    std::lock_guard<std::mutex> lock(gMessageMutex);
     if(!msgVec.empty()) {
         if(bufSize < msgVec.at(0).size()) {
             msgVec.at(0) = msgVec.at(0).substr(0,bufSize);
@@ -70,7 +90,10 @@ int loadModel(const char* path) {
     if(spCoreComponentSystem) {
         delete spCoreComponentSystem;
     }
-    spCoreComponentSystem = gHopsanCore.loadHMFModelFile(path, startTime, stopTime);
+    {
+        std::lock_guard<std::mutex> lock(gCoreMutex);
+        spCoreComponentSystem = gHopsanCore.loadHMFModelFile(path, startTime, stopTime);
+    }
     if(!spCoreComponentSystem) {
         printMessage("Failed to instantiate model!");
         printWaitingMessages(gHopsanCore, false, false);
@@ -84,17 +107,30 @@ int loadModel(const char* path) {
 }
 
 
-//! @brief Provides specified data vector from last simulation
-//! @param [in] variable Variable name ("component.port.variable")
-//! @param [in,out] data Buffer where data vector is stored (must be preallocated to match number of log samples)
-//! @returns Status (0 = success)
-int getDataVector(const char* variable, double *data)
+//! @brief Moves waiting messages, except debug messages, from a message handler to a message vector
+//! @param [in] pHandler The message handler to take messages from
+//! @param [in,out] rMessages The vector that the messages are appended to
+static void takeWaitingMessages(hopsan::HopsanCoreMessageHandler *pHandler, std::vector<hopsan::HString> &rMessages)
 {
-    if(!spCoreComponentSystem) {
-        printMessage("Error: No model is loaded.");
-        return -1;
+    hopsan::HString msg, type, tag;
+    while (pHandler->getNumWaitingMessages() > 0) {
+        pHandler->getMessage(msg,type,tag);
+        if (type != "debug") {
+            rMessages.push_back(msg);
+        }
     }
+}
 
+
+//! @brief Finds the port and node data id of a variable
+//! @param [in] pRootSystem The top level system of the model
+//! @param [in] variable Variable name ("component.port.variable", with "subsystem|" prefixes, or an alias)
+//! @param [out] rpPort The port where the variable was found
+//! @param [out] rVarId The node data id of the variable
+//! @param [in] printFunc Function used to report errors
+//! @returns True if the variable was found
+static bool findVariable(hopsan::ComponentSystem *pRootSystem, const char* variable, hopsan::Port *&rpPort, int &rVarId, const MessageFunctionT &printFunc)
+{
     //Parse variable string
     hopsan::HString varStr(variable);
     hopsan::HVector<hopsan::HString> splitSys = varStr.split('|');
@@ -102,62 +138,78 @@ int getDataVector(const char* variable, double *data)
     splitSys.resize(splitSys.size()-1);
 
     //Find system
-    hopsan::ComponentSystem *pSystem = spCoreComponentSystem;
+    hopsan::ComponentSystem *pSystem = pRootSystem;
     for(size_t i=0; i<splitSys.size(); ++i) {
         pSystem = pSystem->getSubComponentSystem(splitSys[i]);
         if(!pSystem) {
-            printMessage("Error: Subsystem not found: "+splitSys[i]);
-            return -1;
+            printFunc("Error: Subsystem not found: "+splitSys[i]);
+            return false;
         }
     }
 
     //Check for alias if splitVar is of size one
     if(splitVar.size() == 1 && pSystem->getAliasHandler().hasAlias(splitVar[0])) {
         hopsan::HString compName, portName;
-        int varId;
-        pSystem->getAliasHandler().getVariableFromAlias(splitVar[0], compName, portName, varId);
+        pSystem->getAliasHandler().getVariableFromAlias(splitVar[0], compName, portName, rVarId);
         hopsan::Component *pComp = pSystem->getSubComponent(compName);
-        hopsan::Port *pPort = pComp->getPort(portName);
-        std::vector< std::vector<double> > *pLogData = pPort->getLogDataVectorPtr();
-        for (size_t t=0; t<pSystem->getNumActuallyLoggedSamples(); ++t) {
-            data[t] = (*pLogData)[t][size_t(varId)];
-        }
-        return 0;   //Found alias variable!
+        rpPort = pComp->getPort(portName);
+        return true;   //Found alias variable!
     }
     else if(splitVar.size() < 3) {
-        printMessage("Error: Component name, port name and variable name must be specified.");
-        return -1;
+        printFunc("Error: Component name, port name and variable name must be specified.");
+        return false;
     }
 
     //Find component
     hopsan::Component *pComp = pSystem->getSubComponent(splitVar[0]);
     if(!pComp) {
-        printMessage("Error: No such component: "+splitVar[0]);
-        printMessage("Alternatives:");
+        printFunc("Error: No such component: "+splitVar[0]);
+        printFunc("Alternatives:");
         for(const hopsan::HString &name : pSystem->getSubComponentNames()) {
-            printMessage("  "+name);
+            printFunc("  "+name);
         }
-        return -1;
+        return false;
     }
 
     //Find port
     hopsan::Port *pPort = pComp->getPort(splitVar[1]);
     if(!pPort) {
-        printMessage("Error: No such port: "+splitVar[1]);
-        printMessage("Alternatives:");
+        printFunc("Error: No such port: "+splitVar[1]);
+        printFunc("Alternatives:");
         for(const hopsan::HString &name : pComp->getPortNames()) {
-            printMessage("  "+name);
+            printFunc("  "+name);
         }
-        return -1;
+        return false;
     }
 
-    int varId = pPort->getNodeDataIdFromName(splitVar[2]);
-    if(varId < 0) {
-        printMessage("Error: No such variable: "+splitVar[2]);
-        printMessage("Alternatives:");
+    rVarId = pPort->getNodeDataIdFromName(splitVar[2]);
+    if(rVarId < 0) {
+        printFunc("Error: No such variable: "+splitVar[2]);
+        printFunc("Alternatives:");
         for(const auto &node : *pPort->getNodeDataDescriptions(0)) {
-            printMessage("  "+node.name);
+            printFunc("  "+node.name);
         }
+        return false;
+    }
+    rpPort = pPort;
+    return true;
+}
+
+
+//! @brief Provides specified data vector from last simulation
+//! @param [in] variable Variable name ("component.port.variable")
+//! @param [in,out] data Buffer where data vector is stored (must be preallocated to match number of log samples)
+//! @returns Status (0 = success)
+int getDataVector(const char* variable, double *data)
+{
+    if(!spCoreComponentSystem) {
+        printMessage("Error: No model is loaded.");
+        return -1;
+    }
+
+    hopsan::Port *pPort;
+    int varId;
+    if(!findVariable(spCoreComponentSystem, variable, pPort, varId, printMessage)) {
         return -1;
     }
 
@@ -174,7 +226,12 @@ int getDataVector(const char* variable, double *data)
 //! @returns Status (0 = success)
 int loadLibrary(const char *path)
 {
-    if(!gHopsanCore.loadExternalComponentLib(path)) {
+    bool success;
+    {
+        std::lock_guard<std::mutex> lock(gCoreMutex);
+        success = gHopsanCore.loadExternalComponentLib(path);
+    }
+    if(!success) {
         printWaitingMessages(gHopsanCore, false, false);
         return -1;
     };
@@ -273,17 +330,14 @@ int getTimeVector(double *data)
 }
 
 
-//! @brief Sets a parameter value
+//! @brief Sets a parameter value in a model
+//! @param [in] pRootSystem The top level system of the model
 //! @param [in] name Name of parameter (with all qualifiers)
 //! @param [in] value New value for parameter (will be converted from string to correct type)
-//! @returns Status (0 = success)
-int setParameter(const char *name, const char *value)
+//! @param [in] printFunc Function used to report errors
+//! @returns True if the parameter was set
+static bool setParameterValue(hopsan::ComponentSystem *pRootSystem, const char *name, const hopsan::HString &value, const MessageFunctionT &printFunc)
 {
-    if(!spCoreComponentSystem) {
-        printMessage("Error: No model is loaded.");
-        return -1;
-    }
-
     //Parse arguments
     hopsan::HString nameStr(name);
     hopsan::HVector<hopsan::HString> sysVec = nameStr.split('|');
@@ -305,45 +359,60 @@ int setParameter(const char *name, const char *value)
         parName = nameVec[1]+"#"+nameVec[2];
     }
     else {
-        printMessage("Error: Parameter name not specified.");
-        return -1;
+        printFunc("Error: Parameter name not specified.");
+        return false;
     }
 
     //Find system
-    hopsan::ComponentSystem *pSystem = spCoreComponentSystem;
+    hopsan::ComponentSystem *pSystem = pRootSystem;
     for(size_t i=0; i<sysVec.size(); ++i) {
         pSystem = pSystem->getSubComponentSystem(sysVec[i]);
         if(!pSystem) {
-            printMessage("Error: Subsystem not found: "+sysVec[i]);
-            return -1;
+            printFunc("Error: Subsystem not found: "+sysVec[i]);
+            return false;
         }
     }
 
     if(compName.empty()) {   //Set system parameter
-        if(pSystem->setParameterValue(parName, hopsan::HString(value))) {
-            return 0;
+        if(pSystem->setParameterValue(parName, value)) {
+            return true;
         }
         else {
-            printMessage("Error: Failed to set parameter value: "+parName);
-            return -1;
+            printFunc("Error: Failed to set parameter value: "+parName);
+            return false;
         }
     }
-    else if(nameVec.size() == 2 || nameVec.size() == 3) { //Set constant or input variable
+    else { //Set constant or input variable
         hopsan::Component *pComp = pSystem->getSubComponent(compName);
         if(!pComp) {
-            printMessage("Error: No such component: "+compName);
-            return -1;
+            printFunc("Error: No such component: "+compName);
+            return false;
         }
-        if(pComp->setParameterValue(parName, hopsan::HString(value))) {
-            return 0;
+        if(pComp->setParameterValue(parName, value)) {
+            return true;
         }
         else {
-            printMessage("Error: Failed to set parameter value: "+parName);
-            return -1;
+            printFunc("Error: Failed to set parameter value: "+parName);
+            return false;
         }
     }
+}
+
+
+//! @brief Sets a parameter value
+//! @param [in] name Name of parameter (with all qualifiers)
+//! @param [in] value New value for parameter (will be converted from string to correct type)
+//! @returns Status (0 = success)
+int setParameter(const char *name, const char *value)
+{
+    if(!spCoreComponentSystem) {
+        printMessage("Error: No model is loaded.");
+        return -1;
+    }
 
-    printMessage("Error: Wrong number of arguments.");
+    if(setParameterValue(spCoreComponentSystem, name, hopsan::HString(value), printMessage)) {
+        return 0;
+    }
     return -1;
 }
 
@@ -379,3 +448,560 @@ int printWaitingMessages()
     printWaitingMessages(gHopsanCore, false, false);
     return 0;
 }
+
+
+//! @brief Opens a Hopsan binary result file (.hrb) using memory mapping, any previously opened result file is closed
+//! @param [in] path Path to result file
+//! @returns Status (0 = success)
+int openResultFile(const char *path)
+{
+    if(!gResultFile.openFile(path)) {
+        printMessage("Error: "+gResultFile.getErrorString());
+        return -1;
+    }
+    return 0;
+}
+
+
+//! @brief Closes the opened result file, pointers obtained from getResultFileDataPtr() become invalid
+//! @returns Status (0 = success)
+int closeResultFile()
+{
+    gResultFile.closeFile();
+    return 0;
+}
+
+
+//! @brief Returns number of variables (including time vectors) in the opened result file
+//! @returns Number of variables
+size_t getResultFileNumberOfVariables()
+{
+    return gResultFile.getNumVariables();
+}
+
+
+//! @brief Provides the full name of a variable in the opened result file
+//! Name will be truncated if buffer is too small
+//! @param [in] index Variable index
+//! @param [in,out] buf Name buffer
+//! @param [in] bufSize Buffer size
+//! @returns Status (0 = success)
+int getResultFileVariableName(size_t index, char *buf, size_t bufSize)
+{
+    const hopsan::ResultFileVariable *pVariable = gResultFile.getVariable(index);
+    if(!pVariable || bufSize == 0) {
+        return -1;
+    }
+    const size_t len = std::min(pVariable->mName.size(), bufSize-1);
+    memcpy(buf, pVariable->mName.c_str(), len);
+    buf[len] = '\0';
+    return 0;
+}
+
+
+//! @brief Provides pointers directly into the memory mapped result file, no data is copied
+//! @param [in] variable Full variable name or alias
+//! @param [out] data Pointer to variable data
+//! @param [out] time Pointer to corresponding time data (null if variable has no time vector), may be null
+//! @param [out] numSamples Number of samples
+//! @returns Status (0 = success)
+int getResultFileDataPtr(const char *variable, const double **data, const double **time, size_t *numSamples)
+{
+    const int idx = gResultFile.findVariable(variable);
+    if(idx < 0) {
+        printMessage("Error: No such variable in result file: "+hopsan::HString(variable));
+        return -1;
+    }
+    *data = gResultFile.getVariableData(size_t(idx));
+    if(time) {
+        *time = gResultFile.getTimeData(size_t(idx));
+    }
+    *numSamples = gResultFile.getVariable(size_t(idx))->mNumSamples;
+    return 0;
+}
+
+
+//! @brief Copies the samples of a variable within a time window from the opened result file
+//! @param [in] variable Full variable name or alias
+//! @param [in] startTime Window start time
+//! @param [in] stopTime Window stop time
+//! @param [in,out] data Buffer where data is stored
+//! @param [in] bufSize Buffer size (number of doubles)
+//! @param [out] numSamples Number of copied samples
+//! @returns Status (0 = success)
+int getResultFileDataWindow(const char *variable, double startTime, double stopTime, double *data, size_t bufSize, size_t *numSamples)
+{
+    *numSamples = 0;
+    const int idx = gResultFile.findVariable(variable);
+    if(idx < 0) {
+        printMessage("Error: No such variable in result file: "+hopsan::HString(variable));
+        return -1;
+    }
+    size_t first, count;
+    if(!gResultFile.findTimeWindow(size_t(idx), startTime, stopTime, first, count)) {
+        printMessage("Error: Variable has no time vector: "+hopsan::HString(variable));
+        return -1;
+    }
+    *numSamples = gResultFile.copyVariableData(size_t(idx), first, std::min(count, bufSize), data);
+    return 0;
+}
+
+
+//! @brief An independent model instance used through the handle based API
+//! All access to one instance is serialized by its mutex, different instances can be used concurrently from different threads
+struct HopsanModel
+{
+    typedef std::pair<hopsan::Port*, int> VariableT;
+
+    hopsan::ComponentSystem *mpSystem = nullptr;
+    double mStartTime = 0;
+    double mStopTime = 1;
+    bool mIsInitialized = false;
+    std::mutex mMutex;
+    hopsan::HopsanCoreMessageHandler mMessageHandler;
+    std::vector<hopsan::HString> mMessages;
+    std::map<std::string, VariableT> mVariables;
+    std::map<std::string, std::vector<double> > mLogColumns;
+
+    void addMessage(const hopsan::HString &msg)
+    {
+        mMessages.push_back(msg);
+    }
+
+    //! @brief Moves waiting messages from the message handler of this model to its message queue
+    void takeCoreMessages()
+    {
+        takeWaitingMessages(&mMessageHandler, mMessages);
+    }
+
+    //! @brief Looks up a variable, the result is cached so that the name is only parsed once
+    bool getVariable(const char *variable, VariableT &rVariable)
+    {
+        auto it = mVariables.find(variable);
+        if(it != mVariables.end()) {
+            rVariable = it->second;
+            return true;
+        }
+        hopsan::Port *pPort;
+        int varId;
+        if(!findVariable(mpSystem, variable, pPort, varId, [this](const hopsan::HString &msg){addMessage(msg);})) {
+            return false;
+        }
+        rVariable = VariableT(pPort, varId);
+        mVariables.insert(std::make_pair(std::string(variable), rVariable));
+        return true;
+    }
+
+    //! @brief Returns a pointer to a contiguous copy of a logged variable, the copy is made once per simulation
+    const double *getLogColumn(const char *variable)
+    {
+        auto it = mLogColumns.find(variable);
+        if(it != mLogColumns.end()) {
+            return it->second.data();
+        }
+        VariableT var;
+        if(!getVariable(variable, var)) {
+            return nullptr;
+        }
+        if(!var.first->haveLogData()) {
+            addMessage("Error: Variable has not been logged: "+hopsan::HString(variable));
+            return nullptr;
+        }
+        const std::vector< std::vector<double> > *pLogData = var.first->getLogDataVectorPtr();
+        const size_t nSamples = std::min(mpSystem->getNumActuallyLoggedSamples(), pLogData->size());
+        std::vector<double> &rColumn = mLogColumns[variable];
+        rColumn.resize(nSamples);
+        for (size_t t=0; t<nSamples; ++t) {
+            rColumn[t] = (*pLogData)[t][size_t(var.second)];
+        }
+        return rColumn.data();
+    }
+
+    bool initialize()
+    {
+        if(mIsInitialized) {
+            mpSystem->finalize();
+            mIsInitialized = false;
+        }
+        mLogColumns.clear();
+        if (!mpSystem->checkModelBeforeSimulation()) {
+            addMessage("Error: Model check failed");
+            takeCoreMessages();
+            return false;
+        }
+        mIsInitialized = mpSystem->initialize(mStartTime, mStopTime);
+        takeCoreMessages();
+        if(!mIsInitialized) {
+            addMessage("Error: Initialization failed");
+        }
+        return mIsInitialized;
+    }
+
+    void finalize()
+    {
+        if(mIsInitialized) {
+            mpSystem->finalize();
+            mIsInitialized = false;
+        }
+        takeCoreMessages();
+    }
+};
+
+
+//! @brief Loads a model file into a new independent model instance
+//! The instance must be released with modelFree()
+//! @param [in] path Full path to model file
+//! @returns Model handle, or null if loading failed (messages can then be read with getMessage())
+HopsanModel *modelLoad(const char *path)
+{
+    HopsanModel *pModel = new HopsanModel();
+    double start, stop;
+    hopsan::ComponentSystem *pSystem;
+    std::vector<hopsan::HString> loadMessages;
+    {
+        // Messages from loading end up in the shared core message handler, take them while still holding the lock
+        // After loading the model reports to its own message handler, so that models never take each others messages
+        std::lock_guard<std::mutex> lock(gCoreMutex);
+        pSystem = gHopsanCore.loadHMFModelFile(path, start, stop);
+        takeWaitingMessages(gHopsanCore.getCoreMessageHandler(), loadMessages);
+        if(pSystem) {
+            pSystem->setMessageHandler(&pModel->mMessageHandler);
+        }
+    }
+    if(!pSystem) {
+        delete pModel;
+        printMessage("Failed to instantiate model!");
+        for(size_t i=0; i<loadMessages.size(); ++i) {
+            printMessage(loadMessages[i]);
+        }
+        return nullptr;
+    }
+    pSystem->addSearchPath(pSystem->getName()+"-resources");
+
+    pModel->mpSystem = pSystem;
+    pModel->mStartTime = start;
+    pModel->mStopTime = stop;
+    pModel->mMessages.swap(loadMessages);
+    pModel->takeCoreMessages();
+    return pModel;
+}
+
+
+//! @brief Finalizes (if needed) and deletes a model instance, all pointers obtained from the model become invalid
+//! @param [in] model Model handle
+void modelFree(HopsanModel *model)
+{
+    if(!model) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(model->mMutex);
+        if(model->mIsInitialized) {
+            model->mpSystem->finalize();
+        }
+        delete model->mpSystem;
+    }
+    delete model;
+}
+
+
+//! @brief Reads a message from the message queue of a model and removes it, unless queue is empty
+//! Message will be truncated if buffer is too small
+//! @param [in] model Model handle
+//! @param [in,out] buf Message buffer
+//! @param [in] bufSize Buffer size
+//! @returns Status (0 = success)
+int modelGetMessage(HopsanModel *model, char *buf, size_t bufSize)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    if(model->mMessages.empty() || bufSize == 0) {
+        return -1;
+    }
+    const hopsan::HString &msg = model->mMessages.front();
+    const size_t len = std::min(msg.size(), bufSize-1);
+    memcpy(buf, msg.c_str(), len);
+    buf[len] = '\0';
+    model->mMessages.erase(model->mMessages.begin());
+    return 0;
+}
+
+
+//! @brief Sets a parameter value in a model
+//! @param [in] model Model handle
+//! @param [in] name Name of parameter (with all qualifiers)
+//! @param [in] value New value for parameter (will be converted from string to correct type)
+//! @returns Status (0 = success)
+int modelSetParameter(HopsanModel *model, const char *name, const char *value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    if(setParameterValue(model->mpSystem, name, hopsan::HString(value), [model](const hopsan::HString &msg){model->addMessage(msg);})) {
+        return 0;
+    }
+    return -1;
+}
+
+
+//! @brief Sets a numeric parameter value in a model
+//! @param [in] model Model handle
+//! @param [in] name Name of parameter (with all qualifiers)
+//! @param [in] value New value for parameter
+//! @returns Status (0 = success)
+int modelSetParameterDouble(HopsanModel *model, const char *name, double value)
+{
+    return modelSetParametersDouble(model, &name, &value, 1);
+}
+
+
+//! @brief Sets an integer parameter value in a model
+//! @param [in] model Model handle
+//! @param [in] name Name of parameter (with all qualifiers)
+//! @param [in] value New value for parameter
+//! @returns Status (0 = success)
+int modelSetParameterInt(HopsanModel *model, const char *name, int value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    if(setParameterValue(model->mpSystem, name, to_hstring(value), [model](const hopsan::HString &msg){model->addMessage(msg);})) {
+        return 0;
+    }
+    return -1;
+}
+
+
+//! @brief Sets several numeric parameter values in a model
+//! @param [in] model Model handle
+//! @param [in] names Array of parameter names (with all qualifiers)
+//! @param [in] values Array of new parameter values
+//! @param [in] count Number of parameters
+//! @returns Status (0 = success, otherwise the number of parameters that could not be set)
+int modelSetParametersDouble(HopsanModel *model, const char **names, const double *values, size_t count)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    int nFailed = 0;
+    for(size_t i=0; i<count; ++i) {
+        if(!setParameterValue(model->mpSystem, names[i], to_hstring(values[i]), [model](const hopsan::HString &msg){model->addMessage(msg);})) {
+            ++nFailed;
+        }
+    }
+    return nFailed;
+}
+
+
+//! @brief Sets start time for simulation of a model
+//! @param [in] model Model handle
+//! @param [in] value Start time
+//! @returns Status (0 = success)
+int modelSetStartTime(HopsanModel *model, double value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    model->mStartTime = value;
+    return 0;
+}
+
+
+//! @brief Sets time step for simulation of a model
+//! @param [in] model Model handle
+//! @param [in] value Time step
+//! @returns Status (0 = success)
+int modelSetTimeStep(HopsanModel *model, double value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    model->mpSystem->setDesiredTimestep(value);
+    return 0;
+}
+
+
+//! @brief Sets stop time for simulation of a model
+//! @param [in] model Model handle
+//! @param [in] value Stop time
+//! @returns Status (0 = success)
+int modelSetStopTime(HopsanModel *model, double value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    model->mStopTime = value;
+    return 0;
+}
+
+
+//! @brief Specifies number of log samples for the simulation of a model
+//! @param [in] model Model handle
+//! @param [in] value Number of samples
+//! @returns Status (0 = success)
+int modelSetNumberOfLogSamples(HopsanModel *model, size_t value)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    model->mpSystem->setNumLogSamples(value);
+    return 0;
+}
+
+
+//! @brief Runs a complete simulation (check, initialize, simulate and finalize) of a model
+//! @param [in] model Model handle
+//! @returns Status (0 = success)
+int modelSimulate(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    if(!model->initialize()) {
+        return -1;
+    }
+    model->mpSystem->simulate(model->mStopTime);
+    model->finalize();
+    return model->mpSystem->wasSimulationAborted() ? -1 : 0;
+}
+
+
+//! @brief Checks and initializes a model for stepwise simulation with modelSimulateTo()
+//! An already initialized model is finalized first
+//! @param [in] model Model handle
+//! @returns Status (0 = success)
+int modelInitialize(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    return model->initialize() ? 0 : -1;
+}
+
+
+//! @brief Simulates a model from its current time to the specified time, can be called repeatedly for co-simulation
+//! The model is initialized first if needed. Log data is stored up to the stop time set before initialization.
+//! @param [in] model Model handle
+//! @param [in] time Time to simulate to (must not be larger than the stop time)
+//! @returns Status (0 = success)
+int modelSimulateTo(HopsanModel *model, double time)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    if(!model->mIsInitialized && !model->initialize()) {
+        return -1;
+    }
+    if(time > model->mStopTime + 0.5*model->mpSystem->getDesiredTimeStep()) {
+        model->addMessage("Error: Can not simulate beyond stop time: "+to_hstring(model->mStopTime));
+        return -1;
+    }
+    model->mLogColumns.clear();
+    model->mpSystem->simulate(time);
+    if(model->mpSystem->wasSimulationAborted()) {
+        model->takeCoreMessages();
+        return -1;
+    }
+    return 0;
+}
+
+
+//! @brief Finalizes a model after stepwise simulation, log data remains available
+//! @param [in] model Model handle
+//! @returns Status (0 = success)
+int modelFinalize(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    model->finalize();
+    return 0;
+}
+
+
+//! @brief Returns the current simulation time of a model
+//! @param [in] model Model handle
+//! @returns Simulation time
+double modelGetTime(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    return model->mpSystem->getTime();
+}
+
+
+//! @brief Returns number of logged samples in a model
+//! @param [in] model Model handle
+//! @returns Number of samples
+size_t modelGetNumberOfLogSamples(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    return model->mpSystem->getNumActuallyLoggedSamples();
+}
+
+
+//! @brief Provides a pointer directly to the log time vector of a model, no data is copied
+//! The pointer is valid until the model is initialized again or freed
+//! @param [in] model Model handle
+//! @returns Pointer to time vector, length given by modelGetNumberOfLogSamples()
+const double *modelGetTimeVectorPtr(HopsanModel *model)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    return model->mpSystem->getLogTimeVector()->data();
+}
+
+
+//! @brief Provides a pointer to the logged data of a variable in a model
+//! The log data is stored per node and time step, so each variable is gathered into a contiguous vector once
+//! per simulation. The pointer is valid until the model is simulated again or freed.
+//! @param [in] model Model handle
+//! @param [in] variable Variable name ("component.port.variable", with "subsystem|" prefixes, or an alias)
+//! @returns Pointer to data vector, length given by modelGetNumberOfLogSamples(), or null on failure
+const double *modelGetDataVectorPtr(HopsanModel *model, const char *variable)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    return model->getLogColumn(variable);
+}
+
+
+//! @brief Provides pointers to the logged data of several variables in a model, see modelGetDataVectorPtr()
+//! @param [in] model Model handle
+//! @param [in] variables Array of variable names
+//! @param [out] data Array of data pointers, null for variables that were not found
+//! @param [in] count Number of variables
+//! @returns Status (0 = success, otherwise the number of variables that were not found)
+int modelGetDataVectorPtrs(HopsanModel *model, const char **variables, const double **data, size_t count)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    int nFailed = 0;
+    for(size_t i=0; i<count; ++i) {
+        data[i] = model->getLogColumn(variables[i]);
+        if(!data[i]) {
+            ++nFailed;
+        }
+    }
+    return nFailed;
+}
+
+
+//! @brief Reads the current values of several variables in a model
+//! @param [in] model Model handle
+//! @param [in] variables Array of variable names
+//! @param [out] values Array where the values are stored
+//! @param [in] count Number of variables
+//! @returns Status (0 = success, otherwise the number of variables that were not found)
+int modelGetValues(HopsanModel *model, const char **variables, double *values, size_t count)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    int nFailed = 0;
+    HopsanModel::VariableT var;
+    for(size_t i=0; i<count; ++i) {
+        if(model->getVariable(variables[i], var)) {
+            values[i] = var.first->readNode(size_t(var.second));
+        }
+        else {
+            ++nFailed;
+        }
+    }
+    return nFailed;
+}
+
+
+//! @brief Writes the current values of several variables in a model, e.g. co-simulation inputs between calls to modelSimulateTo()
+//! Note! Values written to variables that are also written by a component will be overwritten in the next step.
+//! @param [in] model Model handle
+//! @param [in] variables Array of variable names
+//! @param [in] values Array of new values
+//! @param [in] count Number of variables
+//! @returns Status (0 = success, otherwise the number of variables that were not found)
+int modelSetValues(HopsanModel *model, const char **variables, const double *values, size_t count)
+{
+    std::lock_guard<std::mutex> lock(model->mMutex);
+    int nFailed = 0;
+    HopsanModel::VariableT var;
+    for(size_t i=0; i<count; ++i) {
+        if(model->getVariable(variables[i], var)) {
+            var.first->writeNode(size_t(var.second), values[i]);
+        }
+        else {
+            ++nFailed;
+        }
+    }
+    return nFailed;
+}
@@ -44,6 +44,7 @@
 
 #include "HopsanEssentials.h"
 #include "CoreUtilities/HopsanCoreMessageHandler.h"
+#include "CoreUtilities/SimulationProgress.h"
 #include "TicToc.hpp"
 
 #ifdef _WIN32
@@ -538,9 +539,13 @@ int main(int argc, char* argv[])
                     msg.simulation_inprogress = gIsSimulating;
                     if (msg.simulation_inprogress || msg.simulation_finished)
                     {
-                        msg.current_simulation_time = gpRootSystem->getTime();
-                        msg.simulation_progress = (msg.current_simulation_time-gSimStartTime) / (gSimStopTime - gSimStartTime);
-                        msg.estimated_simulation_time_remaining = -1;
+                        const SimulationProgressMetrics metrics = gpRootSystem->getSimulationProgress()->getMetrics();
+                        msg.current_simulation_time = metrics.mSimulationTime;
+                        msg.simulation_progress = metrics.mProgress;
+                        msg.estimated_simulation_time_remaining = metrics.mEstimatedTimeRemaining;
+                        msg.simulation_phase = metrics.mPhase;
+                        msg.simulation_steps_per_second = metrics.mStepsPerSecond;
+                        msg.simulation_realtime_ratio = metrics.mRealTimeRatio;
                     }
                     else
                     {
@@ -251,7 +251,9 @@ class ReplymsgReplyWorkerStatus : public WorkerStatusT
 public:
     MSGPACK_DEFINE(model_loaded, simulation_inprogress, simualtion_success, simulation_finished,
                    current_simulation_time, simulation_progress, estimated_simulation_time_remaining,
-                   shell_inprogress, shell_exitok)
+                   shell_inprogress, shell_exitok,
+                   /* Added last to avoid breaking compatibility */
+                   simulation_phase, simulation_steps_per_second, simulation_realtime_ratio)
 };
 
 // Message structs typically used by the Adress server
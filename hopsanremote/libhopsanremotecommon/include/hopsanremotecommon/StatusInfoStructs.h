@@ -51,6 +51,9 @@ public:
     double estimated_simulation_time_remaining=-1;
     bool shell_inprogress=false;
     bool shell_exitok=false;
+    std::string simulation_phase;
+    double simulation_steps_per_second=-1;
+    double simulation_realtime_ratio=-1;
 };
 
 class ServerMachineInfoT